@@ -0,0 +1,191 @@
+#include "include/alloc_tracker.h"
+
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+
+#ifdef ME_ALLOC_TRACKING
+#include <bx/allocator.h>
+
+#if defined(_WIN32)
+#include <malloc.h>
+#define ME_USABLE_SIZE(ptr) _msize(ptr)
+#elif defined(__APPLE__)
+#include <malloc/malloc.h>
+#define ME_USABLE_SIZE(ptr) malloc_size(ptr)
+#else
+#include <malloc.h>
+#define ME_USABLE_SIZE(ptr) malloc_usable_size(ptr)
+#endif
+#endif
+
+namespace MainboardEngine {
+    struct AllocCounters {
+        std::atomic<int64_t> allocations{0};
+        std::atomic<int64_t> frees{0};
+        std::atomic<int64_t> bytes{0};
+    };
+
+    static AllocCounters g_alloc_counters[ME_ALLOC_SUBSYSTEM_COUNT];
+    static std::atomic<int64_t> g_alloc_live_bytes(0);
+    // totals at the last MarkAllocFrame and the difference to the one before, render thread only
+    static ME_AllocCounters g_alloc_frame_start[ME_ALLOC_SUBSYSTEM_COUNT];
+    static ME_AllocCounters g_alloc_frame[ME_ALLOC_SUBSYSTEM_COUNT];
+    static thread_local int g_alloc_subsystem = ME_ALLOC_OTHER;
+
+    void CountAllocation(int subsystem, size_t bytes) {
+        AllocCounters &counters = g_alloc_counters[subsystem];
+        counters.allocations.fetch_add(1, std::memory_order_relaxed);
+        counters.bytes.fetch_add(static_cast<int64_t>(bytes), std::memory_order_relaxed);
+    }
+
+    void CountFree(int subsystem) {
+        g_alloc_counters[subsystem].frees.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    int GetAllocSubsystem() {
+        return g_alloc_subsystem;
+    }
+
+    void SetAllocSubsystem(int subsystem) {
+        g_alloc_subsystem = subsystem;
+    }
+
+    static ME_AllocCounters LoadCounters(const AllocCounters &counters) {
+        ME_AllocCounters loaded = {};
+        loaded.allocations = counters.allocations.load(std::memory_order_relaxed);
+        loaded.frees = counters.frees.load(std::memory_order_relaxed);
+        loaded.bytes = counters.bytes.load(std::memory_order_relaxed);
+        return loaded;
+    }
+
+    void MarkAllocFrame() {
+        for (int i = 0; i < ME_ALLOC_SUBSYSTEM_COUNT; ++i) {
+            ME_AllocCounters now = LoadCounters(g_alloc_counters[i]);
+            g_alloc_frame[i].allocations = now.allocations - g_alloc_frame_start[i].allocations;
+            g_alloc_frame[i].frees = now.frees - g_alloc_frame_start[i].frees;
+            g_alloc_frame[i].bytes = now.bytes - g_alloc_frame_start[i].bytes;
+            g_alloc_frame_start[i] = now;
+        }
+    }
+
+    void GetAllocStats(ME_AllocStats *stats) {
+        *stats = {};
+#ifdef ME_ALLOC_TRACKING
+        stats->enabled = ME_TRUE;
+#endif
+        stats->live_bytes = g_alloc_live_bytes.load(std::memory_order_relaxed);
+        for (int i = 0; i < ME_ALLOC_SUBSYSTEM_COUNT; ++i) {
+            stats->total[i] = LoadCounters(g_alloc_counters[i]);
+            stats->frame[i] = g_alloc_frame[i];
+        }
+    }
+
+    void ResetAllocStats() {
+        for (int i = 0; i < ME_ALLOC_SUBSYSTEM_COUNT; ++i) {
+            g_alloc_counters[i].allocations.store(0, std::memory_order_relaxed);
+            g_alloc_counters[i].frees.store(0, std::memory_order_relaxed);
+            g_alloc_counters[i].bytes.store(0, std::memory_order_relaxed);
+            g_alloc_frame_start[i] = {};
+            g_alloc_frame[i] = {};
+        }
+    }
+
+#ifdef ME_ALLOC_TRACKING
+    class MEBgfxAllocator : public bx::AllocatorI {
+        bx::DefaultAllocator m_allocator;
+
+    public:
+        void *realloc(void *ptr, size_t size, size_t align, const char *file_path, uint32_t line) override {
+            // a realloc counts as a fresh allocation plus a free, it copies like one
+            if (ptr) {
+                CountFree(ME_ALLOC_BGFX);
+            }
+            if (size > 0) {
+                CountAllocation(ME_ALLOC_BGFX, size);
+            }
+            return m_allocator.realloc(ptr, size, align, file_path, line);
+        }
+    };
+
+    bx::AllocatorI *GetTrackedBgfxAllocator() {
+        static MEBgfxAllocator allocator;
+        return &allocator;
+    }
+
+    // no header in front of the blocks: memory may cross between this library's and the
+    // runtime's operator new (other modules, dlopen symbol lookup), so both must stay plain malloc
+    static void *TrackedAlloc(size_t size) noexcept {
+        void *ptr = std::malloc(size ? size : 1);
+        if (ptr) {
+            CountAllocation(g_alloc_subsystem, size);
+            g_alloc_live_bytes.fetch_add(static_cast<int64_t>(ME_USABLE_SIZE(ptr)), std::memory_order_relaxed);
+        }
+        return ptr;
+    }
+
+    static void TrackedFree(void *ptr) noexcept {
+        if (!ptr) {
+            return;
+        }
+        CountFree(g_alloc_subsystem);
+        g_alloc_live_bytes.fetch_sub(static_cast<int64_t>(ME_USABLE_SIZE(ptr)), std::memory_order_relaxed);
+        std::free(ptr);
+    }
+#else
+    bx::AllocatorI *GetTrackedBgfxAllocator() {
+        return nullptr;
+    }
+#endif
+}
+
+#ifdef ME_ALLOC_TRACKING
+void *operator new(size_t size) {
+    void *ptr = MainboardEngine::TrackedAlloc(size);
+    if (!ptr) {
+        throw std::bad_alloc();
+    }
+    return ptr;
+}
+
+void *operator new[](size_t size) {
+    void *ptr = MainboardEngine::TrackedAlloc(size);
+    if (!ptr) {
+        throw std::bad_alloc();
+    }
+    return ptr;
+}
+
+void *operator new(size_t size, const std::nothrow_t &) noexcept {
+    return MainboardEngine::TrackedAlloc(size);
+}
+
+void *operator new[](size_t size, const std::nothrow_t &) noexcept {
+    return MainboardEngine::TrackedAlloc(size);
+}
+
+void operator delete(void *ptr) noexcept {
+    MainboardEngine::TrackedFree(ptr);
+}
+
+void operator delete[](void *ptr) noexcept {
+    MainboardEngine::TrackedFree(ptr);
+}
+
+void operator delete(void *ptr, size_t) noexcept {
+    MainboardEngine::TrackedFree(ptr);
+}
+
+void operator delete[](void *ptr, size_t) noexcept {
+    MainboardEngine::TrackedFree(ptr);
+}
+
+void operator delete(void *ptr, const std::nothrow_t &) noexcept {
+    MainboardEngine::TrackedFree(ptr);
+}
+
+void operator delete[](void *ptr, const std::nothrow_t &) noexcept {
+    MainboardEngine::TrackedFree(ptr);
+}
+#endif
@@ -0,0 +1,84 @@
+#include "include/block_loader.h"
+
+#include <algorithm>
+
+namespace MainboardEngine {
+    MEBlockLoader::MEBlockLoader(int workers) : m_worker_count(workers), m_generation(0), m_in_flight(0),
+                                                m_stop(false) {
+        if (m_worker_count <= 0) {
+            m_worker_count = std::max(1, static_cast<int>(std::thread::hardware_concurrency()) - 1);
+        }
+    }
+
+    MEBlockLoader::~MEBlockLoader() {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stop = true;
+            m_requests.clear();
+        }
+        m_wake.notify_all();
+        for (auto &worker: m_workers) {
+            worker.join();
+        }
+    }
+
+    void MEBlockLoader::Submit(int id, const std::string &path, const ME_BlockDesc &desc) {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_requests.push_back({id, path, desc});
+            if (m_workers.empty()) {
+                for (int i = 0; i < m_worker_count; ++i) {
+                    m_workers.emplace_back(&MEBlockLoader::WorkerLoop, this);
+                }
+            }
+        }
+        m_wake.notify_one();
+    }
+
+    void MEBlockLoader::WorkerLoop() {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        while (true) {
+            m_wake.wait(lock, [this] { return m_stop || !m_requests.empty(); });
+            if (m_stop) {
+                return;
+            }
+            Request request = std::move(m_requests.front());
+            m_requests.pop_front();
+            uint64_t generation = m_generation;
+            ++m_in_flight;
+            lock.unlock();
+
+            MEDecodedBlock decoded = {};
+            decoded.id = request.id;
+            decoded.path = std::move(request.path);
+            decoded.desc = request.desc;
+            DecodeImageFile(decoded.path, 0, decoded.image);
+
+            lock.lock();
+            --m_in_flight;
+            if (generation == m_generation) {
+                m_decoded.push_back(std::move(decoded));
+            }
+        }
+    }
+
+    void MEBlockLoader::TakeDecoded(std::vector<MEDecodedBlock> &out) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        for (auto &decoded: m_decoded) {
+            out.push_back(std::move(decoded));
+        }
+        m_decoded.clear();
+    }
+
+    void MEBlockLoader::Cancel() {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_requests.clear();
+        m_decoded.clear();
+        ++m_generation;
+    }
+
+    int MEBlockLoader::GetPendingCount() const {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return static_cast<int>(m_requests.size() + m_decoded.size()) + m_in_flight;
+    }
+}
@@ -0,0 +1,766 @@
+#include "include/call_recorder.h"
+#include "include/mapped_file.h"
+#include "include/trace.h"
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace MainboardEngine {
+    std::atomic<bool> g_record_enabled(false);
+
+    static const char RECORD_MAGIC[4] = {'M', 'B', 'R', 'C'};
+    constexpr uint32_t RECORD_VERSION = 1;
+    // calls are buffered and written in blocks, so recording does not add a syscall per call
+    constexpr size_t RECORD_FLUSH_SIZE = 1 << 20;
+
+    struct Recorder {
+        std::mutex mutex;
+        std::ofstream file;
+        std::vector<uint8_t> buffer;
+        size_t record_start = 0;
+        std::chrono::steady_clock::time_point last_call;
+        std::vector<ME_HANDLE> windows;
+        std::vector<int> batches;
+    };
+
+    static Recorder g_recorder;
+
+    static void FlushRecorder() {
+        g_recorder.file.write(reinterpret_cast<const char *>(g_recorder.buffer.data()),
+                              static_cast<std::streamsize>(g_recorder.buffer.size()));
+        g_recorder.buffer.clear();
+    }
+
+    bool StartRecording(const char *path) {
+        std::lock_guard<std::mutex> lock(g_recorder.mutex);
+        if (g_recorder.file.is_open()) {
+            return false;
+        }
+        g_recorder.file.open(path, std::ios::binary | std::ios::trunc);
+        if (!g_recorder.file.is_open()) {
+            return false;
+        }
+        MERecordHeader header = {};
+        std::memcpy(header.magic, RECORD_MAGIC, sizeof(RECORD_MAGIC));
+        header.version = RECORD_VERSION;
+        g_recorder.file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+
+        g_recorder.buffer.clear();
+        g_recorder.buffer.reserve(RECORD_FLUSH_SIZE * 2);
+        g_recorder.last_call = std::chrono::steady_clock::now();
+        g_recorder.windows.clear();
+        g_recorder.batches.clear();
+        g_record_enabled.store(true, std::memory_order_relaxed);
+
+        return g_recorder.file.good();
+    }
+
+    bool StopRecording() {
+        g_record_enabled.store(false, std::memory_order_relaxed);
+        std::lock_guard<std::mutex> lock(g_recorder.mutex);
+        if (!g_recorder.file.is_open()) {
+            return false;
+        }
+        FlushRecorder();
+        bool state = g_recorder.file.good();
+        g_recorder.file.close();
+
+        return state;
+    }
+
+    uint8_t *BeginRecord(MERecordOpcode opcode, uint32_t size) {
+        g_recorder.mutex.lock();
+        if (!g_recorder.file.is_open()) {
+            return nullptr;
+        }
+        auto now = std::chrono::steady_clock::now();
+        MERecordCall call = {};
+        call.opcode = opcode;
+        call.size = size;
+        call.delta_us = static_cast<uint32_t>(
+            std::chrono::duration_cast<std::chrono::microseconds>(now - g_recorder.last_call).count());
+        g_recorder.last_call = now;
+
+        auto &buffer = g_recorder.buffer;
+        g_recorder.record_start = buffer.size();
+        buffer.resize(buffer.size() + sizeof(call) + size);
+        std::memcpy(buffer.data() + g_recorder.record_start, &call, sizeof(call));
+
+        return buffer.data() + g_recorder.record_start + sizeof(call);
+    }
+
+    void EndRecord() {
+        if (g_recorder.buffer.size() >= RECORD_FLUSH_SIZE) {
+            FlushRecorder();
+        }
+        g_recorder.mutex.unlock();
+    }
+
+    // called with the recorder locked
+    int GetRecordedWindow(ME_HANDLE handle) {
+        for (size_t i = 0; i < g_recorder.windows.size(); ++i) {
+            if (g_recorder.windows[i] == handle) {
+                return static_cast<int>(i);
+            }
+        }
+        return -1;
+    }
+
+    void RecordWindow(ME_HANDLE handle) {
+        std::lock_guard<std::mutex> lock(g_recorder.mutex);
+        if (!g_recorder.file.is_open()) {
+            return;
+        }
+        // failed creations take an index too, the replay counts them the same way
+        g_recorder.windows.push_back(handle);
+    }
+
+    void ForgetWindow(ME_HANDLE handle) {
+        std::lock_guard<std::mutex> lock(g_recorder.mutex);
+        if (!handle) {
+            return;
+        }
+        int index = GetRecordedWindow(handle);
+        if (index >= 0) {
+            // keep the indices of the other windows stable
+            g_recorder.windows[index] = nullptr;
+        }
+    }
+
+    // called with the recorder locked, a released id is forgotten so only its live batch matches
+    int GetRecordedPathBatch(int batch) {
+        if (batch < 0) {
+            return -1;
+        }
+        for (size_t i = 0; i < g_recorder.batches.size(); ++i) {
+            if (g_recorder.batches[i] == batch) {
+                return static_cast<int>(i);
+            }
+        }
+        return -1;
+    }
+
+    void RecordPathBatch(int batch) {
+        std::lock_guard<std::mutex> lock(g_recorder.mutex);
+        if (!g_recorder.file.is_open()) {
+            return;
+        }
+        // failed submissions take an index too, like windows
+        g_recorder.batches.push_back(batch);
+    }
+
+    void ForgetPathBatch(int batch) {
+        std::lock_guard<std::mutex> lock(g_recorder.mutex);
+        int index = GetRecordedPathBatch(batch);
+        if (index >= 0) {
+            g_recorder.batches[index] = -1;
+        }
+    }
+
+    // reads the arguments of one record in the order they were written
+    class RecordReader {
+        const uint8_t *m_data;
+        const uint8_t *m_end;
+        bool m_valid;
+
+    public:
+        RecordReader(const uint8_t *data, uint32_t size) : m_data(data), m_end(data + size), m_valid(true) {
+        }
+
+        bool IsValid() const {
+            return m_valid;
+        }
+
+        template<typename T>
+        T Read() {
+            T value = {};
+            if (m_end - m_data < static_cast<ptrdiff_t>(sizeof(T))) {
+                m_valid = false;
+                return value;
+            }
+            std::memcpy(&value, m_data, sizeof(T));
+            m_data += sizeof(T);
+            return value;
+        }
+
+        // copied into storage, records give no alignment guarantee
+        template<typename T>
+        const T *ReadArray(int &count, std::vector<T> &storage) {
+            count = Read<int32_t>();
+            if (count <= 0) {
+                return nullptr;
+            }
+            if (m_end - m_data < static_cast<ptrdiff_t>(count * sizeof(T))) {
+                m_valid = false;
+                count = 0;
+                return nullptr;
+            }
+            storage.resize(count);
+            std::memcpy(storage.data(), m_data, count * sizeof(T));
+            m_data += count * sizeof(T);
+            return storage.data();
+        }
+
+        const char *ReadString(std::string &storage) {
+            int32_t length = Read<int32_t>();
+            if (length < 0) {
+                return nullptr;
+            }
+            if (m_end - m_data < length) {
+                m_valid = false;
+                return nullptr;
+            }
+            storage.assign(reinterpret_cast<const char *>(m_data), length);
+            m_data += length;
+            return storage.c_str();
+        }
+    };
+
+    struct ReplayState {
+        std::vector<ME_HANDLE> windows;
+        std::vector<int> ints[4];
+        std::vector<unsigned int> tints;
+        std::vector<ME_AABB> boxes;
+        std::vector<ME_Ray> rays;
+        std::vector<ME_RaycastHit> hits;
+        std::vector<ME_PathRequest> paths;
+        std::vector<ME_PathResult> path_results;
+        std::vector<ME_TileCoord> tiles;
+        std::vector<short> shorts;
+        std::vector<int> batches; // the replayed id and request count of every ME_FindPaths call
+        std::vector<int> batch_sizes;
+        std::string text;
+
+        ME_HANDLE GetWindow(int index) const {
+            return index >= 0 && index < static_cast<int>(windows.size()) ? windows[index] : nullptr;
+        }
+
+        int GetBatch(int index) const {
+            return index >= 0 && index < static_cast<int>(batches.size()) ? batches[index] : -1;
+        }
+    };
+
+    static bool ReplayCall(ReplayState &state, uint16_t opcode, RecordReader &reader) {
+        switch (opcode) {
+            case RECORD_INITIALIZE:
+                ME_Initialize();
+                break;
+            case RECORD_CREATE_WINDOW: {
+                int full_screen = reader.Read<int>();
+                int x = reader.Read<int>();
+                int y = reader.Read<int>();
+                int width = reader.Read<int>();
+                int height = reader.Read<int>();
+                const char *title = reader.ReadString(state.text);
+                state.windows.push_back(reader.IsValid()
+                                            ? ME_CreateWindow(full_screen, x, y, width, height, title ? title : "")
+                                            : nullptr);
+                break;
+            }
+            case RECORD_DESTROY_WINDOW: {
+                int index = reader.Read<int>();
+                ME_HANDLE window = state.GetWindow(index);
+                if (window) {
+                    ME_DestroyWindow(window);
+                    state.windows[index] = nullptr;
+                }
+                break;
+            }
+            case RECORD_PROCESS_EVENTS: {
+                // keeps the window responsive, the events themselves came from the recorded session
+                ME_HANDLE window = state.GetWindow(reader.Read<int>());
+                if (window) {
+                    ME_ProcessEvents(window);
+                }
+                break;
+            }
+            case RECORD_RENDER_BLOCK: {
+                int id = reader.Read<int>();
+                int x = reader.Read<int>();
+                int y = reader.Read<int>();
+                ME_RenderBlock(id, x, y);
+                break;
+            }
+            case RECORD_RENDER_BLOCKS: {
+                int count = 0;
+                int xs_count = 0;
+                int ys_count = 0;
+                const int *ids = reader.ReadArray(count, state.ints[0]);
+                const int *xs = reader.ReadArray(xs_count, state.ints[1]);
+                const int *ys = reader.ReadArray(ys_count, state.ints[2]);
+                if (ids && xs && ys) {
+                    ME_RenderBlocks(ids, xs, ys, std::min(count, std::min(xs_count, ys_count)));
+                }
+                break;
+            }
+            case RECORD_RENDER_FRAME: {
+                ME_HANDLE window = state.GetWindow(reader.Read<int>());
+                if (window) {
+                    ME_RenderFrame(window);
+                }
+                break;
+            }
+            case RECORD_BEGIN_FRAME: {
+                ME_HANDLE window = state.GetWindow(reader.Read<int>());
+                if (window) {
+                    ME_BeginFrame(window);
+                }
+                break;
+            }
+            case RECORD_END_FRAME: {
+                ME_HANDLE window = state.GetWindow(reader.Read<int>());
+                if (window) {
+                    ME_EndFrame(window);
+                }
+                break;
+            }
+            case RECORD_SET_WINDOW_SIZE: {
+                ME_HANDLE window = state.GetWindow(reader.Read<int>());
+                int width = reader.Read<int>();
+                int height = reader.Read<int>();
+                if (window) {
+                    ME_SetWindowSize(window, width, height);
+                }
+                break;
+            }
+            case RECORD_SET_WINDOW_TITLE: {
+                ME_HANDLE window = state.GetWindow(reader.Read<int>());
+                const char *title = reader.ReadString(state.text);
+                if (window && title) {
+                    ME_SetWindowTitle(window, title);
+                }
+                break;
+            }
+            case RECORD_LOAD_BLOCK: {
+                int id = reader.Read<int>();
+                const char *path = reader.ReadString(state.text);
+                if (path) {
+                    ME_LoadBlock(id, path);
+                }
+                break;
+            }
+            case RECORD_LOAD_BLOCK_EX: {
+                int id = reader.Read<int>();
+                const char *path = reader.ReadString(state.text);
+                auto desc = reader.Read<ME_BlockDesc>();
+                if (path) {
+                    ME_LoadBlockEx(id, path, &desc);
+                }
+                break;
+            }
+            case RECORD_LOAD_BLOCK_ASYNC: {
+                int id = reader.Read<int>();
+                const char *path = reader.ReadString(state.text);
+                auto desc = reader.Read<ME_BlockDesc>();
+                if (path) {
+                    ME_LoadBlockAsync(id, path, &desc);
+                }
+                break;
+            }
+            case RECORD_CLEAR_BLOCK:
+                ME_ClearBlock();
+                break;
+            case RECORD_SET_RENDER_SCALE:
+                ME_SetRenderScale(reader.Read<float>());
+                break;
+            case RECORD_SET_STATIC_LAYER: {
+                int tile_width = reader.Read<int>();
+                int tile_height = reader.Read<int>();
+                int columns = reader.Read<int>();
+                int rows = reader.Read<int>();
+                ME_SetStaticLayer(tile_width, tile_height, columns, rows);
+                break;
+            }
+            case RECORD_SET_STATIC_TILE: {
+                int column = reader.Read<int>();
+                int row = reader.Read<int>();
+                int id = reader.Read<int>();
+                ME_SetStaticTile(column, row, id);
+                break;
+            }
+            case RECORD_SET_STATIC_LAYER_MODE:
+                ME_SetStaticLayerMode(reader.Read<int>());
+                break;
+            case RECORD_CREATE_VIEW: {
+                auto desc = reader.Read<ME_ViewDesc>();
+                ME_CreateView(&desc);
+                break;
+            }
+            case RECORD_UPDATE_VIEW: {
+                int view = reader.Read<int>();
+                auto desc = reader.Read<ME_ViewDesc>();
+                ME_UpdateView(view, &desc);
+                break;
+            }
+            case RECORD_DESTROY_VIEW:
+                ME_DestroyView(reader.Read<int>());
+                break;
+            case RECORD_SET_VIEW_LAYERS: {
+                int view = reader.Read<int>();
+                int layer_mask = reader.Read<int>();
+                ME_SetViewLayers(view, layer_mask);
+                break;
+            }
+            case RECORD_LOAD_FONT: {
+                int font_id = reader.Read<int>();
+                const char *path = reader.ReadString(state.text);
+                float pixel_height = reader.Read<float>();
+                int flags = reader.Read<int>();
+                if (path) {
+                    ME_LoadFont(font_id, path, pixel_height, flags);
+                }
+                break;
+            }
+            case RECORD_UNLOAD_FONT:
+                ME_UnloadFont(reader.Read<int>());
+                break;
+            case RECORD_DRAW_TEXT: {
+                int font_id = reader.Read<int>();
+                int x = reader.Read<int>();
+                int y = reader.Read<int>();
+                float scale = reader.Read<float>();
+                const char *text = reader.ReadString(state.text);
+                unsigned int color = reader.Read<unsigned int>();
+                if (text) {
+                    ME_DrawTextScaled(font_id, x, y, scale, text, color);
+                }
+                break;
+            }
+            case RECORD_CREATE_EMITTER: {
+                auto desc = reader.Read<ME_EmitterDesc>();
+                ME_CreateEmitter(&desc);
+                break;
+            }
+            case RECORD_UPDATE_EMITTER: {
+                int emitter = reader.Read<int>();
+                auto desc = reader.Read<ME_EmitterDesc>();
+                ME_UpdateEmitter(emitter, &desc);
+                break;
+            }
+            case RECORD_DESTROY_EMITTER:
+                ME_DestroyEmitter(reader.Read<int>());
+                break;
+            case RECORD_EMIT_PARTICLES: {
+                int emitter = reader.Read<int>();
+                float x = reader.Read<float>();
+                float y = reader.Read<float>();
+                int count = reader.Read<int>();
+                ME_EmitParticles(emitter, x, y, count);
+                break;
+            }
+            case RECORD_SET_BLOCK_LIGHT: {
+                int block_id = reader.Read<int>();
+                int emission = reader.Read<int>();
+                int opacity = reader.Read<int>();
+                ME_SetBlockLight(block_id, emission, opacity);
+                break;
+            }
+            case RECORD_SET_LIGHTING: {
+                int enabled = reader.Read<int>();
+                int ambient = reader.Read<int>();
+                int air_falloff = reader.Read<int>();
+                ME_SetLighting(enabled, ambient, air_falloff);
+                break;
+            }
+            case RECORD_SET_CAMERA: {
+                int x = reader.Read<int>();
+                int y = reader.Read<int>();
+                ME_SetCamera(x, y);
+                break;
+            }
+            case RECORD_OPEN_WORLD: {
+                const char *path = reader.ReadString(state.text);
+                int placeholder = reader.Read<int>();
+                int budget_kb = reader.Read<int>();
+                if (path) {
+                    ME_OpenWorld(path, placeholder, budget_kb);
+                }
+                break;
+            }
+            case RECORD_CLOSE_WORLD:
+                ME_CloseWorld();
+                break;
+            case RECORD_QUERY_POINTS: {
+                int count = 0;
+                int ys_count = 0;
+                const int *xs = reader.ReadArray(count, state.ints[0]);
+                const int *ys = reader.ReadArray(ys_count, state.ints[1]);
+                if (xs && ys) {
+                    count = std::min(count, ys_count);
+                    state.ints[2].resize(count);
+                    ME_QueryPoints(xs, ys, count, state.ints[2].data());
+                }
+                break;
+            }
+            case RECORD_QUERY_AABBS: {
+                int count = 0;
+                const ME_AABB *boxes = reader.ReadArray(count, state.boxes);
+                if (boxes) {
+                    state.ints[0].resize(count);
+                    ME_QueryAABBs(boxes, count, state.ints[0].data());
+                }
+                break;
+            }
+            case RECORD_RAYCASTS: {
+                int count = 0;
+                const ME_Ray *rays = reader.ReadArray(count, state.rays);
+                if (rays) {
+                    state.hits.resize(count);
+                    ME_Raycasts(rays, count, state.hits.data());
+                }
+                break;
+            }
+            case RECORD_FIND_PATHS: {
+                int count = 0;
+                const ME_PathRequest *requests = reader.ReadArray(count, state.paths);
+                // every call takes an index, the waits and releases after it refer to that
+                state.batches.push_back(ME_FindPaths(requests, count));
+                state.batch_sizes.push_back(std::max(count, 0));
+                break;
+            }
+            case RECORD_WAIT_PATHS: {
+                int batch = state.GetBatch(reader.Read<int>());
+                if (batch >= 0) {
+                    ME_WaitPaths(batch);
+                }
+                break;
+            }
+            case RECORD_GET_PATHS: {
+                int index = reader.Read<int>();
+                int capacity = reader.Read<int>();
+                int batch = state.GetBatch(index);
+                if (batch >= 0) {
+                    state.path_results.resize(state.batch_sizes[index]);
+                    state.tiles.resize(std::max(capacity, 0));
+                    ME_GetPaths(batch, state.path_results.data(), state.tiles.data(), std::max(capacity, 0));
+                }
+                break;
+            }
+            case RECORD_RELEASE_PATHS: {
+                int index = reader.Read<int>();
+                int batch = state.GetBatch(index);
+                if (batch >= 0) {
+                    ME_ReleasePaths(batch);
+                    state.batches[index] = -1;
+                }
+                break;
+            }
+            case RECORD_OPEN_MAP: {
+                const char *path = reader.ReadString(state.text);
+                if (path) {
+                    ME_OpenMap(path);
+                }
+                break;
+            }
+            case RECORD_SET_TILE: {
+                // edits go to the static layer only, a replay never writes the map
+                int column = reader.Read<int>();
+                int row = reader.Read<int>();
+                int id = reader.Read<int>();
+                ME_SetStaticTile(column, row, id);
+                break;
+            }
+            case RECORD_FILL_RECT: {
+                int column = reader.Read<int>();
+                int row = reader.Read<int>();
+                int width = reader.Read<int>();
+                int height = reader.Read<int>();
+                int id = reader.Read<int>();
+                // the rect was clipped to the layer, stop where the tiles run out
+                bool inside = true;
+                for (int y = std::max(row, 0); inside && y < row + height; ++y) {
+                    for (int x = std::max(column, 0); x < column + width; ++x) {
+                        if (!ME_SetStaticTile(x, y, id)) {
+                            inside = x > std::max(column, 0);
+                            break;
+                        }
+                    }
+                }
+                break;
+            }
+            case RECORD_RENDER_BLOCK_EX: {
+                int id = reader.Read<int>();
+                int x = reader.Read<int>();
+                int y = reader.Read<int>();
+                unsigned int tint = reader.Read<unsigned int>();
+                int orientation = reader.Read<int>();
+                ME_RenderBlockEx(id, x, y, tint, orientation);
+                break;
+            }
+            case RECORD_RENDER_BLOCKS_EX: {
+                int count = 0;
+                int xs_count = 0;
+                int ys_count = 0;
+                int tints_count = 0;
+                int orientations_count = 0;
+                const int *ids = reader.ReadArray(count, state.ints[0]);
+                const int *xs = reader.ReadArray(xs_count, state.ints[1]);
+                const int *ys = reader.ReadArray(ys_count, state.ints[2]);
+                // recorded as missing when they were NULL
+                const unsigned int *tints = reader.ReadArray(tints_count, state.tints);
+                const int *orientations = reader.ReadArray(orientations_count, state.ints[3]);
+                count = std::min(count, std::min(xs_count, ys_count));
+                if (tints) {
+                    count = std::min(count, tints_count);
+                }
+                if (orientations) {
+                    count = std::min(count, orientations_count);
+                }
+                if (ids && xs && ys) {
+                    ME_RenderBlocksEx(ids, xs, ys, tints, orientations, count);
+                }
+                break;
+            }
+            case RECORD_REGISTER_BLOCK_VARIANT: {
+                int id = reader.Read<int>();
+                int base_id = reader.Read<int>();
+                unsigned int tint = reader.Read<unsigned int>();
+                int orientation = reader.Read<int>();
+                ME_RegisterBlockVariant(id, base_id, tint, orientation);
+                break;
+            }
+            case RECORD_SAVE_MAP:
+            case RECORD_COMPACT_MAP:
+                // the edits only reached the static layer, there is nothing of the replay to write
+                break;
+            case RECORD_CLOSE_MAP:
+                ME_CloseMap();
+                break;
+            case RECORD_COOK_BLOCK_TEXTURE: {
+                const char *path = reader.ReadString(state.text);
+                std::string block_path = path ? path : "";
+                const char *format = reader.ReadString(state.text);
+                int flags = reader.Read<int>();
+                if (path && format) {
+                    ME_CookBlockTexture(block_path.c_str(), format, flags);
+                }
+                break;
+            }
+            case RECORD_WRITE_WORLD: {
+                // writes the same file the session did, the OPEN_WORLD calls after it read that
+                const char *path = reader.ReadString(state.text);
+                int tile_width = reader.Read<int>();
+                int tile_height = reader.Read<int>();
+                int columns = reader.Read<int>();
+                int rows = reader.Read<int>();
+                int count = 0;
+                const short *tiles = reader.ReadArray(count, state.shorts);
+                if (path && tiles && static_cast<long long>(columns) * rows == count) {
+                    ME_WriteWorld(path, tile_width, tile_height, columns, rows, tiles);
+                }
+                break;
+            }
+            case RECORD_SET_RENDERER_TYPE:
+                ME_SetRendererType(reader.Read<int>());
+                break;
+            case RECORD_RUN_LOOP:
+                // the loop's events and frames follow as their own records, its callbacks can't be replayed
+                reader.Read<int>();
+                reader.Read<double>();
+                reader.Read<int>();
+                reader.Read<double>();
+                break;
+            case RECORD_SAVE_FRAME_PNG: {
+                const char *path = reader.ReadString(state.text);
+                if (path) {
+                    ME_SaveFramePng(path);
+                }
+                break;
+            }
+            case RECORD_QUERY_AABB: {
+                int count = 0;
+                const ME_AABB *box = reader.ReadArray(count, state.boxes);
+                int capacity = std::max(reader.Read<int>(), 0);
+                if (box) {
+                    state.tiles.resize(capacity);
+                    ME_QueryAABB(box, capacity > 0 ? state.tiles.data() : nullptr, capacity);
+                }
+                break;
+            }
+            default:
+                // written by a newer engine, its size still lets us step over it
+                break;
+        }
+
+        return reader.IsValid();
+    }
+
+    bool ReplayRecording(const char *path, int flags, ME_ReplayStats *stats) {
+        ME_TRACE_SCOPE("ReplayRecording");
+        if (g_record_enabled.load(std::memory_order_relaxed)) {
+            return false;
+        }
+        MEMappedFile file;
+        if (!file.Open(path) || file.GetSize() < sizeof(MERecordHeader)) {
+            return false;
+        }
+        MERecordHeader header = {};
+        std::memcpy(&header, file.GetData(), sizeof(header));
+        if (std::memcmp(header.magic, RECORD_MAGIC, sizeof(RECORD_MAGIC)) != 0 || header.version != RECORD_VERSION) {
+            return false;
+        }
+
+        using clock = std::chrono::steady_clock;
+        bool realtime = (flags & ME_REPLAY_REALTIME) != 0;
+        ME_ReplayStats result = {};
+        ReplayState state;
+        auto start = clock::now();
+        auto frame_start = start;
+        uint64_t recorded_us = 0;
+
+        const uint8_t *data = file.GetData() + sizeof(MERecordHeader);
+        const uint8_t *end = file.GetData() + file.GetSize();
+        while (end - data >= static_cast<ptrdiff_t>(sizeof(MERecordCall))) {
+            MERecordCall call = {};
+            std::memcpy(&call, data, sizeof(call));
+            data += sizeof(call);
+            if (static_cast<uint64_t>(end - data) < call.size) {
+                break; // cut off, the recording was not stopped
+            }
+            recorded_us += call.delta_us;
+            if (realtime) {
+                std::this_thread::sleep_until(start + std::chrono::microseconds(recorded_us));
+            }
+
+            RecordReader reader(data, call.size);
+            if (!ReplayCall(state, call.opcode, reader)) {
+                return false;
+            }
+            data += call.size;
+            ++result.call_count;
+
+            if (call.opcode == RECORD_RENDER_FRAME || call.opcode == RECORD_END_FRAME) {
+                auto now = clock::now();
+                double frame_ms = std::chrono::duration<double, std::milli>(now - frame_start).count();
+                result.max_frame_ms = std::max(result.max_frame_ms, frame_ms);
+                frame_start = now;
+                ++result.frame_count;
+            }
+        }
+
+        // batches the session still held when the recording stopped
+        for (int batch: state.batches) {
+            if (batch >= 0) {
+                ME_ReleasePaths(batch);
+            }
+        }
+        for (ME_HANDLE window: state.windows) {
+            if (window) {
+                ME_DestroyWindow(window);
+            }
+        }
+
+        result.recorded_ms = static_cast<double>(recorded_us) / 1000.0;
+        result.elapsed_ms = std::chrono::duration<double, std::milli>(clock::now() - start).count();
+        if (stats) {
+            *stats = result;
+        }
+
+        return true;
+    }
+}
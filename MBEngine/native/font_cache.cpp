@@ -0,0 +1,182 @@
+#include "include/font_cache.h"
+#include "include/trace.h"
+
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+
+#define STB_TRUETYPE_IMPLEMENTATION
+#include <stb_truetype.h>
+
+namespace MainboardEngine {
+    // distance field value on the outline, and how much it changes per pixel away from it
+    constexpr unsigned char FONT_SDF_ON_EDGE = 128;
+    constexpr float FONT_SDF_PIXEL_DISTANCE = static_cast<float>(FONT_SDF_ON_EDGE) / FONT_SDF_PADDING;
+
+    MEFont::MEFont() : m_info(std::make_unique<stbtt_fontinfo>()), m_scale(1.0f), m_ascent(0.0f),
+                       m_line_height(0.0f), m_sdf(false), m_atlas BGFX_INVALID_HANDLE, m_shelf_x(0),
+                       m_shelf_y(0), m_shelf_height(0), m_full(false) {
+    }
+
+    MEFont::~MEFont() {
+        if (bgfx::isValid(m_atlas)) {
+            bgfx::destroy(m_atlas);
+        }
+    }
+
+    std::unique_ptr<MEFont> MEFont::Load(const char *path, float pixel_height, bool sdf) {
+        ME_TRACE_SCOPE("LoadFont");
+        if (pixel_height <= 0.0f) {
+            return nullptr;
+        }
+        std::ifstream file(path, std::ios::binary);
+        if (!file.is_open()) {
+            return nullptr;
+        }
+
+        std::unique_ptr<MEFont> font(new MEFont());
+        font->m_data.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+        const unsigned char *data = font->m_data.data();
+        int offset = stbtt_GetFontOffsetForIndex(data, 0);
+        if (font->m_data.empty() || offset < 0 || !stbtt_InitFont(font->m_info.get(), data, offset)) {
+            return nullptr;
+        }
+
+        int ascent = 0;
+        int descent = 0;
+        int line_gap = 0;
+        stbtt_GetFontVMetrics(font->m_info.get(), &ascent, &descent, &line_gap);
+        font->m_scale = stbtt_ScaleForPixelHeight(font->m_info.get(), pixel_height);
+        font->m_ascent = std::round(static_cast<float>(ascent) * font->m_scale);
+        font->m_line_height = std::round(static_cast<float>(ascent - descent + line_gap) * font->m_scale);
+        font->m_sdf = sdf;
+        // glyphs are written into it as they are first used, it must stay mutable
+        font->m_atlas = bgfx::createTexture2D(FONT_ATLAS_SIZE, FONT_ATLAS_SIZE, false, 1, bgfx::TextureFormat::R8,
+                                              BGFX_SAMPLER_UVW_CLAMP);
+        font->ClearAtlas();
+        return font;
+    }
+
+    void MEFont::ClearAtlas() {
+        // the gaps between glyphs are sampled by filtering, they must be blank
+        const bgfx::Memory *blank = bgfx::alloc(FONT_ATLAS_SIZE * FONT_ATLAS_SIZE);
+        std::memset(blank->data, 0, blank->size);
+        bgfx::updateTexture2D(m_atlas, 0, 0, 0, 0, FONT_ATLAS_SIZE, FONT_ATLAS_SIZE, blank);
+        m_glyphs.clear();
+        m_shelf_x = 0;
+        m_shelf_y = 0;
+        m_shelf_height = 0;
+        m_full = false;
+    }
+
+    bool MEFont::Pack(int width, int height, int &x, int &y) {
+        // one pixel between glyphs so bilinear filtering never reads the neighbour
+        if (m_shelf_x + width + 1 > FONT_ATLAS_SIZE) {
+            m_shelf_x = 0;
+            m_shelf_y += m_shelf_height + 1;
+            m_shelf_height = 0;
+        }
+        if (width + 1 > FONT_ATLAS_SIZE || m_shelf_y + height + 1 > FONT_ATLAS_SIZE) {
+            return false;
+        }
+        x = m_shelf_x + 1;
+        y = m_shelf_y + 1;
+        m_shelf_x += width + 1;
+        if (height > m_shelf_height) {
+            m_shelf_height = height;
+        }
+        return true;
+    }
+
+    const MEGlyph *MEFont::GetGlyph(uint32_t codepoint) {
+        auto found = m_glyphs.find(codepoint);
+        if (found != m_glyphs.end()) {
+            return &found->second;
+        }
+        if (m_full) {
+            return nullptr;
+        }
+
+        MEGlyph glyph = {};
+        glyph.index = stbtt_FindGlyphIndex(m_info.get(), static_cast<int>(codepoint));
+        int advance = 0;
+        int left_bearing = 0;
+        stbtt_GetGlyphHMetrics(m_info.get(), glyph.index, &advance, &left_bearing);
+        glyph.advance = static_cast<float>(advance) * m_scale;
+
+        int width = 0;
+        int height = 0;
+        int x_offset = 0;
+        int y_offset = 0;
+        unsigned char *pixels = nullptr;
+        if (m_sdf) {
+            pixels = stbtt_GetGlyphSDF(m_info.get(), m_scale, glyph.index, FONT_SDF_PADDING, FONT_SDF_ON_EDGE,
+                                       FONT_SDF_PIXEL_DISTANCE, &width, &height, &x_offset, &y_offset);
+        } else {
+            pixels = stbtt_GetGlyphBitmap(m_info.get(), m_scale, m_scale, glyph.index, &width, &height, &x_offset,
+                                          &y_offset);
+        }
+
+        if (pixels && width > 0 && height > 0) {
+            int x = 0;
+            int y = 0;
+            if (!Pack(width, height, x, y)) {
+                // the glyphs laid out this frame keep their place, the atlas starts over next frame
+                m_full = true;
+                stbtt_FreeBitmap(pixels, nullptr);
+                return nullptr;
+            }
+            bgfx::updateTexture2D(m_atlas, 0, 0, static_cast<uint16_t>(x), static_cast<uint16_t>(y),
+                                  static_cast<uint16_t>(width), static_cast<uint16_t>(height),
+                                  bgfx::copy(pixels, static_cast<uint32_t>(width * height)));
+            glyph.u0 = static_cast<float>(x) / FONT_ATLAS_SIZE;
+            glyph.v0 = static_cast<float>(y) / FONT_ATLAS_SIZE;
+            glyph.u1 = static_cast<float>(x + width) / FONT_ATLAS_SIZE;
+            glyph.v1 = static_cast<float>(y + height) / FONT_ATLAS_SIZE;
+            glyph.x_offset = static_cast<float>(x_offset);
+            glyph.y_offset = static_cast<float>(y_offset);
+            glyph.width = static_cast<float>(width);
+            glyph.height = static_cast<float>(height);
+            glyph.visible = true;
+        }
+        if (pixels) {
+            // same allocator for both, stbtt_FreeSDF is only a wrapper
+            stbtt_FreeBitmap(pixels, nullptr);
+        }
+
+        return &m_glyphs.emplace(codepoint, glyph).first->second;
+    }
+
+    float MEFont::GetKerning(const MEGlyph &left, const MEGlyph &right) const {
+        return static_cast<float>(stbtt_GetGlyphKernAdvance(m_info.get(), left.index, right.index)) * m_scale;
+    }
+
+    void MEFont::EndFrame() {
+        if (!m_full) {
+            return;
+        }
+        ClearAtlas();
+    }
+
+    uint32_t DecodeUtf8(const char *&text) {
+        auto bytes = reinterpret_cast<const unsigned char *>(text);
+        uint32_t lead = bytes[0];
+        int length = lead < 0x80 ? 1 : (lead >> 5) == 0x6 ? 2 : (lead >> 4) == 0xE ? 3 : (lead >> 3) == 0x1E ? 4 : 0;
+        if (length == 0) {
+            ++text;
+            return 0xFFFD;
+        }
+        uint32_t codepoint = length == 1 ? lead : lead & (0x7F >> length);
+        for (int i = 1; i < length; ++i) {
+            if ((bytes[i] & 0xC0) != 0x80) {
+                // truncated sequence, resume at the byte that broke it
+                text += i;
+                return 0xFFFD;
+            }
+            codepoint = (codepoint << 6) | (bytes[i] & 0x3F);
+        }
+        text += length;
+        return codepoint;
+    }
+}
@@ -0,0 +1,597 @@
+#include "include/image_decoder.h"
+#include "include/mapped_file.h"
+#include "include/trace.h"
+
+#include <algorithm>
+#include <array>
+#include <climits>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <stb_image.h>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define ME_HAS_SSE2
+#endif
+
+namespace MainboardEngine {
+    // pixels QOI decodes before post-processing them, small enough to still be in L1
+    constexpr size_t QOI_CHUNK_PIXELS = 1024;
+    // as the reference decoder, keeps width * height * 4 far from overflowing
+    constexpr size_t QOI_MAX_PIXELS = 400000000;
+    constexpr size_t QOI_HEADER_SIZE = 14;
+    constexpr uint8_t QOI_END_MARKER[8] = {0, 0, 0, 0, 0, 0, 0, 1};
+
+    constexpr uint8_t QOI_OP_INDEX = 0x00;
+    constexpr uint8_t QOI_OP_DIFF = 0x40;
+    constexpr uint8_t QOI_OP_LUMA = 0x80;
+    constexpr uint8_t QOI_OP_RUN = 0xC0;
+    constexpr uint8_t QOI_OP_RGB = 0xFE;
+    constexpr uint8_t QOI_OP_RGBA = 0xFF;
+    constexpr uint8_t QOI_MASK = 0xC0;
+
+    void MEImageDeleter::operator()(uint8_t *pixels) const {
+        std::free(pixels);
+    }
+
+    static void ProcessPixelsScalar(uint8_t *rgba, size_t from, size_t to, uint32_t flags, uint8_t &min_alpha) {
+        for (size_t i = from; i < to; ++i) {
+            uint8_t *p = rgba + i * 4;
+            uint8_t a = p[3];
+            min_alpha = a < min_alpha ? a : min_alpha;
+            if (flags & PIXEL_PREMULTIPLY) {
+                for (int c = 0; c < 3; ++c) {
+                    unsigned t = p[c] * a + 128;
+                    p[c] = static_cast<uint8_t>((t + (t >> 8)) >> 8);
+                }
+            }
+            if (flags & PIXEL_SWIZZLE_BGRA) {
+                uint8_t r = p[0];
+                p[0] = p[2];
+                p[2] = r;
+            }
+        }
+    }
+
+#ifdef ME_HAS_SSE2
+    // x * a / 255 rounded, exact for every 8 bit x and a
+    static __m128i PremultiplyHalf(__m128i rgba16, __m128i alpha_lanes) {
+        __m128i a = _mm_shufflehi_epi16(_mm_shufflelo_epi16(rgba16, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(3, 3, 3, 3));
+        // alpha itself is multiplied by 255, which keeps it
+        a = _mm_or_si128(a, alpha_lanes);
+        __m128i t = _mm_add_epi16(_mm_mullo_epi16(rgba16, a), _mm_set1_epi16(128));
+        return _mm_srli_epi16(_mm_add_epi16(t, _mm_srli_epi16(t, 8)), 8);
+    }
+#endif
+
+    bool ProcessPixels(uint8_t *rgba, size_t pixel_count, uint32_t flags) {
+        size_t i = 0;
+        uint8_t min_alpha = 0xFF;
+#ifdef ME_HAS_SSE2
+        const __m128i zero = _mm_setzero_si128();
+        const __m128i alpha_lanes = _mm_set_epi16(0xFF, 0, 0, 0, 0xFF, 0, 0, 0);
+        const __m128i keep_ga = _mm_set1_epi32(static_cast<int>(0xFF00FF00));
+        const __m128i low_byte = _mm_set1_epi32(0xFF);
+        __m128i all = _mm_set1_epi8(static_cast<char>(0xFF));
+        for (; i + 4 <= pixel_count; i += 4) {
+            __m128i *p = reinterpret_cast<__m128i *>(rgba + i * 4);
+            __m128i v = _mm_loadu_si128(p);
+            all = _mm_and_si128(all, v);
+            if (flags & PIXEL_PREMULTIPLY) {
+                __m128i lo = PremultiplyHalf(_mm_unpacklo_epi8(v, zero), alpha_lanes);
+                __m128i hi = PremultiplyHalf(_mm_unpackhi_epi8(v, zero), alpha_lanes);
+                v = _mm_packus_epi16(lo, hi);
+            }
+            if (flags & PIXEL_SWIZZLE_BGRA) {
+                __m128i r = _mm_slli_epi32(_mm_and_si128(v, low_byte), 16);
+                __m128i b = _mm_and_si128(_mm_srli_epi32(v, 16), low_byte);
+                v = _mm_or_si128(_mm_and_si128(v, keep_ga), _mm_or_si128(r, b));
+            }
+            if (flags) {
+                _mm_storeu_si128(p, v);
+            }
+        }
+        // the alpha bytes of the AND of every pixel are 0xFF only if every alpha was
+        bool opaque = (_mm_movemask_epi8(_mm_cmpeq_epi8(all, _mm_set1_epi8(static_cast<char>(0xFF)))) & 0x8888) ==
+                      0x8888;
+        min_alpha = opaque ? 0xFF : 0;
+#endif
+        ProcessPixelsScalar(rgba, i, pixel_count, flags, min_alpha);
+        return min_alpha != 0xFF;
+    }
+
+    static uint32_t ReadBigEndian(const uint8_t *p) {
+        return static_cast<uint32_t>(p[0]) << 24 | static_cast<uint32_t>(p[1]) << 16 |
+               static_cast<uint32_t>(p[2]) << 8 | p[3];
+    }
+
+    static void WriteBigEndian(std::vector<uint8_t> &out, uint32_t value) {
+        out.push_back(static_cast<uint8_t>(value >> 24));
+        out.push_back(static_cast<uint8_t>(value >> 16));
+        out.push_back(static_cast<uint8_t>(value >> 8));
+        out.push_back(static_cast<uint8_t>(value));
+    }
+
+    static int QoiHash(const uint8_t *px) {
+        return (px[0] * 3 + px[1] * 5 + px[2] * 7 + px[3] * 11) % 64;
+    }
+
+    // stb_image, slower but it reads PNG, JPEG, BMP, TGA and the rest
+    class MEStbDecoder : public MEImageDecoder {
+    public:
+        const char *GetName() const override {
+            return "stb_image";
+        }
+
+        bool CanDecode(const uint8_t *, size_t size) const override {
+            return size > 0 && size <= INT_MAX;
+        }
+
+        bool Decode(const uint8_t *data, size_t size, uint32_t flags, MEDecodedImage &image) const override {
+            image.pixels.reset(stbi_load_from_memory(data, static_cast<int>(size), &image.width, &image.height,
+                                                     &image.channels, 4));
+            if (!image.pixels) {
+                return false;
+            }
+            // stb fills in opaque alpha itself, only a file with alpha needs the scan
+            bool file_alpha = image.channels == 2 || image.channels == 4;
+            image.has_alpha = false;
+            if (file_alpha || (flags & PIXEL_SWIZZLE_BGRA)) {
+                size_t count = static_cast<size_t>(image.width) * image.height;
+                image.has_alpha = ProcessPixels(image.pixels.get(), count, file_alpha ? flags : PIXEL_SWIZZLE_BGRA);
+            }
+            return true;
+        }
+    };
+
+    // QOI, several times faster to decode than PNG at a similar size for block art
+    class MEQoiDecoder : public MEImageDecoder {
+    public:
+        const char *GetName() const override {
+            return "qoi";
+        }
+
+        bool CanDecode(const uint8_t *data, size_t size) const override {
+            return size >= QOI_HEADER_SIZE + sizeof(QOI_END_MARKER) && std::memcmp(data, "qoif", 4) == 0;
+        }
+
+        bool Decode(const uint8_t *data, size_t size, uint32_t flags, MEDecodedImage &image) const override {
+            uint32_t width = ReadBigEndian(data + 4);
+            uint32_t height = ReadBigEndian(data + 8);
+            uint8_t channels = data[12];
+            if (width == 0 || height == 0 || width > INT_MAX || height > INT_MAX ||
+                (channels != 3 && channels != 4) || height >= QOI_MAX_PIXELS / width) {
+                return false;
+            }
+            size_t count = static_cast<size_t>(width) * height;
+            image.pixels.reset(static_cast<uint8_t *>(std::malloc(count * 4)));
+            if (!image.pixels) {
+                return false;
+            }
+            image.width = static_cast<int>(width);
+            image.height = static_cast<int>(height);
+            image.channels = channels;
+            image.has_alpha = false;
+
+            uint8_t index[64][4] = {};
+            uint8_t px[4] = {0, 0, 0, 0xFF};
+            uint8_t *out = image.pixels.get();
+            size_t p = QOI_HEADER_SIZE;
+            size_t end = size - sizeof(QOI_END_MARKER); // every op is read before the end marker
+            int run = 0;
+            size_t chunk_start = 0;
+            for (size_t i = 0; i < count; ++i) {
+                if (run > 0) {
+                    --run;
+                } else {
+                    if (p >= end) {
+                        return false; // truncated
+                    }
+                    uint8_t op = data[p++];
+                    if (op == QOI_OP_RGB || op == QOI_OP_RGBA) {
+                        size_t n = op == QOI_OP_RGB ? 3 : 4;
+                        if (p + n > end) {
+                            return false;
+                        }
+                        std::memcpy(px, data + p, n);
+                        p += n;
+                    } else if ((op & QOI_MASK) == QOI_OP_INDEX) {
+                        std::memcpy(px, index[op], 4);
+                    } else if ((op & QOI_MASK) == QOI_OP_DIFF) {
+                        px[0] = static_cast<uint8_t>(px[0] + ((op >> 4) & 3) - 2);
+                        px[1] = static_cast<uint8_t>(px[1] + ((op >> 2) & 3) - 2);
+                        px[2] = static_cast<uint8_t>(px[2] + (op & 3) - 2);
+                    } else if ((op & QOI_MASK) == QOI_OP_LUMA) {
+                        if (p >= end) {
+                            return false;
+                        }
+                        uint8_t next = data[p++];
+                        int dg = (op & 0x3F) - 32;
+                        px[0] = static_cast<uint8_t>(px[0] + dg - 8 + (next >> 4));
+                        px[1] = static_cast<uint8_t>(px[1] + dg);
+                        px[2] = static_cast<uint8_t>(px[2] + dg - 8 + (next & 0x0F));
+                    } else {
+                        run = op & 0x3F;
+                    }
+                    std::memcpy(index[QoiHash(px)], px, 4);
+                }
+                std::memcpy(out + i * 4, px, 4);
+
+                // post-process what was just written while it is still in cache
+                if (i + 1 - chunk_start == QOI_CHUNK_PIXELS || i + 1 == count) {
+                    image.has_alpha |= ProcessPixels(out + chunk_start * 4, i + 1 - chunk_start, flags);
+                    chunk_start = i + 1;
+                }
+            }
+            return true;
+        }
+    };
+
+    struct MEImageDecoders {
+        std::mutex mutex;
+        std::vector<std::unique_ptr<MEImageDecoder>> owned;
+        std::vector<const MEImageDecoder *> ordered;
+        MEQoiDecoder qoi;
+        MEStbDecoder stb;
+
+        MEImageDecoders() : ordered{&qoi, &stb} {
+        }
+    };
+
+    static MEImageDecoders &GetRegistry() {
+        static MEImageDecoders decoders;
+        return decoders;
+    }
+
+    void RegisterImageDecoder(std::unique_ptr<MEImageDecoder> decoder) {
+        auto &registry = GetRegistry();
+        std::lock_guard<std::mutex> lock(registry.mutex);
+        registry.ordered.insert(registry.ordered.begin() + static_cast<long>(registry.owned.size()), decoder.get());
+        registry.owned.push_back(std::move(decoder));
+    }
+
+    const std::vector<const MEImageDecoder *> &GetImageDecoders() {
+        return GetRegistry().ordered;
+    }
+
+    bool DecodeImage(const uint8_t *data, size_t size, uint32_t flags, MEDecodedImage &image) {
+        auto &registry = GetRegistry();
+        const MEImageDecoder *chosen = nullptr;
+        {
+            std::lock_guard<std::mutex> lock(registry.mutex);
+            for (auto decoder: registry.ordered) {
+                if (decoder->CanDecode(data, size)) {
+                    chosen = decoder;
+                    break;
+                }
+            }
+        }
+        if (!chosen) {
+            return false;
+        }
+        if (!chosen->Decode(data, size, flags, image)) {
+            image.pixels.reset();
+            return false;
+        }
+        return true;
+    }
+
+    bool DecodeImageFile(const std::string &path, uint32_t flags, MEDecodedImage &image) {
+        ME_TRACE_SCOPE("DecodeTexture");
+        // mapped so the decoder reads the file in place, without a copy into a buffer first
+        MEMappedFile file;
+        if (!file.Open(path.c_str())) {
+            return false;
+        }
+        return DecodeImage(file.GetData(), file.GetSize(), flags, image);
+    }
+
+    MEAlphaCoverage AnalyzeAlpha(const uint8_t *rgba, int width, int frame_height, int frame_count) {
+        MEAlphaCoverage coverage = {ALPHA_MIXED, 0, 0, 0, 0};
+        if (!rgba || width <= 0 || frame_height <= 0 || frame_count <= 0) {
+            return coverage;
+        }
+        size_t frame_stride = static_cast<size_t>(width) * frame_height * 4;
+        bool visible = false;
+        // largest rectangle under a histogram per row: heights counts the opaque pixels above and
+        // including the row, the stack keeps the columns of rising heights
+        std::vector<int> heights(width + 1, 0);
+        std::vector<int> stack;
+        stack.reserve(width + 1);
+        int best = 0;
+        for (int y = 0; y < frame_height; ++y) {
+            for (int x = 0; x < width; ++x) {
+                bool opaque = true;
+                for (int frame = 0; frame < frame_count; ++frame) {
+                    uint8_t alpha = rgba[frame * frame_stride + (static_cast<size_t>(y) * width + x) * 4 + 3];
+                    opaque = opaque && alpha == 0xFF;
+                    visible = visible || alpha != 0;
+                }
+                heights[x] = opaque ? heights[x] + 1 : 0;
+            }
+            stack.clear();
+            for (int x = 0; x <= width; ++x) {
+                // heights[width] stays 0 and empties the stack
+                while (!stack.empty() && heights[stack.back()] >= heights[x]) {
+                    int height = heights[stack.back()];
+                    stack.pop_back();
+                    int left = stack.empty() ? 0 : stack.back() + 1;
+                    if (height * (x - left) > best) {
+                        best = height * (x - left);
+                        coverage.left = left;
+                        coverage.right = x;
+                        coverage.top = y + 1 - height;
+                        coverage.bottom = y + 1;
+                    }
+                }
+                stack.push_back(x);
+            }
+        }
+        if (!visible) {
+            coverage.kind = ALPHA_TRANSPARENT;
+        } else if (best == width * frame_height) {
+            coverage.kind = ALPHA_OPAQUE;
+        }
+        return coverage;
+    }
+
+    void EncodeQoi(const uint8_t *rgba, int width, int height, std::vector<uint8_t> &out) {
+        out.clear();
+        out.insert(out.end(), {'q', 'o', 'i', 'f'});
+        WriteBigEndian(out, static_cast<uint32_t>(width));
+        WriteBigEndian(out, static_cast<uint32_t>(height));
+        out.push_back(4);
+        out.push_back(0); // sRGB with linear alpha
+
+        uint8_t index[64][4] = {};
+        uint8_t prev[4] = {0, 0, 0, 0xFF};
+        int run = 0;
+        size_t count = static_cast<size_t>(width) * height;
+        for (size_t i = 0; i < count; ++i) {
+            const uint8_t *px = rgba + i * 4;
+            if (std::memcmp(px, prev, 4) == 0) {
+                ++run;
+                if (run == 62 || i + 1 == count) {
+                    out.push_back(static_cast<uint8_t>(QOI_OP_RUN | (run - 1)));
+                    run = 0;
+                }
+                continue;
+            }
+            if (run > 0) {
+                out.push_back(static_cast<uint8_t>(QOI_OP_RUN | (run - 1)));
+                run = 0;
+            }
+
+            int hash = QoiHash(px);
+            if (std::memcmp(index[hash], px, 4) == 0) {
+                out.push_back(static_cast<uint8_t>(QOI_OP_INDEX | hash));
+            } else {
+                std::memcpy(index[hash], px, 4);
+                if (px[3] != prev[3]) {
+                    out.insert(out.end(), {QOI_OP_RGBA, px[0], px[1], px[2], px[3]});
+                } else {
+                    int dr = static_cast<int8_t>(px[0] - prev[0]);
+                    int dg = static_cast<int8_t>(px[1] - prev[1]);
+                    int db = static_cast<int8_t>(px[2] - prev[2]);
+                    int dr_dg = dr - dg;
+                    int db_dg = db - dg;
+                    if (dr > -3 && dr < 2 && dg > -3 && dg < 2 && db > -3 && db < 2) {
+                        out.push_back(static_cast<uint8_t>(QOI_OP_DIFF | (dr + 2) << 4 | (dg + 2) << 2 | (db + 2)));
+                    } else if (dg > -33 && dg < 32 && dr_dg > -9 && dr_dg < 8 && db_dg > -9 && db_dg < 8) {
+                        out.push_back(static_cast<uint8_t>(QOI_OP_LUMA | (dg + 32)));
+                        out.push_back(static_cast<uint8_t>((dr_dg + 8) << 4 | (db_dg + 8)));
+                    } else {
+                        out.insert(out.end(), {QOI_OP_RGB, px[0], px[1], px[2]});
+                    }
+                }
+            }
+            std::memcpy(prev, px, 4);
+        }
+        out.insert(out.end(), std::begin(QOI_END_MARKER), std::end(QOI_END_MARKER));
+    }
+
+    static const uint16_t DEFLATE_LENGTH_BASE[29] = {
+        3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31, 35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258
+    };
+    static const uint8_t DEFLATE_LENGTH_EXTRA[29] = {
+        0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0
+    };
+    static const uint16_t DEFLATE_DISTANCE_BASE[30] = {
+        1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193, 257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097,
+        6145, 8193, 12289, 16385, 24577
+    };
+    static const uint8_t DEFLATE_DISTANCE_EXTRA[30] = {
+        0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6, 7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13
+    };
+    constexpr size_t DEFLATE_WINDOW = 32768;
+    constexpr size_t DEFLATE_MAX_MATCH = 258;
+    constexpr int DEFLATE_HASH_BITS = 15;
+
+    // deflate bits go least significant first, Huffman codes most significant first
+    class DeflateWriter {
+        std::vector<uint8_t> &m_out;
+        uint32_t m_bits;
+        int m_count;
+
+    public:
+        explicit DeflateWriter(std::vector<uint8_t> &out) : m_out(out), m_bits(0), m_count(0) {
+        }
+
+        void Write(uint32_t value, int count) {
+            m_bits |= value << m_count;
+            m_count += count;
+            while (m_count >= 8) {
+                m_out.push_back(static_cast<uint8_t>(m_bits));
+                m_bits >>= 8;
+                m_count -= 8;
+            }
+        }
+
+        void WriteCode(uint32_t code, int length) {
+            uint32_t reversed = 0;
+            for (int i = 0; i < length; ++i) {
+                reversed = (reversed << 1) | ((code >> i) & 1);
+            }
+            Write(reversed, length);
+        }
+
+        // the fixed literal / length code
+        void WriteSymbol(int symbol) {
+            if (symbol < 144) {
+                WriteCode(0x30 + symbol, 8);
+            } else if (symbol < 256) {
+                WriteCode(0x190 + symbol - 144, 9);
+            } else if (symbol < 280) {
+                WriteCode(symbol - 256, 7);
+            } else {
+                WriteCode(0xC0 + symbol - 280, 8);
+            }
+        }
+
+        void WriteMatch(size_t length, size_t distance) {
+            int code = 28;
+            while (DEFLATE_LENGTH_BASE[code] > length) {
+                --code;
+            }
+            WriteSymbol(257 + code);
+            Write(static_cast<uint32_t>(length - DEFLATE_LENGTH_BASE[code]), DEFLATE_LENGTH_EXTRA[code]);
+            code = 29;
+            while (DEFLATE_DISTANCE_BASE[code] > distance) {
+                --code;
+            }
+            WriteCode(static_cast<uint32_t>(code), 5);
+            Write(static_cast<uint32_t>(distance - DEFLATE_DISTANCE_BASE[code]), DEFLATE_DISTANCE_EXTRA[code]);
+        }
+
+        void Flush() {
+            if (m_count > 0) {
+                m_out.push_back(static_cast<uint8_t>(m_bits));
+            }
+            m_bits = 0;
+            m_count = 0;
+        }
+    };
+
+    static uint32_t HashBytes(const uint8_t *data) {
+        uint32_t value;
+        std::memcpy(&value, data, sizeof(value));
+        return (value * 2654435761u) >> (32 - DEFLATE_HASH_BITS);
+    }
+
+    // zlib stream of one fixed code block. Greedy matching against the last position with the same
+    // 4 bytes, the pixel before and the row above, which is where image data repeats
+    static void Deflate(const uint8_t *data, size_t size, size_t stride, std::vector<uint8_t> &out) {
+        out.push_back(0x78);
+        out.push_back(0x01);
+        DeflateWriter writer(out);
+        writer.Write(1, 1); // last block
+        writer.Write(1, 2); // fixed codes
+
+        std::vector<int64_t> head(static_cast<size_t>(1) << DEFLATE_HASH_BITS, -1);
+        size_t i = 0;
+        while (i < size) {
+            size_t best_length = 0;
+            size_t best_distance = 0;
+            if (i + 4 <= size) {
+                int64_t candidates[3] = {head[HashBytes(data + i)], static_cast<int64_t>(i) - 4,
+                                         static_cast<int64_t>(i) - static_cast<int64_t>(stride)};
+                size_t limit = std::min(DEFLATE_MAX_MATCH, size - i);
+                for (int64_t candidate: candidates) {
+                    if (candidate < 0 || i - static_cast<size_t>(candidate) > DEFLATE_WINDOW) {
+                        continue;
+                    }
+                    const uint8_t *match = data + candidate;
+                    size_t length = 0;
+                    while (length < limit && match[length] == data[i + length]) {
+                        ++length;
+                    }
+                    if (length > best_length) {
+                        best_length = length;
+                        best_distance = i - static_cast<size_t>(candidate);
+                    }
+                }
+            }
+
+            size_t step = 1;
+            if (best_length >= 3) {
+                writer.WriteMatch(best_length, best_distance);
+                step = best_length;
+            } else {
+                writer.WriteSymbol(data[i]);
+            }
+            size_t hash_end = std::min(i + step, size >= 4 ? size - 3 : 0);
+            for (size_t k = i; k < hash_end; ++k) {
+                head[HashBytes(data + k)] = static_cast<int64_t>(k);
+            }
+            i += step;
+        }
+        writer.WriteSymbol(256);
+        writer.Flush();
+
+        // the sums can't overflow for 5552 bytes between the modulos
+        uint32_t a = 1;
+        uint32_t b = 0;
+        for (size_t start = 0; start < size; start += 5552) {
+            size_t end = std::min(size, start + 5552);
+            for (size_t k = start; k < end; ++k) {
+                a += data[k];
+                b += a;
+            }
+            a %= 65521;
+            b %= 65521;
+        }
+        WriteBigEndian(out, (b << 16) | a);
+    }
+
+    static uint32_t Crc32(const uint8_t *data, size_t size) {
+        static const auto table = [] {
+            std::array<uint32_t, 256> values = {};
+            for (uint32_t n = 0; n < 256; ++n) {
+                uint32_t c = n;
+                for (int k = 0; k < 8; ++k) {
+                    c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+                }
+                values[n] = c;
+            }
+            return values;
+        }();
+        uint32_t crc = 0xFFFFFFFFu;
+        for (size_t i = 0; i < size; ++i) {
+            crc = table[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+        }
+        return crc ^ 0xFFFFFFFFu;
+    }
+
+    static void WritePngChunk(std::vector<uint8_t> &out, const char *type, const std::vector<uint8_t> &data) {
+        WriteBigEndian(out, static_cast<uint32_t>(data.size()));
+        size_t start = out.size();
+        out.insert(out.end(), type, type + 4);
+        out.insert(out.end(), data.begin(), data.end());
+        WriteBigEndian(out, Crc32(out.data() + start, out.size() - start));
+    }
+
+    void EncodePng(const uint8_t *rgba, int width, int height, std::vector<uint8_t> &out) {
+        out.clear();
+        out.insert(out.end(), {0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'});
+
+        std::vector<uint8_t> header;
+        WriteBigEndian(header, static_cast<uint32_t>(width));
+        WriteBigEndian(header, static_cast<uint32_t>(height));
+        header.insert(header.end(), {8, 6, 0, 0, 0}); // 8 bit RGBA, no interlace
+        WritePngChunk(out, "IHDR", header);
+
+        // every row unfiltered, the row above is one of the match candidates instead
+        size_t row_size = static_cast<size_t>(width) * 4;
+        std::vector<uint8_t> raw((row_size + 1) * height);
+        for (int y = 0; y < height; ++y) {
+            uint8_t *row = raw.data() + (row_size + 1) * y;
+            row[0] = 0;
+            std::memcpy(row + 1, rgba + row_size * y, row_size);
+        }
+        std::vector<uint8_t> compressed;
+        Deflate(raw.data(), raw.size(), row_size + 1, compressed);
+        WritePngChunk(out, "IDAT", compressed);
+        WritePngChunk(out, "IEND", {});
+    }
+}
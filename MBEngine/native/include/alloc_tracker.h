@@ -0,0 +1,60 @@
+#ifndef MAINBOARD_ENGINE_ALLOC_TRACKER_H
+#define MAINBOARD_ENGINE_ALLOC_TRACKER_H
+
+#include <cstddef>
+
+#include "mainboard_engine.h"
+#include "trace.h"
+
+namespace bx {
+    struct AllocatorI;
+}
+
+namespace MainboardEngine {
+    // Heap accounting, only compiled in with the ME_ALLOC_TRACKING CMake option. Global operator
+    // new / delete of the library count into the subsystem of the innermost ME_ALLOC_SCOPE on
+    // the calling thread, bgfx allocations through its allocator count as ME_ALLOC_BGFX.
+    void CountAllocation(int subsystem, size_t bytes);
+
+    void CountFree(int subsystem);
+
+    int GetAllocSubsystem();
+
+    void SetAllocSubsystem(int subsystem);
+
+    class MEAllocScope {
+        int m_previous;
+
+    public:
+        explicit MEAllocScope(int subsystem) : m_previous(GetAllocSubsystem()) {
+            SetAllocSubsystem(subsystem);
+        }
+
+        ~MEAllocScope() {
+            SetAllocSubsystem(m_previous);
+        }
+
+        MEAllocScope(const MEAllocScope &) = delete;
+
+        MEAllocScope &operator=(const MEAllocScope &) = delete;
+    };
+
+    // closes the current frame, its counts become ME_AllocStats::frame
+    void MarkAllocFrame();
+
+    void GetAllocStats(ME_AllocStats *stats);
+
+    void ResetAllocStats();
+
+    // handed to bgfx::init, it must outlive bgfx
+    bx::AllocatorI *GetTrackedBgfxAllocator();
+}
+
+#ifdef ME_ALLOC_TRACKING
+#define ME_ALLOC_SCOPE(subsystem) \
+    ::MainboardEngine::MEAllocScope ME_TRACE_CONCAT(me_alloc_scope_, __LINE__)(subsystem)
+#else
+#define ME_ALLOC_SCOPE(subsystem) ((void) 0)
+#endif
+
+#endif //MAINBOARD_ENGINE_ALLOC_TRACKER_H
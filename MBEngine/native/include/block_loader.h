@@ -0,0 +1,71 @@
+#ifndef MAINBOARD_ENGINE_BLOCK_LOADER_H
+#define MAINBOARD_ENGINE_BLOCK_LOADER_H
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "image_decoder.h"
+#include "mainboard_engine.h"
+
+namespace MainboardEngine {
+    // RGBA8 pixels of a block image, decoded on a loader thread
+    struct MEDecodedBlock {
+        int id;
+        std::string path;
+        ME_BlockDesc desc;
+        MEDecodedImage image; // of the whole strip, pixels are null when it couldn't be decoded
+    };
+
+    // Decodes block images on worker threads for ME_LoadBlockAsync. bgfx calls stay on the
+    // render thread, which takes the decoded images once per frame and uploads them. The
+    // workers start with the first request, so engines that never load asynchronously don't
+    // pay for them.
+    class MEBlockLoader {
+        struct Request {
+            int id;
+            std::string path;
+            ME_BlockDesc desc;
+        };
+
+        int m_worker_count;
+        std::vector<std::thread> m_workers;
+        mutable std::mutex m_mutex;
+        std::condition_variable m_wake;
+        std::deque<Request> m_requests;
+        std::vector<MEDecodedBlock> m_decoded;
+        uint64_t m_generation; // bumped by Cancel, decodes of an older one are dropped
+        int m_in_flight;
+        bool m_stop;
+
+        void WorkerLoop();
+
+    public:
+        // 0 uses every hardware thread but the caller's, at least one
+        explicit MEBlockLoader(int workers = 0);
+
+        ~MEBlockLoader();
+
+        MEBlockLoader(const MEBlockLoader &) = delete;
+
+        MEBlockLoader &operator=(const MEBlockLoader &) = delete;
+
+        void Submit(int id, const std::string &path, const ME_BlockDesc &desc);
+
+        // appends what was decoded since the last call, in completion order
+        void TakeDecoded(std::vector<MEDecodedBlock> &out);
+
+        // drops the queued requests and the decodes still running
+        void Cancel();
+
+        // queued, decoding or decoded but not taken yet
+        int GetPendingCount() const;
+    };
+}
+
+#endif //MAINBOARD_ENGINE_BLOCK_LOADER_H
@@ -0,0 +1,209 @@
+#ifndef MAINBOARD_ENGINE_CALL_RECORDER_H
+#define MAINBOARD_ENGINE_CALL_RECORDER_H
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+#include "mainboard_engine.h"
+
+namespace MainboardEngine {
+    // .mbrec layout: MERecordHeader, then one record per call, each a MERecordCall followed by
+    // `size` bytes of arguments in declaration order. Scalars and structs are stored as is,
+    // strings and arrays as an int32 length and their elements. Window handles are stored as
+    // the index of the ME_CreateWindow call that returned them, path batches as the index of the
+    // ME_FindPaths call.
+    struct MERecordHeader {
+        char magic[4];
+        uint32_t version;
+    };
+
+#pragma pack(push, 1)
+    struct MERecordCall {
+        uint16_t opcode;
+        uint32_t size;
+        uint32_t delta_us; // since the previous call
+    };
+#pragma pack(pop)
+
+    // values are part of the file format, only append
+    enum MERecordOpcode : uint16_t {
+        RECORD_INITIALIZE = 1,
+        RECORD_CREATE_WINDOW,
+        RECORD_DESTROY_WINDOW,
+        RECORD_PROCESS_EVENTS,
+        RECORD_RENDER_BLOCK,
+        RECORD_RENDER_BLOCKS,
+        RECORD_RENDER_FRAME,
+        RECORD_SET_WINDOW_SIZE,
+        RECORD_SET_WINDOW_TITLE,
+        RECORD_LOAD_BLOCK,
+        RECORD_LOAD_BLOCK_EX,
+        RECORD_CLEAR_BLOCK,
+        RECORD_SET_RENDER_SCALE,
+        RECORD_SET_STATIC_LAYER,
+        RECORD_SET_STATIC_TILE,
+        RECORD_SET_CAMERA,
+        RECORD_OPEN_WORLD,
+        RECORD_CLOSE_WORLD,
+        RECORD_QUERY_POINTS,
+        RECORD_QUERY_AABBS,
+        RECORD_RAYCASTS,
+        RECORD_SET_STATIC_LAYER_MODE,
+        RECORD_CREATE_VIEW,
+        RECORD_UPDATE_VIEW,
+        RECORD_DESTROY_VIEW,
+        RECORD_SET_VIEW_LAYERS,
+        RECORD_LOAD_FONT,
+        RECORD_UNLOAD_FONT,
+        RECORD_DRAW_TEXT,
+        RECORD_CREATE_EMITTER,
+        RECORD_UPDATE_EMITTER,
+        RECORD_DESTROY_EMITTER,
+        RECORD_EMIT_PARTICLES,
+        RECORD_SET_BLOCK_LIGHT,
+        RECORD_SET_LIGHTING,
+        RECORD_BEGIN_FRAME,
+        RECORD_END_FRAME,
+        RECORD_LOAD_BLOCK_ASYNC,
+        RECORD_FIND_PATHS,
+        RECORD_OPEN_MAP,
+        RECORD_SET_TILE,
+        RECORD_FILL_RECT,
+        RECORD_RENDER_BLOCK_EX,
+        RECORD_RENDER_BLOCKS_EX,
+        RECORD_REGISTER_BLOCK_VARIANT,
+        RECORD_SAVE_MAP,
+        RECORD_COMPACT_MAP,
+        RECORD_CLOSE_MAP,
+        RECORD_WAIT_PATHS,
+        RECORD_GET_PATHS,
+        RECORD_RELEASE_PATHS,
+        RECORD_COOK_BLOCK_TEXTURE,
+        RECORD_WRITE_WORLD,
+        RECORD_SET_RENDERER_TYPE,
+        RECORD_RUN_LOOP,
+        RECORD_SAVE_FRAME_PNG,
+        RECORD_QUERY_AABB
+    };
+
+    // set between ME_RecordStart and ME_RecordStop, read at the top of every recorded call
+    extern std::atomic<bool> g_record_enabled;
+
+    struct MERecordString {
+        const char *value;
+    };
+
+    template<typename T>
+    struct MERecordArray {
+        const T *values;
+        int count;
+    };
+
+    struct MERecordHandle {
+        ME_HANDLE value;
+    };
+
+    struct MERecordBatch {
+        int value;
+    };
+
+    bool StartRecording(const char *path);
+
+    bool StopRecording();
+
+    // the window returned by a recorded ME_CreateWindow, later calls refer to it by index
+    void RecordWindow(ME_HANDLE handle);
+
+    void ForgetWindow(ME_HANDLE handle);
+
+    uint8_t *BeginRecord(MERecordOpcode opcode, uint32_t size);
+
+    void EndRecord();
+
+    int GetRecordedWindow(ME_HANDLE handle);
+
+    // the batch returned by a recorded ME_FindPaths, ids are reused once released
+    void RecordPathBatch(int batch);
+
+    void ForgetPathBatch(int batch);
+
+    int GetRecordedPathBatch(int batch);
+
+    // argument serialization, sizes first so a call is written with one reservation
+    template<typename T>
+    uint32_t GetRecordSize(const T &) {
+        static_assert(std::is_trivially_copyable<T>::value, "only plain values can be recorded");
+        return sizeof(T);
+    }
+
+    inline uint32_t GetRecordSize(const MERecordString &value) {
+        return sizeof(int32_t) + (value.value ? static_cast<uint32_t>(std::strlen(value.value)) : 0);
+    }
+
+    template<typename T>
+    uint32_t GetRecordSize(const MERecordArray<T> &value) {
+        return sizeof(int32_t) + (value.values && value.count > 0 ? value.count * sizeof(T) : 0);
+    }
+
+    inline uint32_t GetRecordSize(const MERecordHandle &) {
+        return sizeof(int32_t);
+    }
+
+    inline uint32_t GetRecordSize(const MERecordBatch &) {
+        return sizeof(int32_t);
+    }
+
+    template<typename T>
+    uint8_t *WriteRecordValue(uint8_t *out, const T &value) {
+        std::memcpy(out, &value, sizeof(T));
+        return out + sizeof(T);
+    }
+
+    inline uint8_t *WriteRecordValue(uint8_t *out, const MERecordString &value) {
+        int32_t length = value.value ? static_cast<int32_t>(std::strlen(value.value)) : -1;
+        out = WriteRecordValue(out, length);
+        if (length > 0) {
+            std::memcpy(out, value.value, length);
+            out += length;
+        }
+        return out;
+    }
+
+    template<typename T>
+    uint8_t *WriteRecordValue(uint8_t *out, const MERecordArray<T> &value) {
+        int32_t count = value.values ? value.count : -1;
+        out = WriteRecordValue(out, count);
+        if (count > 0) {
+            std::memcpy(out, value.values, count * sizeof(T));
+            out += count * sizeof(T);
+        }
+        return out;
+    }
+
+    inline uint8_t *WriteRecordValue(uint8_t *out, const MERecordHandle &value) {
+        return WriteRecordValue(out, static_cast<int32_t>(GetRecordedWindow(value.value)));
+    }
+
+    inline uint8_t *WriteRecordValue(uint8_t *out, const MERecordBatch &value) {
+        return WriteRecordValue(out, static_cast<int32_t>(GetRecordedPathBatch(value.value)));
+    }
+
+    template<typename... Args>
+    void RecordCall(MERecordOpcode opcode, const Args &... args) {
+        if (!g_record_enabled.load(std::memory_order_relaxed)) {
+            return;
+        }
+        uint8_t *out = BeginRecord(opcode, (0u + ... + GetRecordSize(args)));
+        if (out) {
+            ((out = WriteRecordValue(out, args)), ...);
+        }
+        EndRecord();
+    }
+
+    // reissues every call of a recording, the calling thread becomes the render thread
+    bool ReplayRecording(const char *path, int flags, ME_ReplayStats *stats);
+}
+
+#endif //MAINBOARD_ENGINE_CALL_RECORDER_H
@@ -0,0 +1,93 @@
+#ifndef MAINBOARD_ENGINE_FONT_CACHE_H
+#define MAINBOARD_ENGINE_FONT_CACHE_H
+
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include <bgfx/bgfx.h>
+
+struct stbtt_fontinfo;
+
+namespace MainboardEngine {
+    // side of the square glyph atlas of every font
+    constexpr int FONT_ATLAS_SIZE = 1024;
+    // empty border around every SDF glyph, the distance field fades out over it
+    constexpr int FONT_SDF_PADDING = 4;
+
+    // a rasterized glyph, sizes in pixels at the font's height
+    struct MEGlyph {
+        int index; // stb_truetype glyph index, for kerning
+        float u0, v0, u1, v1; // in the atlas
+        float x_offset; // from the pen position to the bitmap's top left, y relative to the baseline
+        float y_offset;
+        float width;
+        float height;
+        float advance;
+        bool visible; // false for white space, nothing to draw
+    };
+
+    // TTF font at one pixel height. Glyphs are rasterized on first use, as coverage bitmaps or as
+    // signed distance fields, into an R8 atlas packed in shelves. A full atlas is wiped at the end
+    // of the frame and refilled by the glyphs used afterwards.
+    class MEFont {
+        std::vector<uint8_t> m_data; // the TTF file, stb_truetype reads it in place
+        std::unique_ptr<stbtt_fontinfo> m_info;
+        float m_scale; // font units to pixels
+        float m_ascent;
+        float m_line_height;
+        bool m_sdf;
+        bgfx::TextureHandle m_atlas;
+        std::unordered_map<uint32_t, MEGlyph> m_glyphs;
+        int m_shelf_x;
+        int m_shelf_y;
+        int m_shelf_height;
+        bool m_full;
+
+        MEFont();
+
+        bool Pack(int width, int height, int &x, int &y);
+
+        void ClearAtlas();
+
+    public:
+        ~MEFont();
+
+        MEFont(const MEFont &) = delete;
+
+        MEFont &operator=(const MEFont &) = delete;
+
+        // nullptr when the file can't be read or isn't a font
+        static std::unique_ptr<MEFont> Load(const char *path, float pixel_height, bool sdf);
+
+        // nullptr when the atlas has no room left for it this frame
+        const MEGlyph *GetGlyph(uint32_t codepoint);
+
+        float GetKerning(const MEGlyph &left, const MEGlyph &right) const;
+
+        // baseline below the top of a line
+        float GetAscent() const {
+            return m_ascent;
+        }
+
+        float GetLineHeight() const {
+            return m_line_height;
+        }
+
+        bool IsSdf() const {
+            return m_sdf;
+        }
+
+        bgfx::TextureHandle GetAtlas() const {
+            return m_atlas;
+        }
+
+        void EndFrame();
+    };
+
+    // next code point of a UTF-8 string, advances text past it. Malformed bytes become U+FFFD
+    uint32_t DecodeUtf8(const char *&text);
+}
+
+#endif //MAINBOARD_ENGINE_FONT_CACHE_H
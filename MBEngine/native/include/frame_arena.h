@@ -0,0 +1,186 @@
+#ifndef MAINBOARD_ENGINE_FRAME_ARENA_H
+#define MAINBOARD_ENGINE_FRAME_ARENA_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <type_traits>
+
+namespace MainboardEngine {
+    // Linear allocator for CPU data that only lives until the end of the current frame
+    // (draw lists, sort keys, culling results). Nothing is freed individually, Reset() rewinds it.
+    // When a frame asks for more than the capacity the rest of the frame takes heap blocks, and the
+    // arena grows once at the next Reset(), so nothing is dropped and a steady state frame never
+    // touches the heap. Allocate only fails when the heap does.
+    class MEFrameArena {
+        // heap block of a frame that outgrew the arena, freed at Reset()
+        struct Overflow {
+            Overflow *next;
+        };
+
+        uint8_t *m_buffer;
+        size_t m_capacity;
+        size_t m_offset;
+        size_t m_peak; // bytes the worst frame needed, including what went to overflow blocks
+        size_t m_requested;
+        Overflow *m_overflow;
+        int m_heap_allocations;
+
+    public:
+        explicit MEFrameArena(size_t capacity)
+            : m_buffer(nullptr), m_capacity(0), m_offset(0), m_peak(0), m_requested(0), m_overflow(nullptr),
+              m_heap_allocations(0) {
+            Grow(capacity);
+        }
+
+        ~MEFrameArena() {
+            FreeOverflow();
+            std::free(m_buffer);
+        }
+
+        MEFrameArena(const MEFrameArena &) = delete;
+
+        MEFrameArena &operator=(const MEFrameArena &) = delete;
+
+        void *Allocate(size_t size, size_t align = alignof(std::max_align_t)) {
+            size_t start = (m_offset + align - 1) & ~(align - 1);
+            size_t requested = m_requested + (start - m_offset) + size;
+            if (requested > m_peak) {
+                m_peak = requested;
+            }
+            m_requested = requested;
+            if (!m_buffer || start + size > m_capacity) {
+                return AllocateOverflow(size, align);
+            }
+            m_offset = start + size;
+            return m_buffer + start;
+        }
+
+        template<typename T>
+        T *AllocateArray(size_t count) {
+            static_assert(std::is_trivially_destructible<T>::value, "frame arena never runs destructors");
+            return static_cast<T *>(Allocate(sizeof(T) * count, alignof(T)));
+        }
+
+        void Reset() {
+            FreeOverflow();
+            if (m_peak > m_capacity) {
+                Grow(m_peak * 2);
+            }
+            m_offset = 0;
+            m_requested = 0;
+        }
+
+        size_t GetUsed() const {
+            return m_offset;
+        }
+
+        size_t GetCapacity() const {
+            return m_capacity;
+        }
+
+        size_t GetPeak() const {
+            return m_peak;
+        }
+
+        // number of times the backing buffer was (re)allocated or a frame took an overflow block since
+        // construction
+        int GetHeapAllocations() const {
+            return m_heap_allocations;
+        }
+
+    private:
+        void *AllocateOverflow(size_t size, size_t align) {
+            auto block = static_cast<Overflow *>(std::malloc(sizeof(Overflow) + size + align));
+            if (!block) {
+                return nullptr;
+            }
+            block->next = m_overflow;
+            m_overflow = block;
+            ++m_heap_allocations;
+            auto data = reinterpret_cast<uintptr_t>(block + 1);
+            return reinterpret_cast<void *>((data + align - 1) & ~static_cast<uintptr_t>(align - 1));
+        }
+
+        void FreeOverflow() {
+            while (m_overflow) {
+                Overflow *next = m_overflow->next;
+                std::free(m_overflow);
+                m_overflow = next;
+            }
+        }
+
+        void Grow(size_t capacity) {
+            std::free(m_buffer);
+            m_buffer = static_cast<uint8_t *>(std::malloc(capacity));
+            m_capacity = m_buffer ? capacity : 0;
+            ++m_heap_allocations;
+        }
+    };
+
+    // Growable array living in a MEFrameArena. Growing leaves the old storage behind until the
+    // arena is reset, which is fine for per-frame lists. Must be Clear()ed together with the arena.
+    template<typename T>
+    class MEFrameVector {
+        static_assert(std::is_trivially_copyable<T>::value, "frame vector elements are moved with memcpy");
+
+        MEFrameArena *m_arena;
+        T *m_data;
+        size_t m_size;
+        size_t m_capacity;
+
+    public:
+        explicit MEFrameVector(MEFrameArena *arena)
+            : m_arena(arena), m_data(nullptr), m_size(0), m_capacity(0) {
+        }
+
+        bool Push(const T &value) {
+            if (m_size == m_capacity) {
+                size_t capacity = m_capacity ? m_capacity * 2 : 256;
+                T *data = m_arena->AllocateArray<T>(capacity);
+                if (!data) {
+                    return false;
+                }
+                if (m_size) {
+                    std::memcpy(data, m_data, sizeof(T) * m_size);
+                }
+                m_data = data;
+                m_capacity = capacity;
+            }
+            m_data[m_size++] = value;
+            return true;
+        }
+
+        // drops the elements past size, the storage stays
+        void Truncate(size_t size) {
+            if (size < m_size) {
+                m_size = size;
+            }
+        }
+
+        void Clear() {
+            m_data = nullptr;
+            m_size = 0;
+            m_capacity = 0;
+        }
+
+        T *begin() {
+            return m_data;
+        }
+
+        T *end() {
+            return m_data + m_size;
+        }
+
+        T &operator[](size_t index) {
+            return m_data[index];
+        }
+
+        size_t Size() const {
+            return m_size;
+        }
+    };
+}
+
+#endif //MAINBOARD_ENGINE_FRAME_ARENA_H
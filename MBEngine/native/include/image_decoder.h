@@ -0,0 +1,84 @@
+#ifndef MAINBOARD_ENGINE_IMAGE_DECODER_H
+#define MAINBOARD_ENGINE_IMAGE_DECODER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace MainboardEngine {
+    // applied by ProcessPixels while the decoded pixels are written out
+    constexpr uint32_t PIXEL_PREMULTIPLY = 1; // rgb *= a
+    constexpr uint32_t PIXEL_SWIZZLE_BGRA = 2; // RGBA8 -> BGRA8
+
+    // decoded pixels come from malloc, like stb_image's, so every backend frees them the same way
+    struct MEImageDeleter {
+        void operator()(uint8_t *pixels) const;
+    };
+
+    struct MEDecodedImage {
+        int width;
+        int height;
+        int channels; // in the file, the pixels always have 4
+        bool has_alpha; // some pixel has alpha below 255
+        std::unique_ptr<uint8_t, MEImageDeleter> pixels; // RGBA8 rows, top to bottom
+    };
+
+    // One image format. Decoders are tried in registration order, the first whose CanDecode
+    // accepts the data decodes it, stb_image comes last and takes anything it knows.
+    class MEImageDecoder {
+    public:
+        virtual ~MEImageDecoder() = default;
+
+        virtual const char *GetName() const = 0;
+
+        // from the first bytes of the file
+        virtual bool CanDecode(const uint8_t *data, size_t size) const = 0;
+
+        // RGBA8 into image.pixels, then ProcessPixels with flags over what was written
+        virtual bool Decode(const uint8_t *data, size_t size, uint32_t flags, MEDecodedImage &image) const = 0;
+    };
+
+    // tried before the built in ones, for formats the engine doesn't know
+    // safe while images decode, but not while GetImageDecoders' list is being walked
+    void RegisterImageDecoder(std::unique_ptr<MEImageDecoder> decoder);
+
+    // registered ones, then QOI, then stb_image
+    const std::vector<const MEImageDecoder *> &GetImageDecoders();
+
+    // picks the decoder by the file contents, not the extension
+    bool DecodeImage(const uint8_t *data, size_t size, uint32_t flags, MEDecodedImage &image);
+
+    bool DecodeImageFile(const std::string &path, uint32_t flags, MEDecodedImage &image);
+
+    // PIXEL_* in place over RGBA8 pixels, 4 at a time with SSE2, returns whether any alpha is below 255
+    bool ProcessPixels(uint8_t *rgba, size_t pixel_count, uint32_t flags);
+
+    // how much of what is under an image it hides, MEAlphaCoverage::kind
+    constexpr int ALPHA_MIXED = 0;
+    constexpr int ALPHA_OPAQUE = 1; // every alpha is 255
+    constexpr int ALPHA_TRANSPARENT = 2; // every alpha is 0, drawing it changes nothing
+
+    struct MEAlphaCoverage {
+        int kind; // ALPHA_*
+        // largest rect of pixels opaque in every frame, the whole frame when ALPHA_OPAQUE, empty if none
+        int left;
+        int top;
+        int right;
+        int bottom;
+    };
+
+    // frames are stacked vertically like a block strip, a pixel counts as opaque only when it is in
+    // every one of them since the frame drawn isn't known ahead
+    MEAlphaCoverage AnalyzeAlpha(const uint8_t *rgba, int width, int frame_height, int frame_count);
+
+    // QOI (qoiformat.org) of RGBA8 pixels, for cooking blocks and for benchmarks
+    void EncodeQoi(const uint8_t *rgba, int width, int height, std::vector<uint8_t> &out);
+
+    // PNG of RGBA8 pixels, deflated with the fixed codes only. Fast rather than small, it is meant for
+    // frames and thumbnails, where tiles repeat and matches are long
+    void EncodePng(const uint8_t *rgba, int width, int height, std::vector<uint8_t> &out);
+}
+
+#endif //MAINBOARD_ENGINE_IMAGE_DECODER_H
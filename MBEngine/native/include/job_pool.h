@@ -0,0 +1,74 @@
+#ifndef MAINBOARD_ENGINE_JOB_POOL_H
+#define MAINBOARD_ENGINE_JOB_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace MainboardEngine {
+    // Persistent worker threads for data parallel loops of the render thread. ParallelFor splits
+    // [0, count) into ranges, runs them on the workers and on the calling thread, and returns
+    // once every range is done, so jobs may reference the caller's stack.
+    class MEJobPool {
+        // non-owning reference to the caller's callable, a std::function would heap allocate the
+        // captures of most lambdas on every call
+        struct Job {
+            const void *callable;
+            void (*invoke)(const void *callable, size_t begin, size_t end);
+
+            void operator()(size_t begin, size_t end) const {
+                invoke(callable, begin, end);
+            }
+        };
+
+        std::vector<std::thread> m_workers;
+        std::mutex m_mutex;
+        std::condition_variable m_wake;
+        std::condition_variable m_done;
+        const Job *m_job; // only set during ParallelFor
+        size_t m_count;
+        size_t m_range_size;
+        size_t m_range_count;
+        std::atomic<size_t> m_next_range;
+        uint64_t m_generation;
+        int m_busy; // workers inside the current job
+        bool m_stop;
+
+        void WorkerLoop();
+
+        void RunRanges(const Job &job);
+
+        void Run(size_t count, size_t grain, const Job &job);
+
+    public:
+        // 0 uses every hardware thread but the caller's
+        explicit MEJobPool(int workers = 0);
+
+        ~MEJobPool();
+
+        MEJobPool(const MEJobPool &) = delete;
+
+        MEJobPool &operator=(const MEJobPool &) = delete;
+
+        // workers and the calling thread
+        int GetThreadCount() const {
+            return static_cast<int>(m_workers.size()) + 1;
+        }
+
+        // ranges hold at least `grain` items, a count below it runs inline. `job` is called as
+        // job(begin, end)
+        template<typename Function>
+        void ParallelFor(size_t count, size_t grain, const Function &job) {
+            Job ref = {&job, [](const void *callable, size_t begin, size_t end) {
+                (*static_cast<const Function *>(callable))(begin, end);
+            }};
+            Run(count, grain, ref);
+        }
+    };
+}
+
+#endif //MAINBOARD_ENGINE_JOB_POOL_H
@@ -0,0 +1,80 @@
+#ifndef MAINBOARD_ENGINE_LIGHT_GRID_H
+#define MAINBOARD_ENGINE_LIGHT_GRID_H
+
+#include <cstdint>
+#include <vector>
+
+#include "mainboard_engine.h"
+#include "job_pool.h"
+
+namespace MainboardEngine {
+    // light can't travel further than this many tiles from its source, see ME_LIGHT_MIN_FALLOFF
+    constexpr int LIGHT_RADIUS = ME_LIGHT_MAX / ME_LIGHT_MIN_FALLOFF;
+    // dirty rects are relit in pieces of at most this many tiles per side, one piece per job
+    constexpr int LIGHT_PIECE_SIZE = 64;
+    // more dirty rects than this are merged into their bounding box
+    constexpr size_t MAX_LIGHT_DIRTY_RECTS = 16;
+
+    // Light level of every tile of the static layer. Every tile has an emission and a falloff,
+    // the light lost when entering it, and light spreads from the emitting tiles to the four
+    // neighbours while it lasts. Edits only dirty the tiles their light could reach, and the
+    // dirty rects are flood filled again on the job pool, each piece in its own window that
+    // holds every source able to reach it, so pieces never wait on each other.
+    class MELightGrid {
+        int m_columns;
+        int m_rows;
+        std::vector<uint8_t> m_emission;
+        std::vector<uint8_t> m_falloff; // at least ME_LIGHT_MIN_FALLOFF
+        std::vector<uint8_t> m_light;
+        std::vector<ME_Rect> m_dirty; // in tiles
+        std::vector<ME_Rect> m_pieces;
+        ME_Rect m_changed; // relit since ClearChanged, in tiles
+
+        void Invalidate(const ME_Rect &rect);
+
+        // floods the window around piece and writes the piece's tiles
+        void RelightPiece(const ME_Rect &piece, std::vector<uint8_t> &light, std::vector<uint32_t> &queue);
+
+    public:
+        MELightGrid();
+
+        // every tile becomes empty with the given falloff and is relit on the next Update
+        void Resize(int columns, int rows, int falloff);
+
+        bool IsEnabled() const {
+            return m_columns > 0 && m_rows > 0;
+        }
+
+        void SetTile(int column, int row, int emission, int falloff);
+
+        // relights the dirty tiles, returns how many were relit
+        int Update(MEJobPool &jobs);
+
+        int GetColumns() const {
+            return m_columns;
+        }
+
+        int GetRows() const {
+            return m_rows;
+        }
+
+        int GetLight(int column, int row) const {
+            return m_light[static_cast<size_t>(row) * m_columns + column];
+        }
+
+        const uint8_t *GetLightData() const {
+            return m_light.data();
+        }
+
+        // empty when nothing was relit
+        const ME_Rect &GetChanged() const {
+            return m_changed;
+        }
+
+        void ClearChanged() {
+            m_changed = {0, 0, 0, 0};
+        }
+    };
+}
+
+#endif //MAINBOARD_ENGINE_LIGHT_GRID_H
@@ -25,6 +25,9 @@ extern "C" {
 
 #define ME_MESSAGE_TYPE int
 
+// bumped whenever an exported signature changes, bindings refuse to run against another version
+#define ME_VERSION 1
+
 typedef void *ME_HANDLE;
 
 typedef struct ME_Rect {
@@ -34,16 +37,364 @@ typedef struct ME_Rect {
     int right;
 } ME_Rect;
 
+#define ME_BLOCK_FLAG_NONE 0
+// upload block compressed (BC/ETC2/ASTC, whatever the renderer supports), not bit exact
+#define ME_BLOCK_FLAG_COMPRESS 1
+// generate a mip chain at load, used when blocks are drawn below 1:1 scale
+#define ME_BLOCK_FLAG_MIPMAPS 2
+// tiles of this block are found by ME_QueryAABB and stop ME_Raycast
+#define ME_BLOCK_FLAG_SOLID 4
+
+// how a block is turned when drawn, ME_RenderBlockEx and ME_RegisterBlockVariant. The image is
+// mirrored first, then turned clockwise, quarter turns draw a w x h block as h x w
+#define ME_ORIENT_NONE 0
+#define ME_ORIENT_FLIP_X 1
+#define ME_ORIENT_FLIP_Y 2
+#define ME_ORIENT_ROTATE_90 4
+#define ME_ORIENT_ROTATE_180 8
+#define ME_ORIENT_ROTATE_270 12
+#define ME_ORIENT_MASK 15
+// tints are 0xRRGGBBAA multiplied with the texture, this one leaves it as it is
+#define ME_TINT_NONE 0xFFFFFFFFu
+
+// frames of an animated block are stacked vertically in one image, top to bottom
+typedef struct ME_BlockDesc {
+    int frame_count; // 1 for a static block
+    int frame_duration_ms;
+    int flags; // ME_BLOCK_FLAG_*
+} ME_BlockDesc;
+
+// statistics of the last presented frame
+typedef struct ME_FrameStats {
+    int draw_count; // ME_RenderBlock calls
+    int submit_count; // draw calls actually issued after batching
+    int arena_used; // bytes of per-frame scratch memory
+    int arena_capacity;
+    int arena_heap_allocations; // grows only when a frame outgrew the arena
+    int frame_count; // presented since start
+    int wasted_frames; // presented since start after another one with no ME_ProcessEvents in between
+    int skipped_presents; // ME_RenderFrame inside ME_BeginFrame / ME_EndFrame, ME_EndFrame without ME_BeginFrame
+    int occluded_draws; // skipped, every pixel of them was under an opaque part of a later draw
+    int transparent_draws; // skipped, blocks without a single visible pixel
+} ME_FrameStats;
+
+// where heap allocations are counted, by the C API call (or engine thread) that made them
+#define ME_ALLOC_OTHER 0 // outside any engine call
+#define ME_ALLOC_PLATFORM 1 // windows and events
+#define ME_ALLOC_RENDER 2 // ME_RenderBlock(s) and ME_RenderFrame
+#define ME_ALLOC_RESOURCES 3 // blocks, static layer and worlds being set up
+#define ME_ALLOC_WORLD_STREAM 4 // world chunk decoding thread
+#define ME_ALLOC_QUERIES 5 // spatial queries
+#define ME_ALLOC_BGFX 6 // bgfx, any of its threads
+#define ME_ALLOC_SUBSYSTEM_COUNT 7
+
+typedef struct ME_AllocCounters {
+    long long allocations;
+    long long frees;
+    long long bytes; // requested by the allocations, frees do not subtract
+} ME_AllocCounters;
+
+typedef struct ME_AllocStats {
+    int enabled; // 0 unless the library was built with the ME_ALLOC_TRACKING CMake option
+    long long live_bytes; // held through operator new, bgfx excluded
+    ME_AllocCounters total[ME_ALLOC_SUBSYSTEM_COUNT]; // since ME_ResetAllocStats
+    ME_AllocCounters frame[ME_ALLOC_SUBSYSTEM_COUNT]; // between the last two ME_RenderFrame calls
+} ME_AllocStats;
+
+// chunk residency of the streamed world
+typedef struct ME_WorldStats {
+    int resident_chunks;
+    int requested_chunks; // queued or being decoded
+    int resident_bytes;
+    int budget_bytes;
+    int loaded_total;
+    int evicted_total;
+} ME_WorldStats;
+
+// spatial queries work in static layer pixels, the same space as ME_SetCamera
+typedef struct ME_AABB {
+    int x;
+    int y;
+    int width;
+    int height;
+} ME_AABB;
+
+typedef struct ME_TileCoord {
+    int column;
+    int row;
+} ME_TileCoord;
+
+typedef struct ME_Ray {
+    float x;
+    float y;
+    float dir_x; // need not be normalized
+    float dir_y;
+    float max_distance; // in pixels
+} ME_Ray;
+
+typedef struct ME_RaycastHit {
+    int hit;
+    int column;
+    int row;
+    int block_id;
+    float distance;
+    float x; // where the ray enters the tile
+    float y;
+    int normal_x; // side of the tile that was hit, 0 when the ray starts inside it
+    int normal_y;
+} ME_RaycastHit;
+
+// 8 neighbours, a diagonal step needs both tiles beside it free, 4 neighbours without it
+#define ME_PATH_DIAGONAL 1
+
+#define ME_PATH_PENDING 0 // still being solved
+#define ME_PATH_FOUND 1
+#define ME_PATH_NONE 2 // the goal can't be reached, or max_expanded was hit first
+#define ME_PATH_INVALID 3 // start or goal outside the map or solid
+#define ME_PATH_BLOCKED 4 // found, but a tile on it turned solid since, or the map was replaced
+
+// paths are in tiles of the static layer or world
+typedef struct ME_PathRequest {
+    int start_column;
+    int start_row;
+    int goal_column;
+    int goal_row;
+    int flags; // ME_PATH_DIAGONAL
+    int max_expanded; // tiles the search may expand before giving up, 0 for no limit
+} ME_PathRequest;
+
+typedef struct ME_PathResult {
+    int status; // ME_PATH_*
+    int length; // tiles from start to goal, both included
+    int offset; // of the first tile in the tiles of ME_GetPaths, -1 when they didn't fit
+    int expanded; // tiles the search expanded
+    float cost; // a straight step costs 1, a diagonal one sqrt(2)
+} ME_PathResult;
+
+typedef struct ME_MapStats {
+    int pending_edits; // made since the last ME_SaveMap
+    int journal_records; // saved since the base was last written
+    long long journal_bytes;
+    long long base_bytes;
+    int compactions; // finished since ME_OpenMap
+    int compacting;
+    int compaction_failed; // the last one, its edits stay in the journal
+    double last_save_ms;
+    double last_compaction_ms;
+} ME_MapStats;
+
+// bgfx backend picked by ME_CreateWindow, NOOP runs the whole engine without drawing
+#define ME_RENDERER_AUTO 0
+#define ME_RENDERER_NOOP 1
+#define ME_RENDERER_DIRECT3D11 2
+#define ME_RENDERER_DIRECT3D12 3
+#define ME_RENDERER_OPENGL 4
+#define ME_RENDERER_VULKAN 5
+#define ME_RENDERER_METAL 6
+// Blocks and the static layer rasterized on the CPU into memory, read back with ME_ReadFramePixels /
+// ME_SaveFramePng. Needs no GPU, display or shaders: ME_CreateWindow opens no window, only the size
+// is kept. Views, text, particles and light are not drawn
+#define ME_RENDERER_SOFTWARE 7
+
+// Views: the main view fills the window and follows ME_SetCamera / ME_SetRenderScale. Up to
+// ME_MAX_VIEWS more can be drawn each frame into a rect of the window or into an offscreen texture,
+// each with its own camera, scale and layers. They share the loaded blocks and the static layer,
+// and only draw what falls inside them.
+#define ME_VIEW_MAIN 0
+#define ME_MAX_VIEWS 8
+
+#define ME_VIEW_LAYER_STATIC 1 // the static layer or world
+#define ME_VIEW_LAYER_BLOCKS 2 // ME_RenderBlock draws
+#define ME_VIEW_LAYER_TEXT 4 // ME_DrawText, on top of everything in the window, main view only
+#define ME_VIEW_LAYER_PARTICLES 8 // emitters, over the blocks, main view only
+#define ME_VIEW_LAYER_ALL 15
+
+typedef struct ME_ViewDesc {
+    int x; // rect in window pixels, ignored for offscreen views
+    int y;
+    int width; // size in pixels, of the offscreen texture for offscreen views
+    int height;
+    int camera_x; // top left corner in static layer pixels
+    int camera_y;
+    float scale;
+    int layer_mask; // ME_VIEW_LAYER_*
+    // -1 draws into the window. Otherwise the view renders offscreen, before the main view, into a
+    // texture loaded as this (free) block id, e.g. to draw a minimap with ME_RenderBlock.
+    int target_block_id;
+} ME_ViewDesc;
+
+// fonts are rasterized into a glyph atlas as they are used, every font is one draw call per frame
+#define ME_MAX_FONTS 16
+#define ME_FONT_FLAG_NONE 0
+// signed distance field glyphs, they stay sharp when ME_DrawTextScaled enlarges them
+#define ME_FONT_FLAG_SDF 1
+
+#define ME_MAX_EMITTERS 64
+// live particles of one emitter, spawns past it are dropped
+#define ME_MAX_PARTICLES 1048576
+
+// light levels of ME_SetBlockLight and ME_SetLighting, a tile's light drops by its falloff
+// (the block opacity, or the air falloff for empty tiles) per tile it travels, never by less
+// than ME_LIGHT_MIN_FALLOFF, so light reaches at most ME_LIGHT_MAX / ME_LIGHT_MIN_FALLOFF tiles
+#define ME_LIGHT_MAX 255
+#define ME_LIGHT_MIN_FALLOFF 8
+
+// how the static layer reaches the screen. AUTO uploads the grid as a tile id texture and draws it
+// in one full-screen pass while it qualifies (no world open, render scale >= 1, every placed block
+// uncompressed and exactly tile sized), the offscreen cache is used otherwise. CACHED always does.
+#define ME_STATIC_LAYER_AUTO 0
+#define ME_STATIC_LAYER_CACHED 1
+
+// ME_Replay waits between calls as long as the recorded session did, instead of going flat out
+#define ME_REPLAY_REALTIME 1
+
+// particles live in the same pixel space as ME_RenderBlock and are simulated by ME_RenderFrame
+typedef struct ME_EmitterDesc {
+    float x; // center of the spawn area
+    float y;
+    float width; // spawn area, 0 for a point
+    float height;
+    float rate; // particles per second, 0 to only spawn through ME_EmitParticles
+    float lifetime_min; // seconds
+    float lifetime_max;
+    float speed_min; // pixels per second
+    float speed_max;
+    float direction; // degrees, 0 = +x, 90 = +y (down)
+    float spread; // degrees, spawn directions are spread evenly around direction
+    float gravity_x; // pixels per second squared
+    float gravity_y;
+    float drag; // fraction of the velocity lost per second
+    float size_start; // pixels, faded over the lifetime like the color
+    float size_end;
+    unsigned int color_start; // 0xRRGGBBAA, multiplied with the texture
+    unsigned int color_end;
+    int block_id; // first frame of this block is the particle texture, -1 for plain squares
+} ME_EmitterDesc;
+
+typedef struct ME_ParticleStats {
+    int emitter_count;
+    int live_count;
+    int spawned_count; // in the last frame
+    int thread_count; // that ran the last update
+    double update_ms;
+} ME_ParticleStats;
+
+typedef struct ME_LightStats {
+    int enabled;
+    int relit_tiles; // in the last frame, 0 when no edit touched the light
+    int thread_count; // of the job pool that relights
+    double update_ms;
+} ME_LightStats;
+
+// milliseconds since ME_Initialize
+typedef struct ME_StartupStats {
+    double window_ms; // ME_CreateWindow returned with the renderer up
+    double first_frame_ms; // first present, 0 before it
+    double loaded_ms; // first present with no ME_LoadBlockAsync pending, 0 before it
+    int pending_blocks;
+    int async_blocks; // loaded by ME_LoadBlockAsync
+    int failed_blocks; // ME_LoadBlockAsync images that couldn't be decoded or split into frames
+} ME_StartupStats;
+
+typedef struct ME_ReplayStats {
+    int call_count;
+    int frame_count; // ME_RenderFrame calls
+    double recorded_ms; // length of the recorded session
+    double elapsed_ms; // length of the replay
+    double max_frame_ms; // longest time between two ME_RenderFrame calls
+} ME_ReplayStats;
+
+// callbacks of ME_RunLoop, user_data is ME_LoopDesc.user_data
+typedef void (*ME_TickCallback)(double dt, void *user_data);
+typedef void (*ME_FrameCallback)(double alpha, void *user_data);
+
+typedef struct ME_LoopDesc {
+    double tick_rate; // fixed simulation ticks per second
+    int max_ticks_per_frame; // time for more ticks than this is dropped, the game slows down instead of stalling
+    double frame_rate; // frames per second cap, 0 to present as fast as vsync allows
+    ME_TickCallback update; // once per tick with dt = 1 / tick_rate, may be null
+    ME_FrameCallback render; // once per frame before ME_RenderFrame, may be null
+    void *user_data;
+} ME_LoopDesc;
+
+typedef struct ME_LoopStats {
+    long long tick_count;
+    long long frame_count;
+    long long dropped_ticks; // clamped by max_ticks_per_frame
+    double alpha; // of the last frame, fraction of a tick since the last update
+    double sleep_ms; // total time spent waiting for deadlines
+} ME_LoopStats;
+
+ME_API int ME_GetVersion();
+
 ME_API ME_BOOL ME_Initialize();
 
 ME_API ME_HANDLE ME_CreateWindow(int is_full_screen, int x, int y, int width, int height, const char *title);
 
 ME_API ME_MESSAGE_TYPE ME_ProcessEvents(ME_HANDLE handle);
 
+// blocks are drawn in call order, later ones on top. Consecutive draws of one texture go out as one
+// batch, so drawing blocks grouped by id is faster than interleaving them
 ME_API ME_BOOL ME_RenderBlock(int block_id, int x, int y);
 
+// one crossing for a whole list of blocks, returns how many were accepted. -1 for a negative count
+// or a NULL array
+ME_API int ME_RenderBlocks(const int *block_ids, const int *xs, const int *ys, int count);
+
+// ME_RenderBlock with a tint and an ME_ORIENT_* orientation, applied on top of the block's own when it
+// is a variant. Consecutive draws of one texture still batch whatever their tint and orientation
+ME_API ME_BOOL ME_RenderBlockEx(int block_id, int x, int y, unsigned int tint, int orientation);
+
+// tints or orientations may be NULL for ME_TINT_NONE / ME_ORIENT_NONE on every block, the other arrays
+// may not. -1 for a negative count or a missing array
+ME_API int ME_RenderBlocksEx(const int *block_ids, const int *xs, const int *ys, const unsigned int *tints,
+                             const int *orientations, int count);
+
 ME_API int ME_RenderFrame(ME_HANDLE handle);
 
+// Explicit frames: everything drawn between the two is presented once by ME_EndFrame.
+// ME_RenderFrame inside an open frame and ME_EndFrame without one present nothing and are
+// counted in ME_FrameStats.skipped_presents. ME_BeginFrame fails when a frame is already open
+ME_API ME_BOOL ME_BeginFrame(ME_HANDLE handle);
+
+// bgfx frame number like ME_RenderFrame
+ME_API int ME_EndFrame(ME_HANDLE handle);
+
+// Runs ME_ProcessEvents, the ticks that are due, the render callback and ME_RenderFrame until the
+// window closes or ME_StopLoop is called, then returns the last message (ME_QUIT_MESSAGE when
+// closed). render gets alpha in [0, 1) to interpolate between the last two ticks. Sleeps until
+// the next frame when frame_rate is set. -1 for an invalid desc or a failed frame
+ME_API ME_MESSAGE_TYPE ME_RunLoop(ME_HANDLE handle, const ME_LoopDesc *desc);
+
+// ME_RunLoop returns after the current frame, callable from its callbacks
+ME_API ME_BOOL ME_StopLoop();
+
+ME_API ME_BOOL ME_GetLoopStats(ME_LoopStats *stats);
+
+ME_API ME_BOOL ME_GetFrameStats(ME_FrameStats *stats);
+
+// ME_RENDERER_SOFTWARE: the last rendered frame as RGBA8 rows, top row first. capacity is in bytes,
+// false when rgba is NULL or too small, width and height are set anyway to size the buffer. Also false
+// when the frame is missing draws because the heap ran out while it was built
+ME_API ME_BOOL ME_ReadFramePixels(unsigned char *rgba, int capacity, int *width, int *height);
+
+// ME_RENDERER_SOFTWARE: the last rendered frame as a PNG file, false when it is missing draws as above
+ME_API ME_BOOL ME_SaveFramePng(const char *path);
+
+// heap allocation counts, all zero (and enabled 0) in builds without ME_ALLOC_TRACKING
+ME_API ME_BOOL ME_GetAllocStats(ME_AllocStats *stats);
+
+ME_API ME_BOOL ME_ResetAllocStats();
+
+// zoom of the whole map, block positions and sizes are multiplied by it
+ME_API ME_BOOL ME_SetRenderScale(float scale);
+
+// records engine spans on every thread until ME_TraceStop, which writes them as Chrome trace-event JSON
+ME_API ME_BOOL ME_TraceStart();
+
+// path may be NULL to drop the recorded events
+ME_API ME_BOOL ME_TraceStop(const char *path);
+
 ME_API ME_BOOL ME_ClearView(ME_HANDLE handle);
 
 ME_API ME_BOOL ME_DestroyWindow(ME_HANDLE handle);
@@ -58,8 +409,179 @@ ME_API ME_BOOL ME_SetWindowTitle(ME_HANDLE handle, const char *title);
 
 ME_API ME_BOOL ME_LoadBlock(int id, const char *path);
 
+ME_API ME_BOOL ME_LoadBlockEx(int id, const char *path, const ME_BlockDesc *desc);
+
+// Decodes on a worker thread and uploads at the start of a later ME_RenderFrame, desc may be
+// null. Until then the id draws nothing and static tiles using it show the background.
+// ME_BLOCK_FLAG_COMPRESS blocks load synchronously, their cache is read without decoding
+ME_API ME_BOOL ME_LoadBlockAsync(int id, const char *path, const ME_BlockDesc *desc);
+
+ME_API ME_BOOL ME_GetStartupStats(ME_StartupStats *stats);
+
+// Makes id a tinted / turned copy of base_id that shares its texture, so recolored and rotated tiles
+// cost no memory or load time. It is a block like any other: static tiles, worlds and map files
+// store it by id. It is solid when the base is, its light is its own like for any id. base_id must be
+// a loaded or ME_LoadBlockAsync queued block that isn't a variant itself, the variant shows up with it.
+// ME_ClearBlock drops variants with the blocks
+ME_API ME_BOOL ME_RegisterBlockVariant(int id, int base_id, unsigned int tint, int orientation);
+
+// format is one of "BC1", "BC3", "BC7", "ETC2", "ETC2A", "ASTC4x4", flags may contain ME_BLOCK_FLAG_MIPMAPS
+ME_API ME_BOOL ME_CookBlockTexture(const char *path, const char *format, int flags);
+
 ME_API ME_BOOL ME_ClearBlock();
 
+// Static layer: a grid of tiles rendered once into an offscreen cache and drawn below every
+// ME_RenderBlock with a single quad. Only tiles that change or scroll into view are redrawn.
+// Replaces any previous grid, all tiles start empty.
+ME_API ME_BOOL ME_SetStaticLayer(int tile_width, int tile_height, int columns, int rows);
+
+// block_id -1 empties the tile, the block must be loaded already, queued by ME_LoadBlockAsync or a
+// variant of one
+ME_API ME_BOOL ME_SetStaticTile(int column, int row, int block_id);
+
+// ME_STATIC_LAYER_*
+ME_API ME_BOOL ME_SetStaticLayerMode(int mode);
+
+// top left corner of the screen in static layer pixels, ME_RenderBlock positions stay in screen pixels
+ME_API ME_BOOL ME_SetCamera(int x, int y);
+
+// pixel_height is the size ME_DrawText draws at, font_id < ME_MAX_FONTS replaces any font loaded there
+ME_API ME_BOOL ME_LoadFont(int font_id, const char *ttf_path, float pixel_height, int flags);
+
+ME_API ME_BOOL ME_UnloadFont(int font_id);
+
+// x, y is the top left of the first line in window pixels, '\n' starts a new line.
+// color is 0xRRGGBBAA, text is drawn for the current frame only like ME_RenderBlock
+ME_API ME_BOOL ME_DrawText(int font_id, int x, int y, const char *utf8, unsigned int color);
+
+ME_API ME_BOOL ME_DrawTextScaled(int font_id, int x, int y, float scale, const char *utf8, unsigned int color);
+
+// returns the emitter id, -1 when all ME_MAX_EMITTERS are in use or the desc is invalid
+ME_API int ME_CreateEmitter(const ME_EmitterDesc *desc);
+
+// live particles keep their state, only new ones see the changes except for gravity, drag, sizes and colors
+ME_API ME_BOOL ME_UpdateEmitter(int emitter, const ME_EmitterDesc *desc);
+
+// its live particles vanish with it, set the rate to 0 first to let them fade out
+ME_API ME_BOOL ME_DestroyEmitter(int emitter);
+
+// burst of count particles spawned around x, y instead of the emitter position, e.g. block break dust
+ME_API ME_BOOL ME_EmitParticles(int emitter, float x, float y, int count);
+
+ME_API ME_BOOL ME_GetParticleStats(ME_ParticleStats *stats);
+
+// emission and opacity are 0 to ME_LIGHT_MAX, every id starts dark with an opacity of 0, which
+// means the air falloff. Kept across ME_ClearBlock, they belong to the id and not to its texture
+ME_API ME_BOOL ME_SetBlockLight(int block_id, int emission, int opacity);
+
+// lights the static layer and the blocks over it. ambient is the least light anything gets,
+// air_falloff the light lost per empty tile. The first call lights the whole layer in one go
+ME_API ME_BOOL ME_SetLighting(ME_BOOL enabled, int ambient, int air_falloff);
+
+// 0 to ME_LIGHT_MAX as of the last ME_RenderFrame, -1 outside the layer or with lighting off
+ME_API int ME_GetLight(int column, int row);
+
+ME_API ME_BOOL ME_GetLightStats(ME_LightStats *stats);
+
+// returns the new view id, -1 when the description is invalid or all views are in use.
+// ME_RenderBlock positions are relative to the main camera, other views show them where they are
+// on the static layer.
+ME_API int ME_CreateView(const ME_ViewDesc *desc);
+
+ME_API ME_BOOL ME_UpdateView(int view, const ME_ViewDesc *desc);
+
+// the target block of an offscreen view is unloaded with it
+ME_API ME_BOOL ME_DestroyView(int view);
+
+// works on ME_VIEW_MAIN too, mask is ME_VIEW_LAYER_*
+ME_API ME_BOOL ME_SetViewLayers(int view, int layer_mask);
+
+// Writes a .mbworld file of columns * rows block ids (-1 empty) split into 32x32 tile chunks
+ME_API ME_BOOL ME_WriteWorld(const char *path, int tile_width, int tile_height, int columns, int rows,
+                             const short *tiles);
+
+// Streams a .mbworld file onto the static layer. The file is memory mapped and chunks around the
+// camera are decoded on a background thread, tiles of chunks not loaded yet show
+// placeholder_block_id (-1 for the clear color). Decoded chunks are kept under memory_budget_kb.
+ME_API ME_BOOL ME_OpenWorld(const char *path, int placeholder_block_id, int memory_budget_kb);
+
+// the static layer is empty afterwards
+ME_API ME_BOOL ME_CloseWorld();
+
+ME_API ME_BOOL ME_GetWorldStats(ME_WorldStats *stats);
+
+// block id of the static layer tile under a pixel, -1 for an empty tile, outside the layer or an
+// unloaded world chunk
+ME_API int ME_QueryPoint(int x, int y);
+
+// fills block_ids[i] for every point, returns count. -1 for a negative count or a NULL array
+ME_API int ME_QueryPoints(const int *xs, const int *ys, int count, int *block_ids);
+
+// solid tiles overlapped by the box, up to capacity are written to tiles (may be NULL),
+// returns how many there are in total
+ME_API int ME_QueryAABB(const ME_AABB *box, ME_TileCoord *tiles, int capacity);
+
+// solid_counts[i] is the number of solid tiles under boxes[i], returns how many boxes touch any.
+// -1 for a negative count or a NULL array
+ME_API int ME_QueryAABBs(const ME_AABB *boxes, int count, int *solid_counts);
+
+// first solid tile along the ray
+ME_API ME_BOOL ME_Raycast(const ME_Ray *ray, ME_RaycastHit *hit);
+
+// one hit per ray, returns how many rays hit something. -1 for a negative count or a NULL array
+ME_API int ME_Raycasts(const ME_Ray *rays, int count, ME_RaycastHit *hits);
+
+// solve paths around the solid tiles on worker threads, unloaded world chunks are walkable.
+// The tiles are taken as they are at the call, returns a batch id or -1
+ME_API int ME_FindPaths(const ME_PathRequest *requests, int count);
+
+// wait until every path of the batch is solved
+ME_API ME_BOOL ME_WaitPaths(int batch);
+
+// results[i] for requests[i], the tiles of found and blocked paths are written back to back, up to
+// capacity. Returns how many tiles they take in total, -1 for an unknown batch
+ME_API int ME_GetPaths(int batch, ME_PathResult *results, ME_TileCoord *tiles, int capacity);
+
+// forget a batch, paths still being solved are dropped
+ME_API ME_BOOL ME_ReleasePaths(int batch);
+
+// Maps: a .mbworld base file at path plus path.journal, the tile edits saved since the base was
+// written. Opens the map at path onto the static layer, or saves the static layer as a new map
+// there when path doesn't exist. Tiles of blocks not loaded keep their id and show once the block
+// is. Fails while a world is open, ME_SetStaticLayer and ME_OpenWorld close the map.
+ME_API ME_BOOL ME_OpenMap(const char *path);
+
+// ME_SetStaticTile that is saved with the open map
+ME_API ME_BOOL ME_SetTile(int column, int row, int block_id);
+
+// sets every tile of the rect, clipped to the map, one journal record however large it is
+ME_API ME_BOOL ME_FillRect(int column, int row, int width, int height, int block_id);
+
+// Appends the edits made since the last save to the journal, so it takes time in proportion to
+// them. Once the journal outgrows the base, the map is rewritten as a new base on a background thread.
+ME_API ME_BOOL ME_SaveMap();
+
+// save and start rewriting the base in the background now, after a compaction still running
+ME_API ME_BOOL ME_CompactMap();
+
+// saves and waits for a running compaction, the tiles stay on the static layer
+ME_API ME_BOOL ME_CloseMap();
+
+ME_API ME_BOOL ME_GetMapStats(ME_MapStats *stats);
+
+// takes effect for windows created afterwards. ME_RENDERER_SOFTWARE chosen before ME_Initialize skips the
+// native window system, so it initializes on machines without a display
+ME_API ME_BOOL ME_SetRendererType(int type);
+
+// log every call that changes or drives the engine, with its arguments and timing, into a binary file
+ME_API ME_BOOL ME_RecordStart(const char *path);
+
+ME_API ME_BOOL ME_RecordStop();
+
+// issue the calls of a recording again, windows are created and destroyed as recorded.
+// Paths in the recording are used as is, run it from the directory the session ran in.
+ME_API ME_BOOL ME_Replay(const char *path, int flags, ME_ReplayStats *stats);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,122 @@
+#ifndef MAINBOARD_ENGINE_MAP_JOURNAL_H
+#define MAINBOARD_ENGINE_MAP_JOURNAL_H
+
+#include <atomic>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "mainboard_engine.h"
+#include "world_stream.h"
+
+namespace MainboardEngine {
+    // <map>.journal layout: header, then records as they were saved. A record is an op byte and
+    // its fields, packed: SET_TILE int16 id, uint32 column, row, FILL_RECT adds uint32 width, height.
+    struct MEJournalHeader {
+        char magic[4];
+        uint32_t version;
+        uint32_t columns; // of the base map, a journal of another size is refused
+        uint32_t rows;
+    };
+
+    constexpr uint8_t JOURNAL_SET_TILE = 1;
+    constexpr uint8_t JOURNAL_FILL_RECT = 2;
+    constexpr size_t JOURNAL_SET_TILE_SIZE = 11;
+    constexpr size_t JOURNAL_FILL_RECT_SIZE = 19;
+    // journals are folded into the base once they outgrow it, never below this
+    constexpr uint64_t JOURNAL_COMPACT_BYTES = 64 * 1024;
+
+    // A map on disk as a .mbworld base plus <map>.journal, the tile edits saved since the base was
+    // written. Save appends the edits made since the last one, so it costs what was edited rather
+    // than the map size. Compact moves the journal aside to <map>.journal.old and a worker thread
+    // writes the tiles as they are now as the new base, saves keep going to a fresh journal
+    // meanwhile. Loading applies base, .old and journal in that order, replaying a record on tiles
+    // that already have it changes nothing, so a crash at any point loses only unsaved edits.
+    class MEMapJournal {
+        std::string m_path;
+        MEWorldHeader m_header; // of the base
+        std::ofstream m_journal;
+        std::vector<uint8_t> m_pending; // records since the last Save
+        int m_pending_edits;
+        uint64_t m_journal_bytes; // records only, the header isn't counted
+        int m_journal_records;
+        int m_compactions;
+        double m_last_save_ms;
+
+        uint64_t m_base_bytes;
+        bool m_compact_failed;
+        double m_last_compaction_ms;
+
+        struct CompactionResult {
+            bool ok;
+            double ms;
+            uint64_t base_bytes;
+        };
+
+        // the compaction thread only writes m_result, taken over once it is joined
+        std::thread m_compactor;
+        std::atomic<bool> m_compacting;
+        CompactionResult m_result;
+
+        bool CreateJournal();
+
+        // moves the journal to .old, merged behind the records already there when a compaction failed
+        bool RotateJournal();
+
+        void CompactLoop(std::vector<int16_t> tiles);
+
+        void FinishCompaction();
+
+        // takes the result of a compaction that is done without waiting for a running one
+        void ReapCompaction();
+
+        void AddRecord(const uint8_t *record, size_t size);
+
+    public:
+        MEMapJournal();
+
+        ~MEMapJournal();
+
+        MEMapJournal(const MEMapJournal &) = delete;
+
+        MEMapJournal &operator=(const MEMapJournal &) = delete;
+
+        // reads the map at path into tiles (columns * rows ids, see GetHeader), journals included
+        bool Open(const char *path, std::vector<int16_t> &tiles);
+
+        // writes tiles as the base of a new map at path, any journal left there is dropped
+        bool Create(const char *path, int tile_width, int tile_height, int columns, int rows, const int16_t *tiles);
+
+        // saves, then waits for a running compaction
+        void Close();
+
+        bool IsOpen() const {
+            return m_journal.is_open();
+        }
+
+        // the edit must already be clipped to the map
+        void SetTile(int column, int row, int id);
+
+        void FillRect(int column, int row, int width, int height, int id);
+
+        bool Save();
+
+        // the journal outgrew the base and no compaction is running
+        bool NeedsCompaction() const;
+
+        // tiles are the whole map with every journaled edit applied, false while one is running
+        bool Compact(std::vector<int16_t> tiles);
+
+        void WaitCompaction();
+
+        const MEWorldHeader &GetHeader() const {
+            return m_header;
+        }
+
+        void GetStats(ME_MapStats *stats);
+    };
+}
+
+#endif //MAINBOARD_ENGINE_MAP_JOURNAL_H
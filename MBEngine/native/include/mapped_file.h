@@ -0,0 +1,43 @@
+#ifndef MAINBOARD_ENGINE_MAPPED_FILE_H
+#define MAINBOARD_ENGINE_MAPPED_FILE_H
+
+#include <cstddef>
+#include <cstdint>
+
+namespace MainboardEngine {
+    // Read-only view of a whole file. Pages are read by the OS on first access, so whoever
+    // touches the data pays for the I/O, keep it off the render thread.
+    class MEMappedFile {
+        const uint8_t *m_data;
+        size_t m_size;
+#ifdef _WIN32
+        void *m_file;
+        void *m_mapping;
+#else
+        int m_file;
+#endif
+
+    public:
+        MEMappedFile();
+
+        ~MEMappedFile();
+
+        MEMappedFile(const MEMappedFile &) = delete;
+
+        MEMappedFile &operator=(const MEMappedFile &) = delete;
+
+        bool Open(const char *path);
+
+        void Close();
+
+        const uint8_t *GetData() const {
+            return m_data;
+        }
+
+        size_t GetSize() const {
+            return m_size;
+        }
+    };
+}
+
+#endif //MAINBOARD_ENGINE_MAPPED_FILE_H
@@ -0,0 +1,41 @@
+#ifndef MAINBOARD_ENGINE_OCCLUSION_CULLER_H
+#define MAINBOARD_ENGINE_OCCLUSION_CULLER_H
+
+#include <vector>
+
+#include "mainboard_engine.h"
+
+namespace MainboardEngine {
+    // pixels per side of the buckets occluders are kept in
+    constexpr int OCCLUSION_CELL_SIZE = 64;
+
+    // Finds draws that end up entirely under the opaque part of a later draw. Draws are fed from
+    // the last one drawn to the first: IsHidden tests one against the occluders of the draws after
+    // it, AddOccluder then adds its own opaque rect. A draw is only hidden by a single occluder
+    // that contains it, which must contain its top left corner, so one bucket is searched.
+    class MEOcclusionCuller {
+        struct Occluder {
+            ME_Rect rect;
+            int next; // in the same cell, -1 ends the list
+        };
+
+        ME_Rect m_bounds;
+        int m_columns;
+        int m_rows;
+        std::vector<int> m_cells; // first occluder per cell, -1 when none
+        std::vector<Occluder> m_occluders;
+
+    public:
+        MEOcclusionCuller();
+
+        // forgets the occluders, rects are in the space of bounds, nothing outside it is tested
+        void Reset(const ME_Rect &bounds);
+
+        bool IsHidden(const ME_Rect &rect) const;
+
+        // empty rects are ignored
+        void AddOccluder(const ME_Rect &rect);
+    };
+}
+
+#endif //MAINBOARD_ENGINE_OCCLUSION_CULLER_H
@@ -0,0 +1,103 @@
+#ifndef MAINBOARD_ENGINE_PARTICLE_SYSTEM_H
+#define MAINBOARD_ENGINE_PARTICLE_SYSTEM_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "mainboard_engine.h"
+#include "job_pool.h"
+
+namespace MainboardEngine {
+    // pools are updated in chunks of this many particles, one chunk per job
+    constexpr size_t PARTICLE_CHUNK_SIZE = 16384;
+
+    // one particle quad of vs_particle, in target pixels
+    struct ParticleInstance {
+        float x, y; // top left
+        float width, height;
+        float r, g, b, a;
+    };
+
+    // The particles of one emitter as a struct of arrays, so the update kernel runs four
+    // particles per instruction and the per-emitter parameters stay in registers. Age runs from
+    // 0 to 1 over the lifetime, a particle dies when it reaches 1 and the live ones are packed
+    // to the front in their spawn order.
+    class MEEmitter {
+        ME_EmitterDesc m_desc;
+        float m_color_start[4];
+        float m_color_end[4];
+        std::vector<float> m_x;
+        std::vector<float> m_y;
+        std::vector<float> m_vx;
+        std::vector<float> m_vy;
+        std::vector<float> m_age;
+        std::vector<float> m_rate; // age per second, 1 / lifetime
+        std::vector<size_t> m_chunk_live;
+        size_t m_count;
+        float m_spawn_debt; // fraction of a particle carried over to the next frame
+        uint32_t m_random;
+
+        float Random();
+
+        // integrates [begin, end) and packs its live particles to begin, returns how many there are
+        size_t UpdateRange(size_t begin, size_t end, float dt);
+
+        void MoveRange(size_t from, size_t to, size_t count);
+
+    public:
+        MEEmitter(const ME_EmitterDesc &desc, uint32_t seed);
+
+        static bool IsValidDesc(const ME_EmitterDesc &desc);
+
+        void SetDesc(const ME_EmitterDesc &desc);
+
+        const ME_EmitterDesc &GetDesc() const {
+            return m_desc;
+        }
+
+        size_t Size() const {
+            return m_count;
+        }
+
+        // returns how many fit under ME_MAX_PARTICLES
+        int Spawn(float x, float y, int count);
+
+        // spawns by rate, integrates and drops the dead, returns how many were spawned
+        int Update(float dt, MEJobPool &jobs);
+
+        // quads of [begin, end) centered on the particles, scaled into target pixels
+        void WriteInstances(ParticleInstance *out, size_t begin, size_t end, float scale) const;
+    };
+
+    class MEParticleSystem {
+        std::unique_ptr<MEEmitter> m_emitters[ME_MAX_EMITTERS];
+        ME_ParticleStats m_stats;
+        uint32_t m_seed;
+
+    public:
+        MEParticleSystem();
+
+        int CreateEmitter(const ME_EmitterDesc &desc);
+
+        bool UpdateEmitter(int emitter, const ME_EmitterDesc &desc);
+
+        bool DestroyEmitter(int emitter);
+
+        bool Emit(int emitter, float x, float y, int count);
+
+        void Update(float dt, MEJobPool &jobs);
+
+        // nullptr for a free id
+        const MEEmitter *GetEmitter(int emitter) const {
+            return emitter >= 0 && emitter < ME_MAX_EMITTERS ? m_emitters[emitter].get() : nullptr;
+        }
+
+        void GetStats(ME_ParticleStats *stats) const {
+            *stats = m_stats;
+        }
+    };
+}
+
+#endif //MAINBOARD_ENGINE_PARTICLE_SYSTEM_H
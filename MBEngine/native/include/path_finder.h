@@ -0,0 +1,198 @@
+#ifndef MAINBOARD_ENGINE_PATH_FINDER_H
+#define MAINBOARD_ENGINE_PATH_FINDER_H
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "mainboard_engine.h"
+
+namespace MainboardEngine {
+    // tiles per side of a region, the unit solved paths are invalidated in
+    constexpr int NAV_REGION_SIZE = 16;
+
+    // Walkability of every tile, one bit each, with a solid border around the grid so searches
+    // never bounds check. Turning a tile solid bumps the version of its region, a path only has to
+    // look at its tiles in regions whose version moved since it was solved.
+    class MENavGrid {
+        int m_columns;
+        int m_rows;
+        int m_stride; // words per row, border included
+        int m_regions_x;
+        std::vector<uint64_t> m_walkable;
+        std::vector<uint32_t> m_region_versions;
+        uint64_t m_solid_edits; // tiles turned solid so far
+        uint64_t m_layout; // bumped by Resize, paths solved on another layout are stale
+
+    public:
+        MENavGrid();
+
+        // every tile becomes walkable
+        void Resize(int columns, int rows);
+
+        // every tile becomes walkable, paths stay valid
+        void Clear();
+
+        // returns whether the tile changed
+        bool SetSolid(int column, int row, bool solid);
+
+        bool Contains(int column, int row) const {
+            return column >= 0 && row >= 0 && column < m_columns && row < m_rows;
+        }
+
+        // one tile past the edges is the border and solid, further out must not be asked
+        bool IsWalkable(int column, int row) const {
+            int x = column + 1;
+            return (m_walkable[static_cast<size_t>(row + 1) * m_stride + (x >> 6)] >> (x & 63)) & 1;
+        }
+
+        int GetColumns() const {
+            return m_columns;
+        }
+
+        int GetRows() const {
+            return m_rows;
+        }
+
+        uint32_t GetRegionVersion(int column, int row) const {
+            return m_region_versions[(row / NAV_REGION_SIZE) * m_regions_x + column / NAV_REGION_SIZE];
+        }
+
+        uint64_t GetSolidEdits() const {
+            return m_solid_edits;
+        }
+
+        uint64_t GetLayout() const {
+            return m_layout;
+        }
+    };
+
+    struct MEPath {
+        int status; // ME_PATH_*
+        int expanded;
+        float cost;
+        std::vector<ME_TileCoord> tiles; // start to goal
+        uint64_t checked_edits; // solid edits of the live grid when the path was last checked
+        bool solved;
+    };
+
+    // Search scratch of one thread, kept between searches so a warm thread doesn't allocate. Nodes
+    // are hashed by tile, the memory follows the tiles a search visits rather than the grid size,
+    // which matters for worlds. ME_PATH_DIAGONAL searches jump point search, which only puts the
+    // tiles where the path may turn on the open list, 4-neighbour searches are plain A*.
+    class MEPathSearch {
+        struct Node {
+            uint32_t tile;
+            uint32_t parent; // node index, the start is its own parent
+            float g;
+            bool closed;
+        };
+
+        struct Slot {
+            uint32_t search;
+            uint32_t node;
+        };
+
+        struct OpenEntry {
+            float f;
+            uint32_t node;
+
+            bool operator<(const OpenEntry &other) const {
+                return f > other.f; // std heaps are max heaps
+            }
+        };
+
+        const MENavGrid *m_grid;
+        int m_goal_column;
+        int m_goal_row;
+        bool m_diagonal;
+        uint32_t m_search; // tells the table slots of this search from older ones
+        std::vector<Slot> m_table; // size a power of two
+        std::vector<Node> m_nodes;
+        std::vector<OpenEntry> m_open;
+        std::vector<uint32_t> m_chain;
+
+        uint32_t GetNode(int column, int row);
+
+        void Relax(int column, int row, uint32_t parent, float g);
+
+        float Heuristic(int column, int row) const;
+
+        // walk from column, row in a straight line until a jump point, the goal or a wall
+        bool JumpStraight(int &column, int &row, int dx, int dy) const;
+
+        bool JumpDiagonal(int &column, int &row, int dx, int dy) const;
+
+        void ExpandJumps(uint32_t node, int column, int row);
+
+        void BuildPath(uint32_t goal, MEPath &path);
+
+    public:
+        MEPathSearch();
+
+        // fills path with the result of request, grid must stay unchanged until it returns
+        void Find(const MENavGrid &grid, const ME_PathRequest &request, MEPath &path);
+    };
+
+    // Solves ME_FindPaths batches on worker threads. Tile edits go to the live grid on the calling
+    // thread, batches are solved on an immutable copy taken when they are submitted, shared by
+    // every batch until the next edit. The workers start with the first batch.
+    class MEPathFinder {
+        struct Batch {
+            std::shared_ptr<const MENavGrid> grid;
+            std::vector<ME_PathRequest> requests;
+            std::vector<MEPath> paths;
+            size_t next; // first request no worker took yet
+            size_t remaining;
+        };
+
+        MENavGrid m_grid;
+        std::shared_ptr<const MENavGrid> m_snapshot; // null after an edit
+        int m_worker_count;
+        std::vector<std::thread> m_workers;
+        std::mutex m_mutex;
+        std::condition_variable m_wake;
+        std::condition_variable m_solved;
+        std::deque<std::shared_ptr<Batch>> m_queue;
+        std::vector<std::shared_ptr<Batch>> m_batches; // by id, null for free ids
+        bool m_stop;
+
+        void WorkerLoop();
+
+        // marks path ME_PATH_BLOCKED once a tile on it turned solid
+        void CheckPath(const Batch &batch, MEPath &path) const;
+
+    public:
+        // 0 uses every hardware thread but the caller's, at least one
+        explicit MEPathFinder(int workers = 0);
+
+        ~MEPathFinder();
+
+        MEPathFinder(const MEPathFinder &) = delete;
+
+        MEPathFinder &operator=(const MEPathFinder &) = delete;
+
+        // every tile becomes walkable and every solved path stale
+        void Resize(int columns, int rows);
+
+        void Clear();
+
+        void SetSolid(int column, int row, bool solid);
+
+        // returns the batch id
+        int Submit(const ME_PathRequest *requests, int count);
+
+        bool Wait(int batch);
+
+        // see ME_GetPaths, -1 for an unknown batch
+        int GetResults(int batch, ME_PathResult *results, ME_TileCoord *tiles, int capacity);
+
+        bool Release(int batch);
+    };
+}
+
+#endif //MAINBOARD_ENGINE_PATH_FINDER_H
@@ -5,6 +5,7 @@
 #include <string>
 #include <vector>
 #include <optional>
+#include <chrono>
 #include "mainboard_engine.h"
 
 #include <bgfx/bgfx.h>
@@ -13,20 +14,138 @@
 #include <stb_image.h>
 
 #include "platform.h"
+#include "frame_arena.h"
+#include "texture_loader.h"
+#include "static_layer.h"
+#include "world_stream.h"
+#include "spatial_index.h"
+#include "font_cache.h"
+#include "job_pool.h"
+#include "particle_system.h"
+#include "light_grid.h"
+#include "block_loader.h"
+#include "path_finder.h"
+#include "map_journal.h"
+#include "soft_renderer.h"
+#include "image_decoder.h"
+#include "occlusion_culler.h"
 
 // TODO using factory method, make it determined by java side
 constexpr int BLOCK_ARRAY_SIZE = 1024;
+// initial size of the per-frame scratch memory, grows if a frame needs more
+constexpr size_t FRAME_ARENA_SIZE = 1024 * 1024;
+// 16 bit indices, 4 vertices per quad
+constexpr size_t MAX_BATCH_QUADS = 65536 / 4;
+// block batches and instance data of glyphs and particles, 32 bytes per particle
+constexpr uint32_t TRANSIENT_VERTEX_BUFFER_SIZE = 16 * 1024 * 1024;
+// longest step of the particle simulation, a hitch must not fling particles across the screen
+constexpr float MAX_PARTICLE_STEP = 0.1f;
+// longest common animation loop, the float time stays exact to the millisecond below it
+constexpr int64_t MAX_ANIMATION_PERIOD_MS = int64_t{1} << 23;
+constexpr uint32_t CLEAR_COLOR = 0x443355FF;
+
+// bgfx runs views in id order, offscreen passes must come before the window
+constexpr bgfx::ViewId VIEW_STATIC_COPY = 0;
+constexpr bgfx::ViewId VIEW_STATIC_FILL = 1;
+// offscreen ME_CreateView targets, before the window so it can sample them in the same frame
+constexpr bgfx::ViewId VIEW_OFFSCREEN_FIRST = 2;
+constexpr bgfx::ViewId VIEW_MAIN = VIEW_OFFSCREEN_FIRST + ME_MAX_VIEWS;
+// ME_CreateView rects of the window, drawn over the main view
+constexpr bgfx::ViewId VIEW_WINDOW_FIRST = VIEW_MAIN + 1;
+// ME_DrawText, over every view of the window
+constexpr bgfx::ViewId VIEW_HUD = VIEW_WINDOW_FIRST + ME_MAX_VIEWS;
+
+// sort key layers, the static layer is composited before any of them
+constexpr int LAYER_STATIC_LIVE = 0;
+constexpr int LAYER_BLOCKS = 1;
 
 namespace MainboardEngine {
     class MEWindow;
 
     struct Block {
         int id;
-        std::optional<std::string> type;
         std::optional<bgfx::TextureHandle> texture;
         int width;
-        int height;
+        int height; // height of a single frame
         int channels;
+        int frame_count;
+        int frame_duration_ms;
+        bool solid; // ME_BLOCK_FLAG_SOLID
+        bool compressed; // texture is not RGBA8, it can't be copied into the tile map array
+        bool view_target; // rendered by an offscreen view, which owns the texture
+        int variant_of = -1; // ME_RegisterBlockVariant, the block whose texture this one shares
+        uint32_t tint = ME_TINT_NONE; // of the variant, 0xRRGGBBAA
+        int orientation = ME_ORIENT_NONE; // of the variant
+        // of the decoded alpha, before the variant's tint and orientation. Unknown blocks are mixed
+        // with nothing opaque, so they are drawn and hide nothing
+        MEAlphaCoverage coverage = {ALPHA_MIXED, 0, 0, 0, 0};
+    };
+
+    // ME_RegisterBlockVariant, kept so a variant of a block still loading is added with it
+    struct BlockVariant {
+        int base_id;
+        uint32_t tint;
+        int orientation;
+    };
+
+    struct PosTexCoord {
+        float x, y, z;
+        float u, v;
+        uint32_t abgr; // fs_tiled multiplies the texture with it
+    };
+
+    // one RenderBlock call, kept until the end of the frame in the frame arena
+    struct DrawCommand {
+        uint64_t sort_key;
+        int id;
+        int x;
+        int y;
+        uint32_t tint = ME_TINT_NONE; // 0xRRGGBBAA
+        int orientation = ME_ORIENT_NONE;
+    };
+
+    // view a batch is submitted to, where it is and how blocks are scaled into it
+    struct RenderTarget {
+        bgfx::ViewId view;
+        uint16_t x; // of the view rect, only scissors need it
+        uint16_t y;
+        uint16_t width;
+        uint16_t height;
+        float scale;
+        float lod;
+        bool flip_y; // an offscreen texture sampled as a block on a bottom-left origin renderer
+    };
+
+    // frame buffer and rect last given to a view by SetViewTarget
+    struct ViewState {
+        bool valid;
+        uint16_t frame_buffer; // handle index, UINT16_MAX for the back buffer
+        uint16_t width;
+        uint16_t height;
+    };
+
+    // one glyph quad of ME_DrawText, in window pixels
+    struct TextGlyph {
+        uint64_t sort_key; // font, then the order it was drawn in
+        int font;
+        float x0, y0, x1, y1;
+        float u0, v0, u1, v1;
+        uint32_t color; // 0xRRGGBBAA
+    };
+
+    // one ME_CreateView viewport
+    struct View {
+        ME_ViewDesc desc;
+        bgfx::ViewId id;
+        bgfx::FrameBufferHandle target; // offscreen views only, its texture is block desc.target_block_id
+    };
+
+    // corners in target pixels, uv as fs_tiled expects it
+    struct TexturedQuad {
+        float x0, y0, x1, y1;
+        float u0, v0, u1, v1; // of the unturned texture
+        uint32_t abgr = 0xFFFFFFFF;
+        int orientation = ME_ORIENT_NONE; // the texture is turned inside the quad, x0..x1 is its width once turned
     };
 
     //     struct Command {
@@ -72,6 +191,41 @@ namespace MainboardEngine {
         virtual void *GetMEWindowHandle() = 0;
     };
 
+    // ME_RENDERER_SOFTWARE window, a size and nothing on screen, so frames render where there is no display
+    class MEHeadlessWindow : public MEWindow {
+        int m_width;
+        int m_height;
+
+    public:
+        MEHeadlessWindow(int width, int height) : m_width(width), m_height(height) {
+        }
+
+        bool SetSize(int width, int height) override;
+
+        ME_Rect GetSize() override;
+
+        bool SetPosition(int x, int y) override;
+
+        bool SetTitle(const char *title) override;
+
+        // null, there is no native window to hand to bgfx
+        void *GetMEWindowHandle() override;
+    };
+
+    // platform of ME_RENDERER_SOFTWARE, hands out MEHeadlessWindow so no display or window system is needed
+    class MEHeadlessPlatform : public MEPlatform {
+    public:
+        bool Initialize() override;
+
+        void Shutdown() override;
+
+        bool CreateWindow(int is_full_screen, int x, int y, int width, int height, const char *title,
+                          MEWindow *&window) override;
+
+        // nothing can send a headless window events
+        ME_MESSAGE_TYPE ProcessEvents(ME_HANDLE handle) override;
+    };
+
     class MEEngine {
         MEWindow *m_window;
         std::optional<Block> m_blocks[BLOCK_ARRAY_SIZE];
@@ -81,9 +235,288 @@ namespace MainboardEngine {
         bgfx::ShaderHandle m_fsh;
         bgfx::UniformHandle m_s_tex;
         bgfx::UniformHandle m_u_resolution;
+        bgfx::UniformHandle m_u_animation;
+        bgfx::UniformHandle m_u_sampling;
         bgfx::ProgramHandle m_program;
+        std::chrono::steady_clock::time_point m_start_time;
+        float m_animation_time; // sampled once per frame in Render
+        int64_t m_animation_period_ms; // every loaded animation loops a whole number of times in it
+        bgfx::VertexLayout m_layout;
+        uint16_t m_screen_width;
+        uint16_t m_screen_height;
+        float m_scale;
+        float m_texture_lod;
+
+        MEFrameArena m_arena;
+        MEFrameVector<DrawCommand> m_draws;
+        MEFrameVector<TextGlyph> m_text;
+        size_t m_arena_used;
+        int m_frame_draws;
+        int m_frame_submits;
+        int m_frame_occluded;
+        int m_frame_transparent;
+        MEOcclusionCuller m_occlusion; // reused by every view
+
+        // ME_BeginFrame / ME_EndFrame, presents outside the open frame are skipped
+        bool m_frame_open;
+        int m_last_frame; // bgfx frame number of the last present
+        int m_frame_count;
+        int m_presents_since_events; // more than one between two ME_ProcessEvents is a wasted frame
+        int m_wasted_frames;
+        int m_skipped_presents;
+        ViewState m_view_states[VIEW_HUD + 1]; // as last set, bgfx keeps it across frames
+
+        // ME_LoadBlockAsync, pending ids have no block yet and their tiles show the background
+        MEBlockLoader m_loader;
+        bool m_block_pending[BLOCK_ARRAY_SIZE];
+        std::optional<BlockVariant> m_variants[BLOCK_ARRAY_SIZE];
+        std::vector<MEDecodedBlock> m_decoded_blocks; // reused every frame
+        ME_StartupStats m_startup;
+
+        // static layer cache, two targets so scrolling can copy one into the other
+        MEStaticLayer m_static_layer;
+        bgfx::FrameBufferHandle m_static_cache[2];
+        int m_static_current;
+        uint16_t m_static_width;
+        uint16_t m_static_height;
+        float m_static_scale;
+        Block m_background_block; // 1x1 of CLEAR_COLOR, fills empty parts of the cache
+        int m_camera_x;
+        int m_camera_y;
+        std::unique_ptr<MEWorldStream> m_world; // feeds the static layer when a world is open
+        int m_world_placeholder;
+        MESpatialIndex m_spatial;
+        bool m_spatial_dirty; // block solidity changed, rebuilt before the next query
+        MEPathFinder m_paths; // walkability mirrors m_spatial
+        MEMapJournal m_map; // on disk copy of the static layer while a map is open
+
+        // tile lighting, only allocated while ME_SetLighting has it on
+        MELightGrid m_light;
+        bool m_lighting;
+        bool m_light_tiles_dirty; // emission / falloff of the tiles are refreshed before the next relight
+        int m_light_ambient;
+        int m_air_falloff;
+        uint8_t m_block_emission[BLOCK_ARRAY_SIZE];
+        uint8_t m_block_opacity[BLOCK_ARRAY_SIZE];
+        ME_LightStats m_light_stats;
+        bgfx::TextureHandle m_light_texture; // R8, one texel per tile
+        bgfx::ProgramHandle m_light_program; // invalid without fs_light
+        bgfx::UniformHandle m_u_light;
+
+        // tile map path of the static layer: block ids in an R16 texture, block frames in a 2D
+        // array, one full-screen draw of fs_tilemap looks up and samples the tile of every pixel
+        int m_static_mode; // ME_STATIC_LAYER_*
+        bool m_tilemap_active; // drawn this frame instead of the cache
+        bool m_tilemap_blocks_dirty; // the array no longer matches the loaded blocks
+        int m_tilemap_foreign; // placed tiles whose block is not in the array, the path is off while any
+        ME_Rect m_tilemap_dirty; // in tiles, uploaded to the id texture before the next draw
+        int m_tilemap_layers[BLOCK_ARRAY_SIZE]; // first array layer of each block, -1 when not in it
+        bgfx::TextureHandle m_tilemap_ids;
+        bgfx::TextureHandle m_tilemap_blocks;
+        bgfx::TextureHandle m_tilemap_table; // per block id: first layer, frame count, frame duration
+        bgfx::ProgramHandle m_tilemap_program; // invalid when fs_tilemap is not shipped
+        bgfx::UniformHandle m_s_tile_ids;
+        bgfx::UniformHandle m_s_tile_blocks;
+        bgfx::UniformHandle m_s_tile_table;
+        bgfx::UniformHandle m_u_tilemap;
+        bgfx::UniformHandle m_u_tilemap_grid;
+        bool m_tilemap_ready; // prepared this frame, other views may use it at any scale
+
+        std::optional<View> m_views[ME_MAX_VIEWS]; // view id - 1
+        int m_main_layers; // ME_VIEW_LAYER_* of the main view
+
+        std::unique_ptr<MEFont> m_fonts[ME_MAX_FONTS];
+        bgfx::ProgramHandle m_text_program; // invalid without instancing or the text shaders
+        bgfx::VertexBufferHandle m_instance_vbh; // unit quad, every glyph and particle is an instance of it
+
+        MEJobPool m_jobs;
+        MEParticleSystem m_particles;
+        std::chrono::steady_clock::time_point m_last_update;
+        bgfx::ProgramHandle m_particle_program; // invalid without instancing or the particle shaders
+        bgfx::UniformHandle m_u_particle;
+        bgfx::TextureHandle m_white_texture; // of emitters without a block
+        bgfx::UniformHandle m_u_text;
+
+        // ME_RENDERER_SOFTWARE, blocks are rasterized into memory and bgfx runs its no-op renderer
+        std::unique_ptr<MESoftRenderer> m_soft;
+        // false when the last software frame lost draws, it is not read back or saved
+        bool m_soft_complete = true;
+
+        uint64_t MakeSortKey(int layer, int id, uint32_t sequence) const;
+
+        // block whose texture the id draws with, a variant's base
+        int GetTextureBlock(int id) const;
+
+        static float GetTextureLod(float scale);
+
+        RenderTarget GetMainTarget() const;
+
+        RenderTarget GetViewTarget(const View &view) const;
+
+        void SetBlockUniforms(const Block *block, const RenderTarget &target, float scale, float lod);
+
+        void SubmitBlock(const RenderTarget &target, const DrawCommand &command);
+
+        bool SubmitBatch(const RenderTarget &target, const DrawCommand *commands, uint32_t count);
+
+        bool SubmitQuads(const RenderTarget &target, const Block *block, const TexturedQuad *quads, uint32_t count,
+                         float scale, float lod);
+
+        // commands must be sorted, runs of the same block become one batch
+        void SubmitSorted(const RenderTarget &target, DrawCommand *commands, size_t count);
+
+        void FlushDraws();
+
+        // FlushDraws of the software renderer: the static layer, then the sorted block draws
+        void RenderSoftware();
+
+        MESoftDraw MakeSoftDraw(int id, int x, int y, uint32_t tint, int orientation) const;
+
+        // recorded draws of the given layers that overlap the target once moved by (shift_x, shift_y),
+        // in draw order, without the transparent ones and those under opaque later ones. False when the
+        // frame arena ran out
+        bool CullDraws(const RenderTarget &target, int shift_x, int shift_y, int layers,
+                       MEFrameVector<DrawCommand> &visible);
+
+        // the draw is of one of the ME_VIEW_LAYER_* layers and the target may sample its block
+        bool IsDrawInLayers(const DrawCommand &command, const RenderTarget &target, int layers) const;
+
+        // CullDraws fallback when the heap is out of memory too: every recorded draw of the layers,
+        // unculled, moved in place and back so it needs no memory
+        void SubmitUnculled(const RenderTarget &target, int shift_x, int shift_y, int layers);
+
+        // nothing of the block shows, ALPHA_TRANSPARENT or tinted fully transparent
+        bool IsTransparentDraw(int id, uint32_t tint) const;
+
+        // for draws fed last to first after m_occlusion.Reset: true when the draw is transparent or
+        // under the opaque part of a later one, otherwise its own opaque part becomes an occluder
+        bool IsOccluded(int id, uint32_t tint, int orientation, int x, int y);
+
+        // the static layer tiles under a camera, drawn directly instead of through the cache
+        void DrawStaticTiles(const RenderTarget &target, int camera_x, int camera_y);
+
+        void RenderView(const View &view);
+
+        bool SetView(int index, const ME_ViewDesc &desc);
+
+        void ReleaseViewTarget(View &view);
+
+        // frame buffer and rect of a view, only passed to bgfx when they differ from the last ones
+        void SetViewTarget(bgfx::ViewId view, bgfx::FrameBufferHandle frame_buffer, uint16_t width, uint16_t height);
+
+        // one instanced draw per font
+        void FlushText();
+
+        // one instanced draw per emitter
+        void FlushParticles(const RenderTarget &target);
+
+        void CreateStaticCache();
+
+        void DestroyStaticCache();
+
+        Block GetStaticCacheBlock(int index) const;
+
+        // texture v of a cache row, render targets are stored upside down on some renderers
+        static float GetCacheV(float y, uint16_t height);
+
+        // block id at a static layer tile, -1 for nothing
+        int GetStaticTile(int column, int row) const;
+
+        bool IsSolidBlock(int id) const;
+
+        // in the spatial index and the path finder's grid
+        void SetTileSolid(int column, int row, bool solid);
+
+        void SetChunkSolids(int index, bool resident);
+
+        void UpdateSpatialIndex();
+
+        void SetTileLight(int column, int row, int id);
+
+        void SetChunkLight(int index, bool resident);
+
+        void RefreshLightTiles();
+
+        void UpdateLight();
+
+        void UploadLight();
+
+        // multiplies what the target holds by the light of the tiles under it
+        void DrawLight(const RenderTarget &target, int camera_x, int camera_y);
+
+        void UpdateStaticLayer();
+
+        void CopyStaticCache(int shift_x, int shift_y);
+
+        void DrawStaticDirtyRects();
+
+        void CompositeStaticLayer();
+
+        bool IsTilemapBlock(int id) const;
+
+        // a loaded block that is not in the tile map array
+        bool IsTilemapForeign(int id) const;
+
+        // the id texture is recreated and the array rebuilt before the next tile map frame
+        void InvalidateTilemap();
+
+        // the layer qualifies for the tile map path on this renderer
+        bool CanUseTilemap() const;
+
+        // brings the array and the id texture up to date, false when the cache has to be used
+        bool PrepareTilemap();
+
+        void RebuildTilemapBlocks();
+
+        void UploadTilemapIds();
+
+        void DrawTilemap(const RenderTarget &target, int camera_x, int camera_y);
+
+        static uint64_t GetBlockSamplerFlags(bool mips);
+
+        static bgfx::TextureHandle CreateBlockTexture(const METextureData &texture);
+
+        static bgfx::TextureHandle LoadCompressedBlockTexture(Block &block, const std::string &path, bool mips);
+
+        // free id and a valid desc
+        bool CanLoadBlock(int id, const ME_BlockDesc &desc) const;
+
+        // uploads a decoded image as block id, false when it doesn't split into the frames, takes the
+        // pixels when they can be uploaded as they are
+        bool AddDecodedBlock(int id, const std::string &path, const ME_BlockDesc &desc, MEDecodedImage &image);
+
+        bool AddBlock(int id, const ME_BlockDesc &desc, Block &block, bgfx::TextureHandle texture);
+
+        // stores the block and refreshes what may already use its id
+        void PlaceBlock(const Block &block);
+
+        // the registered variant id, its base must be loaded
+        void AddVariant(int id);
+
+        // uploads the blocks decoded since the last frame
+        void FinishBlockLoads();
 
     public:
+        MEEngine() : m_arena(FRAME_ARENA_SIZE), m_draws(&m_arena), m_text(&m_arena), m_arena_used(0), m_frame_draws(0),
+                     m_frame_submits(0), m_frame_occluded(0), m_frame_transparent(0), m_frame_open(false),
+                     m_last_frame(0), m_frame_count(0),
+                     m_presents_since_events(0), m_wasted_frames(0), m_skipped_presents(0), m_view_states{},
+                     m_block_pending{}, m_startup{},
+                     m_static_cache{BGFX_INVALID_HANDLE, BGFX_INVALID_HANDLE}, m_static_current(0),
+                     m_static_width(0), m_static_height(0), m_static_scale(1.0f), m_background_block(),
+                     m_camera_x(0), m_camera_y(0), m_world_placeholder(-1),
+                     m_spatial_dirty(false), m_lighting(false), m_light_tiles_dirty(false), m_light_ambient(0),
+                     m_air_falloff(ME_LIGHT_MIN_FALLOFF), m_block_emission{}, m_block_opacity{}, m_light_stats{},
+                     m_light_texture BGFX_INVALID_HANDLE, m_light_program BGFX_INVALID_HANDLE,
+                     m_static_mode(ME_STATIC_LAYER_AUTO), m_tilemap_active(false),
+                     m_tilemap_blocks_dirty(true), m_tilemap_foreign(0), m_tilemap_dirty{0, 0, 0, 0},
+                     m_tilemap_ids BGFX_INVALID_HANDLE, m_tilemap_blocks BGFX_INVALID_HANDLE,
+                     m_tilemap_table BGFX_INVALID_HANDLE, m_tilemap_program BGFX_INVALID_HANDLE,
+                     m_tilemap_ready(false), m_main_layers(ME_VIEW_LAYER_ALL),
+                     m_text_program BGFX_INVALID_HANDLE, m_instance_vbh BGFX_INVALID_HANDLE,
+                     m_particle_program BGFX_INVALID_HANDLE, m_white_texture BGFX_INVALID_HANDLE {
+        }
+
         virtual ~MEEngine() = default;
 
         static bool Start(MEWindow *window);
@@ -92,14 +525,133 @@ namespace MainboardEngine {
 
         static bool RegistryBlock(int id, std::string path);
 
-        bool RenderBlock(int id, int x, int y);
+        static bool RegistryBlock(int id, std::string path, ME_BlockDesc desc);
+
+        bool LoadBlockAsync(int id, const std::string &path, const ME_BlockDesc &desc);
+
+        void GetStartupStats(ME_StartupStats *stats) const;
+
+        // writes the compressed cache RegistryBlock picks up for ME_BLOCK_FLAG_COMPRESS blocks,
+        // works without a window so textures can be cooked at build time
+        static bool CookBlockTexture(const std::string &path, const char *format_name, int flags);
+
+        bool RenderBlock(int id, int x, int y, uint32_t tint = ME_TINT_NONE, int orientation = ME_ORIENT_NONE);
+
+        bool RegisterBlockVariant(int id, int base_id, uint32_t tint, int orientation);
 
         static bool ClearBlock();
 
         // bool RegistryRenderBlock(std::string block_name, int x, int y);
 
+        // opens a frame, false when one is already open
+        bool BeginFrame();
+
+        // presents the open frame, a call without one is skipped and counted
+        int EndFrame();
+
+        // ME_RenderFrame, skipped inside an open frame since its ME_EndFrame presents it
+        int RenderFrame();
+
+        // ME_ProcessEvents ran, the next present is the first one that can show its input
+        void OnProcessEvents() {
+            m_presents_since_events = 0;
+        }
+
         int Render();
 
+        // seconds since Start, shared by every animated block
+        float GetAnimationTime() const;
+
+        void GetFrameStats(ME_FrameStats *stats) const;
+
+        void SetRenderScale(float scale);
+
+        // columns * rows tiles of tile_width * tile_height, all empty
+        bool SetStaticLayer(int tile_width, int tile_height, int columns, int rows);
+
+        // id -1 empties the tile, animated blocks are drawn every frame on top of the cache
+        bool SetStaticTile(int column, int row, int id);
+
+        void SetStaticLayerMode(int mode);
+
+        void SetCamera(int x, int y);
+
+        // returns the view id, -1 on failure
+        int CreateView(const ME_ViewDesc &desc);
+
+        bool UpdateView(int view, const ME_ViewDesc &desc);
+
+        bool DestroyView(int view);
+
+        bool SetViewLayers(int view, int layer_mask);
+
+        bool LoadFont(int font_id, const char *path, float pixel_height, int flags);
+
+        bool UnloadFont(int font_id);
+
+        bool DrawText(int font_id, float x, float y, float scale, const char *text, uint32_t color);
+
+        int CreateEmitter(const ME_EmitterDesc &desc);
+
+        bool UpdateEmitter(int emitter, const ME_EmitterDesc &desc);
+
+        bool DestroyEmitter(int emitter);
+
+        bool EmitParticles(int emitter, float x, float y, int count);
+
+        void GetParticleStats(ME_ParticleStats *stats) const;
+
+        bool SetBlockLight(int id, int emission, int opacity);
+
+        bool SetLighting(bool enabled, int ambient, int air_falloff);
+
+        int GetLight(int column, int row) const;
+
+        void GetLightStats(ME_LightStats *stats) const;
+
+        bool OpenWorld(const char *path, int placeholder_id, size_t budget_bytes);
+
+        void CloseWorld();
+
+        bool GetWorldStats(ME_WorldStats *stats);
+
+        // block id under a static layer pixel, -1 for nothing
+        int QueryPoint(int x, int y);
+
+        int QueryAABB(const ME_AABB &box, ME_TileCoord *tiles, int capacity);
+
+        bool Raycast(const ME_Ray &ray, ME_RaycastHit &hit);
+
+        int FindPaths(const ME_PathRequest *requests, int count);
+
+        bool WaitPaths(int batch);
+
+        int GetPaths(int batch, ME_PathResult *results, ME_TileCoord *tiles, int capacity);
+
+        bool ReleasePaths(int batch);
+
+        bool OpenMap(const char *path);
+
+        bool SetMapTile(int column, int row, int id);
+
+        bool FillMapRect(int column, int row, int width, int height, int id);
+
+        bool SaveMap();
+
+        bool CompactMap();
+
+        void CloseMap();
+
+        bool GetMapStats(ME_MapStats *stats);
+
+        // ids of the static layer, row major, for writing the map
+        std::vector<int16_t> GetStaticTiles() const;
+
+        // last software frame as RGBA8 rows, false without the software renderer or room for it
+        bool ReadFramePixels(uint8_t *rgba, int capacity, int *width, int *height) const;
+
+        bool SaveFramePng(const char *path) const;
+
         // bool ClearView();
     };
 }
@@ -150,7 +702,7 @@ namespace MainboardEngine {
 
 #ifdef __linux__
     class LinuxPlatform : public MEPlatform {
-        std::unique_ptr<LinuxPlatform> m_platform;
+        std::unique_ptr<MEPlatform> m_platform; // the display server backend, none without one
 
     public:
         ~LinuxPlatform() override = default;
@@ -159,13 +711,14 @@ namespace MainboardEngine {
 
         void Shutdown() override;
 
-        MEWindow *CreateWindow(int is_full_screen, int x, int y, int width, int height, const char *title) override;
+        bool CreateWindow(int is_full_screen, int x, int y, int width, int height, const char *title,
+                          MEWindow *&window) override;
 
-        int ProcessEvents(ME_HANDLE handle) override;
+        ME_MESSAGE_TYPE ProcessEvents(ME_HANDLE handle) override;
     };
 
     class LinuxWindow : public MEWindow {
-        std::unique_ptr<LinuxWindow> m_window;
+        std::unique_ptr<MEWindow> m_window;
 
     public:
         ~LinuxWindow() override = default;
@@ -182,7 +735,7 @@ namespace MainboardEngine {
     };
 
 #ifdef __ME_USE_WAYLAND__
-    class WaylandPlatform : public LinuxPlatform {
+    class WaylandPlatform : public MEPlatform {
         void *display;
         void *compositor;
         void *shm;
@@ -203,9 +756,10 @@ namespace MainboardEngine {
 
         void Shutdown() override;
 
-        MEWindow *CreateWindow(int is_full_screen, int x, int y, int width, int height, const char *title) override;
+        bool CreateWindow(int is_full_screen, int x, int y, int width, int height, const char *title,
+                          MEWindow *&window) override;
 
-        int ProcessEvents(ME_HANDLE handle) override;
+        ME_MESSAGE_TYPE ProcessEvents(ME_HANDLE handle) override;
     };
 
     class WaylandWindow : public MEWindow {
@@ -0,0 +1,67 @@
+#ifndef MAINBOARD_ENGINE_RUN_LOOP_H
+#define MAINBOARD_ENGINE_RUN_LOOP_H
+
+#include <chrono>
+
+#include "mainboard_engine.h"
+
+namespace MainboardEngine {
+    // sleeps are cut this short of the deadline and the rest is spun, OS sleeps overshoot
+    constexpr std::chrono::microseconds LOOP_SPIN_TIME(1500);
+
+    // Timing of ME_RunLoop without the platform, so it can be driven by a fake clock. Elapsed
+    // time is collected into an accumulator that is paid out in whole ticks, what remains is the
+    // interpolation alpha of the frame.
+    class MEFixedStep {
+    public:
+        using Clock = std::chrono::steady_clock;
+
+    private:
+        Clock::duration m_tick;
+        Clock::duration m_frame; // zero without a frame cap
+        int m_max_ticks;
+        Clock::duration m_accumulator;
+        Clock::time_point m_last;
+        Clock::time_point m_next_frame;
+
+    public:
+        explicit MEFixedStep(const ME_LoopDesc &desc);
+
+        static bool IsValidDesc(const ME_LoopDesc &desc);
+
+        void Start(Clock::time_point now);
+
+        // adds the time since the last call and returns how many ticks to run, at most
+        // max_ticks_per_frame, the ones over it are dropped and counted in dropped
+        int Advance(Clock::time_point now, int &dropped);
+
+        double GetTickSeconds() const {
+            return std::chrono::duration<double>(m_tick).count();
+        }
+
+        // [0, 1) after Advance
+        double GetAlpha() const {
+            return std::chrono::duration<double>(m_accumulator).count() / GetTickSeconds();
+        }
+
+        // when the next frame may start, now when frames aren't capped
+        Clock::time_point NextFrame(Clock::time_point now);
+    };
+
+    // sleeps until shortly before deadline and spins the rest, returns the time waited
+    std::chrono::steady_clock::duration SleepUntil(std::chrono::steady_clock::time_point deadline);
+
+    // 1 ms scheduler granularity while alive, Windows sleeps in 15.6 ms steps otherwise
+    class METimerResolution {
+    public:
+        METimerResolution();
+
+        ~METimerResolution();
+
+        METimerResolution(const METimerResolution &) = delete;
+
+        METimerResolution &operator=(const METimerResolution &) = delete;
+    };
+}
+
+#endif //MAINBOARD_ENGINE_RUN_LOOP_H
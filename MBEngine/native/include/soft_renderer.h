@@ -0,0 +1,99 @@
+#ifndef MAINBOARD_ENGINE_SOFT_RENDERER_H
+#define MAINBOARD_ENGINE_SOFT_RENDERER_H
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "job_pool.h"
+
+namespace MainboardEngine {
+    // pixels per side of the screen tiles a frame is split into, one job each
+    constexpr int SOFT_BIN_SIZE = 64;
+
+    struct MESoftDraw {
+        int id;
+        int x; // in target pixels before the render scale, like DrawCommand
+        int y;
+        uint32_t tint = 0xFFFFFFFF; // ME_TINT_NONE, 0xRRGGBBAA
+        int orientation = 0; // ME_ORIENT_*
+    };
+
+    // CPU rasterizer of block quads behind ME_RENDERER_SOFTWARE. Blocks keep an RGBA8 copy of their
+    // pixels. Render bins the draws into SOFT_BIN_SIZE screen tiles and draws the tiles in parallel,
+    // each one in painter's order, so no two threads touch the same pixel. Sampling is nearest like
+    // fs_tiled. Fully transparent texels are skipped and partly transparent ones blended over what is
+    // below, 4 pixels at a time with SSE2. Opaque blocks are copied row by row. Tinted or turned draws
+    // gather their texels one by one.
+    class MESoftRenderer {
+        struct Texture {
+            int width;
+            int frame_height;
+            int frame_count;
+            int frame_duration_ms;
+            bool opaque; // every texel has alpha 255
+            std::vector<uint8_t> pixels; // RGBA8, frames stacked vertically
+        };
+
+        struct DrawRect {
+            int left; // covered pixels, clipped to the target
+            int top;
+            int right;
+            int bottom;
+            float x; // unclipped corner in target pixels
+            float y;
+            int width; // on screen before the render scale, swapped by quarter turns
+            int height;
+            uint32_t tint;
+            int orientation;
+            const Texture *texture;
+            const uint8_t *frame; // first row of the frame to sample
+        };
+
+        int m_width;
+        int m_height;
+        int m_bins_x;
+        std::vector<uint8_t> m_pixels; // RGBA8, top row first
+        std::vector<std::unique_ptr<Texture> > m_textures; // by block id
+        std::vector<std::vector<uint32_t> > m_bins; // draw indices per screen tile, in draw order
+        std::vector<DrawRect> m_rects;
+
+        void DrawBin(int bin, float scale, const uint8_t clear[4]);
+
+        // texels of a tinted or turned draw, gathered into texels before blending
+        void GatherRow(const DrawRect &rect, const int *columns, int span, int v, uint8_t *texels) const;
+
+    public:
+        explicit MESoftRenderer(int texture_count);
+
+        void Resize(int width, int height);
+
+        // rgba is width * frame_height * frame_count pixels, copied
+        void SetTexture(int id, int width, int frame_height, int frame_count, int frame_duration_ms,
+                        const uint8_t *rgba);
+
+        void RemoveTexture(int id);
+
+        // draws are in painter's order, ids without a texture are skipped. clear is RGBA8 as 0xRRGGBBAA
+        void Render(const MESoftDraw *draws, size_t count, float scale, float time, uint32_t clear, MEJobPool &jobs);
+
+        const uint8_t *GetPixels() const {
+            return m_pixels.data();
+        }
+
+        int GetWidth() const {
+            return m_width;
+        }
+
+        int GetHeight() const {
+            return m_height;
+        }
+
+        bool SavePng(const char *path) const;
+    };
+
+    // dst = src over dst for count RGBA8 pixels, what Render blends with
+    void BlendPixels(uint8_t *dst, const uint8_t *src, int count);
+}
+
+#endif //MAINBOARD_ENGINE_SOFT_RENDERER_H
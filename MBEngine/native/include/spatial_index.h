@@ -0,0 +1,61 @@
+#ifndef MAINBOARD_ENGINE_SPATIAL_INDEX_H
+#define MAINBOARD_ENGINE_SPATIAL_INDEX_H
+
+#include <cstdint>
+#include <vector>
+
+#include "mainboard_engine.h"
+
+namespace MainboardEngine {
+    // tiles per side of one bitset word, 8 * 8 = 64 bits
+    constexpr int SPATIAL_BRICK_SIZE = 8;
+
+    // Solid occupancy of the static layer, one bit per tile grouped into 8x8 bricks so a box
+    // query touches a handful of words and empty bricks are skipped whole. Coordinates are in
+    // layer pixels, the block ids themselves stay in the static layer / world.
+    class MESpatialIndex {
+        int m_tile_width;
+        int m_tile_height;
+        int m_columns;
+        int m_rows;
+        int m_bricks_x;
+        int m_bricks_y;
+        std::vector<uint64_t> m_bricks;
+
+        uint64_t GetBrick(int column, int row) const {
+            return m_bricks[(row / SPATIAL_BRICK_SIZE) * m_bricks_x + column / SPATIAL_BRICK_SIZE];
+        }
+
+    public:
+        MESpatialIndex();
+
+        // every tile becomes empty
+        void Resize(int tile_width, int tile_height, int columns, int rows);
+
+        void Clear();
+
+        void SetSolid(int column, int row, bool solid);
+
+        bool IsSolid(int column, int row) const {
+            if (column < 0 || row < 0 || column >= m_columns || row >= m_rows) {
+                return false;
+            }
+            int bit = (row % SPATIAL_BRICK_SIZE) * SPATIAL_BRICK_SIZE + column % SPATIAL_BRICK_SIZE;
+            return (GetBrick(column, row) >> bit) & 1;
+        }
+
+        // tile under a pixel, false outside the grid
+        bool GetTileAt(int x, int y, int &column, int &row) const;
+
+        // number of solid tiles the box overlaps, a box touching a tile edge does not overlap it
+        int CountSolid(const ME_AABB &box) const;
+
+        // writes up to capacity overlapped solid tiles, returns how many there are in total
+        int QuerySolid(const ME_AABB &box, ME_TileCoord *tiles, int capacity) const;
+
+        // first solid tile along the ray, block_id of the hit is left for the caller
+        bool Raycast(const ME_Ray &ray, ME_RaycastHit &hit) const;
+    };
+}
+
+#endif //MAINBOARD_ENGINE_SPATIAL_INDEX_H
@@ -0,0 +1,218 @@
+#ifndef MAINBOARD_ENGINE_STATIC_LAYER_H
+#define MAINBOARD_ENGINE_STATIC_LAYER_H
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <vector>
+
+#include "mainboard_engine.h"
+
+namespace MainboardEngine {
+    // more dirty rects than this are merged into their bounding box
+    constexpr size_t MAX_STATIC_DIRTY_RECTS = 16;
+
+    // Tile grid of a layer that rarely changes, plus the bookkeeping of which part of its
+    // cached image is out of date. Rects are in layer pixels (tile size * tile index), the
+    // cache covers `view`, the part of the layer that is on screen. No rendering in here,
+    // MEEngine turns the dirty rects into draws.
+    class MEStaticLayer {
+        int m_tile_width;
+        int m_tile_height;
+        int m_columns;
+        int m_rows;
+        std::vector<int> m_tiles; // block id per tile, -1 when empty
+        std::vector<int> m_live_tiles; // indices of tiles drawn every frame instead of cached
+        ME_Rect m_view;
+        bool m_valid; // false until the cache holds a full image of m_view
+        std::vector<ME_Rect> m_dirty;
+
+    public:
+        MEStaticLayer() : m_tile_width(0), m_tile_height(0), m_columns(0), m_rows(0), m_view{0, 0, 0, 0},
+                          m_valid(false) {
+            m_dirty.reserve(MAX_STATIC_DIRTY_RECTS + 1);
+        }
+
+        // drops every tile, the whole cache is redrawn on the next frame. Without store_tiles
+        // the ids come from elsewhere (a streamed world) and SetTile fails.
+        void Resize(int tile_width, int tile_height, int columns, int rows, bool store_tiles = true) {
+            m_tile_width = tile_width;
+            m_tile_height = tile_height;
+            m_columns = columns;
+            m_rows = rows;
+            m_tiles.assign(store_tiles ? static_cast<size_t>(columns) * rows : 0, -1);
+            m_live_tiles.clear();
+            InvalidateAll();
+        }
+
+        bool IsEnabled() const {
+            return m_columns > 0 && m_rows > 0;
+        }
+
+        // live tiles (animated blocks) are not baked into the cache
+        bool SetTile(int column, int row, int id, bool live) {
+            if (m_tiles.empty() || column < 0 || row < 0 || column >= m_columns || row >= m_rows) {
+                return false;
+            }
+            int index = row * m_columns + column;
+            auto it = std::find(m_live_tiles.begin(), m_live_tiles.end(), index);
+            if (it != m_live_tiles.end()) {
+                m_live_tiles.erase(it);
+            }
+            if (live && id >= 0) {
+                m_live_tiles.push_back(index);
+            }
+            if (m_tiles[index] != id) {
+                m_tiles[index] = id;
+                Invalidate(GetTileRect(column, row));
+            }
+            return true;
+        }
+
+        int GetTile(int column, int row) const {
+            return m_tiles[row * m_columns + column];
+        }
+
+        const std::vector<int> &GetLiveTiles() const {
+            return m_live_tiles;
+        }
+
+        ME_Rect GetTileRect(int column, int row) const {
+            ME_Rect rect;
+            rect.left = column * m_tile_width;
+            rect.top = row * m_tile_height;
+            rect.right = rect.left + m_tile_width;
+            rect.bottom = rect.top + m_tile_height;
+            return rect;
+        }
+
+        int GetTileWidth() const {
+            return m_tile_width;
+        }
+
+        int GetTileHeight() const {
+            return m_tile_height;
+        }
+
+        int GetColumns() const {
+            return m_columns;
+        }
+
+        int GetRows() const {
+            return m_rows;
+        }
+
+        void Invalidate(const ME_Rect &rect) {
+            if (rect.left >= rect.right || rect.top >= rect.bottom) {
+                return;
+            }
+            for (auto &dirty: m_dirty) {
+                // a tile edit next to the last one is the common case, grow instead of adding
+                if (Touches(dirty, rect)) {
+                    dirty = Union(dirty, rect);
+                    return;
+                }
+            }
+            m_dirty.push_back(rect);
+            if (m_dirty.size() > MAX_STATIC_DIRTY_RECTS) {
+                ME_Rect bounds = m_dirty[0];
+                for (auto &dirty: m_dirty) {
+                    bounds = Union(bounds, dirty);
+                }
+                m_dirty.clear();
+                m_dirty.push_back(bounds);
+            }
+        }
+
+        void InvalidateAll() {
+            m_valid = false;
+            m_dirty.clear();
+        }
+
+        // Moves the cached window to `view`. Returns true when the old image can be kept and
+        // shifted by (dx, dy) layer pixels, only the exposed strips are dirty then. Otherwise
+        // the whole view is dirty.
+        bool Scroll(const ME_Rect &view, int &dx, int &dy) {
+            dx = view.left - m_view.left;
+            dy = view.top - m_view.top;
+            int width = view.right - view.left;
+            int height = view.bottom - view.top;
+            bool same_size = width == m_view.right - m_view.left && height == m_view.bottom - m_view.top;
+            bool copy = m_valid && same_size && (dx != 0 || dy != 0) && std::abs(dx) < width &&
+                        std::abs(dy) < height;
+
+            if (!m_valid || !same_size || (!copy && (dx != 0 || dy != 0))) {
+                m_view = view;
+                m_valid = true;
+                m_dirty.clear();
+                m_dirty.push_back(view);
+                return false;
+            }
+            if (!copy) {
+                return false;
+            }
+
+            // columns entering on the left or right, then rows entering on top or bottom
+            if (dx > 0) {
+                Invalidate({view.top, view.bottom, m_view.right, view.right});
+            } else if (dx < 0) {
+                Invalidate({view.top, view.bottom, view.left, m_view.left});
+            }
+            if (dy > 0) {
+                Invalidate({m_view.bottom, view.bottom, view.left, view.right});
+            } else if (dy < 0) {
+                Invalidate({view.top, m_view.top, view.left, view.right});
+            }
+            m_view = view;
+            return true;
+        }
+
+        const ME_Rect &GetView() const {
+            return m_view;
+        }
+
+        // dirty rects clipped to the view, empty ones removed
+        const std::vector<ME_Rect> &GetDirtyRects() {
+            size_t kept = 0;
+            for (auto &dirty: m_dirty) {
+                ME_Rect clipped = Intersect(dirty, m_view);
+                if (clipped.left < clipped.right && clipped.top < clipped.bottom) {
+                    m_dirty[kept++] = clipped;
+                }
+            }
+            m_dirty.resize(kept);
+            return m_dirty;
+        }
+
+        void ClearDirty() {
+            m_dirty.clear();
+        }
+
+        static ME_Rect Union(const ME_Rect &a, const ME_Rect &b) {
+            return {
+                std::min(a.top, b.top), std::max(a.bottom, b.bottom),
+                std::min(a.left, b.left), std::max(a.right, b.right)
+            };
+        }
+
+        static ME_Rect Intersect(const ME_Rect &a, const ME_Rect &b) {
+            return {
+                std::max(a.top, b.top), std::min(a.bottom, b.bottom),
+                std::max(a.left, b.left), std::min(a.right, b.right)
+            };
+        }
+
+    private:
+        // same row span or column span and touching, or one inside the other,
+        // the union of those covers nothing that was clean
+        static bool Touches(const ME_Rect &a, const ME_Rect &b) {
+            bool share_rows = a.top == b.top && a.bottom == b.bottom && a.left <= b.right && b.left <= a.right;
+            bool share_columns = a.left == b.left && a.right == b.right && a.top <= b.bottom && b.top <= a.bottom;
+            bool contains = (a.left <= b.left && a.top <= b.top && b.right <= a.right && b.bottom <= a.bottom) ||
+                            (b.left <= a.left && b.top <= a.top && a.right <= b.right && a.bottom <= b.bottom);
+            return share_rows || share_columns || contains;
+        }
+    };
+}
+
+#endif //MAINBOARD_ENGINE_STATIC_LAYER_H
@@ -0,0 +1,51 @@
+#ifndef MAINBOARD_ENGINE_TEXTURE_LOADER_H
+#define MAINBOARD_ENGINE_TEXTURE_LOADER_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <bgfx/bgfx.h>
+
+namespace MainboardEngine {
+    // pixels ready for createTexture2D, either RGBA8 or a block compressed format,
+    // mip levels are stored one after another starting with the full size image
+    struct METextureData {
+        bgfx::TextureFormat::Enum format;
+        int width;
+        int height;
+        int num_mips;
+        std::vector<uint8_t> data;
+    };
+
+    // best compressed format the current renderer can sample, or RGBA8 if there is none
+    bgfx::TextureFormat::Enum ChooseCompressedFormat(bool has_alpha);
+
+    // block formats work on 4x4 blocks, frames of an animated strip must not share one
+    bool CanCompress(int width, int frame_height);
+
+    // full chain down to 1x1, as bgfx expects when a texture is created with mips
+    int GetMipCount(int width, int height);
+
+    // 2x2 box filter of every level into the next one, RGBA8 in and out
+    void BuildMipChain(const uint8_t *rgba, int width, int height, std::vector<uint8_t> &chain);
+
+    bool EncodeTexture(const uint8_t *rgba, int width, int height, bgfx::TextureFormat::Enum format, bool mips,
+                       METextureData &texture);
+
+    // the encoded texture is cached next to the source image as `<path>.<format>[.mips].mbtx`
+    std::string GetTextureCachePath(const std::string &path, bgfx::TextureFormat::Enum format, bool mips);
+
+    // fails if the cache is missing or older than the source image
+    bool LoadTextureCache(const std::string &path, bgfx::TextureFormat::Enum format, bool mips,
+                          METextureData &texture);
+
+    bool WriteTextureCache(const std::string &path, const METextureData &texture);
+
+    const char *GetTextureFormatName(bgfx::TextureFormat::Enum format);
+
+    // accepts the names returned by GetTextureFormatName
+    bool ParseTextureFormat(const char *name, bgfx::TextureFormat::Enum &format);
+}
+
+#endif //MAINBOARD_ENGINE_TEXTURE_LOADER_H
@@ -0,0 +1,54 @@
+#ifndef MAINBOARD_ENGINE_TRACE_H
+#define MAINBOARD_ENGINE_TRACE_H
+
+#include <atomic>
+#include <cstdint>
+
+namespace MainboardEngine {
+    // set by ME_TraceStart / ME_TraceStop, read once per scope
+    extern std::atomic<bool> g_trace_enabled;
+
+    uint64_t GetTraceTimestamp();
+
+    void RecordTraceEvent(const char *name, uint64_t start, uint64_t end);
+
+    // Complete event from construction to destruction, `name` must be a string literal.
+    // When tracing is off this costs one relaxed load and a well predicted branch.
+    class METraceScope {
+        const char *m_name;
+        uint64_t m_start;
+
+    public:
+        explicit METraceScope(const char *name) : m_name(nullptr), m_start(0) {
+            if (g_trace_enabled.load(std::memory_order_relaxed)) {
+                m_name = name;
+                m_start = GetTraceTimestamp();
+            }
+        }
+
+        ~METraceScope() {
+            if (m_name) {
+                RecordTraceEvent(m_name, m_start, GetTraceTimestamp());
+            }
+        }
+
+        METraceScope(const METraceScope &) = delete;
+
+        METraceScope &operator=(const METraceScope &) = delete;
+    };
+
+    // clears g_trace_enabled and waits for threads still writing an event, call before WriteTrace
+    void StopTrace();
+
+    // writes every buffered event as Chrome trace-event JSON (chrome://tracing, ui.perfetto.dev)
+    bool WriteTrace(const char *path);
+
+    // drops the events of the last session, the rings are left to their owners
+    void ResetTrace();
+}
+
+#define ME_TRACE_CONCAT_IMPL(a, b) a##b
+#define ME_TRACE_CONCAT(a, b) ME_TRACE_CONCAT_IMPL(a, b)
+#define ME_TRACE_SCOPE(name) ::MainboardEngine::METraceScope ME_TRACE_CONCAT(me_trace_scope_, __LINE__)(name)
+
+#endif //MAINBOARD_ENGINE_TRACE_H
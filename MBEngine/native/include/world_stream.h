@@ -0,0 +1,195 @@
+#ifndef MAINBOARD_ENGINE_WORLD_STREAM_H
+#define MAINBOARD_ENGINE_WORLD_STREAM_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "mainboard_engine.h"
+#include "mapped_file.h"
+
+namespace MainboardEngine {
+    // .mbworld layout: header, one MEWorldChunkEntry per chunk (row major), chunk payloads.
+    // A payload is chunk_size * chunk_size int16 block ids (-1 empty), raw or run length encoded
+    // as (uint16 count, int16 id) pairs. Chunks on the right and bottom edge are padded with -1.
+    struct MEWorldHeader {
+        char magic[4];
+        uint32_t version;
+        uint32_t tile_width;
+        uint32_t tile_height;
+        uint32_t columns;
+        uint32_t rows;
+        uint32_t chunk_size; // tiles per chunk side
+        uint32_t reserved;
+    };
+
+    struct MEWorldChunkEntry {
+        uint64_t offset;
+        uint32_t size; // 0 for a chunk that was never written, read as empty
+        uint32_t encoding;
+    };
+
+    constexpr uint32_t WORLD_CHUNK_RAW = 0;
+    constexpr uint32_t WORLD_CHUNK_RLE = 1;
+    constexpr uint32_t WORLD_CHUNK_SIZE = 32;
+
+    // Writes a world chunk by chunk, so generators never hold the whole map in memory
+    class MEWorldWriter {
+        std::ofstream m_file;
+        MEWorldHeader m_header;
+        uint32_t m_chunks_x;
+        std::vector<MEWorldChunkEntry> m_entries;
+        std::vector<uint8_t> m_encoded;
+
+    public:
+        MEWorldWriter();
+
+        bool Open(const char *path, int tile_width, int tile_height, int columns, int rows,
+                  int chunk_size = WORLD_CHUNK_SIZE);
+
+        // tiles are chunk_size * chunk_size ids, row major
+        bool WriteChunk(int chunk_x, int chunk_y, const int16_t *tiles);
+
+        // writes the chunk table, the file is unusable until then
+        bool Close();
+
+        // convenience for maps that do fit in memory, tiles are columns * rows ids
+        static bool WriteWorld(const char *path, int tile_width, int tile_height, int columns, int rows,
+                               const int16_t *tiles);
+    };
+
+    // decodes one chunk of an in-memory .mbworld file into count ids, a damaged chunk reads as empty
+    void DecodeWorldChunk(const uint8_t *file, size_t file_size, const MEWorldChunkEntry &entry, int16_t *tiles,
+                          size_t count);
+
+    // reads a whole world, tiles becomes columns * rows ids. For maps that fit in memory, like
+    // MEWorldWriter::WriteWorld
+    bool ReadWorld(const char *path, MEWorldHeader &header, std::vector<int16_t> &tiles);
+
+    // Keeps the chunks around the camera of an mmapped world decoded. A worker thread does all
+    // file access and decoding, the render thread only swaps finished chunks in during Update,
+    // so it never waits for the disk. Chunks ahead of the camera motion are requested early
+    // and the ones furthest away are dropped when the decoded size exceeds the budget.
+    class MEWorldStream {
+        struct DecodedChunk {
+            int index;
+            std::unique_ptr<int16_t[]> tiles;
+        };
+
+        enum ChunkState : uint8_t {
+            CHUNK_ABSENT,
+            CHUNK_REQUESTED,
+            CHUNK_RESIDENT
+        };
+
+        MEMappedFile m_file;
+        MEWorldHeader m_header;
+        const MEWorldChunkEntry *m_entries;
+        int m_chunks_x;
+        int m_chunks_y;
+        size_t m_chunk_bytes;
+        size_t m_budget;
+
+        // owned by the render thread
+        std::vector<std::unique_ptr<int16_t[]> > m_chunks;
+        std::vector<uint8_t> m_states;
+        std::vector<int> m_resident;
+        std::vector<int> m_wanted; // visible chunks first, then prefetch, nearest first
+        std::vector<int> m_posted; // m_wanted as of the last request to the worker
+        std::vector<uint8_t> m_wanted_mask;
+        std::vector<int> m_arrived;
+        std::vector<int> m_evicted;
+        std::vector<DecodedChunk> m_received;
+        ME_Rect m_last_view;
+        bool m_has_last_view;
+        std::chrono::steady_clock::time_point m_last_update;
+        float m_velocity_x; // layer pixels per second
+        float m_velocity_y;
+        int m_loaded_total;
+        int m_evicted_total;
+        int m_requested_count;
+
+        // shared with the worker, guarded by m_mutex
+        std::mutex m_mutex;
+        std::condition_variable m_wake;
+        std::deque<int> m_queue;
+        std::vector<DecodedChunk> m_finished;
+        std::atomic<int> m_finished_count; // lets Update skip the lock while nothing arrived
+        bool m_stop;
+        std::thread m_worker;
+
+        void WorkerLoop();
+
+        void DecodeChunk(int index, int16_t *tiles) const;
+
+        void AddWanted(int chunk_x0, int chunk_y0, int chunk_x1, int chunk_y1, float center_x, float center_y,
+                       size_t first);
+
+        void Evict(float center_x, float center_y);
+
+    public:
+        MEWorldStream();
+
+        ~MEWorldStream();
+
+        MEWorldStream(const MEWorldStream &) = delete;
+
+        MEWorldStream &operator=(const MEWorldStream &) = delete;
+
+        bool Open(const char *path, size_t budget_bytes);
+
+        void Close();
+
+        // view is the visible part of the world in layer pixels, call once per frame
+        void Update(const ME_Rect &view);
+
+        // chunks that became resident during the last Update
+        const std::vector<int> &GetArrivedChunks() const {
+            return m_arrived;
+        }
+
+        // chunks dropped during the last Update
+        const std::vector<int> &GetEvictedChunks() const {
+            return m_evicted;
+        }
+
+        const std::vector<int> &GetResidentChunks() const {
+            return m_resident;
+        }
+
+        ME_Rect GetChunkRect(int index) const;
+
+        // tile ids of a resident chunk, chunk_size * chunk_size row major
+        const int16_t *GetChunkTiles(int index) const {
+            return m_chunks[index].get();
+        }
+
+        // false while the chunk holding the tile is not resident
+        bool GetTile(int column, int row, int &id) const {
+            int chunk_size = static_cast<int>(m_header.chunk_size);
+            int index = (row / chunk_size) * m_chunks_x + column / chunk_size;
+            const int16_t *tiles = m_chunks[index].get();
+            if (!tiles) {
+                return false;
+            }
+            id = tiles[(row % chunk_size) * chunk_size + column % chunk_size];
+            return true;
+        }
+
+        const MEWorldHeader &GetHeader() const {
+            return m_header;
+        }
+
+        void GetStats(ME_WorldStats *stats);
+    };
+}
+
+#endif //MAINBOARD_ENGINE_WORLD_STREAM_H
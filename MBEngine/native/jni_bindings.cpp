@@ -0,0 +1,171 @@
+// JNI entry points for the calls Java makes every frame. JNA dispatches through reflection and
+// converts every argument, RegisterNatives binds these directly to `MainboardJNI`.
+// Only compiled when CMake finds a JDK (ME_HAS_JNI).
+#include "include/mainboard_engine.h"
+
+#include <jni.h>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace MainboardEngine {
+    static jint JNICALL JniGetVersion(JNIEnv *, jclass) {
+        return ME_GetVersion();
+    }
+
+    static jint JNICALL JniProcessEvents(JNIEnv *, jclass, jlong handle) {
+        return ME_ProcessEvents(reinterpret_cast<ME_HANDLE>(handle));
+    }
+
+    static jint JNICALL JniRenderBlock(JNIEnv *, jclass, jint block_id, jint x, jint y) {
+        return ME_RenderBlock(block_id, x, y);
+    }
+
+    static jint JNICALL JniRenderBlocks(JNIEnv *env, jclass, jintArray block_ids, jintArray xs, jintArray ys,
+                                        jint count) {
+        if (count <= 0 || !block_ids || !xs || !ys) {
+            return 0;
+        }
+        if (env->GetArrayLength(block_ids) < count || env->GetArrayLength(xs) < count ||
+            env->GetArrayLength(ys) < count) {
+            return 0;
+        }
+
+        // copied rather than pinned, a critical region would hold off the GC for the whole draw list.
+        // The buffer is kept per thread so a frame does not allocate once it has seen its largest list
+        thread_local std::vector<jint> scratch;
+        scratch.resize(static_cast<size_t>(count) * 3);
+        jint *ids_data = scratch.data();
+        jint *xs_data = ids_data + count;
+        jint *ys_data = xs_data + count;
+        env->GetIntArrayRegion(block_ids, 0, count, ids_data);
+        env->GetIntArrayRegion(xs, 0, count, xs_data);
+        env->GetIntArrayRegion(ys, 0, count, ys_data);
+        if (env->ExceptionCheck()) {
+            return 0;
+        }
+
+        return ME_RenderBlocks(ids_data, xs_data, ys_data, count);
+    }
+
+    static jint JNICALL JniRenderFrame(JNIEnv *, jclass, jlong handle) {
+        return ME_RenderFrame(reinterpret_cast<ME_HANDLE>(handle));
+    }
+
+    static jint JNICALL JniBeginFrame(JNIEnv *, jclass, jlong handle) {
+        return ME_BeginFrame(reinterpret_cast<ME_HANDLE>(handle));
+    }
+
+    static jint JNICALL JniEndFrame(JNIEnv *, jclass, jlong handle) {
+        return ME_EndFrame(reinterpret_cast<ME_HANDLE>(handle));
+    }
+
+    // JNI's own UTF functions write modified UTF-8: U+0000 as two bytes and characters past U+FFFF
+    // as two three-byte surrogates. The engine takes standard UTF-8, so it is converted from UTF-16
+    // here. out needs 3 bytes per unit and the terminator, an unpaired surrogate becomes U+FFFD
+    static void ConvertUtf16(const jchar *units, jsize length, char *out) {
+        for (jsize i = 0; i < length; ++i) {
+            uint32_t code = units[i];
+            if (code >= 0xD800 && code <= 0xDFFF) {
+                bool paired = code <= 0xDBFF && i + 1 < length && units[i + 1] >= 0xDC00 && units[i + 1] <= 0xDFFF;
+                code = paired ? 0x10000 + ((code - 0xD800) << 10) + (units[++i] - 0xDC00) : 0xFFFD;
+            }
+            if (code < 0x80) {
+                *out++ = static_cast<char>(code);
+            } else if (code < 0x800) {
+                *out++ = static_cast<char>(0xC0 | code >> 6);
+                *out++ = static_cast<char>(0x80 | (code & 0x3F));
+            } else if (code < 0x10000) {
+                *out++ = static_cast<char>(0xE0 | code >> 12);
+                *out++ = static_cast<char>(0x80 | (code >> 6 & 0x3F));
+                *out++ = static_cast<char>(0x80 | (code & 0x3F));
+            } else {
+                *out++ = static_cast<char>(0xF0 | code >> 18);
+                *out++ = static_cast<char>(0x80 | (code >> 12 & 0x3F));
+                *out++ = static_cast<char>(0x80 | (code >> 6 & 0x3F));
+                *out++ = static_cast<char>(0x80 | (code & 0x3F));
+            }
+        }
+        *out = '\0';
+    }
+
+    // short strings are converted on the stack, HUD titles and labels change every frame
+    template<typename Call>
+    static jint WithUtf8(JNIEnv *env, jstring string, Call call) {
+        jchar units[128];
+        char buffer[sizeof(units) / sizeof(units[0]) * 3 + 1];
+        jsize length = env->GetStringLength(string);
+        if (length <= static_cast<jsize>(sizeof(units) / sizeof(units[0]))) {
+            env->GetStringRegion(string, 0, length, units);
+            ConvertUtf16(units, length, buffer);
+            return call(buffer);
+        }
+
+        std::vector<jchar> long_units(static_cast<size_t>(length));
+        std::string converted(static_cast<size_t>(length) * 3 + 1, '\0');
+        env->GetStringRegion(string, 0, length, long_units.data());
+        ConvertUtf16(long_units.data(), length, &converted[0]);
+        return call(converted.c_str());
+    }
+
+    static jint JNICALL JniSetWindowTitle(JNIEnv *env, jclass, jlong handle, jstring title) {
+        if (!title) {
+            return ME_FALSE;
+        }
+        return WithUtf8(env, title, [handle](const char *text) {
+            return ME_SetWindowTitle(reinterpret_cast<ME_HANDLE>(handle), text);
+        });
+    }
+
+    static jint JNICALL JniDrawText(JNIEnv *env, jclass, jint font_id, jint x, jint y, jstring text, jint color) {
+        if (!text) {
+            return ME_FALSE;
+        }
+        return WithUtf8(env, text, [font_id, x, y, color](const char *utf8) {
+            return ME_DrawText(font_id, x, y, utf8, static_cast<unsigned int>(color));
+        });
+    }
+
+    static const JNINativeMethod JNI_METHODS[] = {
+        {const_cast<char *>("getVersion"), const_cast<char *>("()I"), reinterpret_cast<void *>(JniGetVersion)},
+        {const_cast<char *>("processEvents"), const_cast<char *>("(J)I"), reinterpret_cast<void *>(JniProcessEvents)},
+        {const_cast<char *>("renderBlock"), const_cast<char *>("(III)I"), reinterpret_cast<void *>(JniRenderBlock)},
+        {
+            const_cast<char *>("renderBlocks"), const_cast<char *>("([I[I[II)I"),
+            reinterpret_cast<void *>(JniRenderBlocks)
+        },
+        {const_cast<char *>("renderFrame"), const_cast<char *>("(J)I"), reinterpret_cast<void *>(JniRenderFrame)},
+        {const_cast<char *>("beginFrame"), const_cast<char *>("(J)I"), reinterpret_cast<void *>(JniBeginFrame)},
+        {const_cast<char *>("endFrame"), const_cast<char *>("(J)I"), reinterpret_cast<void *>(JniEndFrame)},
+        {
+            const_cast<char *>("setWindowTitle"), const_cast<char *>("(JLjava/lang/String;)I"),
+            reinterpret_cast<void *>(JniSetWindowTitle)
+        },
+        {
+            const_cast<char *>("drawText"), const_cast<char *>("(IIILjava/lang/String;I)I"),
+            reinterpret_cast<void *>(JniDrawText)
+        },
+    };
+}
+
+extern "C" JNIEXPORT jint JNICALL JNI_OnLoad(JavaVM *vm, void *) {
+    JNIEnv *env = nullptr;
+    if (vm->GetEnv(reinterpret_cast<void **>(&env), JNI_VERSION_1_8) != JNI_OK) {
+        return JNI_ERR;
+    }
+
+    // a missing class only disables the JNI path, NativeCaller keeps using JNA
+    jclass bindings = env->FindClass("com/potato/NativeUtils/MainboardJNI");
+    if (!bindings) {
+        env->ExceptionClear();
+        return JNI_VERSION_1_8;
+    }
+
+    jint count = static_cast<jint>(sizeof(MainboardEngine::JNI_METHODS) / sizeof(MainboardEngine::JNI_METHODS[0]));
+    if (env->RegisterNatives(bindings, MainboardEngine::JNI_METHODS, count) != JNI_OK) {
+        env->ExceptionClear();
+    }
+    env->DeleteLocalRef(bindings);
+
+    return JNI_VERSION_1_8;
+}
@@ -0,0 +1,95 @@
+#include "include/job_pool.h"
+
+#include <algorithm>
+
+namespace MainboardEngine {
+    MEJobPool::MEJobPool(int workers) : m_job(nullptr), m_count(0), m_range_size(0), m_range_count(0),
+                                        m_next_range(0), m_generation(0), m_busy(0), m_stop(false) {
+        if (workers <= 0) {
+            workers = static_cast<int>(std::thread::hardware_concurrency()) - 1;
+        }
+        for (int i = 0; i < workers; ++i) {
+            m_workers.emplace_back(&MEJobPool::WorkerLoop, this);
+        }
+    }
+
+    MEJobPool::~MEJobPool() {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stop = true;
+        }
+        m_wake.notify_all();
+        for (auto &worker: m_workers) {
+            worker.join();
+        }
+    }
+
+    void MEJobPool::RunRanges(const Job &job) {
+        for (;;) {
+            size_t range = m_next_range.fetch_add(1, std::memory_order_relaxed);
+            if (range >= m_range_count) {
+                return;
+            }
+            size_t begin = range * m_range_size;
+            job(begin, std::min(begin + m_range_size, m_count));
+        }
+    }
+
+    void MEJobPool::WorkerLoop() {
+        uint64_t seen = 0;
+        for (;;) {
+            const Job *job = nullptr;
+            {
+                std::unique_lock<std::mutex> lock(m_mutex);
+                m_wake.wait(lock, [&] {
+                    return m_stop || (m_job && m_generation != seen);
+                });
+                if (m_stop) {
+                    return;
+                }
+                // joined under the lock, ParallelFor can't return while we hold a range
+                seen = m_generation;
+                job = m_job;
+                ++m_busy;
+            }
+            RunRanges(*job);
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                --m_busy;
+            }
+            m_done.notify_one();
+        }
+    }
+
+    void MEJobPool::Run(size_t count, size_t grain, const Job &job) {
+        grain = std::max<size_t>(grain, 1);
+        if (count == 0) {
+            return;
+        }
+        if (m_workers.empty() || count <= grain) {
+            job(0, count);
+            return;
+        }
+
+        // a few ranges per thread so a slow one doesn't hold up the rest
+        size_t ranges = std::min((count + grain - 1) / grain, static_cast<size_t>(GetThreadCount()) * 4);
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_count = count;
+            m_range_size = (count + ranges - 1) / ranges;
+            m_range_count = (count + m_range_size - 1) / m_range_size;
+            m_next_range.store(0, std::memory_order_relaxed);
+            m_job = &job;
+            ++m_generation;
+        }
+        m_wake.notify_all();
+
+        RunRanges(job);
+
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_done.wait(lock, [&] {
+            return m_busy == 0;
+        });
+        m_job = nullptr;
+    }
+}
@@ -0,0 +1,169 @@
+#include "include/light_grid.h"
+#include "include/static_layer.h"
+#include "include/trace.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace MainboardEngine {
+    static bool IsEmpty(const ME_Rect &rect) {
+        return rect.left >= rect.right || rect.top >= rect.bottom;
+    }
+
+    // overlapping or sharing an edge
+    static bool Touches(const ME_Rect &a, const ME_Rect &b) {
+        return a.left <= b.right && b.left <= a.right && a.top <= b.bottom && b.top <= a.bottom;
+    }
+
+    MELightGrid::MELightGrid() : m_columns(0), m_rows(0), m_changed{0, 0, 0, 0} {
+        m_dirty.reserve(MAX_LIGHT_DIRTY_RECTS + 1);
+    }
+
+    void MELightGrid::Resize(int columns, int rows, int falloff) {
+        m_columns = std::max(columns, 0);
+        m_rows = std::max(rows, 0);
+        size_t size = static_cast<size_t>(m_columns) * m_rows;
+        m_emission.assign(size, 0);
+        m_falloff.assign(size, static_cast<uint8_t>(std::clamp(falloff, ME_LIGHT_MIN_FALLOFF, ME_LIGHT_MAX)));
+        m_light.assign(size, 0);
+        m_dirty.clear();
+        m_changed = {0, 0, 0, 0};
+        Invalidate({0, m_rows, 0, m_columns});
+    }
+
+    void MELightGrid::Invalidate(const ME_Rect &rect) {
+        ME_Rect clipped = MEStaticLayer::Intersect(rect, {0, m_rows, 0, m_columns});
+        if (IsEmpty(clipped)) {
+            return;
+        }
+        // pieces of different rects must not overlap, fold everything the rect touches into it
+        bool grew = true;
+        while (grew) {
+            grew = false;
+            for (size_t i = 0; i < m_dirty.size();) {
+                if (Touches(clipped, m_dirty[i])) {
+                    clipped = MEStaticLayer::Union(clipped, m_dirty[i]);
+                    m_dirty.erase(m_dirty.begin() + static_cast<std::ptrdiff_t>(i));
+                    grew = true;
+                } else {
+                    ++i;
+                }
+            }
+        }
+        m_dirty.push_back(clipped);
+        if (m_dirty.size() > MAX_LIGHT_DIRTY_RECTS) {
+            ME_Rect bounds = m_dirty[0];
+            for (auto &dirty: m_dirty) {
+                bounds = MEStaticLayer::Union(bounds, dirty);
+            }
+            m_dirty.clear();
+            m_dirty.push_back(bounds);
+        }
+    }
+
+    void MELightGrid::SetTile(int column, int row, int emission, int falloff) {
+        if (column < 0 || row < 0 || column >= m_columns || row >= m_rows) {
+            return;
+        }
+        auto new_emission = static_cast<uint8_t>(std::clamp(emission, 0, ME_LIGHT_MAX));
+        auto new_falloff = static_cast<uint8_t>(std::clamp(falloff, ME_LIGHT_MIN_FALLOFF, ME_LIGHT_MAX));
+        size_t index = static_cast<size_t>(row) * m_columns + column;
+        if (m_emission[index] == new_emission && m_falloff[index] == new_falloff) {
+            return;
+        }
+        m_emission[index] = new_emission;
+        m_falloff[index] = new_falloff;
+        // everything the tile's light reached before or reaches now
+        Invalidate({row - LIGHT_RADIUS, row + LIGHT_RADIUS + 1, column - LIGHT_RADIUS, column + LIGHT_RADIUS + 1});
+    }
+
+    void MELightGrid::RelightPiece(const ME_Rect &piece, std::vector<uint8_t> &light, std::vector<uint32_t> &queue) {
+        // a path from a source to the piece never leaves the piece grown by the radius
+        ME_Rect window = MEStaticLayer::Intersect({
+                                                      piece.top - LIGHT_RADIUS, piece.bottom + LIGHT_RADIUS,
+                                                      piece.left - LIGHT_RADIUS, piece.right + LIGHT_RADIUS
+                                                  }, {0, m_rows, 0, m_columns});
+        int width = window.right - window.left;
+        int height = window.bottom - window.top;
+        light.assign(static_cast<size_t>(width) * height, 0);
+        queue.clear();
+
+        for (int y = 0; y < height; ++y) {
+            const uint8_t *emission = &m_emission[static_cast<size_t>(window.top + y) * m_columns + window.left];
+            for (int x = 0; x < width; ++x) {
+                if (emission[x]) {
+                    uint32_t local = static_cast<uint32_t>(y * width + x);
+                    light[local] = emission[x];
+                    queue.push_back(local);
+                }
+            }
+        }
+
+        // breadth first, a tile is queued again whenever a brighter path reaches it
+        for (size_t head = 0; head < queue.size(); ++head) {
+            uint32_t local = queue[head];
+            int x = static_cast<int>(local % static_cast<uint32_t>(width));
+            int y = static_cast<int>(local / static_cast<uint32_t>(width));
+            int level = light[local];
+            const uint8_t *falloff = &m_falloff[static_cast<size_t>(window.top + y) * m_columns + window.left + x];
+            auto spread = [&](uint32_t neighbour, uint8_t loss) {
+                int reached = level - loss;
+                if (reached > light[neighbour]) {
+                    light[neighbour] = static_cast<uint8_t>(reached);
+                    queue.push_back(neighbour);
+                }
+            };
+            if (x > 0) {
+                spread(local - 1, falloff[-1]);
+            }
+            if (x + 1 < width) {
+                spread(local + 1, falloff[1]);
+            }
+            if (y > 0) {
+                spread(local - width, falloff[-m_columns]);
+            }
+            if (y + 1 < height) {
+                spread(local + width, falloff[m_columns]);
+            }
+        }
+
+        int piece_width = piece.right - piece.left;
+        for (int row = piece.top; row < piece.bottom; ++row) {
+            const uint8_t *source = &light[static_cast<size_t>(row - window.top) * width + piece.left - window.left];
+            std::memcpy(&m_light[static_cast<size_t>(row) * m_columns + piece.left], source, piece_width);
+        }
+    }
+
+    int MELightGrid::Update(MEJobPool &jobs) {
+        if (m_dirty.empty()) {
+            return 0;
+        }
+        ME_TRACE_SCOPE("UpdateLight");
+
+        m_pieces.clear();
+        int relit = 0;
+        for (const auto &dirty: m_dirty) {
+            for (int top = dirty.top; top < dirty.bottom; top += LIGHT_PIECE_SIZE) {
+                for (int left = dirty.left; left < dirty.right; left += LIGHT_PIECE_SIZE) {
+                    m_pieces.push_back({
+                        top, std::min(top + LIGHT_PIECE_SIZE, dirty.bottom),
+                        left, std::min(left + LIGHT_PIECE_SIZE, dirty.right)
+                    });
+                }
+            }
+            relit += (dirty.right - dirty.left) * (dirty.bottom - dirty.top);
+            m_changed = IsEmpty(m_changed) ? dirty : MEStaticLayer::Union(m_changed, dirty);
+        }
+        m_dirty.clear();
+
+        // the pieces don't overlap, every job writes its own tiles
+        jobs.ParallelFor(m_pieces.size(), 1, [this](size_t begin, size_t end) {
+            std::vector<uint8_t> light;
+            std::vector<uint32_t> queue;
+            for (size_t i = begin; i < end; ++i) {
+                RelightPiece(m_pieces[i], light, queue);
+            }
+        });
+        return relit;
+    }
+}
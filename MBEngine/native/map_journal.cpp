@@ -0,0 +1,377 @@
+#include "include/map_journal.h"
+#include "include/trace.h"
+#include "include/alloc_tracker.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <iterator>
+
+namespace MainboardEngine {
+    namespace fs = std::filesystem;
+
+    static const char JOURNAL_MAGIC[4] = {'M', 'B', 'J', 'L'};
+    constexpr uint32_t JOURNAL_VERSION = 1;
+
+    static double ElapsedMs(std::chrono::steady_clock::time_point start) {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    static MEJournalHeader MakeJournalHeader(const MEWorldHeader &base) {
+        MEJournalHeader header = {};
+        std::memcpy(header.magic, JOURNAL_MAGIC, sizeof(JOURNAL_MAGIC));
+        header.version = JOURNAL_VERSION;
+        header.columns = base.columns;
+        header.rows = base.rows;
+        return header;
+    }
+
+    static void ApplyRecord(const uint8_t *record, int columns, int rows, int16_t *tiles) {
+        int16_t id;
+        uint32_t column;
+        uint32_t row;
+        uint32_t width = 1;
+        uint32_t height = 1;
+        std::memcpy(&id, record + 1, sizeof(id));
+        std::memcpy(&column, record + 3, sizeof(column));
+        std::memcpy(&row, record + 7, sizeof(row));
+        if (record[0] == JOURNAL_FILL_RECT) {
+            std::memcpy(&width, record + 11, sizeof(width));
+            std::memcpy(&height, record + 15, sizeof(height));
+        }
+        // the writer clips, a damaged record is clipped again instead of trusted
+        if (column >= static_cast<uint32_t>(columns) || row >= static_cast<uint32_t>(rows)) {
+            return;
+        }
+        uint32_t column_end = static_cast<uint32_t>(std::min<uint64_t>(static_cast<uint64_t>(column) + width, columns));
+        uint32_t row_end = static_cast<uint32_t>(std::min<uint64_t>(static_cast<uint64_t>(row) + height, rows));
+        for (uint32_t y = row; y < row_end; ++y) {
+            int16_t *line = tiles + static_cast<size_t>(y) * columns;
+            std::fill(line + column, line + column_end, id);
+        }
+    }
+
+    // Appends the whole records of the journal at path to records and applies them to tiles when
+    // given. A missing journal has none, a torn record at the end (a crash during a save) is
+    // dropped. False for a journal of another map.
+    static bool ReadJournal(const std::string &path, int columns, int rows, int16_t *tiles,
+                            std::vector<uint8_t> &records, int &count) {
+        std::ifstream file(path, std::ios::binary);
+        if (!file.is_open()) {
+            return true;
+        }
+        std::vector<uint8_t> data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+        MEJournalHeader header = {};
+        if (data.size() < sizeof(header)) {
+            return true;
+        }
+        std::memcpy(&header, data.data(), sizeof(header));
+        if (std::memcmp(header.magic, JOURNAL_MAGIC, sizeof(JOURNAL_MAGIC)) != 0 || header.version != JOURNAL_VERSION ||
+            header.columns != static_cast<uint32_t>(columns) || header.rows != static_cast<uint32_t>(rows)) {
+            return false;
+        }
+
+        size_t offset = sizeof(header);
+        while (offset < data.size()) {
+            size_t size = data[offset] == JOURNAL_SET_TILE ? JOURNAL_SET_TILE_SIZE
+                          : data[offset] == JOURNAL_FILL_RECT ? JOURNAL_FILL_RECT_SIZE
+                          : 0;
+            if (size == 0 || size > data.size() - offset) {
+                break;
+            }
+            if (tiles) {
+                ApplyRecord(data.data() + offset, columns, rows, tiles);
+            }
+            records.insert(records.end(), data.begin() + static_cast<std::ptrdiff_t>(offset),
+                           data.begin() + static_cast<std::ptrdiff_t>(offset + size));
+            ++count;
+            offset += size;
+        }
+        return true;
+    }
+
+    MEMapJournal::MEMapJournal() : m_header(), m_pending_edits(0), m_journal_bytes(0), m_journal_records(0),
+                                   m_compactions(0), m_last_save_ms(0.0), m_base_bytes(0), m_compact_failed(false),
+                                   m_last_compaction_ms(0.0), m_compacting(false), m_result{false, 0.0, 0} {
+    }
+
+    MEMapJournal::~MEMapJournal() {
+        Close();
+    }
+
+    bool MEMapJournal::Open(const char *path, std::vector<int16_t> &tiles) {
+        Close();
+        MEWorldHeader header;
+        if (!ReadWorld(path, header, tiles)) {
+            return false;
+        }
+        int columns = static_cast<int>(header.columns);
+        int rows = static_cast<int>(header.rows);
+        std::vector<uint8_t> records;
+        int count = 0;
+        std::string journal = std::string(path) + ".journal";
+        if (!ReadJournal(journal + ".old", columns, rows, tiles.data(), records, count) ||
+            !ReadJournal(journal, columns, rows, tiles.data(), records, count)) {
+            return false;
+        }
+
+        m_path = path;
+        m_header = header;
+        std::error_code ec;
+        m_base_bytes = fs::file_size(m_path, ec);
+        if (count == 0) {
+            return CreateJournal();
+        }
+        // whatever the last session saved goes into the base right away, its journal starts empty
+        if (!RotateJournal()) {
+            m_journal.close();
+            return false;
+        }
+        Compact(tiles);
+        return true;
+    }
+
+    bool MEMapJournal::Create(const char *path, int tile_width, int tile_height, int columns, int rows,
+                              const int16_t *tiles) {
+        Close();
+        std::string base = path;
+        std::string temp = base + ".tmp";
+        if (!MEWorldWriter::WriteWorld(temp.c_str(), tile_width, tile_height, columns, rows, tiles)) {
+            return false;
+        }
+        std::error_code ec;
+        fs::rename(temp, base, ec);
+        if (ec) {
+            fs::remove(temp, ec);
+            return false;
+        }
+        fs::remove(base + ".journal.old", ec);
+
+        m_path = base;
+        m_header = {};
+        m_header.tile_width = static_cast<uint32_t>(tile_width);
+        m_header.tile_height = static_cast<uint32_t>(tile_height);
+        m_header.columns = static_cast<uint32_t>(columns);
+        m_header.rows = static_cast<uint32_t>(rows);
+        m_header.chunk_size = WORLD_CHUNK_SIZE;
+        m_base_bytes = fs::file_size(m_path, ec);
+        return CreateJournal();
+    }
+
+    void MEMapJournal::Close() {
+        if (!IsOpen()) {
+            return;
+        }
+        Save();
+        WaitCompaction();
+        m_journal.close();
+        m_pending.clear();
+        m_pending_edits = 0;
+        m_journal_bytes = 0;
+        m_journal_records = 0;
+        m_compactions = 0;
+        m_last_save_ms = 0.0;
+        m_last_compaction_ms = 0.0;
+        m_compact_failed = false;
+    }
+
+    bool MEMapJournal::CreateJournal() {
+        m_journal.close();
+        m_journal.clear();
+        m_journal.open(m_path + ".journal", std::ios::binary | std::ios::trunc);
+        MEJournalHeader header = MakeJournalHeader(m_header);
+        m_journal.write(reinterpret_cast<const char *>(&header), sizeof(header));
+        m_journal.flush();
+        m_journal_bytes = 0;
+        m_journal_records = 0;
+        if (!m_journal.good()) {
+            m_journal.close();
+            return false;
+        }
+        return true;
+    }
+
+    bool MEMapJournal::RotateJournal() {
+        std::string journal = m_path + ".journal";
+        std::string old = journal + ".old";
+        m_journal.close();
+        std::error_code ec;
+        if (!fs::exists(old, ec)) {
+            fs::rename(journal, old, ec);
+        } else {
+            // the last compaction didn't finish, its edits are still needed ahead of the new ones
+            std::vector<uint8_t> records;
+            int count = 0;
+            int columns = static_cast<int>(m_header.columns);
+            int rows = static_cast<int>(m_header.rows);
+            std::string temp = old + ".tmp";
+            std::ofstream merged(temp, std::ios::binary | std::ios::trunc);
+            if (!ReadJournal(old, columns, rows, nullptr, records, count) ||
+                !ReadJournal(journal, columns, rows, nullptr, records, count) || !merged.is_open()) {
+                ec = std::make_error_code(std::errc::io_error);
+            } else {
+                MEJournalHeader header = MakeJournalHeader(m_header);
+                merged.write(reinterpret_cast<const char *>(&header), sizeof(header));
+                merged.write(reinterpret_cast<const char *>(records.data()),
+                             static_cast<std::streamsize>(records.size()));
+                merged.close();
+                if (!merged) {
+                    ec = std::make_error_code(std::errc::io_error);
+                } else {
+                    fs::rename(temp, old, ec);
+                }
+            }
+            if (ec) {
+                fs::remove(temp, ec);
+                ec = std::make_error_code(std::errc::io_error);
+            } else {
+                fs::remove(journal, ec);
+            }
+        }
+
+        if (ec) {
+            // keep saving to the journal we have
+            m_journal.clear();
+            m_journal.open(journal, std::ios::binary | std::ios::app);
+            return false;
+        }
+        return CreateJournal();
+    }
+
+    void MEMapJournal::AddRecord(const uint8_t *record, size_t size) {
+        m_pending.insert(m_pending.end(), record, record + size);
+        ++m_pending_edits;
+    }
+
+    void MEMapJournal::SetTile(int column, int row, int id) {
+        uint8_t record[JOURNAL_SET_TILE_SIZE];
+        int16_t tile = static_cast<int16_t>(id < 0 ? -1 : id);
+        uint32_t x = static_cast<uint32_t>(column);
+        uint32_t y = static_cast<uint32_t>(row);
+        record[0] = JOURNAL_SET_TILE;
+        std::memcpy(record + 1, &tile, sizeof(tile));
+        std::memcpy(record + 3, &x, sizeof(x));
+        std::memcpy(record + 7, &y, sizeof(y));
+        AddRecord(record, sizeof(record));
+    }
+
+    void MEMapJournal::FillRect(int column, int row, int width, int height, int id) {
+        uint8_t record[JOURNAL_FILL_RECT_SIZE];
+        int16_t tile = static_cast<int16_t>(id < 0 ? -1 : id);
+        uint32_t fields[4] = {static_cast<uint32_t>(column), static_cast<uint32_t>(row), static_cast<uint32_t>(width),
+                              static_cast<uint32_t>(height)};
+        record[0] = JOURNAL_FILL_RECT;
+        std::memcpy(record + 1, &tile, sizeof(tile));
+        std::memcpy(record + 3, fields, sizeof(fields));
+        AddRecord(record, sizeof(record));
+    }
+
+    bool MEMapJournal::Save() {
+        if (!IsOpen()) {
+            return false;
+        }
+        ReapCompaction();
+        if (m_pending.empty()) {
+            return true;
+        }
+        ME_TRACE_SCOPE("SaveMap");
+        auto start = std::chrono::steady_clock::now();
+        m_journal.write(reinterpret_cast<const char *>(m_pending.data()), static_cast<std::streamsize>(m_pending.size()));
+        m_journal.flush();
+        if (!m_journal.good()) {
+            // a retry writing some records twice is harmless
+            m_journal.clear();
+            return false;
+        }
+        m_journal_bytes += m_pending.size();
+        m_journal_records += m_pending_edits;
+        m_pending.clear();
+        m_pending_edits = 0;
+        m_last_save_ms = ElapsedMs(start);
+        return true;
+    }
+
+    bool MEMapJournal::NeedsCompaction() const {
+        return IsOpen() && !m_compacting.load(std::memory_order_acquire) &&
+               m_journal_bytes >= std::max(JOURNAL_COMPACT_BYTES, m_base_bytes);
+    }
+
+    bool MEMapJournal::Compact(std::vector<int16_t> tiles) {
+        // tiles may hold edits not saved yet, saving first keeps the base a state the journal had
+        if (m_compacting.load(std::memory_order_acquire) || !Save()) {
+            return false;
+        }
+        std::error_code ec;
+        if (m_journal_records > 0 && !RotateJournal()) {
+            return false;
+        }
+        if (!fs::exists(m_path + ".journal.old", ec)) {
+            return true;
+        }
+        m_compacting.store(true, std::memory_order_relaxed);
+        m_compactor = std::thread(&MEMapJournal::CompactLoop, this, std::move(tiles));
+        return true;
+    }
+
+    void MEMapJournal::CompactLoop(std::vector<int16_t> tiles) {
+        ME_ALLOC_SCOPE(ME_ALLOC_RESOURCES);
+        ME_TRACE_SCOPE("CompactMap");
+        auto start = std::chrono::steady_clock::now();
+        std::string temp = m_path + ".tmp";
+        std::error_code ec;
+        bool written = MEWorldWriter::WriteWorld(temp.c_str(), static_cast<int>(m_header.tile_width),
+                                                 static_cast<int>(m_header.tile_height),
+                                                 static_cast<int>(m_header.columns), static_cast<int>(m_header.rows),
+                                                 tiles.data());
+        if (written) {
+            // the new base replaces the old one in one step, .old is only dropped once it did
+            fs::rename(temp, m_path, ec);
+            written = !ec;
+        }
+        if (written) {
+            fs::remove(m_path + ".journal.old", ec);
+            m_result.base_bytes = fs::file_size(m_path, ec);
+        } else {
+            fs::remove(temp, ec);
+        }
+        m_result.ok = written;
+        m_result.ms = ElapsedMs(start);
+        m_compacting.store(false, std::memory_order_release);
+    }
+
+    void MEMapJournal::FinishCompaction() {
+        m_compactor.join();
+        m_last_compaction_ms = m_result.ms;
+        m_compact_failed = !m_result.ok;
+        if (m_result.ok) {
+            m_base_bytes = m_result.base_bytes;
+            ++m_compactions;
+        }
+    }
+
+    void MEMapJournal::ReapCompaction() {
+        if (m_compactor.joinable() && !m_compacting.load(std::memory_order_acquire)) {
+            FinishCompaction();
+        }
+    }
+
+    void MEMapJournal::WaitCompaction() {
+        if (m_compactor.joinable()) {
+            FinishCompaction();
+        }
+    }
+
+    void MEMapJournal::GetStats(ME_MapStats *stats) {
+        ReapCompaction();
+        stats->pending_edits = m_pending_edits;
+        stats->journal_records = m_journal_records;
+        stats->journal_bytes = static_cast<long long>(m_journal_bytes);
+        stats->base_bytes = static_cast<long long>(m_base_bytes);
+        stats->compactions = m_compactions;
+        stats->compacting = m_compacting.load(std::memory_order_acquire) ? 1 : 0;
+        stats->compaction_failed = m_compact_failed ? 1 : 0;
+        stats->last_save_ms = m_last_save_ms;
+        stats->last_compaction_ms = m_last_compaction_ms;
+    }
+}
@@ -0,0 +1,108 @@
+#include "include/mapped_file.h"
+
+#ifdef _WIN32
+#ifndef ME_WINDOWS_H_INCLUDED
+#include <windows.h>
+#define ME_WINDOWS_H_INCLUDED
+#endif
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace MainboardEngine {
+#ifdef _WIN32
+    MEMappedFile::MEMappedFile() : m_data(nullptr), m_size(0), m_file(INVALID_HANDLE_VALUE), m_mapping(nullptr) {
+    }
+
+    bool MEMappedFile::Open(const char *path) {
+        Close();
+
+        m_file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL,
+                             nullptr);
+        if (m_file == INVALID_HANDLE_VALUE) {
+            return false;
+        }
+        LARGE_INTEGER size;
+        if (!GetFileSizeEx(m_file, &size) || size.QuadPart == 0) {
+            Close();
+            return false;
+        }
+        m_mapping = CreateFileMappingA(m_file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (!m_mapping) {
+            Close();
+            return false;
+        }
+        m_data = static_cast<const uint8_t *>(MapViewOfFile(m_mapping, FILE_MAP_READ, 0, 0, 0));
+        if (!m_data) {
+            Close();
+            return false;
+        }
+        m_size = static_cast<size_t>(size.QuadPart);
+
+        return true;
+    }
+
+    void MEMappedFile::Close() {
+        if (m_data) {
+            UnmapViewOfFile(m_data);
+        }
+        if (m_mapping) {
+            CloseHandle(m_mapping);
+        }
+        if (m_file != INVALID_HANDLE_VALUE) {
+            CloseHandle(m_file);
+        }
+        m_data = nullptr;
+        m_size = 0;
+        m_mapping = nullptr;
+        m_file = INVALID_HANDLE_VALUE;
+    }
+#else
+    MEMappedFile::MEMappedFile() : m_data(nullptr), m_size(0), m_file(-1) {
+    }
+
+    bool MEMappedFile::Open(const char *path) {
+        Close();
+
+        m_file = open(path, O_RDONLY);
+        if (m_file < 0) {
+            return false;
+        }
+        struct stat info = {};
+        if (fstat(m_file, &info) != 0 || info.st_size == 0) {
+            Close();
+            return false;
+        }
+        void *data = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_PRIVATE, m_file, 0);
+        if (data == MAP_FAILED) {
+            Close();
+            return false;
+        }
+        // chunks are picked all over the file
+        madvise(data, static_cast<size_t>(info.st_size), MADV_RANDOM);
+        m_data = static_cast<const uint8_t *>(data);
+        m_size = static_cast<size_t>(info.st_size);
+
+        return true;
+    }
+
+    void MEMappedFile::Close() {
+        if (m_data) {
+            munmap(const_cast<uint8_t *>(m_data), m_size);
+        }
+        if (m_file >= 0) {
+            close(m_file);
+        }
+        m_data = nullptr;
+        m_size = 0;
+        m_file = -1;
+    }
+#endif
+
+    MEMappedFile::~MEMappedFile() {
+        Close();
+    }
+}
@@ -0,0 +1,58 @@
+#include "include/occlusion_culler.h"
+
+#include <algorithm>
+
+namespace MainboardEngine {
+    MEOcclusionCuller::MEOcclusionCuller() : m_bounds{0, 0, 0, 0}, m_columns(0), m_rows(0) {
+    }
+
+    void MEOcclusionCuller::Reset(const ME_Rect &bounds) {
+        m_bounds = bounds;
+        m_columns = std::max(0, (bounds.right - bounds.left + OCCLUSION_CELL_SIZE - 1) / OCCLUSION_CELL_SIZE);
+        m_rows = std::max(0, (bounds.bottom - bounds.top + OCCLUSION_CELL_SIZE - 1) / OCCLUSION_CELL_SIZE);
+        m_cells.assign(static_cast<size_t>(m_columns) * m_rows, -1);
+        m_occluders.clear();
+    }
+
+    bool MEOcclusionCuller::IsHidden(const ME_Rect &rect) const {
+        // only the part inside the bounds is drawn
+        int left = std::max(rect.left, m_bounds.left);
+        int top = std::max(rect.top, m_bounds.top);
+        int right = std::min(rect.right, m_bounds.right);
+        int bottom = std::min(rect.bottom, m_bounds.bottom);
+        if (left >= right || top >= bottom) {
+            return false; // culled before it gets here
+        }
+        int column = (left - m_bounds.left) / OCCLUSION_CELL_SIZE;
+        int row = (top - m_bounds.top) / OCCLUSION_CELL_SIZE;
+        for (int i = m_cells[row * m_columns + column]; i >= 0; i = m_occluders[i].next) {
+            const ME_Rect &occluder = m_occluders[i].rect;
+            if (occluder.left <= left && occluder.top <= top && occluder.right >= right &&
+                occluder.bottom >= bottom) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void MEOcclusionCuller::AddOccluder(const ME_Rect &rect) {
+        int left = std::max(rect.left, m_bounds.left);
+        int top = std::max(rect.top, m_bounds.top);
+        int right = std::min(rect.right, m_bounds.right);
+        int bottom = std::min(rect.bottom, m_bounds.bottom);
+        if (left >= right || top >= bottom) {
+            return;
+        }
+        ME_Rect clipped = {top, bottom, left, right};
+        // in every cell it overlaps, a draw's top left corner can be in any of them
+        int column_end = (right - 1 - m_bounds.left) / OCCLUSION_CELL_SIZE;
+        int row_end = (bottom - 1 - m_bounds.top) / OCCLUSION_CELL_SIZE;
+        for (int row = (top - m_bounds.top) / OCCLUSION_CELL_SIZE; row <= row_end; ++row) {
+            for (int column = (left - m_bounds.left) / OCCLUSION_CELL_SIZE; column <= column_end; ++column) {
+                int &head = m_cells[row * m_columns + column];
+                m_occluders.push_back({clipped, head});
+                head = static_cast<int>(m_occluders.size()) - 1;
+            }
+        }
+    }
+}
@@ -0,0 +1,275 @@
+#include "include/particle_system.h"
+#include "include/trace.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define ME_HAS_SSE2
+#endif
+
+namespace MainboardEngine {
+    constexpr float PARTICLE_PI = 3.14159265358979f;
+
+    static void UnpackColor(uint32_t color, float *out) {
+        out[0] = static_cast<float>((color >> 24) & 0xFF) / 255.0f;
+        out[1] = static_cast<float>((color >> 16) & 0xFF) / 255.0f;
+        out[2] = static_cast<float>((color >> 8) & 0xFF) / 255.0f;
+        out[3] = static_cast<float>(color & 0xFF) / 255.0f;
+    }
+
+    MEEmitter::MEEmitter(const ME_EmitterDesc &desc, uint32_t seed) : m_desc(desc), m_color_start{},
+                                                                       m_color_end{}, m_count(0),
+                                                                       m_spawn_debt(0.0f), m_random(seed | 1u) {
+        SetDesc(desc);
+    }
+
+    bool MEEmitter::IsValidDesc(const ME_EmitterDesc &desc) {
+        // written so NaN fails every check
+        return desc.rate >= 0.0f && desc.lifetime_min > 0.0f && desc.lifetime_max >= desc.lifetime_min &&
+               desc.speed_min >= 0.0f && desc.speed_max >= desc.speed_min && desc.drag >= 0.0f &&
+               desc.size_start >= 0.0f && desc.size_end >= 0.0f && desc.width >= 0.0f && desc.height >= 0.0f &&
+               std::isfinite(desc.x) && std::isfinite(desc.y) && std::isfinite(desc.direction) &&
+               std::isfinite(desc.spread) && std::isfinite(desc.gravity_x) && std::isfinite(desc.gravity_y);
+    }
+
+    void MEEmitter::SetDesc(const ME_EmitterDesc &desc) {
+        m_desc = desc;
+        UnpackColor(desc.color_start, m_color_start);
+        UnpackColor(desc.color_end, m_color_end);
+    }
+
+    float MEEmitter::Random() {
+        // xorshift32, [0, 1)
+        m_random ^= m_random << 13;
+        m_random ^= m_random >> 17;
+        m_random ^= m_random << 5;
+        return static_cast<float>(m_random >> 8) * (1.0f / 16777216.0f);
+    }
+
+    int MEEmitter::Spawn(float x, float y, int count) {
+        count = static_cast<int>(std::min<size_t>(static_cast<size_t>(std::max(count, 0)),
+                                                  ME_MAX_PARTICLES - m_count));
+        if (count == 0) {
+            return 0;
+        }
+
+        size_t size = m_count + static_cast<size_t>(count);
+        if (size > m_x.size()) {
+            size_t capacity = std::max<size_t>(std::max<size_t>(m_x.size() * 2, 1024), size);
+            for (auto *array: {&m_x, &m_y, &m_vx, &m_vy, &m_age, &m_rate}) {
+                array->resize(capacity);
+            }
+        }
+
+        float direction = m_desc.direction * (PARTICLE_PI / 180.0f);
+        float spread = m_desc.spread * (PARTICLE_PI / 180.0f);
+        for (size_t i = m_count; i < size; ++i) {
+            float angle = direction + (Random() - 0.5f) * spread;
+            float speed = m_desc.speed_min + (m_desc.speed_max - m_desc.speed_min) * Random();
+            float lifetime = m_desc.lifetime_min + (m_desc.lifetime_max - m_desc.lifetime_min) * Random();
+            m_x[i] = x + (Random() - 0.5f) * m_desc.width;
+            m_y[i] = y + (Random() - 0.5f) * m_desc.height;
+            m_vx[i] = std::cos(angle) * speed;
+            m_vy[i] = std::sin(angle) * speed;
+            m_age[i] = 0.0f;
+            m_rate[i] = 1.0f / lifetime;
+        }
+        m_count = size;
+        return count;
+    }
+
+    void MEEmitter::MoveRange(size_t from, size_t to, size_t count) {
+        for (auto *array: {&m_x, &m_y, &m_vx, &m_vy, &m_age, &m_rate}) {
+            std::memmove(array->data() + to, array->data() + from, count * sizeof(float));
+        }
+    }
+
+    size_t MEEmitter::UpdateRange(size_t begin, size_t end, float dt) {
+        // the velocity is damped first so drag never reverses it, even on long frames
+        float damping = std::max(0.0f, 1.0f - m_desc.drag * dt);
+        float gravity_x = m_desc.gravity_x * dt;
+        float gravity_y = m_desc.gravity_y * dt;
+        float *x = m_x.data();
+        float *y = m_y.data();
+        float *vx = m_vx.data();
+        float *vy = m_vy.data();
+        float *age = m_age.data();
+        const float *rate = m_rate.data();
+
+        size_t dead = 0;
+        size_t i = begin;
+#ifdef ME_HAS_SSE2
+        const __m128 v_dt = _mm_set1_ps(dt);
+        const __m128 v_damping = _mm_set1_ps(damping);
+        const __m128 v_gravity_x = _mm_set1_ps(gravity_x);
+        const __m128 v_gravity_y = _mm_set1_ps(gravity_y);
+        const __m128 v_one = _mm_set1_ps(1.0f);
+        for (; i + 4 <= end; i += 4) {
+            __m128 new_vx = _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(vx + i), v_damping), v_gravity_x);
+            __m128 new_vy = _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(vy + i), v_damping), v_gravity_y);
+            _mm_storeu_ps(vx + i, new_vx);
+            _mm_storeu_ps(vy + i, new_vy);
+            _mm_storeu_ps(x + i, _mm_add_ps(_mm_loadu_ps(x + i), _mm_mul_ps(new_vx, v_dt)));
+            _mm_storeu_ps(y + i, _mm_add_ps(_mm_loadu_ps(y + i), _mm_mul_ps(new_vy, v_dt)));
+            __m128 new_age = _mm_add_ps(_mm_loadu_ps(age + i), _mm_mul_ps(_mm_loadu_ps(rate + i), v_dt));
+            _mm_storeu_ps(age + i, new_age);
+            dead += static_cast<size_t>(_mm_movemask_ps(_mm_cmpge_ps(new_age, v_one)) != 0);
+        }
+#endif
+        for (; i < end; ++i) {
+            vx[i] = vx[i] * damping + gravity_x;
+            vy[i] = vy[i] * damping + gravity_y;
+            x[i] += vx[i] * dt;
+            y[i] += vy[i] * dt;
+            age[i] += rate[i] * dt;
+            dead += static_cast<size_t>(age[i] >= 1.0f);
+        }
+        if (dead == 0) {
+            return end - begin;
+        }
+
+        // dead ones are rare next to live ones, skip to the first and pack the rest behind it
+        size_t write = begin;
+        while (write < end && age[write] < 1.0f) {
+            ++write;
+        }
+        for (size_t read = write + 1; read < end; ++read) {
+            if (age[read] < 1.0f) {
+                x[write] = x[read];
+                y[write] = y[read];
+                vx[write] = vx[read];
+                vy[write] = vy[read];
+                age[write] = age[read];
+                m_rate[write] = rate[read];
+                ++write;
+            }
+        }
+        return write - begin;
+    }
+
+    int MEEmitter::Update(float dt, MEJobPool &jobs) {
+        int spawned = 0;
+        if (m_desc.rate > 0.0f) {
+            m_spawn_debt += m_desc.rate * dt;
+            auto count = static_cast<int>(std::min(m_spawn_debt, static_cast<float>(ME_MAX_PARTICLES)));
+            m_spawn_debt -= static_cast<float>(count);
+            spawned = Spawn(m_desc.x, m_desc.y, count);
+        }
+        if (m_count == 0) {
+            return spawned;
+        }
+
+        if (m_count <= PARTICLE_CHUNK_SIZE) {
+            m_count = UpdateRange(0, m_count, dt);
+            return spawned;
+        }
+
+        // fixed chunks so the live ones of every chunk can be packed together afterwards
+        size_t chunks = (m_count + PARTICLE_CHUNK_SIZE - 1) / PARTICLE_CHUNK_SIZE;
+        m_chunk_live.resize(chunks);
+        size_t count = m_count;
+        jobs.ParallelFor(chunks, 1, [this, count, dt](size_t begin, size_t end) {
+            for (size_t chunk = begin; chunk < end; ++chunk) {
+                size_t first = chunk * PARTICLE_CHUNK_SIZE;
+                m_chunk_live[chunk] = UpdateRange(first, std::min(first + PARTICLE_CHUNK_SIZE, count), dt);
+            }
+        });
+        size_t live = m_chunk_live[0];
+        for (size_t chunk = 1; chunk < chunks; ++chunk) {
+            size_t first = chunk * PARTICLE_CHUNK_SIZE;
+            if (first != live) {
+                MoveRange(first, live, m_chunk_live[chunk]);
+            }
+            live += m_chunk_live[chunk];
+        }
+        m_count = live;
+        return spawned;
+    }
+
+    void MEEmitter::WriteInstances(ParticleInstance *out, size_t begin, size_t end, float scale) const {
+        float size_delta = m_desc.size_end - m_desc.size_start;
+        float color_delta[4];
+        for (int c = 0; c < 4; ++c) {
+            color_delta[c] = m_color_end[c] - m_color_start[c];
+        }
+        for (size_t i = begin; i < end; ++i, ++out) {
+            float t = m_age[i];
+            float size = (m_desc.size_start + size_delta * t) * scale;
+            out->x = m_x[i] * scale - size * 0.5f;
+            out->y = m_y[i] * scale - size * 0.5f;
+            out->width = size;
+            out->height = size;
+            out->r = m_color_start[0] + color_delta[0] * t;
+            out->g = m_color_start[1] + color_delta[1] * t;
+            out->b = m_color_start[2] + color_delta[2] * t;
+            out->a = m_color_start[3] + color_delta[3] * t;
+        }
+    }
+
+    MEParticleSystem::MEParticleSystem() : m_stats{}, m_seed(0x9E3779B9u) {
+    }
+
+    int MEParticleSystem::CreateEmitter(const ME_EmitterDesc &desc) {
+        if (!MEEmitter::IsValidDesc(desc)) {
+            return -1;
+        }
+        for (int i = 0; i < ME_MAX_EMITTERS; ++i) {
+            if (!m_emitters[i]) {
+                // every emitter gets its own sequence, same order of calls gives the same particles
+                m_seed = m_seed * 1664525u + 1013904223u;
+                m_emitters[i] = std::make_unique<MEEmitter>(desc, m_seed);
+                return i;
+            }
+        }
+        return -1;
+    }
+
+    bool MEParticleSystem::UpdateEmitter(int emitter, const ME_EmitterDesc &desc) {
+        if (emitter < 0 || emitter >= ME_MAX_EMITTERS || !m_emitters[emitter] || !MEEmitter::IsValidDesc(desc)) {
+            return false;
+        }
+        m_emitters[emitter]->SetDesc(desc);
+        return true;
+    }
+
+    bool MEParticleSystem::DestroyEmitter(int emitter) {
+        if (emitter < 0 || emitter >= ME_MAX_EMITTERS || !m_emitters[emitter]) {
+            return false;
+        }
+        m_emitters[emitter].reset();
+        return true;
+    }
+
+    bool MEParticleSystem::Emit(int emitter, float x, float y, int count) {
+        if (emitter < 0 || emitter >= ME_MAX_EMITTERS || !m_emitters[emitter] || count < 0) {
+            return false;
+        }
+        m_emitters[emitter]->Spawn(x, y, count);
+        return true;
+    }
+
+    void MEParticleSystem::Update(float dt, MEJobPool &jobs) {
+        ME_TRACE_SCOPE("UpdateParticles");
+        auto start = std::chrono::steady_clock::now();
+        ME_ParticleStats stats = {};
+        stats.thread_count = 1;
+        for (auto &emitter: m_emitters) {
+            if (!emitter) {
+                continue;
+            }
+            if (emitter->Size() > PARTICLE_CHUNK_SIZE) {
+                stats.thread_count = jobs.GetThreadCount();
+            }
+            stats.spawned_count += emitter->Update(dt, jobs);
+            stats.live_count += static_cast<int>(emitter->Size());
+            ++stats.emitter_count;
+        }
+        auto elapsed = std::chrono::steady_clock::now() - start;
+        stats.update_ms = std::chrono::duration<double, std::milli>(elapsed).count();
+        m_stats = stats;
+    }
+}
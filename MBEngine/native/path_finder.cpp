@@ -0,0 +1,537 @@
+#include "include/path_finder.h"
+#include "include/trace.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace MainboardEngine {
+    constexpr float PATH_SQRT2 = 1.41421356f;
+    // the node table is grown once it is this full, in eighths
+    constexpr size_t PATH_TABLE_LOAD = 5;
+    constexpr size_t PATH_TABLE_MIN_SIZE = 1024;
+
+    MENavGrid::MENavGrid() : m_columns(0), m_rows(0), m_stride(1), m_regions_x(0), m_walkable(2, 0),
+                             m_solid_edits(0), m_layout(0) {
+    }
+
+    void MENavGrid::Resize(int columns, int rows) {
+        m_columns = std::max(columns, 0);
+        m_rows = std::max(rows, 0);
+        m_stride = (m_columns + 2 + 63) / 64;
+        m_regions_x = (m_columns + NAV_REGION_SIZE - 1) / NAV_REGION_SIZE;
+        int regions_y = (m_rows + NAV_REGION_SIZE - 1) / NAV_REGION_SIZE;
+        m_region_versions.assign(static_cast<size_t>(m_regions_x) * regions_y, 0);
+        m_solid_edits = 0;
+        ++m_layout;
+        Clear();
+    }
+
+    void MENavGrid::Clear() {
+        m_walkable.assign(static_cast<size_t>(m_rows + 2) * m_stride, 0);
+        for (int row = 0; row < m_rows; ++row) {
+            uint64_t *words = m_walkable.data() + static_cast<size_t>(row + 1) * m_stride;
+            // bits 1 to columns, the border bits around them stay solid
+            for (int x = 1; x <= m_columns; x += 64 - (x & 63)) {
+                int end = std::min(m_columns + 1, (x & ~63) + 64);
+                int count = end - x;
+                uint64_t bits = count == 64 ? ~uint64_t(0) : ((uint64_t(1) << count) - 1) << (x & 63);
+                words[x >> 6] |= bits;
+            }
+        }
+    }
+
+    bool MENavGrid::SetSolid(int column, int row, bool solid) {
+        if (!Contains(column, row)) {
+            return false;
+        }
+        int x = column + 1;
+        uint64_t &word = m_walkable[static_cast<size_t>(row + 1) * m_stride + (x >> 6)];
+        uint64_t bit = uint64_t(1) << (x & 63);
+        if (((word & bit) == 0) == solid) {
+            return false;
+        }
+        if (solid) {
+            word &= ~bit;
+            ++m_region_versions[(row / NAV_REGION_SIZE) * m_regions_x + column / NAV_REGION_SIZE];
+            ++m_solid_edits;
+        } else {
+            word |= bit;
+        }
+        return true;
+    }
+
+    MEPathSearch::MEPathSearch() : m_grid(nullptr), m_goal_column(0), m_goal_row(0), m_diagonal(false),
+                                   m_search(0), m_table(PATH_TABLE_MIN_SIZE, Slot{0, 0}) {
+    }
+
+    static uint32_t HashTile(uint32_t tile, size_t mask) {
+        return static_cast<uint32_t>((tile * 2654435761u) & mask);
+    }
+
+    uint32_t MEPathSearch::GetNode(int column, int row) {
+        uint32_t tile = static_cast<uint32_t>(row) * static_cast<uint32_t>(m_grid->GetColumns()) +
+                        static_cast<uint32_t>(column);
+        size_t mask = m_table.size() - 1;
+        for (uint32_t i = HashTile(tile, mask);; i = static_cast<uint32_t>((i + 1) & mask)) {
+            Slot &slot = m_table[i];
+            if (slot.search != m_search) {
+                slot.search = m_search;
+                slot.node = static_cast<uint32_t>(m_nodes.size());
+                m_nodes.push_back({tile, slot.node, std::numeric_limits<float>::infinity(), false});
+                break;
+            }
+            if (m_nodes[slot.node].tile == tile) {
+                return slot.node;
+            }
+        }
+
+        uint32_t node = static_cast<uint32_t>(m_nodes.size() - 1);
+        if (m_nodes.size() * 8 > m_table.size() * PATH_TABLE_LOAD) {
+            // rehash the nodes of this search into a table twice the size
+            m_table.assign(m_table.size() * 2, Slot{0, 0});
+            mask = m_table.size() - 1;
+            for (uint32_t n = 0; n < m_nodes.size(); ++n) {
+                uint32_t i = HashTile(m_nodes[n].tile, mask);
+                while (m_table[i].search == m_search) {
+                    i = static_cast<uint32_t>((i + 1) & mask);
+                }
+                m_table[i] = {m_search, n};
+            }
+        }
+        return node;
+    }
+
+    float MEPathSearch::Heuristic(int column, int row) const {
+        float dx = static_cast<float>(std::abs(column - m_goal_column));
+        float dy = static_cast<float>(std::abs(row - m_goal_row));
+        if (!m_diagonal) {
+            return dx + dy;
+        }
+        // octile distance, exact on an empty grid
+        return dx + dy + (PATH_SQRT2 - 2.0f) * std::min(dx, dy);
+    }
+
+    void MEPathSearch::Relax(int column, int row, uint32_t parent, float g) {
+        uint32_t index = GetNode(column, row);
+        Node &node = m_nodes[index];
+        if (node.closed || g >= node.g) {
+            return;
+        }
+        node.g = g;
+        node.parent = parent;
+        // the older entry stays in the heap and is skipped once it comes up closed
+        m_open.push_back({g + Heuristic(column, row), index});
+        std::push_heap(m_open.begin(), m_open.end());
+    }
+
+    bool MEPathSearch::JumpStraight(int &column, int &row, int dx, int dy) const {
+        const MENavGrid &grid = *m_grid;
+        while (true) {
+            if (!grid.IsWalkable(column, row)) {
+                return false;
+            }
+            if (column == m_goal_column && row == m_goal_row) {
+                return true;
+            }
+            // a wall beside the line ends, the tile past its end can't be reached any shorter
+            if (dx != 0) {
+                if ((grid.IsWalkable(column, row - 1) && !grid.IsWalkable(column - dx, row - 1)) ||
+                    (grid.IsWalkable(column, row + 1) && !grid.IsWalkable(column - dx, row + 1))) {
+                    return true;
+                }
+            } else if ((grid.IsWalkable(column - 1, row) && !grid.IsWalkable(column - 1, row - dy)) ||
+                       (grid.IsWalkable(column + 1, row) && !grid.IsWalkable(column + 1, row - dy))) {
+                return true;
+            }
+            column += dx;
+            row += dy;
+        }
+    }
+
+    bool MEPathSearch::JumpDiagonal(int &column, int &row, int dx, int dy) const {
+        const MENavGrid &grid = *m_grid;
+        while (true) {
+            if (!grid.IsWalkable(column, row)) {
+                return false;
+            }
+            if (column == m_goal_column && row == m_goal_row) {
+                return true;
+            }
+            int x = column + dx;
+            int y = row;
+            if (JumpStraight(x, y, dx, 0)) {
+                return true;
+            }
+            x = column;
+            y = row + dy;
+            if (JumpStraight(x, y, 0, dy)) {
+                return true;
+            }
+            if (!grid.IsWalkable(column + dx, row) || !grid.IsWalkable(column, row + dy)) {
+                return false;
+            }
+            column += dx;
+            row += dy;
+        }
+    }
+
+    void MEPathSearch::ExpandJumps(uint32_t node, int column, int row) {
+        const MENavGrid &grid = *m_grid;
+        int directions[8][2];
+        int count = 0;
+        auto add = [&](int dx, int dy) {
+            directions[count][0] = dx;
+            directions[count][1] = dy;
+            ++count;
+        };
+
+        uint32_t parent = m_nodes[node].parent;
+        if (parent == node) {
+            for (int dy = -1; dy <= 1; ++dy) {
+                for (int dx = -1; dx <= 1; ++dx) {
+                    if ((dx != 0 || dy != 0) &&
+                        (dx == 0 || dy == 0 ||
+                         (grid.IsWalkable(column + dx, row) && grid.IsWalkable(column, row + dy)))) {
+                        add(dx, dy);
+                    }
+                }
+            }
+        } else {
+            // only the neighbours no shorter path reaches without passing this tile
+            int columns = grid.GetColumns();
+            int parent_column = static_cast<int>(m_nodes[parent].tile % static_cast<uint32_t>(columns));
+            int parent_row = static_cast<int>(m_nodes[parent].tile / static_cast<uint32_t>(columns));
+            int dx = (column > parent_column) - (column < parent_column);
+            int dy = (row > parent_row) - (row < parent_row);
+            if (dx != 0 && dy != 0) {
+                bool horizontal = grid.IsWalkable(column + dx, row);
+                bool vertical = grid.IsWalkable(column, row + dy);
+                if (vertical) {
+                    add(0, dy);
+                }
+                if (horizontal) {
+                    add(dx, 0);
+                }
+                if (horizontal && vertical) {
+                    add(dx, dy);
+                }
+            } else if (dx != 0) {
+                bool up = grid.IsWalkable(column, row - 1);
+                bool down = grid.IsWalkable(column, row + 1);
+                if (grid.IsWalkable(column + dx, row)) {
+                    add(dx, 0);
+                    if (up) {
+                        add(dx, -1);
+                    }
+                    if (down) {
+                        add(dx, 1);
+                    }
+                }
+                if (up) {
+                    add(0, -1);
+                }
+                if (down) {
+                    add(0, 1);
+                }
+            } else {
+                bool left = grid.IsWalkable(column - 1, row);
+                bool right = grid.IsWalkable(column + 1, row);
+                if (grid.IsWalkable(column, row + dy)) {
+                    add(0, dy);
+                    if (left) {
+                        add(-1, dy);
+                    }
+                    if (right) {
+                        add(1, dy);
+                    }
+                }
+                if (left) {
+                    add(-1, 0);
+                }
+                if (right) {
+                    add(1, 0);
+                }
+            }
+        }
+
+        float g = m_nodes[node].g;
+        for (int i = 0; i < count; ++i) {
+            int dx = directions[i][0];
+            int dy = directions[i][1];
+            int x = column + dx;
+            int y = row + dy;
+            bool found = dx != 0 && dy != 0 ? JumpDiagonal(x, y, dx, dy) : JumpStraight(x, y, dx, dy);
+            if (found) {
+                int steps = std::max(std::abs(x - column), std::abs(y - row));
+                Relax(x, y, node, g + static_cast<float>(steps) * (dx != 0 && dy != 0 ? PATH_SQRT2 : 1.0f));
+            }
+        }
+    }
+
+    void MEPathSearch::BuildPath(uint32_t goal, MEPath &path) {
+        m_chain.clear();
+        for (uint32_t node = goal;; node = m_nodes[node].parent) {
+            m_chain.push_back(m_nodes[node].tile);
+            if (m_nodes[node].parent == node) {
+                break;
+            }
+        }
+
+        // jump points are joined by straight or diagonal runs, fill in the tiles between them
+        auto columns = static_cast<uint32_t>(m_grid->GetColumns());
+        int column = static_cast<int>(m_chain.back() % columns);
+        int row = static_cast<int>(m_chain.back() / columns);
+        path.tiles.push_back({column, row});
+        for (size_t i = m_chain.size() - 1; i-- > 0;) {
+            int to_column = static_cast<int>(m_chain[i] % columns);
+            int to_row = static_cast<int>(m_chain[i] / columns);
+            int dx = (to_column > column) - (to_column < column);
+            int dy = (to_row > row) - (to_row < row);
+            while (column != to_column || row != to_row) {
+                column += dx;
+                row += dy;
+                path.tiles.push_back({column, row});
+            }
+        }
+        path.cost = m_nodes[goal].g;
+    }
+
+    void MEPathSearch::Find(const MENavGrid &grid, const ME_PathRequest &request, MEPath &path) {
+        path.tiles.clear();
+        path.cost = 0.0f;
+        path.expanded = 0;
+        if (!grid.Contains(request.start_column, request.start_row) ||
+            !grid.Contains(request.goal_column, request.goal_row) ||
+            !grid.IsWalkable(request.start_column, request.start_row) ||
+            !grid.IsWalkable(request.goal_column, request.goal_row)) {
+            path.status = ME_PATH_INVALID;
+            return;
+        }
+
+        m_grid = &grid;
+        m_goal_column = request.goal_column;
+        m_goal_row = request.goal_row;
+        m_diagonal = (request.flags & ME_PATH_DIAGONAL) != 0;
+        if (++m_search == 0) {
+            // wrapped, stamps of four billion searches ago would look current
+            std::fill(m_table.begin(), m_table.end(), Slot{0, 0});
+            m_search = 1;
+        }
+        m_nodes.clear();
+        m_open.clear();
+
+        uint32_t start = GetNode(request.start_column, request.start_row);
+        m_nodes[start].g = 0.0f;
+        m_open.push_back({Heuristic(request.start_column, request.start_row), start});
+
+        auto columns = static_cast<uint32_t>(grid.GetColumns());
+        uint32_t goal_tile = static_cast<uint32_t>(m_goal_row) * columns + static_cast<uint32_t>(m_goal_column);
+        while (!m_open.empty()) {
+            std::pop_heap(m_open.begin(), m_open.end());
+            uint32_t node = m_open.back().node;
+            m_open.pop_back();
+            if (m_nodes[node].closed) {
+                continue;
+            }
+            m_nodes[node].closed = true;
+            if (m_nodes[node].tile == goal_tile) {
+                BuildPath(node, path);
+                path.status = ME_PATH_FOUND;
+                return;
+            }
+            if (request.max_expanded > 0 && path.expanded >= request.max_expanded) {
+                break;
+            }
+            ++path.expanded;
+
+            int column = static_cast<int>(m_nodes[node].tile % columns);
+            int row = static_cast<int>(m_nodes[node].tile / columns);
+            if (m_diagonal) {
+                ExpandJumps(node, column, row);
+                continue;
+            }
+            float g = m_nodes[node].g + 1.0f;
+            static const int NEIGHBOURS[4][2] = {{1, 0}, {-1, 0}, {0, 1}, {0, -1}};
+            for (auto &neighbour: NEIGHBOURS) {
+                int x = column + neighbour[0];
+                int y = row + neighbour[1];
+                if (grid.IsWalkable(x, y)) {
+                    Relax(x, y, node, g);
+                }
+            }
+        }
+        path.status = ME_PATH_NONE;
+    }
+
+    MEPathFinder::MEPathFinder(int workers) : m_worker_count(workers), m_stop(false) {
+        if (m_worker_count <= 0) {
+            m_worker_count = std::max(1, static_cast<int>(std::thread::hardware_concurrency()) - 1);
+        }
+    }
+
+    MEPathFinder::~MEPathFinder() {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stop = true;
+            m_queue.clear();
+        }
+        m_wake.notify_all();
+        for (auto &worker: m_workers) {
+            worker.join();
+        }
+    }
+
+    void MEPathFinder::Resize(int columns, int rows) {
+        m_grid.Resize(columns, rows);
+        m_snapshot.reset();
+    }
+
+    void MEPathFinder::Clear() {
+        m_grid.Clear();
+        m_snapshot.reset();
+    }
+
+    void MEPathFinder::SetSolid(int column, int row, bool solid) {
+        if (m_grid.SetSolid(column, row, solid)) {
+            m_snapshot.reset();
+        }
+    }
+
+    int MEPathFinder::Submit(const ME_PathRequest *requests, int count) {
+        if (!m_snapshot) {
+            ME_TRACE_SCOPE("SnapshotNavGrid");
+            m_snapshot = std::make_shared<const MENavGrid>(m_grid);
+        }
+        auto batch = std::make_shared<Batch>();
+        batch->grid = m_snapshot;
+        batch->requests.assign(requests, requests + count);
+        batch->paths.resize(count);
+        for (auto &path: batch->paths) {
+            path.status = ME_PATH_PENDING;
+            path.checked_edits = m_grid.GetSolidEdits();
+        }
+        batch->next = 0;
+        batch->remaining = static_cast<size_t>(count);
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto free = std::find(m_batches.begin(), m_batches.end(), nullptr);
+        int id = static_cast<int>(free - m_batches.begin());
+        if (free == m_batches.end()) {
+            m_batches.push_back(batch);
+        } else {
+            *free = batch;
+        }
+        if (count > 0) {
+            m_queue.push_back(std::move(batch));
+            if (m_workers.empty()) {
+                for (int i = 0; i < m_worker_count; ++i) {
+                    m_workers.emplace_back(&MEPathFinder::WorkerLoop, this);
+                }
+            }
+            m_wake.notify_all();
+        }
+        return id;
+    }
+
+    void MEPathFinder::WorkerLoop() {
+        MEPathSearch search;
+        std::unique_lock<std::mutex> lock(m_mutex);
+        while (true) {
+            m_wake.wait(lock, [this] { return m_stop || !m_queue.empty(); });
+            if (m_stop) {
+                return;
+            }
+            std::shared_ptr<Batch> batch = m_queue.front();
+            size_t index = batch->next++;
+            if (batch->next == batch->requests.size()) {
+                m_queue.pop_front();
+            }
+            lock.unlock();
+
+            MEPath &path = batch->paths[index];
+            {
+                ME_TRACE_SCOPE("FindPath");
+                search.Find(*batch->grid, batch->requests[index], path);
+            }
+
+            lock.lock();
+            path.solved = true;
+            if (--batch->remaining == 0) {
+                m_solved.notify_all();
+            }
+        }
+    }
+
+    bool MEPathFinder::Wait(int batch) {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        if (batch < 0 || batch >= static_cast<int>(m_batches.size()) || !m_batches[batch]) {
+            return false;
+        }
+        std::shared_ptr<Batch> waited = m_batches[batch];
+        m_solved.wait(lock, [&waited] { return waited->remaining == 0; });
+        return true;
+    }
+
+    void MEPathFinder::CheckPath(const Batch &batch, MEPath &path) const {
+        if (path.status != ME_PATH_FOUND) {
+            return;
+        }
+        if (batch.grid->GetLayout() != m_grid.GetLayout()) {
+            path.status = ME_PATH_BLOCKED;
+            return;
+        }
+        if (path.checked_edits == m_grid.GetSolidEdits()) {
+            return;
+        }
+        path.checked_edits = m_grid.GetSolidEdits();
+        for (auto &tile: path.tiles) {
+            if (m_grid.GetRegionVersion(tile.column, tile.row) != batch.grid->GetRegionVersion(tile.column, tile.row) &&
+                !m_grid.IsWalkable(tile.column, tile.row)) {
+                path.status = ME_PATH_BLOCKED;
+                return;
+            }
+        }
+    }
+
+    int MEPathFinder::GetResults(int batch, ME_PathResult *results, ME_TileCoord *tiles, int capacity) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (batch < 0 || batch >= static_cast<int>(m_batches.size()) || !m_batches[batch]) {
+            return -1;
+        }
+        Batch &solved = *m_batches[batch];
+        int total = 0;
+        int written = 0;
+        for (size_t i = 0; i < solved.paths.size(); ++i) {
+            MEPath &path = solved.paths[i];
+            ME_PathResult &result = results[i];
+            result = {ME_PATH_PENDING, 0, -1, 0, 0.0f};
+            if (!path.solved) {
+                continue;
+            }
+            CheckPath(solved, path);
+            result.status = path.status;
+            result.expanded = path.expanded;
+            result.cost = path.cost;
+            result.length = static_cast<int>(path.tiles.size());
+            if (result.length > 0 && result.length <= capacity - written) {
+                result.offset = written;
+                std::copy(path.tiles.begin(), path.tiles.end(), tiles + written);
+                written += result.length;
+            }
+            total += result.length;
+        }
+        return total;
+    }
+
+    bool MEPathFinder::Release(int batch) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (batch < 0 || batch >= static_cast<int>(m_batches.size()) || !m_batches[batch]) {
+            return false;
+        }
+        // workers still holding one of its requests finish it into the void
+        m_queue.erase(std::remove(m_queue.begin(), m_queue.end(), m_batches[batch]), m_queue.end());
+        m_batches[batch].reset();
+        return true;
+    }
+}
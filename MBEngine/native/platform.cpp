@@ -4,20 +4,51 @@
 #include <string>
 #include <fstream>
 #include <iostream>
+#include <algorithm>
+#include <array>
+#include <climits>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <future>
+#include <numeric>
 // #include <direct.h>
 
 #include  "include/event_message_type.h"
+#include "include/texture_loader.h"
+#include "include/trace.h"
+#include "include/call_recorder.h"
+#include "include/alloc_tracker.h"
+#include "include/run_loop.h"
 
 extern "C" {
 namespace ME = MainboardEngine;
 
 static std::unique_ptr<ME::MEPlatform> g_platform;
+static ME::MEHeadlessPlatform g_headless_platform; // ME_RENDERER_SOFTWARE windows, whatever the OS
 static std::unique_ptr<ME::MEEngine> g_engine;
+static int g_renderer_type = ME_RENDERER_AUTO;
+static std::chrono::steady_clock::time_point g_initialize_time; // start of ME_StartupStats
+static bool g_loop_stop = false;
+static ME_LoopStats g_loop_stats = {};
+
+ME_API int ME_GetVersion() {
+    return ME_VERSION;
+}
 
 ME_API ME_BOOL ME_Initialize() {
+    ME_ALLOC_SCOPE(ME_ALLOC_PLATFORM);
+    ME::RecordCall(ME::RECORD_INITIALIZE);
     if (g_platform) {
         return ME_TRUE;
     }
+    g_initialize_time = std::chrono::steady_clock::now();
+    if (g_renderer_type == ME_RENDERER_SOFTWARE) {
+        // no window system needed, e.g. tests on a machine without a display. The native platform
+        // starts on a later call once another renderer is chosen
+        return g_headless_platform.Initialize();
+    }
 
 #if defined(_WIN32)
     g_platform = std::make_unique<MainboardEngine::Win32Platform>();
@@ -32,26 +63,218 @@ ME_API ME_BOOL ME_Initialize() {
 
 ME_API ME_HANDLE ME_CreateWindow(
     int is_full_screen, int x, int y, int width, int height, const char *title) {
+    ME_ALLOC_SCOPE(ME_ALLOC_PLATFORM);
     ME::MEWindow *window = nullptr;
-    bool state = g_platform->CreateWindow(is_full_screen, x, y, width, height, title, window);
+    // the software renderer needs no display, the native platform isn't asked for a window
+    ME::MEPlatform *platform = g_renderer_type == ME_RENDERER_SOFTWARE ? &g_headless_platform : g_platform.get();
+    bool state = platform && platform->CreateWindow(is_full_screen, x, y, width, height, title, window);
     if (!state) {
-        return nullptr;
+        window = nullptr;
+    }
+    if (ME::g_record_enabled.load(std::memory_order_relaxed)) {
+        ME::RecordCall(ME::RECORD_CREATE_WINDOW, is_full_screen, x, y, width, height, ME::MERecordString{title});
+        ME::RecordWindow(window);
     }
 
     return window;
 }
 
 ME_API ME_MESSAGE_TYPE ME_ProcessEvents(ME_HANDLE handle) {
+    ME_TRACE_SCOPE("ProcessEvents");
+    ME_ALLOC_SCOPE(ME_ALLOC_PLATFORM);
+    ME::RecordCall(ME::RECORD_PROCESS_EVENTS, ME::MERecordHandle{handle});
     auto *window = static_cast<ME::MEWindow *>(handle);
+    if (g_engine) {
+        g_engine->OnProcessEvents();
+    }
+    if (!g_platform || (window && !window->GetMEWindowHandle())) {
+        return g_headless_platform.ProcessEvents(window);
+    }
     return g_platform->ProcessEvents(window);
 }
 
 ME_API ME_BOOL ME_RenderBlock(int block_id, int x, int y) {
+    ME_ALLOC_SCOPE(ME_ALLOC_RENDER);
+    ME::RecordCall(ME::RECORD_RENDER_BLOCK, block_id, x, y);
     return g_engine->RenderBlock(block_id, x, y);
 }
 
+ME_API int ME_RenderBlocks(const int *block_ids, const int *xs, const int *ys, int count) {
+    ME_ALLOC_SCOPE(ME_ALLOC_RENDER);
+    ME::RecordCall(ME::RECORD_RENDER_BLOCKS, ME::MERecordArray<int>{block_ids, count}, ME::MERecordArray<int>{xs, count},
+                   ME::MERecordArray<int>{ys, count});
+    if (count < 0 || ((!block_ids || !xs || !ys) && count > 0)) {
+        return -1;
+    }
+    if (!g_engine) {
+        return 0;
+    }
+    int rendered = 0;
+    for (int i = 0; i < count; ++i) {
+        rendered += g_engine->RenderBlock(block_ids[i], xs[i], ys[i]) ? 1 : 0;
+    }
+    return rendered;
+}
+
+ME_API ME_BOOL ME_RenderBlockEx(int block_id, int x, int y, unsigned int tint, int orientation) {
+    ME_ALLOC_SCOPE(ME_ALLOC_RENDER);
+    ME::RecordCall(ME::RECORD_RENDER_BLOCK_EX, block_id, x, y, tint, orientation);
+    if (!g_engine) {
+        return ME_FALSE;
+    }
+    return g_engine->RenderBlock(block_id, x, y, tint, orientation);
+}
+
+ME_API int ME_RenderBlocksEx(const int *block_ids, const int *xs, const int *ys, const unsigned int *tints,
+                             const int *orientations, int count) {
+    ME_ALLOC_SCOPE(ME_ALLOC_RENDER);
+    ME::RecordCall(ME::RECORD_RENDER_BLOCKS_EX, ME::MERecordArray<int>{block_ids, count},
+                   ME::MERecordArray<int>{xs, count}, ME::MERecordArray<int>{ys, count},
+                   ME::MERecordArray<unsigned int>{tints, count}, ME::MERecordArray<int>{orientations, count});
+    if (count < 0 || ((!block_ids || !xs || !ys) && count > 0)) {
+        return -1;
+    }
+    if (!g_engine) {
+        return 0;
+    }
+    int rendered = 0;
+    for (int i = 0; i < count; ++i) {
+        rendered += g_engine->RenderBlock(block_ids[i], xs[i], ys[i], tints ? tints[i] : ME_TINT_NONE,
+                                          orientations ? orientations[i] : ME_ORIENT_NONE) ? 1 : 0;
+    }
+    return rendered;
+}
+
 ME_API int ME_RenderFrame(ME_HANDLE handle) {
-    return g_engine->Render();
+    ME_ALLOC_SCOPE(ME_ALLOC_RENDER);
+    ME::RecordCall(ME::RECORD_RENDER_FRAME, ME::MERecordHandle{handle});
+    return g_engine->RenderFrame();
+}
+
+ME_API ME_BOOL ME_BeginFrame(ME_HANDLE handle) {
+    ME::RecordCall(ME::RECORD_BEGIN_FRAME, ME::MERecordHandle{handle});
+    if (!g_engine) {
+        return ME_FALSE;
+    }
+    return g_engine->BeginFrame();
+}
+
+ME_API int ME_EndFrame(ME_HANDLE handle) {
+    ME_ALLOC_SCOPE(ME_ALLOC_RENDER);
+    ME::RecordCall(ME::RECORD_END_FRAME, ME::MERecordHandle{handle});
+    if (!g_engine) {
+        return 0;
+    }
+    return g_engine->EndFrame();
+}
+
+ME_API ME_MESSAGE_TYPE ME_RunLoop(ME_HANDLE handle, const ME_LoopDesc *desc) {
+    if (desc) {
+        // the callbacks are the caller's code, the events and frames they run are recorded on their own
+        ME::RecordCall(ME::RECORD_RUN_LOOP, ME::MERecordHandle{handle}, desc->tick_rate, desc->max_ticks_per_frame,
+                       desc->frame_rate);
+    }
+    if (!g_engine || !handle || !desc || !ME::MEFixedStep::IsValidDesc(*desc)) {
+        return -1;
+    }
+    ME::METimerResolution resolution;
+    ME::MEFixedStep step(*desc);
+    g_loop_stop = false;
+    g_loop_stats = {};
+    step.Start(ME::MEFixedStep::Clock::now());
+    ME_MESSAGE_TYPE message = 0;
+    while (!g_loop_stop) {
+        message = ME_ProcessEvents(handle);
+        if (message == ME_QUIT_MESSAGE) {
+            break;
+        }
+
+        int dropped = 0;
+        int ticks = step.Advance(ME::MEFixedStep::Clock::now(), dropped);
+        for (int i = 0; i < ticks && desc->update; ++i) {
+            ME_TRACE_SCOPE("LoopTick");
+            desc->update(step.GetTickSeconds(), desc->user_data);
+        }
+        g_loop_stats.tick_count += ticks;
+        g_loop_stats.dropped_ticks += dropped;
+        g_loop_stats.alpha = step.GetAlpha();
+        // a render callback that still calls ME_RenderFrame doesn't present twice
+        ME_BeginFrame(handle);
+        if (desc->render) {
+            desc->render(g_loop_stats.alpha, desc->user_data);
+        }
+        if (!ME_EndFrame(handle)) {
+            return -1;
+        }
+        ++g_loop_stats.frame_count;
+
+        auto waited = ME::SleepUntil(step.NextFrame(ME::MEFixedStep::Clock::now()));
+        g_loop_stats.sleep_ms += std::chrono::duration<double, std::milli>(waited).count();
+    }
+    return message;
+}
+
+ME_API ME_BOOL ME_StopLoop() {
+    g_loop_stop = true;
+    return ME_TRUE;
+}
+
+ME_API ME_BOOL ME_GetLoopStats(ME_LoopStats *stats) {
+    if (!stats) {
+        return ME_FALSE;
+    }
+    *stats = g_loop_stats;
+    return ME_TRUE;
+}
+
+ME_API ME_BOOL ME_ReadFramePixels(unsigned char *rgba, int capacity, int *width, int *height) {
+    if (!g_engine) {
+        return ME_FALSE;
+    }
+    return g_engine->ReadFramePixels(rgba, capacity, width, height);
+}
+
+ME_API ME_BOOL ME_SaveFramePng(const char *path) {
+    ME::RecordCall(ME::RECORD_SAVE_FRAME_PNG, ME::MERecordString{path});
+    if (!g_engine || !path) {
+        return ME_FALSE;
+    }
+    return g_engine->SaveFramePng(path);
+}
+
+ME_API ME_BOOL ME_GetFrameStats(ME_FrameStats *stats) {
+    if (!g_engine || !stats) {
+        return ME_FALSE;
+    }
+    g_engine->GetFrameStats(stats);
+    return ME_TRUE;
+}
+
+ME_API ME_BOOL ME_GetAllocStats(ME_AllocStats *stats) {
+    if (!stats) {
+        return ME_FALSE;
+    }
+    MainboardEngine::GetAllocStats(stats);
+    return ME_TRUE;
+}
+
+ME_API ME_BOOL ME_ResetAllocStats() {
+    MainboardEngine::ResetAllocStats();
+    return ME_TRUE;
+}
+
+ME_API ME_BOOL ME_TraceStart() {
+    MainboardEngine::ResetTrace();
+    MainboardEngine::g_trace_enabled.store(true, std::memory_order_release);
+    return ME_TRUE;
+}
+
+ME_API ME_BOOL ME_TraceStop(const char *path) {
+    MainboardEngine::StopTrace();
+    if (!path) {
+        return ME_TRUE;
+    }
+    return MainboardEngine::WriteTrace(path);
 }
 
 ME_API ME_BOOL ME_ClearView(ME_HANDLE handle) {
@@ -59,6 +282,11 @@ ME_API ME_BOOL ME_ClearView(ME_HANDLE handle) {
 }
 
 ME_API ME_BOOL ME_DestroyWindow(ME_HANDLE handle) {
+    ME_ALLOC_SCOPE(ME_ALLOC_PLATFORM);
+    if (ME::g_record_enabled.load(std::memory_order_relaxed)) {
+        ME::RecordCall(ME::RECORD_DESTROY_WINDOW, ME::MERecordHandle{handle});
+        ME::ForgetWindow(handle);
+    }
     auto *windows = static_cast<ME::MEWindow *>(handle);
     delete windows; // MEWindow has developer defined deconstructor function
     return ME_TRUE;
@@ -70,266 +298,3254 @@ ME_API ME_HANDLE ME_GetMEWindowHandle(ME_HANDLE handle) {
 }
 
 ME_API ME_BOOL ME_SetWindowSize(ME_HANDLE handle, int width, int height) {
+    ME::RecordCall(ME::RECORD_SET_WINDOW_SIZE, ME::MERecordHandle{handle}, width, height);
     auto *window = static_cast<ME::MEWindow *>(handle);
     return window->SetSize(width, height);
 }
 
-ME_API int ME_GetWindowSize(ME_HANDLE handle, ME_Rect *rect) {
-    auto *window = static_cast<ME::MEWindow *>(handle);
-    *rect = window->GetSize();
+ME_API int ME_GetWindowSize(ME_HANDLE handle, ME_Rect *rect) {
+    auto *window = static_cast<ME::MEWindow *>(handle);
+    *rect = window->GetSize();
+
+    return ME_TRUE;
+}
+
+ME_API ME_BOOL ME_SetWindowTitle(ME_HANDLE handle, const char *title) {
+    ME::RecordCall(ME::RECORD_SET_WINDOW_TITLE, ME::MERecordHandle{handle}, ME::MERecordString{title});
+    auto *window = static_cast<ME::MEWindow *>(handle);
+    return window->SetTitle(title);
+}
+
+ME_API ME_BOOL ME_LoadBlock(int id, const char *path) {
+    ME_ALLOC_SCOPE(ME_ALLOC_RESOURCES);
+    ME::RecordCall(ME::RECORD_LOAD_BLOCK, id, ME::MERecordString{path});
+    return MainboardEngine::MEEngine::RegistryBlock(id, path);
+}
+
+ME_API ME_BOOL ME_LoadBlockAsync(int id, const char *path, const ME_BlockDesc *desc) {
+    ME_ALLOC_SCOPE(ME_ALLOC_RESOURCES);
+    ME_BlockDesc block_desc = {1, 0, ME_BLOCK_FLAG_NONE};
+    if (desc) {
+        block_desc = *desc;
+    }
+    ME::RecordCall(ME::RECORD_LOAD_BLOCK_ASYNC, id, ME::MERecordString{path}, block_desc);
+    if (!g_engine || !path) {
+        return ME_FALSE;
+    }
+    return g_engine->LoadBlockAsync(id, path, block_desc);
+}
+
+ME_API ME_BOOL ME_RegisterBlockVariant(int id, int base_id, unsigned int tint, int orientation) {
+    ME_ALLOC_SCOPE(ME_ALLOC_RESOURCES);
+    ME::RecordCall(ME::RECORD_REGISTER_BLOCK_VARIANT, id, base_id, tint, orientation);
+    if (!g_engine) {
+        return ME_FALSE;
+    }
+    return g_engine->RegisterBlockVariant(id, base_id, tint, orientation);
+}
+
+ME_API ME_BOOL ME_GetStartupStats(ME_StartupStats *stats) {
+    if (!g_engine || !stats) {
+        return ME_FALSE;
+    }
+    g_engine->GetStartupStats(stats);
+    return ME_TRUE;
+}
+
+ME_API ME_BOOL ME_LoadBlockEx(int id, const char *path, const ME_BlockDesc *desc) {
+    ME_ALLOC_SCOPE(ME_ALLOC_RESOURCES);
+    if (!desc) {
+        ME::RecordCall(ME::RECORD_LOAD_BLOCK, id, ME::MERecordString{path});
+        return MainboardEngine::MEEngine::RegistryBlock(id, path);
+    }
+    ME::RecordCall(ME::RECORD_LOAD_BLOCK_EX, id, ME::MERecordString{path}, *desc);
+    return MainboardEngine::MEEngine::RegistryBlock(id, path, *desc);
+}
+
+
+ME_API ME_BOOL ME_CookBlockTexture(const char *path, const char *format, int flags) {
+    ME_ALLOC_SCOPE(ME_ALLOC_RESOURCES);
+    ME::RecordCall(ME::RECORD_COOK_BLOCK_TEXTURE, ME::MERecordString{path}, ME::MERecordString{format}, flags);
+    return MainboardEngine::MEEngine::CookBlockTexture(path, format, flags);
+}
+
+ME_API ME_BOOL ME_SetRenderScale(float scale) {
+    ME::RecordCall(ME::RECORD_SET_RENDER_SCALE, scale);
+    if (!g_engine || scale <= 0.0f) {
+        return ME_FALSE;
+    }
+    g_engine->SetRenderScale(scale);
+    return ME_TRUE;
+}
+
+ME_API ME_BOOL ME_SetStaticLayer(int tile_width, int tile_height, int columns, int rows) {
+    ME_ALLOC_SCOPE(ME_ALLOC_RESOURCES);
+    ME::RecordCall(ME::RECORD_SET_STATIC_LAYER, tile_width, tile_height, columns, rows);
+    if (!g_engine) {
+        return ME_FALSE;
+    }
+    return g_engine->SetStaticLayer(tile_width, tile_height, columns, rows);
+}
+
+ME_API ME_BOOL ME_SetStaticTile(int column, int row, int block_id) {
+    ME_ALLOC_SCOPE(ME_ALLOC_RESOURCES);
+    ME::RecordCall(ME::RECORD_SET_STATIC_TILE, column, row, block_id);
+    if (!g_engine) {
+        return ME_FALSE;
+    }
+    return g_engine->SetStaticTile(column, row, block_id);
+}
+
+ME_API int ME_CreateView(const ME_ViewDesc *desc) {
+    ME_ALLOC_SCOPE(ME_ALLOC_RESOURCES);
+    if (!desc) {
+        return -1;
+    }
+    ME::RecordCall(ME::RECORD_CREATE_VIEW, *desc);
+    if (!g_engine) {
+        return -1;
+    }
+    return g_engine->CreateView(*desc);
+}
+
+ME_API ME_BOOL ME_UpdateView(int view, const ME_ViewDesc *desc) {
+    ME_ALLOC_SCOPE(ME_ALLOC_RESOURCES);
+    if (!desc) {
+        return ME_FALSE;
+    }
+    ME::RecordCall(ME::RECORD_UPDATE_VIEW, view, *desc);
+    if (!g_engine) {
+        return ME_FALSE;
+    }
+    return g_engine->UpdateView(view, *desc);
+}
+
+ME_API ME_BOOL ME_DestroyView(int view) {
+    ME::RecordCall(ME::RECORD_DESTROY_VIEW, view);
+    if (!g_engine) {
+        return ME_FALSE;
+    }
+    return g_engine->DestroyView(view);
+}
+
+ME_API ME_BOOL ME_SetViewLayers(int view, int layer_mask) {
+    ME::RecordCall(ME::RECORD_SET_VIEW_LAYERS, view, layer_mask);
+    if (!g_engine) {
+        return ME_FALSE;
+    }
+    return g_engine->SetViewLayers(view, layer_mask);
+}
+
+ME_API ME_BOOL ME_LoadFont(int font_id, const char *ttf_path, float pixel_height, int flags) {
+    ME_ALLOC_SCOPE(ME_ALLOC_RESOURCES);
+    ME::RecordCall(ME::RECORD_LOAD_FONT, font_id, ME::MERecordString{ttf_path}, pixel_height, flags);
+    if (!g_engine || !ttf_path) {
+        return ME_FALSE;
+    }
+    return g_engine->LoadFont(font_id, ttf_path, pixel_height, flags);
+}
+
+ME_API ME_BOOL ME_UnloadFont(int font_id) {
+    ME::RecordCall(ME::RECORD_UNLOAD_FONT, font_id);
+    if (!g_engine) {
+        return ME_FALSE;
+    }
+    return g_engine->UnloadFont(font_id);
+}
+
+ME_API ME_BOOL ME_DrawText(int font_id, int x, int y, const char *utf8, unsigned int color) {
+    return ME_DrawTextScaled(font_id, x, y, 1.0f, utf8, color);
+}
+
+ME_API ME_BOOL ME_DrawTextScaled(int font_id, int x, int y, float scale, const char *utf8, unsigned int color) {
+    ME_ALLOC_SCOPE(ME_ALLOC_RENDER);
+    ME::RecordCall(ME::RECORD_DRAW_TEXT, font_id, x, y, scale, ME::MERecordString{utf8}, color);
+    if (!g_engine || !utf8 || !(scale > 0.0f)) {
+        return ME_FALSE;
+    }
+    return g_engine->DrawText(font_id, static_cast<float>(x), static_cast<float>(y), scale, utf8, color);
+}
+
+ME_API int ME_CreateEmitter(const ME_EmitterDesc *desc) {
+    ME_ALLOC_SCOPE(ME_ALLOC_RESOURCES);
+    if (!desc) {
+        return -1;
+    }
+    ME::RecordCall(ME::RECORD_CREATE_EMITTER, *desc);
+    if (!g_engine) {
+        return -1;
+    }
+    return g_engine->CreateEmitter(*desc);
+}
+
+ME_API ME_BOOL ME_UpdateEmitter(int emitter, const ME_EmitterDesc *desc) {
+    if (!desc) {
+        return ME_FALSE;
+    }
+    ME::RecordCall(ME::RECORD_UPDATE_EMITTER, emitter, *desc);
+    if (!g_engine) {
+        return ME_FALSE;
+    }
+    return g_engine->UpdateEmitter(emitter, *desc);
+}
+
+ME_API ME_BOOL ME_DestroyEmitter(int emitter) {
+    ME_ALLOC_SCOPE(ME_ALLOC_RESOURCES);
+    ME::RecordCall(ME::RECORD_DESTROY_EMITTER, emitter);
+    if (!g_engine) {
+        return ME_FALSE;
+    }
+    return g_engine->DestroyEmitter(emitter);
+}
+
+ME_API ME_BOOL ME_EmitParticles(int emitter, float x, float y, int count) {
+    ME_ALLOC_SCOPE(ME_ALLOC_RENDER);
+    ME::RecordCall(ME::RECORD_EMIT_PARTICLES, emitter, x, y, count);
+    if (!g_engine) {
+        return ME_FALSE;
+    }
+    return g_engine->EmitParticles(emitter, x, y, count);
+}
+
+ME_API ME_BOOL ME_GetParticleStats(ME_ParticleStats *stats) {
+    if (!g_engine || !stats) {
+        return ME_FALSE;
+    }
+    g_engine->GetParticleStats(stats);
+    return ME_TRUE;
+}
+
+ME_API ME_BOOL ME_SetBlockLight(int block_id, int emission, int opacity) {
+    ME::RecordCall(ME::RECORD_SET_BLOCK_LIGHT, block_id, emission, opacity);
+    if (!g_engine) {
+        return ME_FALSE;
+    }
+    return g_engine->SetBlockLight(block_id, emission, opacity);
+}
+
+ME_API ME_BOOL ME_SetLighting(ME_BOOL enabled, int ambient, int air_falloff) {
+    ME_ALLOC_SCOPE(ME_ALLOC_RESOURCES);
+    ME::RecordCall(ME::RECORD_SET_LIGHTING, enabled, ambient, air_falloff);
+    if (!g_engine) {
+        return ME_FALSE;
+    }
+    return g_engine->SetLighting(enabled != ME_FALSE, ambient, air_falloff);
+}
+
+ME_API int ME_GetLight(int column, int row) {
+    if (!g_engine) {
+        return -1;
+    }
+    return g_engine->GetLight(column, row);
+}
+
+ME_API ME_BOOL ME_GetLightStats(ME_LightStats *stats) {
+    if (!g_engine || !stats) {
+        return ME_FALSE;
+    }
+    g_engine->GetLightStats(stats);
+    return ME_TRUE;
+}
+
+ME_API ME_BOOL ME_SetStaticLayerMode(int mode) {
+    ME::RecordCall(ME::RECORD_SET_STATIC_LAYER_MODE, mode);
+    if (!g_engine || (mode != ME_STATIC_LAYER_AUTO && mode != ME_STATIC_LAYER_CACHED)) {
+        return ME_FALSE;
+    }
+    g_engine->SetStaticLayerMode(mode);
+    return ME_TRUE;
+}
+
+ME_API ME_BOOL ME_SetCamera(int x, int y) {
+    ME::RecordCall(ME::RECORD_SET_CAMERA, x, y);
+    if (!g_engine) {
+        return ME_FALSE;
+    }
+    g_engine->SetCamera(x, y);
+    return ME_TRUE;
+}
+
+ME_API ME_BOOL ME_WriteWorld(const char *path, int tile_width, int tile_height, int columns, int rows,
+                             const short *tiles) {
+    ME_ALLOC_SCOPE(ME_ALLOC_RESOURCES);
+    if (ME::g_record_enabled.load(std::memory_order_relaxed)) {
+        // a size the writer rejects, or one too large for a record, records no tiles
+        long long count = columns > 0 && rows > 0 ? static_cast<long long>(columns) * rows : 0;
+        ME::RecordCall(ME::RECORD_WRITE_WORLD, ME::MERecordString{path}, tile_width, tile_height, columns, rows,
+                       ME::MERecordArray<short>{tiles, count <= INT_MAX / 2 ? static_cast<int>(count) : 0});
+    }
+    if (!path || !tiles) {
+        return ME_FALSE;
+    }
+    return MainboardEngine::MEWorldWriter::WriteWorld(path, tile_width, tile_height, columns, rows, tiles);
+}
+
+ME_API ME_BOOL ME_OpenWorld(const char *path, int placeholder_block_id, int memory_budget_kb) {
+    ME_ALLOC_SCOPE(ME_ALLOC_RESOURCES);
+    ME::RecordCall(ME::RECORD_OPEN_WORLD, ME::MERecordString{path}, placeholder_block_id, memory_budget_kb);
+    if (!g_engine || !path || memory_budget_kb <= 0) {
+        return ME_FALSE;
+    }
+    return g_engine->OpenWorld(path, placeholder_block_id, static_cast<size_t>(memory_budget_kb) * 1024);
+}
+
+ME_API ME_BOOL ME_CloseWorld() {
+    ME_ALLOC_SCOPE(ME_ALLOC_RESOURCES);
+    ME::RecordCall(ME::RECORD_CLOSE_WORLD);
+    if (!g_engine) {
+        return ME_FALSE;
+    }
+    g_engine->CloseWorld();
+    return ME_TRUE;
+}
+
+ME_API ME_BOOL ME_GetWorldStats(ME_WorldStats *stats) {
+    if (!g_engine || !stats) {
+        return ME_FALSE;
+    }
+    return g_engine->GetWorldStats(stats);
+}
+
+ME_API int ME_QueryPoint(int x, int y) {
+    ME_ALLOC_SCOPE(ME_ALLOC_QUERIES);
+    ME::RecordCall(ME::RECORD_QUERY_POINTS, ME::MERecordArray<int>{&x, 1}, ME::MERecordArray<int>{&y, 1});
+    if (!g_engine) {
+        return -1;
+    }
+    return g_engine->QueryPoint(x, y);
+}
+
+ME_API int ME_QueryPoints(const int *xs, const int *ys, int count, int *block_ids) {
+    ME_ALLOC_SCOPE(ME_ALLOC_QUERIES);
+    ME::RecordCall(ME::RECORD_QUERY_POINTS, ME::MERecordArray<int>{xs, count}, ME::MERecordArray<int>{ys, count});
+    if (count < 0 || ((!xs || !ys || !block_ids) && count > 0)) {
+        return -1;
+    }
+    if (!g_engine) {
+        return 0;
+    }
+    for (int i = 0; i < count; ++i) {
+        block_ids[i] = g_engine->QueryPoint(xs[i], ys[i]);
+    }
+    return count;
+}
+
+ME_API int ME_QueryAABB(const ME_AABB *box, ME_TileCoord *tiles, int capacity) {
+    ME_ALLOC_SCOPE(ME_ALLOC_QUERIES);
+    ME::RecordCall(ME::RECORD_QUERY_AABB, ME::MERecordArray<ME_AABB>{box, 1}, tiles ? capacity : 0);
+    if (!g_engine || !box) {
+        return 0;
+    }
+    return g_engine->QueryAABB(*box, tiles, tiles ? capacity : 0);
+}
+
+ME_API int ME_QueryAABBs(const ME_AABB *boxes, int count, int *solid_counts) {
+    ME_ALLOC_SCOPE(ME_ALLOC_QUERIES);
+    ME::RecordCall(ME::RECORD_QUERY_AABBS, ME::MERecordArray<ME_AABB>{boxes, count});
+    if (count < 0 || ((!boxes || !solid_counts) && count > 0)) {
+        return -1;
+    }
+    if (!g_engine) {
+        return 0;
+    }
+    int touching = 0;
+    for (int i = 0; i < count; ++i) {
+        solid_counts[i] = g_engine->QueryAABB(boxes[i], nullptr, 0);
+        touching += solid_counts[i] > 0 ? 1 : 0;
+    }
+    return touching;
+}
+
+ME_API ME_BOOL ME_Raycast(const ME_Ray *ray, ME_RaycastHit *hit) {
+    ME_ALLOC_SCOPE(ME_ALLOC_QUERIES);
+    ME::RecordCall(ME::RECORD_RAYCASTS, ME::MERecordArray<ME_Ray>{ray, 1});
+    if (!g_engine || !ray || !hit) {
+        return ME_FALSE;
+    }
+    return g_engine->Raycast(*ray, *hit);
+}
+
+ME_API int ME_Raycasts(const ME_Ray *rays, int count, ME_RaycastHit *hits) {
+    ME_ALLOC_SCOPE(ME_ALLOC_QUERIES);
+    ME::RecordCall(ME::RECORD_RAYCASTS, ME::MERecordArray<ME_Ray>{rays, count});
+    if (count < 0 || ((!rays || !hits) && count > 0)) {
+        return -1;
+    }
+    if (!g_engine) {
+        return 0;
+    }
+    int hit_count = 0;
+    for (int i = 0; i < count; ++i) {
+        hit_count += g_engine->Raycast(rays[i], hits[i]) ? 1 : 0;
+    }
+    return hit_count;
+}
+
+ME_API int ME_FindPaths(const ME_PathRequest *requests, int count) {
+    ME_ALLOC_SCOPE(ME_ALLOC_QUERIES);
+    int batch = -1;
+    if (g_engine && count >= 0 && (requests || count == 0)) {
+        batch = g_engine->FindPaths(requests, count);
+    }
+    if (ME::g_record_enabled.load(std::memory_order_relaxed)) {
+        ME::RecordCall(ME::RECORD_FIND_PATHS, ME::MERecordArray<ME_PathRequest>{requests, count});
+        ME::RecordPathBatch(batch);
+    }
+    return batch;
+}
+
+ME_API ME_BOOL ME_WaitPaths(int batch) {
+    ME::RecordCall(ME::RECORD_WAIT_PATHS, ME::MERecordBatch{batch});
+    if (!g_engine) {
+        return ME_FALSE;
+    }
+    return g_engine->WaitPaths(batch);
+}
+
+ME_API int ME_GetPaths(int batch, ME_PathResult *results, ME_TileCoord *tiles, int capacity) {
+    ME_ALLOC_SCOPE(ME_ALLOC_QUERIES);
+    ME::RecordCall(ME::RECORD_GET_PATHS, ME::MERecordBatch{batch}, tiles ? capacity : 0);
+    if (!g_engine || !results) {
+        return -1;
+    }
+    return g_engine->GetPaths(batch, results, tiles, tiles ? capacity : 0);
+}
+
+ME_API ME_BOOL ME_ReleasePaths(int batch) {
+    ME_ALLOC_SCOPE(ME_ALLOC_QUERIES);
+    if (ME::g_record_enabled.load(std::memory_order_relaxed)) {
+        ME::RecordCall(ME::RECORD_RELEASE_PATHS, ME::MERecordBatch{batch});
+        ME::ForgetPathBatch(batch);
+    }
+    if (!g_engine) {
+        return ME_FALSE;
+    }
+    return g_engine->ReleasePaths(batch);
+}
+
+ME_API ME_BOOL ME_OpenMap(const char *path) {
+    ME_ALLOC_SCOPE(ME_ALLOC_RESOURCES);
+    ME::RecordCall(ME::RECORD_OPEN_MAP, ME::MERecordString{path});
+    if (!g_engine || !path) {
+        return ME_FALSE;
+    }
+    return g_engine->OpenMap(path);
+}
+
+ME_API ME_BOOL ME_SetTile(int column, int row, int block_id) {
+    ME_ALLOC_SCOPE(ME_ALLOC_RESOURCES);
+    ME::RecordCall(ME::RECORD_SET_TILE, column, row, block_id);
+    if (!g_engine) {
+        return ME_FALSE;
+    }
+    return g_engine->SetMapTile(column, row, block_id);
+}
+
+ME_API ME_BOOL ME_FillRect(int column, int row, int width, int height, int block_id) {
+    ME_ALLOC_SCOPE(ME_ALLOC_RESOURCES);
+    ME::RecordCall(ME::RECORD_FILL_RECT, column, row, width, height, block_id);
+    if (!g_engine) {
+        return ME_FALSE;
+    }
+    return g_engine->FillMapRect(column, row, width, height, block_id);
+}
+
+ME_API ME_BOOL ME_SaveMap() {
+    ME_ALLOC_SCOPE(ME_ALLOC_RESOURCES);
+    ME::RecordCall(ME::RECORD_SAVE_MAP);
+    if (!g_engine) {
+        return ME_FALSE;
+    }
+    return g_engine->SaveMap();
+}
+
+ME_API ME_BOOL ME_CompactMap() {
+    ME_ALLOC_SCOPE(ME_ALLOC_RESOURCES);
+    ME::RecordCall(ME::RECORD_COMPACT_MAP);
+    if (!g_engine) {
+        return ME_FALSE;
+    }
+    return g_engine->CompactMap();
+}
+
+ME_API ME_BOOL ME_CloseMap() {
+    ME_ALLOC_SCOPE(ME_ALLOC_RESOURCES);
+    ME::RecordCall(ME::RECORD_CLOSE_MAP);
+    if (!g_engine) {
+        return ME_FALSE;
+    }
+    g_engine->CloseMap();
+    return ME_TRUE;
+}
+
+ME_API ME_BOOL ME_GetMapStats(ME_MapStats *stats) {
+    if (!g_engine || !stats) {
+        return ME_FALSE;
+    }
+    return g_engine->GetMapStats(stats);
+}
+
+ME_API ME_BOOL ME_ClearBlock() {
+    ME_ALLOC_SCOPE(ME_ALLOC_RESOURCES);
+    ME::RecordCall(ME::RECORD_CLEAR_BLOCK);
+    return MainboardEngine::MEEngine::ClearBlock();
+}
+
+ME_API ME_BOOL ME_SetRendererType(int type) {
+    ME::RecordCall(ME::RECORD_SET_RENDERER_TYPE, type);
+    if (type < ME_RENDERER_AUTO || type > ME_RENDERER_SOFTWARE) {
+        return ME_FALSE;
+    }
+    g_renderer_type = type;
+    return ME_TRUE;
+}
+
+ME_API ME_BOOL ME_RecordStart(const char *path) {
+    if (!path) {
+        return ME_FALSE;
+    }
+    return MainboardEngine::StartRecording(path);
+}
+
+ME_API ME_BOOL ME_RecordStop() {
+    return MainboardEngine::StopRecording();
+}
+
+ME_API ME_BOOL ME_Replay(const char *path, int flags, ME_ReplayStats *stats) {
+    if (!path) {
+        return ME_FALSE;
+    }
+    return MainboardEngine::ReplayRecording(path, flags, stats);
+}
+
+namespace MainboardEngine {
+    static int GetRectWidth(ME_Rect *rect) {
+        return rect->right - rect->left;
+    }
+
+    static int GetRectHeight(ME_Rect *rect) {
+        return rect->bottom - rect->top;
+    }
+
+    static bgfx::RendererType::Enum GetRendererType(int type) {
+        switch (type) {
+            case ME_RENDERER_NOOP:
+            case ME_RENDERER_SOFTWARE:
+                return bgfx::RendererType::Noop;
+            case ME_RENDERER_DIRECT3D11:
+                return bgfx::RendererType::Direct3D11;
+            case ME_RENDERER_DIRECT3D12:
+                return bgfx::RendererType::Direct3D12;
+            case ME_RENDERER_OPENGL:
+                return bgfx::RendererType::OpenGL;
+            case ME_RENDERER_VULKAN:
+                return bgfx::RendererType::Vulkan;
+            case ME_RENDERER_METAL:
+                return bgfx::RendererType::Metal;
+            default:
+                return bgfx::RendererType::Count;
+        }
+    }
+}
+
+namespace MainboardEngine {
+    // every shader Start creates, read in this order by readShaderFiles
+    enum ShaderFile {
+        SHADER_FULLSCREEN_VS,
+        SHADER_TILED_FS,
+        SHADER_TILEMAP_FS,
+        SHADER_LIGHT_FS,
+        SHADER_TEXT_VS,
+        SHADER_TEXT_FS,
+        SHADER_PARTICLE_VS,
+        SHADER_PARTICLE_FS,
+        SHADER_FILE_COUNT
+    };
+
+    static const char *const SHADER_FILE_NAMES[SHADER_FILE_COUNT] = {
+        "vs_fullscreen", "fs_tiled", "fs_tilemap", "fs_light", "vs_text", "fs_text", "vs_particle", "fs_particle"
+    };
+
+    static const char *getShaderDir(bgfx::RendererType::Enum renderer) {
+        switch (renderer) {
+            case bgfx::RendererType::Direct3D11:
+            case bgfx::RendererType::Direct3D12:
+                return "dx11";
+            case bgfx::RendererType::OpenGL:
+                return "glsl";
+            case bgfx::RendererType::Vulkan:
+                return "spirv";
+            default:
+                return "dx11";
+        }
+    }
+
+    // the renderer bgfx::init will most likely pick, a wrong guess only costs reading the shaders again
+    static bgfx::RendererType::Enum predictRendererType(int type) {
+        if (type != ME_RENDERER_AUTO) {
+            return GetRendererType(type);
+        }
+#if defined(_WIN32)
+        return bgfx::RendererType::Direct3D11;
+#else
+        return bgfx::RendererType::OpenGL;
+#endif
+    }
+
+    // empty when the file is missing
+    static std::vector<uint8_t> readShaderFile(const char *filename) {
+        std::vector<uint8_t> code;
+        std::ifstream file(filename, std::ios::binary);
+        if (!file.is_open()) {
+            return code;
+        }
+
+        file.seekg(0, std::ios::end);
+        std::streamsize size = file.tellg();
+        file.seekg(0, std::ios::beg);
+
+        code.resize(static_cast<size_t>(size) + 1);
+        file.read(reinterpret_cast<char *>(code.data()), size);
+        code[size] = '\0';
+        return code;
+    }
+
+    static std::vector<std::vector<uint8_t>> readShaderFiles(const std::string &dir) {
+        ME_TRACE_SCOPE("ReadShaderFiles");
+        std::vector<std::vector<uint8_t>> files(SHADER_FILE_COUNT);
+        char path[64];
+        for (int i = 0; i < SHADER_FILE_COUNT; ++i) {
+            std::snprintf(path, sizeof(path), "./shader/%s/%s.bin", dir.c_str(), SHADER_FILE_NAMES[i]);
+            files[i] = readShaderFile(path);
+        }
+        return files;
+    }
+
+    static bgfx::ShaderHandle loadShader(const std::vector<uint8_t> &code) {
+        if (code.empty()) {
+            return BGFX_INVALID_HANDLE;
+        }
+        return bgfx::createShader(bgfx::copy(code.data(), static_cast<uint32_t>(code.size())));
+    }
+
+    // programs that are optional, both shaders are released when either is missing
+    static bgfx::ProgramHandle loadProgram(const std::vector<uint8_t> &vs_code, const std::vector<uint8_t> &fs_code) {
+        bgfx::ShaderHandle vsh = loadShader(vs_code);
+        bgfx::ShaderHandle fsh = loadShader(fs_code);
+        if (bgfx::isValid(vsh) && bgfx::isValid(fsh)) {
+            return bgfx::createProgram(vsh, fsh, true);
+        }
+        if (bgfx::isValid(vsh)) {
+            bgfx::destroy(vsh);
+        }
+        if (bgfx::isValid(fsh)) {
+            bgfx::destroy(fsh);
+        }
+        return BGFX_INVALID_HANDLE;
+    }
+
+    bool MEEngine::Start(MEWindow *window) {
+        using namespace bgfx;
+
+        auto temp_engine = new MEEngine();
+        temp_engine->m_window = window;
+
+        for (int i = 0; i < BLOCK_ARRAY_SIZE; ++i) {
+            temp_engine->m_blocks[i] = std::nullopt;
+            temp_engine->m_tilemap_layers[i] = -1;
+        }
+
+        ME_Rect window_rect = temp_engine->m_window->GetSize();
+        Init init;
+        init.type = GetRendererType(g_renderer_type);
+        init.resolution.width = GetRectWidth(&window_rect);
+        init.resolution.height = GetRectHeight(&window_rect);
+        init.resolution.reset = BGFX_RESET_VSYNC;
+        init.limits.transientVbSize = TRANSIENT_VERTEX_BUFFER_SIZE;
+        PlatformData platformData;
+        platformData.nwh = temp_engine->m_window->GetMEWindowHandle();
+        init.platformData = platformData;
+#ifdef ME_ALLOC_TRACKING
+        init.allocator = GetTrackedBgfxAllocator();
+#endif
+
+        // the shader files are read while bgfx brings up the device
+        std::string predicted_dir = getShaderDir(predictRendererType(g_renderer_type));
+        auto shader_prefetch = std::async(std::launch::async, readShaderFiles, predicted_dir);
+
+        bool stat = false;
+        {
+            ME_TRACE_SCOPE("bgfx::init");
+            stat = bgfx::init(init);
+        }
+        if (!stat) {
+            return false;
+        }
+
+        setViewRect(VIEW_MAIN, 0, 0, init.resolution.width, init.resolution.height);
+        // the static layer and its fill must stay under what is drawn after them
+        setViewMode(VIEW_MAIN, ViewMode::Sequential);
+        setViewMode(VIEW_STATIC_FILL, ViewMode::Sequential);
+        temp_engine->m_screen_width = static_cast<uint16_t>(init.resolution.width);
+        temp_engine->m_screen_height = static_cast<uint16_t>(init.resolution.height);
+
+        static PosTexCoord quadVertices[] = {
+            {-1.0f, 1.0f, 0.0f, 0.0f, 0.0f, 0xFFFFFFFF},
+            {1.0f, 1.0f, 0.0f, 1.0f, 0.0f, 0xFFFFFFFF},
+            {-1.0f, -1.0f, 0.0f, 0.0f, 1.0f, 0xFFFFFFFF},
+            {1.0f, -1.0f, 0.0f, 1.0f, 1.0f, 0xFFFFFFFF}
+        };
+
+        VertexLayout &layout = temp_engine->m_layout;
+        layout.begin()
+                .add(Attrib::Position, 3, AttribType::Float)
+                .add(Attrib::TexCoord0, 2, AttribType::Float)
+                .add(Attrib::Color0, 4, AttribType::Uint8, true)
+                .end();
+        VertexBufferHandle vbh = createVertexBuffer(makeRef(quadVertices, sizeof(quadVertices)), layout);
+        static const uint16_t quadIndices[] = {0, 1, 2, 1, 3, 2};
+        IndexBufferHandle ibh = createIndexBuffer(makeRef(quadIndices, sizeof(quadIndices)));
+        temp_engine->m_vbh = vbh;
+        temp_engine->m_ibh = ibh;
+
+        // unit quad of every glyph and particle instance, drawn with the indices above
+        static PosTexCoord glyphVertices[] = {
+            {0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0xFFFFFFFF},
+            {1.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0xFFFFFFFF},
+            {0.0f, 1.0f, 0.0f, 0.0f, 1.0f, 0xFFFFFFFF},
+            {1.0f, 1.0f, 0.0f, 1.0f, 1.0f, 0xFFFFFFFF}
+        };
+        temp_engine->m_instance_vbh = createVertexBuffer(makeRef(glyphVertices, sizeof(glyphVertices)), layout);
+        // text goes over every view of the window in the order it was drawn
+        setViewMode(VIEW_HUD, ViewMode::Sequential);
+
+        UniformHandle s_tex = createUniform("s_tex", UniformType::Sampler);
+        UniformHandle u_resolution = createUniform("u_resolution", UniformType::Vec4);
+        UniformHandle u_animation = createUniform("u_animation", UniformType::Vec4);
+        UniformHandle u_sampling = createUniform("u_sampling", UniformType::Vec4);
+        temp_engine->m_s_tex = s_tex;
+        temp_engine->m_u_resolution = u_resolution;
+        temp_engine->m_u_animation = u_animation;
+        temp_engine->m_u_sampling = u_sampling;
+        temp_engine->m_s_tile_ids = createUniform("s_tile_ids", UniformType::Sampler);
+        temp_engine->m_s_tile_blocks = createUniform("s_tile_blocks", UniformType::Sampler);
+        temp_engine->m_s_tile_table = createUniform("s_tile_table", UniformType::Sampler);
+        temp_engine->m_u_tilemap = createUniform("u_tilemap", UniformType::Vec4);
+        temp_engine->m_u_tilemap_grid = createUniform("u_tilemap_grid", UniformType::Vec4);
+        temp_engine->m_u_text = createUniform("u_text", UniformType::Vec4);
+        temp_engine->m_u_particle = createUniform("u_particle", UniformType::Vec4);
+        temp_engine->m_u_light = createUniform("u_light", UniformType::Vec4);
+        temp_engine->m_scale = 1.0f;
+        temp_engine->m_texture_lod = 0.0f;
+        temp_engine->m_start_time = std::chrono::steady_clock::now();
+        temp_engine->m_last_update = temp_engine->m_start_time;
+        temp_engine->m_animation_time = 0.0f;
+        temp_engine->m_animation_period_ms = 1;
+
+        ShaderHandle vsh = BGFX_INVALID_HANDLE;
+        ShaderHandle fsh = BGFX_INVALID_HANDLE;
+
+        const char *shaderDir = getShaderDir(getRendererType());
+        std::vector<std::vector<uint8_t>> shaders = shader_prefetch.get();
+        if (predicted_dir != shaderDir) {
+            shaders = readShaderFiles(shaderDir);
+        }
+
+        vsh = loadShader(shaders[SHADER_FULLSCREEN_VS]);
+        fsh = loadShader(shaders[SHADER_TILED_FS]);
+        ProgramHandle program = BGFX_INVALID_HANDLE;
+
+        if (isValid(vsh) && isValid(fsh)) {
+            // optional, without it the static layer always goes through the cache. Created first,
+            // the program below releases the shared vertex shader
+            ShaderHandle tilemap_fsh = loadShader(shaders[SHADER_TILEMAP_FS]);
+            if (isValid(tilemap_fsh)) {
+                temp_engine->m_tilemap_program = createProgram(vsh, tilemap_fsh, false);
+                destroy(tilemap_fsh);
+            }
+            // optional as well, lighting computes but isn't drawn without it
+            ShaderHandle light_fsh = loadShader(shaders[SHADER_LIGHT_FS]);
+            if (isValid(light_fsh)) {
+                temp_engine->m_light_program = createProgram(vsh, light_fsh, false);
+                destroy(light_fsh);
+            }
+            // optional as well, ME_DrawText and emitters draw nothing without them
+            if (getCaps()->supported & BGFX_CAPS_INSTANCING) {
+                temp_engine->m_text_program = loadProgram(shaders[SHADER_TEXT_VS], shaders[SHADER_TEXT_FS]);
+                temp_engine->m_particle_program = loadProgram(shaders[SHADER_PARTICLE_VS],
+                                                              shaders[SHADER_PARTICLE_FS]);
+            }
+            program = createProgram(vsh, fsh, true);
+            temp_engine->m_program = program;
+            temp_engine->m_vsh = vsh;
+            temp_engine->m_fsh = fsh;
+        } else if (g_renderer_type != ME_RENDERER_SOFTWARE) {
+            return false;
+        }
+        if (g_renderer_type == ME_RENDERER_SOFTWARE) {
+            temp_engine->m_soft = std::make_unique<MESoftRenderer>(BLOCK_ARRAY_SIZE);
+        }
+        setViewClear(VIEW_MAIN, BGFX_CLEAR_COLOR | BGFX_CLEAR_DEPTH, CLEAR_COLOR, 1.0f, 0);
+
+        const uint8_t background[4] = {
+            static_cast<uint8_t>(CLEAR_COLOR >> 24), static_cast<uint8_t>(CLEAR_COLOR >> 16),
+            static_cast<uint8_t>(CLEAR_COLOR >> 8), static_cast<uint8_t>(CLEAR_COLOR)
+        };
+        Block &background_block = temp_engine->m_background_block;
+        background_block.id = -1;
+        background_block.width = 1;
+        background_block.height = 1;
+        background_block.channels = 4;
+        background_block.frame_count = 1;
+        background_block.texture = createTexture2D(1, 1, false, 1, TextureFormat::RGBA8, GetBlockSamplerFlags(false),
+                                                   copy(background, sizeof(background)));
+
+        const uint8_t white[4] = {0xFF, 0xFF, 0xFF, 0xFF};
+        temp_engine->m_white_texture = createTexture2D(1, 1, false, 1, TextureFormat::RGBA8,
+                                                       GetBlockSamplerFlags(false), copy(white, sizeof(white)));
+
+        auto started = std::chrono::steady_clock::now() - g_initialize_time;
+        temp_engine->m_startup.window_ms = std::chrono::duration<double, std::milli>(started).count();
+        g_engine = std::unique_ptr<MEEngine>(temp_engine);
+
+        return true;
+    }
+
+
+    bool MEEngine::RegistryBlock(int id, std::string path) {
+        ME_BlockDesc desc = {};
+        desc.frame_count = 1;
+        desc.frame_duration_ms = 0;
+        desc.flags = ME_BLOCK_FLAG_NONE;
+        return RegistryBlock(id, path, desc);
+    }
+
+    bool MEEngine::RegistryBlock(int id, std::string path, ME_BlockDesc desc) {
+        ME_TRACE_SCOPE("RegistryBlock");
+        if (!g_engine->CanLoadBlock(id, desc)) {
+            return false;
+        }
+
+        // the software renderer needs the pixels, which the compressed cache doesn't keep
+        if ((desc.flags & ME_BLOCK_FLAG_COMPRESS) && !g_engine->m_soft) {
+            Block block = {};
+            block.frame_count = desc.frame_count;
+            bool mips = (desc.flags & ME_BLOCK_FLAG_MIPMAPS) != 0;
+            bgfx::TextureHandle texture = LoadCompressedBlockTexture(block, path, mips);
+            if (bgfx::isValid(texture)) {
+                return g_engine->AddBlock(id, desc, block, texture);
+            }
+        }
+
+        MEDecodedImage image = {};
+        if (!DecodeImageFile(path, 0, image)) {
+            return false;
+        }
+        return g_engine->AddDecodedBlock(id, path, desc, image);
+    }
+
+    bool MEEngine::CanLoadBlock(int id, const ME_BlockDesc &desc) const {
+        if (id < 0 || id >= BLOCK_ARRAY_SIZE || m_blocks[id] != std::nullopt || m_block_pending[id] ||
+            m_variants[id] != std::nullopt) {
+            return false;
+        }
+        return desc.frame_count >= 1 && (desc.frame_count == 1 || desc.frame_duration_ms > 0);
+    }
+
+    static void ReleaseImagePixels(void *pixels, void *) {
+        MEImageDeleter()(static_cast<uint8_t *>(pixels));
+    }
+
+    bool MEEngine::AddDecodedBlock(int id, const std::string &path, const ME_BlockDesc &desc, MEDecodedImage &image) {
+        // the strip must split into frames of equal height
+        int image_height = image.height;
+        if (image_height % desc.frame_count != 0) {
+            return false;
+        }
+        Block block = {};
+        block.frame_count = desc.frame_count;
+        block.width = image.width;
+        block.height = image_height / desc.frame_count;
+        block.channels = image.channels;
+
+        const uint8_t *data = image.pixels.get();
+
+        bool mips = (desc.flags & ME_BLOCK_FLAG_MIPMAPS) != 0;
+        METextureData prepared = {};
+        if ((desc.flags & ME_BLOCK_FLAG_COMPRESS) && CanCompress(block.width, block.height)) {
+            auto format = ChooseCompressedFormat(image.has_alpha);
+            if (format != bgfx::TextureFormat::RGBA8 &&
+                EncodeTexture(data, block.width, image_height, format, mips, prepared)) {
+                WriteTextureCache(path, prepared);
+            } else {
+                prepared.data.clear();
+            }
+        }
+        if (prepared.data.empty() && mips) {
+            prepared.format = bgfx::TextureFormat::RGBA8;
+            prepared.width = block.width;
+            prepared.height = image_height;
+            prepared.num_mips = GetMipCount(block.width, image_height);
+            BuildMipChain(data, block.width, image_height, prepared.data);
+        }
+
+        if (m_soft) {
+            m_soft->SetTexture(id, block.width, block.height, block.frame_count, desc.frame_duration_ms, data);
+        }
+
+        // once per block, the renderer uses it to skip what is hidden or invisible
+        if (image.has_alpha) {
+            block.coverage = AnalyzeAlpha(data, block.width, block.height, block.frame_count);
+        } else {
+            block.coverage = {ALPHA_OPAQUE, 0, 0, block.width, block.height};
+        }
+
+        bgfx::TextureHandle texture = BGFX_INVALID_HANDLE;
+        if (!prepared.data.empty()) {
+            block.compressed = prepared.format != bgfx::TextureFormat::RGBA8;
+            texture = CreateBlockTexture(prepared);
+        } else {
+            ME_TRACE_SCOPE("UploadTexture");
+            // bgfx takes the decoded pixels as they are and frees them once uploaded, no copy
+            uint32_t size = static_cast<uint32_t>(block.width) * image_height * 4;
+            texture = bgfx::createTexture2D(block.width, image_height, false, 1, bgfx::TextureFormat::RGBA8,
+                                            GetBlockSamplerFlags(false),
+                                            bgfx::makeRef(image.pixels.release(), size, ReleaseImagePixels));
+        }
+        if ((block.compressed || mips) && block.coverage.kind != ALPHA_OPAQUE) {
+            // lossy alpha and filtered mips blur the edges of what was opaque or clear
+            block.coverage = {ALPHA_MIXED, 0, 0, 0, 0};
+        }
+        return AddBlock(id, desc, block, texture);
+    }
+
+    bool MEEngine::AddBlock(int id, const ME_BlockDesc &desc, Block &block, bgfx::TextureHandle texture) {
+        block.id = id;
+        block.frame_duration_ms = desc.frame_duration_ms;
+        block.solid = (desc.flags & ME_BLOCK_FLAG_SOLID) != 0;
+        // TODO how the hell can i know if the texture is created successfully
+        block.texture = texture;
+
+        PlaceBlock(block);
+        // variants registered while the block was loading
+        for (int variant = 0; variant < BLOCK_ARRAY_SIZE; ++variant) {
+            if (m_variants[variant] != std::nullopt && m_variants[variant].value().base_id == id &&
+                m_blocks[variant] == std::nullopt) {
+                AddVariant(variant);
+            }
+        }
+
+        return true;
+    }
+
+    void MEEngine::PlaceBlock(const Block &block) {
+        int id = block.id;
+        m_blocks[id] = block;
+        // static tiles may already point at this id
+        m_static_layer.InvalidateAll();
+        m_spatial_dirty = true;
+        m_tilemap_blocks_dirty = true;
+        if (block.frame_count > 1 && block.frame_duration_ms > 0) {
+            // past the limit the block jumps back to its first frame when the time wraps
+            int64_t period = std::lcm(m_animation_period_ms,
+                                      static_cast<int64_t>(block.frame_count) * block.frame_duration_ms);
+            if (period <= MAX_ANIMATION_PERIOD_MS) {
+                m_animation_period_ms = period;
+            }
+        }
+        if (block.frame_count > 1 && !m_world) {
+            // placed while the block was loading, they couldn't know it animates
+            for (int row = 0; row < m_static_layer.GetRows(); ++row) {
+                for (int column = 0; column < m_static_layer.GetColumns(); ++column) {
+                    if (m_static_layer.GetTile(column, row) == id) {
+                        m_static_layer.SetTile(column, row, id, true);
+                    }
+                }
+            }
+        }
+    }
+
+    void MEEngine::AddVariant(int id) {
+        const BlockVariant &variant = m_variants[id].value();
+        // the texture handle is copied, only the base destroys it
+        Block block = m_blocks[variant.base_id].value();
+        block.id = id;
+        block.variant_of = variant.base_id;
+        block.tint = variant.tint;
+        block.orientation = variant.orientation;
+        PlaceBlock(block);
+    }
+
+    bool MEEngine::RegisterBlockVariant(int id, int base_id, uint32_t tint, int orientation) {
+        if (id < 0 || id >= BLOCK_ARRAY_SIZE || base_id < 0 || base_id >= BLOCK_ARRAY_SIZE || id == base_id ||
+            (orientation & ~ME_ORIENT_MASK)) {
+            return false;
+        }
+        if (m_blocks[id] != std::nullopt || m_block_pending[id] || m_variants[id] != std::nullopt) {
+            return false;
+        }
+        bool loaded = m_blocks[base_id] != std::nullopt;
+        if (loaded && (m_blocks[base_id].value().variant_of >= 0 || m_blocks[base_id].value().view_target)) {
+            return false;
+        }
+        if (!loaded && !m_block_pending[base_id]) {
+            return false;
+        }
+        m_variants[id] = BlockVariant{base_id, tint, orientation};
+        if (loaded) {
+            AddVariant(id);
+        }
+        return true;
+    }
+
+    bool MEEngine::LoadBlockAsync(int id, const std::string &path, const ME_BlockDesc &desc) {
+        if (!CanLoadBlock(id, desc)) {
+            return false;
+        }
+        // a fresh compressed cache is read without decoding, it isn't worth a worker
+        if (desc.flags & ME_BLOCK_FLAG_COMPRESS) {
+            return RegistryBlock(id, path, desc);
+        }
+        m_block_pending[id] = true;
+        ++m_startup.pending_blocks;
+        m_loader.Submit(id, path, desc);
+        return true;
+    }
+
+    void MEEngine::FinishBlockLoads() {
+        if (m_startup.pending_blocks == 0) {
+            return;
+        }
+        m_loader.TakeDecoded(m_decoded_blocks);
+        if (m_decoded_blocks.empty()) {
+            return;
+        }
+        ME_TRACE_SCOPE("FinishBlockLoads");
+        for (auto &decoded: m_decoded_blocks) {
+            if (!m_block_pending[decoded.id]) {
+                continue; // cleared while it was decoding
+            }
+            m_block_pending[decoded.id] = false;
+            --m_startup.pending_blocks;
+            if (decoded.image.pixels && AddDecodedBlock(decoded.id, decoded.path, decoded.desc, decoded.image)) {
+                ++m_startup.async_blocks;
+            } else {
+                ++m_startup.failed_blocks;
+            }
+        }
+        m_decoded_blocks.clear();
+    }
+
+    void MEEngine::GetStartupStats(ME_StartupStats *stats) const {
+        *stats = m_startup;
+    }
+
+    uint64_t MEEngine::GetBlockSamplerFlags(bool mips) {
+        if (!mips) {
+            return BGFX_TEXTURE_NONE | BGFX_SAMPLER_MIN_POINT | BGFX_SAMPLER_MAG_POINT;
+        }
+        // magnified blocks stay pixel exact, minified ones filter through the mip chain
+        return BGFX_TEXTURE_NONE | BGFX_SAMPLER_MAG_POINT;
+    }
+
+    bgfx::TextureHandle MEEngine::CreateBlockTexture(const METextureData &texture) {
+        ME_TRACE_SCOPE("UploadTexture");
+        return bgfx::createTexture2D(texture.width, texture.height, texture.num_mips > 1, 1, texture.format,
+                                     GetBlockSamplerFlags(texture.num_mips > 1),
+                                     bgfx::copy(texture.data.data(), static_cast<uint32_t>(texture.data.size())));
+    }
+
+    bgfx::TextureHandle MEEngine::LoadCompressedBlockTexture(Block &block, const std::string &path, bool mips) {
+        // a fresh cache skips decoding the image entirely, we don't know yet if it has alpha so try both
+        for (bool has_alpha: {true, false}) {
+            auto format = ChooseCompressedFormat(has_alpha);
+            METextureData cached = {};
+            if (format == bgfx::TextureFormat::RGBA8 || !LoadTextureCache(path, format, mips, cached)) {
+                continue;
+            }
+            if (cached.height % block.frame_count != 0) {
+                return BGFX_INVALID_HANDLE;
+            }
+
+            block.width = cached.width;
+            block.height = cached.height / block.frame_count;
+            block.channels = 4;
+            block.compressed = true;
+            return CreateBlockTexture(cached);
+        }
+
+        return BGFX_INVALID_HANDLE;
+    }
+
+    bool MEEngine::CookBlockTexture(const std::string &path, const char *format_name, int flags) {
+        bgfx::TextureFormat::Enum format;
+        if (!ParseTextureFormat(format_name, format)) {
+            return false;
+        }
+
+        MEDecodedImage image = {};
+        if (!DecodeImageFile(path, 0, image)) {
+            return false;
+        }
+
+        METextureData encoded = {};
+        bool mips = (flags & ME_BLOCK_FLAG_MIPMAPS) != 0;
+        return EncodeTexture(image.pixels.get(), image.width, image.height, format, mips, encoded) &&
+               WriteTextureCache(path, encoded);
+    }
+
+    bool MEEngine::ClearBlock() {
+        // loads still decoding would land after the clear
+        g_engine->m_loader.Cancel();
+        std::fill(std::begin(g_engine->m_block_pending), std::end(g_engine->m_block_pending), false);
+        g_engine->m_startup.pending_blocks = 0;
+        for (int i = 0; i < BLOCK_ARRAY_SIZE; ++i) {
+            // view targets stay until their view is destroyed
+            g_engine->m_variants[i] = std::nullopt;
+            if (g_engine->m_blocks[i] != std::nullopt && !g_engine->m_blocks[i].value().view_target) {
+                auto block = &g_engine->m_blocks[i].value();
+                if (block->variant_of < 0 && bgfx::isValid(block->texture.value())) {
+                    bgfx::destroy(block->texture.value());
+                }
+                if (g_engine->m_soft) {
+                    g_engine->m_soft->RemoveTexture(i);
+                }
+                g_engine->m_blocks[i] = std::nullopt;
+            }
+        }
+        g_engine->m_animation_period_ms = 1;
+        g_engine->m_static_layer.InvalidateAll();
+        g_engine->m_spatial_dirty = true;
+        g_engine->m_tilemap_blocks_dirty = true;
+
+        return true;
+    }
+
+
+    // bool MEEngine::RegistryRenderBlock(std::string block_name, int x, int y) {
+    //     RenderBlockCommand command = {};
+    //     command.block_name = block_name;
+    //     command.x = x;
+    //     command.y = y;
+    //     m_commands.push_back(command);
+    //
+    //     return true;
+    // }
+    //
+    bool MEEngine::RenderBlock(int id, int x, int y, uint32_t tint, int orientation) {
+        ME_TRACE_SCOPE("RenderBlock");
+        if (id < 0 || id >= BLOCK_ARRAY_SIZE || m_blocks[id] == std::nullopt || (orientation & ~ME_ORIENT_MASK)) {
+            return false;
+        }
+
+        if (!bgfx::isValid(m_program) && !m_soft) {
+            return false;
+        }
+        if (!bgfx::isValid(m_blocks[id].value().texture.value())) {
+            return false;
+        }
+
+        // draws are only recorded here, Render() sorts and batches them
+        DrawCommand command = {};
+        command.sort_key = MakeSortKey(LAYER_BLOCKS, id, static_cast<uint32_t>(m_draws.Size()));
+        command.id = id;
+        command.x = x;
+        command.y = y;
+        command.tint = tint;
+        command.orientation = orientation;
+        // past the arena capacity the frame spills to the heap, the draw keeps its place in the order.
+        // It is only lost when the heap is out of memory too, and then the caller is told
+        return m_draws.Push(command);
+    }
+
+    uint64_t MEEngine::MakeSortKey(int layer, int id, uint32_t sequence) const {
+        // layer first keeps the painter's order between layers. Blocks may overlap, so they keep their
+        // call order and only adjacent draws of one texture batch. Static tiles sit on a grid and never
+        // overlap, the block id groups them by texture, variants go with their base
+        int texture = layer == LAYER_BLOCKS ? 0 : GetTextureBlock(id);
+        return (static_cast<uint64_t>(layer & 0xFF) << 56) |
+               (static_cast<uint64_t>(texture & 0xFFFFFF) << 32) |
+               sequence;
+    }
+
+    int MEEngine::GetTextureBlock(int id) const {
+        if (id < 0 || id >= BLOCK_ARRAY_SIZE || m_blocks[id] == std::nullopt || m_blocks[id].value().variant_of < 0) {
+            return id;
+        }
+        return m_blocks[id].value().variant_of;
+    }
+
+    // texture corner drawn at a corner of the quad, corners are bit 0 = right, bit 1 = bottom
+    static int GetOrientedCorner(int orientation, int corner) {
+        int x = corner & 1;
+        int y = corner >> 1;
+        // the quarter turns are undone first since they were applied last
+        for (int turn = 0; turn < ((orientation >> 2) & 3); ++turn) {
+            int turned = y;
+            y = 1 - x;
+            x = turned;
+        }
+        x ^= orientation & ME_ORIENT_FLIP_X ? 1 : 0;
+        y ^= orientation & ME_ORIENT_FLIP_Y ? 1 : 0;
+        return x | (y << 1);
+    }
+
+    // orientation of a texture turned by first, then by then
+    static int ComposeOrientation(int first, int then) {
+        static const auto table = [] {
+            std::array<std::array<uint8_t, 16>, 16> composed = {};
+            for (int a = 0; a < 16; ++a) {
+                for (int b = 0; b < 16; ++b) {
+                    // flips and turns overlap (FLIP_X | FLIP_Y is ROTATE_180), any match will do
+                    for (int c = 0; c < 16; ++c) {
+                        bool same = true;
+                        for (int corner = 0; corner < 4; ++corner) {
+                            same = same && GetOrientedCorner(c, corner) ==
+                                           GetOrientedCorner(a, GetOrientedCorner(b, corner));
+                        }
+                        if (same) {
+                            composed[a][b] = static_cast<uint8_t>(c);
+                            break;
+                        }
+                    }
+                }
+            }
+            return composed;
+        }();
+        return table[first & ME_ORIENT_MASK][then & ME_ORIENT_MASK];
+    }
+
+    // quarter turns swap the width and height on screen, mirroring doesn't change the parity
+    static bool IsTurned(int first, int then) {
+        return ((first ^ then) & ME_ORIENT_ROTATE_90) != 0;
+    }
+
+    // per channel of two 0xRRGGBBAA colors
+    static uint32_t MultiplyTint(uint32_t a, uint32_t b) {
+        if (a == ME_TINT_NONE || b == ME_TINT_NONE) {
+            return a & b;
+        }
+        uint32_t result = 0;
+        for (int shift = 0; shift < 32; shift += 8) {
+            uint32_t t = ((a >> shift) & 0xFF) * ((b >> shift) & 0xFF) + 128;
+            result |= ((t + (t >> 8)) >> 8) << shift;
+        }
+        return result;
+    }
+
+    // Color0 bytes are r, g, b, a in memory
+    static uint32_t GetTintAbgr(uint32_t tint) {
+        return (tint >> 24) | ((tint >> 8) & 0xFF00) | ((tint << 8) & 0xFF0000) | (tint << 24);
+    }
+
+    // blending only where something below can show through: a block with clear texels or a tint
+    // with alpha. Opaque ones write over the target and skip the read of what is under them
+    static uint64_t GetBlockState(const MEAlphaCoverage &coverage, bool opaque_tint) {
+        uint64_t state = BGFX_STATE_WRITE_RGB | BGFX_STATE_WRITE_A;
+        if (coverage.kind != ALPHA_OPAQUE || !opaque_tint) {
+            state |= BGFX_STATE_BLEND_ALPHA;
+        }
+        return state;
+    }
+
+    void MEEngine::SetBlockUniforms(const Block *block, const RenderTarget &target, float scale, float lod) {
+        float resolution[4] = {
+            static_cast<float>(target.width),
+            static_cast<float>(target.height),
+            static_cast<float>(block->width) * scale,
+            static_cast<float>(block->height) * scale
+        };
+        bgfx::setUniform(m_u_resolution, resolution);
+
+        // the frame is picked in the shader, so animated blocks need no per-frame work here
+        float animation[4] = {
+            static_cast<float>(block->frame_count),
+            block->frame_count > 1 ? static_cast<float>(block->frame_duration_ms) / 1000.0f : 1.0f,
+            m_animation_time,
+            0.0f
+        };
+        bgfx::setUniform(m_u_animation, animation);
+
+        if (block->frame_count > 1) {
+            // the chain is built over the whole strip, past the level where a frame's height stops
+            // halving evenly (in whole 4x4 blocks when compressed) rows of neighbouring frames mix
+            int levels = 0;
+            for (int height = block->height; height > 0 && height % (block->compressed ? 8 : 2) == 0; height /= 2) {
+                ++levels;
+            }
+            lod = std::min(lod, static_cast<float>(levels));
+        }
+        float sampling[4] = {lod, 0.0f, 0.0f, 0.0f};
+        bgfx::setUniform(m_u_sampling, sampling);
+    }
+
+    void MEEngine::SubmitBlock(const RenderTarget &target, const DrawCommand &command) {
+        // full target quad clipped to the block, used when no transient buffer space is left,
+        // the texture repeats from the target origin here instead of the block origin and a
+        // variant is drawn as its base, without the tint or orientation
+        auto block = &m_blocks[GetTextureBlock(command.id)].value();
+        // the part off the left or top of the target is cut from the size as well as the origin
+        float left = static_cast<float>(command.x) * target.scale;
+        float top = static_cast<float>(command.y) * target.scale;
+        float right = std::ceil(left + static_cast<float>(block->width) * target.scale);
+        float bottom = std::ceil(top + static_cast<float>(block->height) * target.scale);
+        left = std::max(0.0f, std::floor(left));
+        top = std::max(0.0f, std::floor(top));
+        if (right <= left || bottom <= top) {
+            return;
+        }
+        bgfx::setScissor(static_cast<uint16_t>(target.x + left), static_cast<uint16_t>(target.y + top),
+                         static_cast<uint16_t>(right - left), static_cast<uint16_t>(bottom - top));
+        SetBlockUniforms(block, target, target.scale, target.lod);
+        bgfx::setVertexBuffer(0, m_vbh);
+        bgfx::setIndexBuffer(m_ibh);
+        bgfx::setTexture(0, m_s_tex, block->texture.value());
+        bgfx::setState(GetBlockState(block->coverage, true));
+        bgfx::submit(target.view, m_program);
+        ++m_frame_submits;
+    }
+
+    static void WriteQuad(PosTexCoord *vertices, uint16_t *indices, uint32_t index, const TexturedQuad &quad,
+                          const RenderTarget &target) {
+        float x0 = quad.x0 / static_cast<float>(target.width) * 2.0f - 1.0f;
+        float x1 = quad.x1 / static_cast<float>(target.width) * 2.0f - 1.0f;
+        float y0 = 1.0f - quad.y0 / static_cast<float>(target.height) * 2.0f;
+        float y1 = 1.0f - quad.y1 / static_cast<float>(target.height) * 2.0f;
+        if (target.flip_y) {
+            y0 = -y0;
+            y1 = -y1;
+        }
+
+        // a turned or mirrored quad keeps its place and takes the uv of another corner
+        PosTexCoord *corners = vertices + index * 4;
+        for (int corner = 0; corner < 4; ++corner) {
+            int source = GetOrientedCorner(quad.orientation, corner);
+            corners[corner] = {corner & 1 ? x1 : x0, corner & 2 ? y1 : y0, 0.0f,
+                               source & 1 ? quad.u1 : quad.u0, source & 2 ? quad.v1 : quad.v0, quad.abgr};
+        }
+
+        uint16_t base = static_cast<uint16_t>(index * 4);
+        uint16_t *quad_indices = indices + index * 6;
+        quad_indices[0] = base;
+        quad_indices[1] = base + 1;
+        quad_indices[2] = base + 2;
+        quad_indices[3] = base + 1;
+        quad_indices[4] = base + 3;
+        quad_indices[5] = base + 2;
+    }
+
+    bool MEEngine::SubmitBatch(const RenderTarget &target, const DrawCommand *commands, uint32_t count) {
+        // commands share a texture, they can be different variants of it
+        auto block = &m_blocks[GetTextureBlock(commands[0].id)].value();
+
+        bgfx::TransientVertexBuffer tvb;
+        bgfx::TransientIndexBuffer tib;
+        if (!bgfx::allocTransientBuffers(&tvb, m_layout, count * 4, &tib, count * 6)) {
+            return false;
+        }
+
+        // one quad per block, fs_tiled repeats the texture every u_resolution.zw pixels of
+        // the target, so uv starts at 0 on every block to line the texture up with its corner
+        float width = static_cast<float>(block->width) * target.scale;
+        float height = static_cast<float>(block->height) * target.scale;
+        float u1 = width / static_cast<float>(target.width);
+        float v1 = height / static_cast<float>(target.height);
+        auto vertices = reinterpret_cast<PosTexCoord *>(tvb.data);
+        auto indices = reinterpret_cast<uint16_t *>(tib.data);
+        bool opaque_tints = true;
+        for (uint32_t i = 0; i < count; ++i) {
+            const Block &variant = m_blocks[commands[i].id].value();
+            bool turned = IsTurned(variant.orientation, commands[i].orientation);
+            TexturedQuad quad = {};
+            quad.x0 = static_cast<float>(commands[i].x) * target.scale;
+            quad.y0 = static_cast<float>(commands[i].y) * target.scale;
+            quad.x1 = quad.x0 + (turned ? height : width);
+            quad.y1 = quad.y0 + (turned ? width : height);
+            quad.u1 = u1;
+            quad.v1 = v1;
+            uint32_t tint = MultiplyTint(variant.tint, commands[i].tint);
+            opaque_tints = opaque_tints && (tint & 0xFF) == 0xFF;
+            quad.abgr = GetTintAbgr(tint);
+            quad.orientation = ComposeOrientation(variant.orientation, commands[i].orientation);
+            WriteQuad(vertices, indices, i, quad, target);
+        }
+
+        SetBlockUniforms(block, target, target.scale, target.lod);
+        bgfx::setVertexBuffer(0, &tvb);
+        bgfx::setIndexBuffer(&tib);
+        bgfx::setTexture(0, m_s_tex, block->texture.value());
+        // blended like the software renderer does, clear texels and the tint's alpha show what is below,
+        // which is what lets CullDraws skip transparent blocks and only trust opaque texels to hide others.
+        // One translucent tint blends the whole batch
+        bgfx::setState(GetBlockState(block->coverage, opaque_tints));
+        bgfx::submit(target.view, m_program);
+        ++m_frame_submits;
+
+        return true;
+    }
+
+    bool MEEngine::SubmitQuads(const RenderTarget &target, const Block *block, const TexturedQuad *quads,
+                               uint32_t count, float scale, float lod) {
+        bgfx::TransientVertexBuffer tvb;
+        bgfx::TransientIndexBuffer tib;
+        if (!bgfx::allocTransientBuffers(&tvb, m_layout, count * 4, &tib, count * 6)) {
+            return false;
+        }
+
+        auto vertices = reinterpret_cast<PosTexCoord *>(tvb.data);
+        auto indices = reinterpret_cast<uint16_t *>(tib.data);
+        for (uint32_t i = 0; i < count; ++i) {
+            WriteQuad(vertices, indices, i, quads[i], target);
+        }
+
+        SetBlockUniforms(block, target, scale, lod);
+        bgfx::setVertexBuffer(0, &tvb);
+        bgfx::setIndexBuffer(&tib);
+        bgfx::setTexture(0, m_s_tex, block->texture.value());
+        bgfx::setState(BGFX_STATE_WRITE_RGB | BGFX_STATE_WRITE_A);
+        bgfx::submit(target.view, m_program);
+        ++m_frame_submits;
+
+        return true;
+    }
+
+    void MEEngine::SubmitSorted(const RenderTarget &target, DrawCommand *commands, size_t count) {
+        size_t start = 0;
+        while (start < count) {
+            // 16 bit indices limit a batch to MAX_BATCH_QUADS quads
+            if (IsTransparentDraw(commands[start].id, commands[start].tint)) {
+                // static tiles come here without CullDraws
+                ++m_frame_transparent;
+                ++start;
+                continue;
+            }
+            size_t end = start + 1;
+            while (end < count && end - start < MAX_BATCH_QUADS &&
+                   GetTextureBlock(commands[end].id) == GetTextureBlock(commands[start].id) &&
+                   !IsTransparentDraw(commands[end].id, commands[end].tint)) {
+                ++end;
+            }
+
+            if (m_blocks[commands[start].id] == std::nullopt) {
+                // cleared after it was recorded
+            } else if (!SubmitBatch(target, &commands[start], static_cast<uint32_t>(end - start))) {
+                for (size_t i = start; i < end; ++i) {
+                    SubmitBlock(target, commands[i]);
+                }
+            }
+            start = end;
+        }
+    }
+
+    static int FloorDiv(int value, int divisor) {
+        return value >= 0 ? value / divisor : -((-value + divisor - 1) / divisor);
+    }
+
+    void MEEngine::FlushDraws() {
+        if (m_screen_width == 0 || m_screen_height == 0) {
+            return; // minimized
+        }
+        if (m_soft) {
+            RenderSoftware();
+            return;
+        }
+
+        if (m_main_layers & ME_VIEW_LAYER_STATIC) {
+            CompositeStaticLayer();
+        }
+
+        // sorted once, every view culls from the same order
+        std::sort(m_draws.begin(), m_draws.end(), [](const DrawCommand &a, const DrawCommand &b) {
+            return a.sort_key < b.sort_key;
+        });
+
+        RenderTarget target = GetMainTarget();
+        MEFrameVector<DrawCommand> visible(&m_arena);
+        if (CullDraws(target, 0, 0, m_main_layers, visible)) {
+            SubmitSorted(target, visible.begin(), visible.Size());
+        } else {
+            // out of memory, drawing everything beats dropping blocks for a frame
+            SubmitUnculled(target, 0, 0, m_main_layers);
+        }
+        // particles and text glow, they are drawn after the light
+        if (m_main_layers & (ME_VIEW_LAYER_STATIC | ME_VIEW_LAYER_BLOCKS)) {
+            DrawLight(target, m_camera_x, m_camera_y);
+        }
+        if (m_main_layers & ME_VIEW_LAYER_PARTICLES) {
+            FlushParticles(target);
+        }
+
+        for (const auto &view: m_views) {
+            if (view != std::nullopt) {
+                RenderView(view.value());
+            }
+        }
+
+        if (m_main_layers & ME_VIEW_LAYER_TEXT) {
+            FlushText();
+        }
+    }
+
+    MESoftDraw MEEngine::MakeSoftDraw(int id, int x, int y, uint32_t tint, int orientation) const {
+        // the software renderer only knows textures, a variant draws its base turned and tinted
+        MESoftDraw draw = {GetTextureBlock(id), x, y, tint, orientation};
+        if (id >= 0 && id < BLOCK_ARRAY_SIZE && m_blocks[id] != std::nullopt) {
+            const Block &block = m_blocks[id].value();
+            draw.tint = MultiplyTint(block.tint, tint);
+            draw.orientation = ComposeOrientation(block.orientation, orientation);
+        }
+        return draw;
+    }
+
+    void MEEngine::RenderSoftware() {
+        ME_TRACE_SCOPE("RenderSoftware");
+        MEFrameVector<MESoftDraw> draws(&m_arena);
+        bool complete = true;
+        if ((m_main_layers & ME_VIEW_LAYER_STATIC) && m_static_layer.IsEnabled()) {
+            // there is no cache to keep, every visible tile is drawn, animated ones included
+            int tile_width = m_static_layer.GetTileWidth();
+            int tile_height = m_static_layer.GetTileHeight();
+            int right = m_camera_x + static_cast<int>(std::ceil(static_cast<float>(m_screen_width) / m_scale));
+            int bottom = m_camera_y + static_cast<int>(std::ceil(static_cast<float>(m_screen_height) / m_scale));
+            int column_begin = std::max(0, FloorDiv(m_camera_x, tile_width));
+            int column_end = std::min(m_static_layer.GetColumns(), FloorDiv(right - 1, tile_width) + 1);
+            int row_begin = std::max(0, FloorDiv(m_camera_y, tile_height));
+            int row_end = std::min(m_static_layer.GetRows(), FloorDiv(bottom - 1, tile_height) + 1);
+            for (int row = row_begin; complete && row < row_end; ++row) {
+                for (int column = column_begin; complete && column < column_end; ++column) {
+                    int id = GetStaticTile(column, row);
+                    if (id >= 0) {
+                        complete = draws.Push(MakeSoftDraw(id, column * tile_width - m_camera_x,
+                                                           row * tile_height - m_camera_y, ME_TINT_NONE,
+                                                           ME_ORIENT_NONE));
+                    }
+                }
+            }
+        }
+
+        std::sort(m_draws.begin(), m_draws.end(), [](const DrawCommand &a, const DrawCommand &b) {
+            return a.sort_key < b.sort_key;
+        });
+        for (const auto &command: m_draws) {
+            // live static tiles were drawn with the others above
+            if (!complete || !(m_main_layers & ME_VIEW_LAYER_BLOCKS) ||
+                static_cast<int>(command.sort_key >> 56) == LAYER_STATIC_LIVE) {
+                continue;
+            }
+            complete = draws.Push(MakeSoftDraw(command.id, command.x, command.y, command.tint, command.orientation));
+        }
+
+        // the static tiles are in the same list here, blocks over them hide them as well
+        float width = static_cast<float>(m_screen_width) / m_scale;
+        float height = static_cast<float>(m_screen_height) / m_scale;
+        m_occlusion.Reset({0, static_cast<int>(std::ceil(height)), 0, static_cast<int>(std::ceil(width))});
+        for (size_t i = draws.Size(); i-- > 0;) {
+            MESoftDraw &draw = draws.begin()[i];
+            if (IsOccluded(draw.id, draw.tint, draw.orientation, draw.x, draw.y)) {
+                draw.id = -1;
+            }
+        }
+        auto kept = std::remove_if(draws.begin(), draws.end(), [](const MESoftDraw &draw) {
+            return draw.id < 0;
+        });
+        draws.Truncate(static_cast<size_t>(kept - draws.begin()));
+
+        m_soft->Resize(m_screen_width, m_screen_height);
+        m_soft->Render(draws.begin(), draws.Size(), m_scale, m_animation_time, CLEAR_COLOR, m_jobs);
+        // the arena spills to the heap, a draw is only missing when that failed too. The frame is
+        // kept on screen but not handed out as a capture
+        m_soft_complete = complete;
+    }
+
+    bool MEEngine::ReadFramePixels(uint8_t *rgba, int capacity, int *width, int *height) const {
+        if (!m_soft) {
+            return false;
+        }
+        if (width) {
+            *width = m_soft->GetWidth();
+        }
+        if (height) {
+            *height = m_soft->GetHeight();
+        }
+        size_t size = static_cast<size_t>(m_soft->GetWidth()) * m_soft->GetHeight() * 4;
+        if (!m_soft_complete || !rgba || capacity < 0 || static_cast<size_t>(capacity) < size) {
+            return false;
+        }
+        std::memcpy(rgba, m_soft->GetPixels(), size);
+        return true;
+    }
+
+    bool MEEngine::SaveFramePng(const char *path) const {
+        return m_soft && m_soft_complete && m_soft->SavePng(path);
+    }
+
+    bool MEEngine::LoadFont(int font_id, const char *path, float pixel_height, int flags) {
+        if (font_id < 0 || font_id >= ME_MAX_FONTS) {
+            return false;
+        }
+        auto font = MEFont::Load(path, pixel_height, (flags & ME_FONT_FLAG_SDF) != 0);
+        if (!font) {
+            return false;
+        }
+        // glyphs of the old font may still be queued this frame, they are dropped with it
+        UnloadFont(font_id);
+        m_fonts[font_id] = std::move(font);
+        return true;
+    }
+
+    bool MEEngine::UnloadFont(int font_id) {
+        if (font_id < 0 || font_id >= ME_MAX_FONTS || !m_fonts[font_id]) {
+            return false;
+        }
+        auto end = std::remove_if(m_text.begin(), m_text.end(), [font_id](const TextGlyph &glyph) {
+            return glyph.font == font_id;
+        });
+        m_text.Truncate(static_cast<size_t>(end - m_text.begin()));
+        m_fonts[font_id].reset();
+        return true;
+    }
+
+    bool MEEngine::DrawText(int font_id, float x, float y, float scale, const char *text, uint32_t color) {
+        if (font_id < 0 || font_id >= ME_MAX_FONTS || !m_fonts[font_id]) {
+            return false;
+        }
+        MEFont &font = *m_fonts[font_id];
+        // bitmap glyphs only stay crisp on whole pixels, distance fields are fine anywhere
+        bool snap = !font.IsSdf() && scale == 1.0f;
+        float width = static_cast<float>(m_screen_width);
+        float height = static_cast<float>(m_screen_height);
+        float line = y;
+        float pen = x;
+        float baseline = line + font.GetAscent() * scale;
+        const MEGlyph *previous = nullptr;
+        while (*text) {
+            uint32_t codepoint = DecodeUtf8(text);
+            if (codepoint == '\n') {
+                line += font.GetLineHeight() * scale;
+                baseline = line + font.GetAscent() * scale;
+                pen = x;
+                previous = nullptr;
+                continue;
+            }
+            const MEGlyph *glyph = font.GetGlyph(codepoint);
+            if (!glyph) {
+                // the atlas is full, it is wiped after this frame
+                continue;
+            }
+            if (previous) {
+                pen += font.GetKerning(*previous, *glyph) * scale;
+            }
+            previous = glyph;
+
+            if (glyph->visible) {
+                TextGlyph quad = {};
+                quad.sort_key = (static_cast<uint64_t>(font_id) << 32) | static_cast<uint32_t>(m_text.Size());
+                quad.font = font_id;
+                quad.x0 = pen + glyph->x_offset * scale;
+                quad.y0 = baseline + glyph->y_offset * scale;
+                if (snap) {
+                    quad.x0 = std::round(quad.x0);
+                    quad.y0 = std::round(quad.y0);
+                }
+                quad.x1 = quad.x0 + glyph->width * scale;
+                quad.y1 = quad.y0 + glyph->height * scale;
+                quad.u0 = glyph->u0;
+                quad.v0 = glyph->v0;
+                quad.u1 = glyph->u1;
+                quad.v1 = glyph->v1;
+                quad.color = color;
+                bool visible = quad.x1 > 0.0f && quad.y1 > 0.0f && quad.x0 < width && quad.y0 < height;
+                if (visible && !m_text.Push(quad)) {
+                    return false;
+                }
+            }
+            pen += glyph->advance * scale;
+        }
+        return true;
+    }
+
+    int MEEngine::CreateEmitter(const ME_EmitterDesc &desc) {
+        if (desc.block_id < -1 || desc.block_id >= BLOCK_ARRAY_SIZE) {
+            return -1;
+        }
+        return m_particles.CreateEmitter(desc);
+    }
+
+    bool MEEngine::UpdateEmitter(int emitter, const ME_EmitterDesc &desc) {
+        if (desc.block_id < -1 || desc.block_id >= BLOCK_ARRAY_SIZE) {
+            return false;
+        }
+        return m_particles.UpdateEmitter(emitter, desc);
+    }
+
+    bool MEEngine::DestroyEmitter(int emitter) {
+        return m_particles.DestroyEmitter(emitter);
+    }
+
+    bool MEEngine::EmitParticles(int emitter, float x, float y, int count) {
+        return m_particles.Emit(emitter, x, y, count);
+    }
+
+    void MEEngine::GetParticleStats(ME_ParticleStats *stats) const {
+        m_particles.GetStats(stats);
+    }
+
+    void MEEngine::FlushParticles(const RenderTarget &target) {
+        if (!bgfx::isValid(m_particle_program)) {
+            return;
+        }
+        ME_TRACE_SCOPE("FlushParticles");
+        constexpr auto stride = static_cast<uint16_t>(sizeof(ParticleInstance));
+        float resolution[4] = {static_cast<float>(target.width), static_cast<float>(target.height), 0.0f, 0.0f};
+        for (int i = 0; i < ME_MAX_EMITTERS; ++i) {
+            const MEEmitter *emitter = m_particles.GetEmitter(i);
+            if (!emitter || emitter->Size() == 0) {
+                continue;
+            }
+
+            // x = where the first frame of the block ends in its texture
+            float particle[4] = {1.0f, 0.0f, 0.0f, 0.0f};
+            bgfx::TextureHandle texture = m_white_texture;
+            int block_id = emitter->GetDesc().block_id;
+            if (block_id >= 0 && m_blocks[block_id] != std::nullopt) {
+                const Block &block = m_blocks[block_id].value();
+                texture = block.texture.value();
+                particle[0] = 1.0f / static_cast<float>(block.frame_count);
+            }
+
+            // one submit per emitter unless the instance buffer can't hold all of its particles
+            size_t start = 0;
+            size_t total = emitter->Size();
+            while (start < total) {
+                uint32_t count = bgfx::getAvailInstanceDataBuffer(static_cast<uint32_t>(total - start), stride);
+                if (count == 0) {
+                    return;
+                }
+                bgfx::InstanceDataBuffer idb;
+                bgfx::allocInstanceDataBuffer(&idb, count, stride);
+                auto instances = reinterpret_cast<ParticleInstance *>(idb.data);
+                m_jobs.ParallelFor(count, PARTICLE_CHUNK_SIZE, [&](size_t begin, size_t end) {
+                    emitter->WriteInstances(instances + begin, start + begin, start + end, target.scale);
+                });
+
+                bgfx::setUniform(m_u_resolution, resolution);
+                bgfx::setUniform(m_u_particle, particle);
+                bgfx::setVertexBuffer(0, m_instance_vbh);
+                bgfx::setIndexBuffer(m_ibh);
+                bgfx::setInstanceDataBuffer(&idb);
+                bgfx::setTexture(0, m_s_tex, texture);
+                bgfx::setState(BGFX_STATE_WRITE_RGB | BGFX_STATE_WRITE_A | BGFX_STATE_BLEND_ALPHA);
+                bgfx::submit(target.view, m_particle_program);
+                ++m_frame_submits;
+                start += count;
+            }
+        }
+    }
+
+    void MEEngine::SetViewTarget(bgfx::ViewId view, bgfx::FrameBufferHandle frame_buffer, uint16_t width,
+                                 uint16_t height) {
+        ViewState &state = m_view_states[view];
+        if (state.valid && state.frame_buffer == frame_buffer.idx && state.width == width && state.height == height) {
+            return;
+        }
+        state = {true, frame_buffer.idx, width, height};
+        bgfx::setViewFrameBuffer(view, frame_buffer);
+        bgfx::setViewRect(view, 0, 0, width, height);
+    }
+
+    void MEEngine::FlushText() {
+        if (m_text.Size() == 0 || !bgfx::isValid(m_text_program)) {
+            return;
+        }
+        ME_TRACE_SCOPE("FlushText");
+        SetViewTarget(VIEW_HUD, BGFX_INVALID_HANDLE, m_screen_width, m_screen_height);
+
+        // grouped by font, the order inside a font stays the order it was drawn in. The key makes it
+        // unique, std::sort keeps the order without the buffer std::stable_sort allocates
+        std::sort(m_text.begin(), m_text.end(), [](const TextGlyph &a, const TextGlyph &b) {
+            return a.sort_key < b.sort_key;
+        });
+
+        // rect, uv rect and color of every glyph, see vs_text
+        constexpr uint16_t stride = sizeof(float) * 12;
+        float resolution[4] = {static_cast<float>(m_screen_width), static_cast<float>(m_screen_height), 0.0f, 0.0f};
+        size_t start = 0;
+        while (start < m_text.Size()) {
+            int font_id = m_text[start].font;
+            size_t end = start + 1;
+            while (end < m_text.Size() && m_text[end].font == font_id) {
+                ++end;
+            }
+
+            // one submit per font unless the instance buffer can't hold all of its glyphs
+            while (start < end) {
+                uint32_t count = bgfx::getAvailInstanceDataBuffer(static_cast<uint32_t>(end - start), stride);
+                if (count == 0) {
+                    return;
+                }
+                bgfx::InstanceDataBuffer idb;
+                bgfx::allocInstanceDataBuffer(&idb, count, stride);
+                auto data = reinterpret_cast<float *>(idb.data);
+                for (uint32_t i = 0; i < count; ++i, data += 12) {
+                    const TextGlyph &glyph = m_text[start + i];
+                    data[0] = glyph.x0;
+                    data[1] = glyph.y0;
+                    data[2] = glyph.x1 - glyph.x0;
+                    data[3] = glyph.y1 - glyph.y0;
+                    data[4] = glyph.u0;
+                    data[5] = glyph.v0;
+                    data[6] = glyph.u1;
+                    data[7] = glyph.v1;
+                    data[8] = static_cast<float>((glyph.color >> 24) & 0xFF) / 255.0f;
+                    data[9] = static_cast<float>((glyph.color >> 16) & 0xFF) / 255.0f;
+                    data[10] = static_cast<float>((glyph.color >> 8) & 0xFF) / 255.0f;
+                    data[11] = static_cast<float>(glyph.color & 0xFF) / 255.0f;
+                }
+
+                const MEFont &font = *m_fonts[font_id];
+                float text[4] = {font.IsSdf() ? 1.0f : 0.0f, 0.0f, 0.0f, 0.0f};
+                bgfx::setUniform(m_u_resolution, resolution);
+                bgfx::setUniform(m_u_text, text);
+                bgfx::setVertexBuffer(0, m_instance_vbh);
+                bgfx::setIndexBuffer(m_ibh);
+                bgfx::setInstanceDataBuffer(&idb);
+                bgfx::setTexture(0, m_s_tex, font.GetAtlas());
+                bgfx::setState(BGFX_STATE_WRITE_RGB | BGFX_STATE_WRITE_A | BGFX_STATE_BLEND_ALPHA);
+                bgfx::submit(VIEW_HUD, m_text_program);
+                ++m_frame_submits;
+                start += count;
+            }
+        }
+    }
+
+    bool MEEngine::CullDraws(const RenderTarget &target, int shift_x, int shift_y, int layers,
+                             MEFrameVector<DrawCommand> &visible) {
+        float width = static_cast<float>(target.width) / target.scale;
+        float height = static_cast<float>(target.height) / target.scale;
+        for (const auto &command: m_draws) {
+            if (!IsDrawInLayers(command, target, layers)) {
+                continue;
+            }
+            const Block &block = m_blocks[command.id].value();
+            DrawCommand moved = command;
+            moved.x += shift_x;
+            moved.y += shift_y;
+            bool turned = IsTurned(block.orientation, command.orientation);
+            if (static_cast<float>(moved.x) >= width || static_cast<float>(moved.y) >= height ||
+                moved.x + (turned ? block.height : block.width) <= 0 ||
+                moved.y + (turned ? block.width : block.height) <= 0) {
+                continue;
+            }
+            if (!visible.Push(moved)) {
+                return false;
+            }
+        }
+
+        // the sort key keeps blocks in call order, so walking back from the last drawn sees what is on top
+        // first. What a later opaque draw covers whole is never seen
+        m_occlusion.Reset({0, static_cast<int>(std::ceil(height)), 0, static_cast<int>(std::ceil(width))});
+        for (size_t i = visible.Size(); i-- > 0;) {
+            DrawCommand &command = visible.begin()[i];
+            if (IsOccluded(command.id, command.tint, command.orientation, command.x, command.y)) {
+                command.id = -1;
+            }
+        }
+        auto kept = std::remove_if(visible.begin(), visible.end(), [](const DrawCommand &command) {
+            return command.id < 0;
+        });
+        visible.Truncate(static_cast<size_t>(kept - visible.begin()));
+        return true;
+    }
+
+    bool MEEngine::IsDrawInLayers(const DrawCommand &command, const RenderTarget &target, int layers) const {
+        // live static tiles are recorded with the blocks but belong to the static layer
+        int layer = static_cast<int>(command.sort_key >> 56) == LAYER_STATIC_LIVE
+                        ? ME_VIEW_LAYER_STATIC
+                        : ME_VIEW_LAYER_BLOCKS;
+        if (!(layers & layer) || m_blocks[command.id] == std::nullopt) {
+            return false;
+        }
+        // an offscreen view can't sample what it is rendering into
+        return !(m_blocks[command.id].value().view_target && target.view < VIEW_MAIN);
+    }
+
+    void MEEngine::SubmitUnculled(const RenderTarget &target, int shift_x, int shift_y, int layers) {
+        size_t count = m_draws.Size();
+        size_t start = 0;
+        while (start < count) {
+            if (!IsDrawInLayers(m_draws[start], target, layers)) {
+                ++start;
+                continue;
+            }
+            size_t end = start + 1;
+            while (end < count && IsDrawInLayers(m_draws[end], target, layers)) {
+                ++end;
+            }
+            for (size_t i = start; i < end; ++i) {
+                m_draws[i].x += shift_x;
+                m_draws[i].y += shift_y;
+            }
+            SubmitSorted(target, &m_draws[start], end - start);
+            for (size_t i = start; i < end; ++i) {
+                m_draws[i].x -= shift_x;
+                m_draws[i].y -= shift_y;
+            }
+            start = end;
+        }
+    }
+
+    bool MEEngine::IsTransparentDraw(int id, uint32_t tint) const {
+        if (id < 0 || id >= BLOCK_ARRAY_SIZE || m_blocks[id] == std::nullopt) {
+            return false;
+        }
+        const Block &block = m_blocks[id].value();
+        return block.coverage.kind == ALPHA_TRANSPARENT || (MultiplyTint(block.tint, tint) & 0xFF) == 0;
+    }
+
+    // the opaque rect of a texture where it ends up once the texture is drawn turned
+    static ME_Rect OrientCoverage(const MEAlphaCoverage &coverage, int width, int height, int orientation) {
+        ME_Rect rect = {coverage.top, coverage.bottom, coverage.left, coverage.right};
+        if (orientation & ME_ORIENT_FLIP_X) {
+            rect = {rect.top, rect.bottom, width - rect.right, width - rect.left};
+        }
+        if (orientation & ME_ORIENT_FLIP_Y) {
+            rect = {height - rect.bottom, height - rect.top, rect.left, rect.right};
+        }
+        // clockwise, the left edge becomes the top one
+        for (int turn = 0; turn < ((orientation >> 2) & 3); ++turn) {
+            rect = {rect.left, rect.right, height - rect.bottom, height - rect.top};
+            std::swap(width, height);
+        }
+        return rect;
+    }
+
+    bool MEEngine::IsOccluded(int id, uint32_t tint, int orientation, int x, int y) {
+        if (id < 0 || id >= BLOCK_ARRAY_SIZE || m_blocks[id] == std::nullopt) {
+            return false;
+        }
+        if (IsTransparentDraw(id, tint)) {
+            ++m_frame_transparent;
+            return true;
+        }
+        const Block &block = m_blocks[id].value();
+        orientation = ComposeOrientation(block.orientation, orientation);
+        bool turned = (orientation & ME_ORIENT_ROTATE_90) != 0;
+        ME_Rect rect = {y, y + (turned ? block.width : block.height), x, x + (turned ? block.height : block.width)};
+        if (m_occlusion.IsHidden(rect)) {
+            ++m_frame_occluded;
+            return true;
+        }
+        // a translucent tint lets everything under it show
+        if ((MultiplyTint(block.tint, tint) & 0xFF) == 0xFF) {
+            ME_Rect opaque = OrientCoverage(block.coverage, block.width, block.height, orientation);
+            m_occlusion.AddOccluder({opaque.top + y, opaque.bottom + y, opaque.left + x, opaque.right + x});
+        }
+        return false;
+    }
+
+    void MEEngine::DrawStaticTiles(const RenderTarget &target, int camera_x, int camera_y) {
+        if (!m_static_layer.IsEnabled()) {
+            return;
+        }
+        if (m_tilemap_ready) {
+            DrawTilemap(target, camera_x, camera_y);
+            return;
+        }
+
+        // the cache only holds the main view, other views draw their visible tiles every frame
+        int tile_width = m_static_layer.GetTileWidth();
+        int tile_height = m_static_layer.GetTileHeight();
+        int right = camera_x + static_cast<int>(std::ceil(static_cast<float>(target.width) / target.scale));
+        int bottom = camera_y + static_cast<int>(std::ceil(static_cast<float>(target.height) / target.scale));
+        int column_begin = std::max(0, FloorDiv(camera_x, tile_width));
+        int column_end = std::min(m_static_layer.GetColumns(), FloorDiv(right - 1, tile_width) + 1);
+        int row_begin = std::max(0, FloorDiv(camera_y, tile_height));
+        int row_end = std::min(m_static_layer.GetRows(), FloorDiv(bottom - 1, tile_height) + 1);
+
+        MEFrameVector<DrawCommand> tiles(&m_arena);
+        bool complete = true;
+        for (int row = row_begin; complete && row < row_end; ++row) {
+            for (int column = column_begin; complete && column < column_end; ++column) {
+                int id = GetStaticTile(column, row);
+                if (id < 0 || id >= BLOCK_ARRAY_SIZE || m_blocks[id] == std::nullopt ||
+                    (m_blocks[id].value().view_target && target.view < VIEW_MAIN)) {
+                    continue;
+                }
+                DrawCommand command = {};
+                command.sort_key = MakeSortKey(0, id, static_cast<uint32_t>(tiles.Size()));
+                command.id = id;
+                command.x = column * tile_width - camera_x;
+                command.y = row * tile_height - camera_y;
+                // the arena spills to the heap, this only stops when the heap is out of memory too
+                complete = tiles.Push(command);
+            }
+        }
+        std::sort(tiles.begin(), tiles.end(), [](const DrawCommand &a, const DrawCommand &b) {
+            return a.sort_key < b.sort_key;
+        });
+        SubmitSorted(target, tiles.begin(), tiles.Size());
+    }
+
+    void MEEngine::RenderView(const View &view) {
+        ME_TRACE_SCOPE("RenderView");
+        RenderTarget target = GetViewTarget(view);
+        // cleared even when nothing is drawn into it
+        bgfx::touch(target.view);
+
+        const ME_ViewDesc &desc = view.desc;
+        if (desc.layer_mask & ME_VIEW_LAYER_STATIC) {
+            DrawStaticTiles(target, desc.camera_x, desc.camera_y);
+        }
+        if (desc.layer_mask & ME_VIEW_LAYER_BLOCKS) {
+            // block positions are relative to the main camera
+            int shift_x = m_camera_x - desc.camera_x;
+            int shift_y = m_camera_y - desc.camera_y;
+            MEFrameVector<DrawCommand> visible(&m_arena);
+            if (CullDraws(target, shift_x, shift_y, ME_VIEW_LAYER_BLOCKS, visible)) {
+                SubmitSorted(target, visible.begin(), visible.Size());
+            } else {
+                SubmitUnculled(target, shift_x, shift_y, ME_VIEW_LAYER_BLOCKS);
+            }
+        }
+        if (desc.layer_mask & (ME_VIEW_LAYER_STATIC | ME_VIEW_LAYER_BLOCKS)) {
+            DrawLight(target, desc.camera_x, desc.camera_y);
+        }
+    }
+
+    RenderTarget MEEngine::GetMainTarget() const {
+        return {VIEW_MAIN, 0, 0, m_screen_width, m_screen_height, m_scale, m_texture_lod, false};
+    }
+
+    RenderTarget MEEngine::GetViewTarget(const View &view) const {
+        bool offscreen = view.desc.target_block_id >= 0;
+        RenderTarget target = {};
+        target.view = view.id;
+        target.x = offscreen ? 0 : static_cast<uint16_t>(view.desc.x);
+        target.y = offscreen ? 0 : static_cast<uint16_t>(view.desc.y);
+        target.width = static_cast<uint16_t>(view.desc.width);
+        target.height = static_cast<uint16_t>(view.desc.height);
+        target.scale = view.desc.scale;
+        target.lod = GetTextureLod(view.desc.scale);
+        target.flip_y = offscreen && bgfx::getCaps()->originBottomLeft;
+        return target;
+    }
+
+    int MEEngine::CreateView(const ME_ViewDesc &desc) {
+        for (int i = 0; i < ME_MAX_VIEWS; ++i) {
+            if (m_views[i] == std::nullopt) {
+                return SetView(i, desc) ? i + 1 : -1;
+            }
+        }
+        return -1;
+    }
+
+    bool MEEngine::UpdateView(int view, const ME_ViewDesc &desc) {
+        if (view < 1 || view > ME_MAX_VIEWS || m_views[view - 1] == std::nullopt) {
+            return false;
+        }
+        return SetView(view - 1, desc);
+    }
+
+    bool MEEngine::DestroyView(int view) {
+        if (view < 1 || view > ME_MAX_VIEWS || m_views[view - 1] == std::nullopt) {
+            return false;
+        }
+        ReleaseViewTarget(m_views[view - 1].value());
+        m_views[view - 1] = std::nullopt;
+        return true;
+    }
+
+    bool MEEngine::SetViewLayers(int view, int layer_mask) {
+        if (view == ME_VIEW_MAIN) {
+            m_main_layers = layer_mask;
+            return true;
+        }
+        if (view < 1 || view > ME_MAX_VIEWS || m_views[view - 1] == std::nullopt) {
+            return false;
+        }
+        m_views[view - 1].value().desc.layer_mask = layer_mask;
+        return true;
+    }
+
+    bool MEEngine::SetView(int index, const ME_ViewDesc &desc) {
+        if (desc.width <= 0 || desc.height <= 0 || desc.width > UINT16_MAX || desc.height > UINT16_MAX ||
+            desc.scale <= 0.0f || desc.target_block_id >= BLOCK_ARRAY_SIZE) {
+            return false;
+        }
+        bool offscreen = desc.target_block_id >= 0;
+        if (!offscreen && (desc.x < 0 || desc.y < 0 || desc.x > UINT16_MAX || desc.y > UINT16_MAX)) {
+            return false;
+        }
+
+        auto &slot = m_views[index];
+        bool keep_target = slot != std::nullopt && offscreen && slot->desc.target_block_id == desc.target_block_id &&
+                           slot->desc.width == desc.width && slot->desc.height == desc.height;
+        bool own_block = slot != std::nullopt && slot->desc.target_block_id == desc.target_block_id;
+        if (offscreen && !own_block && m_blocks[desc.target_block_id] != std::nullopt) {
+            return false;
+        }
+
+        View view = {};
+        view.target = BGFX_INVALID_HANDLE;
+        if (slot != std::nullopt) {
+            if (keep_target) {
+                view.target = slot->target;
+            } else {
+                ReleaseViewTarget(slot.value());
+            }
+        }
+        view.desc = desc;
+        view.id = static_cast<bgfx::ViewId>((offscreen ? VIEW_OFFSCREEN_FIRST : VIEW_WINDOW_FIRST) + index);
+
+        if (offscreen && !keep_target) {
+            uint16_t width = static_cast<uint16_t>(desc.width);
+            uint16_t height = static_cast<uint16_t>(desc.height);
+            bgfx::TextureHandle texture = bgfx::createTexture2D(
+                width, height, false, 1, bgfx::TextureFormat::RGBA8,
+                BGFX_TEXTURE_RT | BGFX_SAMPLER_POINT | BGFX_SAMPLER_UVW_CLAMP);
+            view.target = bgfx::createFrameBuffer(1, &texture, true);
+
+            // drawn like any other block, the view renders it again every frame
+            Block block = {};
+            block.id = desc.target_block_id;
+            block.texture = texture;
+            block.width = desc.width;
+            block.height = desc.height;
+            block.channels = 4;
+            block.frame_count = 1;
+            block.view_target = true;
+            m_blocks[block.id] = block;
+            m_static_layer.InvalidateAll();
+            m_tilemap_blocks_dirty = true;
+        }
+
+        bgfx::setViewMode(view.id, bgfx::ViewMode::Sequential);
+        bgfx::setViewClear(view.id, BGFX_CLEAR_COLOR | BGFX_CLEAR_DEPTH, CLEAR_COLOR, 1.0f, 0);
+        if (offscreen) {
+            bgfx::setViewFrameBuffer(view.id, view.target);
+            bgfx::setViewRect(view.id, 0, 0, static_cast<uint16_t>(desc.width), static_cast<uint16_t>(desc.height));
+        } else {
+            bgfx::setViewFrameBuffer(view.id, BGFX_INVALID_HANDLE);
+            bgfx::setViewRect(view.id, static_cast<uint16_t>(desc.x), static_cast<uint16_t>(desc.y),
+                              static_cast<uint16_t>(desc.width), static_cast<uint16_t>(desc.height));
+        }
+        slot = view;
+        return true;
+    }
+
+    void MEEngine::ReleaseViewTarget(View &view) {
+        if (!bgfx::isValid(view.target)) {
+            return;
+        }
+        bgfx::setViewFrameBuffer(view.id, BGFX_INVALID_HANDLE);
+        bgfx::destroy(view.target);
+        view.target = BGFX_INVALID_HANDLE;
+        m_blocks[view.desc.target_block_id] = std::nullopt;
+        m_static_layer.InvalidateAll();
+        m_tilemap_blocks_dirty = true;
+    }
+
+    bool MEEngine::SetStaticLayer(int tile_width, int tile_height, int columns, int rows) {
+        if (tile_width <= 0 || tile_height <= 0 || columns < 0 || rows < 0) {
+            return false;
+        }
+        m_map.Close();
+        m_world.reset();
+        m_static_layer.Resize(tile_width, tile_height, columns, rows);
+        m_spatial.Resize(tile_width, tile_height, columns, rows);
+        m_paths.Resize(columns, rows);
+        m_light_tiles_dirty = true;
+        InvalidateTilemap();
+        return true;
+    }
+
+    bool MEEngine::SetStaticTile(int column, int row, int id) {
+        if (id >= BLOCK_ARRAY_SIZE) {
+            return false;
+        }
+        bool live = false;
+        if (id >= 0) {
+            // a block still loading is placed as well, it shows up once it arrives
+            if (m_blocks[id] == std::nullopt) {
+                if (!m_block_pending[id] && m_variants[id] == std::nullopt) {
+                    return false;
+                }
+            } else {
+                // a cached animated block would stop on whatever frame it was drawn with
+                live = m_blocks[id].value().frame_count > 1;
+            }
+        } else {
+            id = -1;
+        }
+        bool inside = !m_world && column >= 0 && row >= 0 && column < m_static_layer.GetColumns() &&
+                      row < m_static_layer.GetRows();
+        int previous = inside ? m_static_layer.GetTile(column, row) : -1;
+        if (!m_static_layer.SetTile(column, row, id, live)) {
+            return false;
+        }
+        SetTileSolid(column, row, IsSolidBlock(id));
+        SetTileLight(column, row, id);
+
+        if (!m_tilemap_blocks_dirty) {
+            m_tilemap_foreign += (IsTilemapForeign(id) ? 1 : 0) - (IsTilemapForeign(previous) ? 1 : 0);
+        }
+        ME_Rect tile = {row, row + 1, column, column + 1};
+        bool empty = m_tilemap_dirty.left >= m_tilemap_dirty.right || m_tilemap_dirty.top >= m_tilemap_dirty.bottom;
+        m_tilemap_dirty = empty ? tile : MEStaticLayer::Union(m_tilemap_dirty, tile);
+        return true;
+    }
+
+    void MEEngine::SetCamera(int x, int y) {
+        m_camera_x = x;
+        m_camera_y = y;
+    }
+
+    bool MEEngine::OpenWorld(const char *path, int placeholder_id, size_t budget_bytes) {
+        if (placeholder_id >= BLOCK_ARRAY_SIZE || (placeholder_id >= 0 && m_blocks[placeholder_id] == std::nullopt)) {
+            return false;
+        }
+        auto world = std::make_unique<MEWorldStream>();
+        if (!world->Open(path, budget_bytes)) {
+            return false;
+        }
+        m_map.Close();
+
+        const MEWorldHeader &header = world->GetHeader();
+        m_static_layer.Resize(static_cast<int>(header.tile_width), static_cast<int>(header.tile_height),
+                              static_cast<int>(header.columns), static_cast<int>(header.rows), false);
+        m_spatial.Resize(static_cast<int>(header.tile_width), static_cast<int>(header.tile_height),
+                         static_cast<int>(header.columns), static_cast<int>(header.rows));
+        m_paths.Resize(static_cast<int>(header.columns), static_cast<int>(header.rows));
+        m_world = std::move(world);
+        m_world_placeholder = placeholder_id < 0 ? -1 : placeholder_id;
+        m_light_tiles_dirty = true;
+        InvalidateTilemap();
+
+        return true;
+    }
+
+    void MEEngine::CloseWorld() {
+        m_world.reset();
+        m_static_layer.Resize(0, 0, 0, 0);
+        m_spatial.Resize(0, 0, 0, 0);
+        m_paths.Resize(0, 0);
+        m_light_tiles_dirty = true;
+        InvalidateTilemap();
+    }
+
+    bool MEEngine::GetWorldStats(ME_WorldStats *stats) {
+        if (!m_world) {
+            return false;
+        }
+        m_world->GetStats(stats);
+        return true;
+    }
+
+    bool MEEngine::OpenMap(const char *path) {
+        if (m_world) {
+            return false;
+        }
+        std::error_code ec;
+        if (!std::filesystem::exists(path, ec)) {
+            if (!m_static_layer.IsEnabled()) {
+                return false;
+            }
+            std::vector<int16_t> tiles = GetStaticTiles();
+            return m_map.Create(path, m_static_layer.GetTileWidth(), m_static_layer.GetTileHeight(),
+                                m_static_layer.GetColumns(), m_static_layer.GetRows(), tiles.data());
+        }
+
+        std::vector<int16_t> tiles;
+        if (!m_map.Open(path, tiles)) {
+            return false;
+        }
+        const MEWorldHeader &header = m_map.GetHeader();
+        int columns = static_cast<int>(header.columns);
+        int rows = static_cast<int>(header.rows);
+        m_static_layer.Resize(static_cast<int>(header.tile_width), static_cast<int>(header.tile_height), columns, rows);
+        m_spatial.Resize(static_cast<int>(header.tile_width), static_cast<int>(header.tile_height), columns, rows);
+        m_paths.Resize(columns, rows);
+        for (int row = 0; row < rows; ++row) {
+            for (int column = 0; column < columns; ++column) {
+                // ids of blocks that aren't loaded are kept, they are the map's and get saved again
+                int id = tiles[static_cast<size_t>(row) * columns + column];
+                id = id >= 0 && id < BLOCK_ARRAY_SIZE ? id : -1;
+                bool live = id >= 0 && m_blocks[id] != std::nullopt && m_blocks[id].value().frame_count > 1;
+                m_static_layer.SetTile(column, row, id, live);
+            }
+        }
+        m_spatial_dirty = true;
+        m_light_tiles_dirty = true;
+        InvalidateTilemap();
+        return true;
+    }
+
+    bool MEEngine::SetMapTile(int column, int row, int id) {
+        if (!m_map.IsOpen() || !SetStaticTile(column, row, id)) {
+            return false;
+        }
+        m_map.SetTile(column, row, id);
+        return true;
+    }
+
+    bool MEEngine::FillMapRect(int column, int row, int width, int height, int id) {
+        int column_end = std::min(m_static_layer.GetColumns(), column + width);
+        int row_end = std::min(m_static_layer.GetRows(), row + height);
+        column = std::max(column, 0);
+        row = std::max(row, 0);
+        if (!m_map.IsOpen() || width <= 0 || height <= 0 || column >= column_end || row >= row_end) {
+            return false;
+        }
+        for (int y = row; y < row_end; ++y) {
+            for (int x = column; x < column_end; ++x) {
+                // fails on the first tile already when the block is unknown
+                if (!SetStaticTile(x, y, id)) {
+                    return false;
+                }
+            }
+        }
+        m_map.FillRect(column, row, column_end - column, row_end - row, id);
+        return true;
+    }
+
+    bool MEEngine::SaveMap() {
+        if (!m_map.Save()) {
+            return false;
+        }
+        if (m_map.NeedsCompaction()) {
+            m_map.Compact(GetStaticTiles());
+        }
+        return true;
+    }
+
+    bool MEEngine::CompactMap() {
+        if (!m_map.IsOpen()) {
+            return false;
+        }
+        m_map.WaitCompaction();
+        return m_map.Compact(GetStaticTiles());
+    }
+
+    void MEEngine::CloseMap() {
+        m_map.Close();
+    }
+
+    bool MEEngine::GetMapStats(ME_MapStats *stats) {
+        if (!m_map.IsOpen()) {
+            return false;
+        }
+        m_map.GetStats(stats);
+        return true;
+    }
+
+    std::vector<int16_t> MEEngine::GetStaticTiles() const {
+        int columns = m_static_layer.GetColumns();
+        int rows = m_static_layer.GetRows();
+        std::vector<int16_t> tiles(static_cast<size_t>(columns) * rows);
+        for (int row = 0; row < rows; ++row) {
+            for (int column = 0; column < columns; ++column) {
+                tiles[static_cast<size_t>(row) * columns + column] = static_cast<int16_t>(
+                    m_static_layer.GetTile(column, row));
+            }
+        }
+        return tiles;
+    }
+
+    bool MEEngine::IsSolidBlock(int id) const {
+        return id >= 0 && id < BLOCK_ARRAY_SIZE && m_blocks[id] != std::nullopt && m_blocks[id].value().solid;
+    }
+
+    void MEEngine::SetTileSolid(int column, int row, bool solid) {
+        m_spatial.SetSolid(column, row, solid);
+        m_paths.SetSolid(column, row, solid);
+    }
+
+    void MEEngine::SetChunkSolids(int index, bool resident) {
+        const ME_Rect rect = m_world->GetChunkRect(index);
+        const int16_t *tiles = resident ? m_world->GetChunkTiles(index) : nullptr;
+        int chunk_size = static_cast<int>(m_world->GetHeader().chunk_size);
+        int column0 = rect.left / m_static_layer.GetTileWidth();
+        int row0 = rect.top / m_static_layer.GetTileHeight();
+        for (int y = 0; y < chunk_size; ++y) {
+            for (int x = 0; x < chunk_size; ++x) {
+                // unloaded chunks are treated as empty, gameplay should stay near the camera
+                bool solid = tiles && IsSolidBlock(tiles[y * chunk_size + x]);
+                SetTileSolid(column0 + x, row0 + y, solid);
+            }
+        }
+    }
+
+    void MEEngine::UpdateSpatialIndex() {
+        if (!m_spatial_dirty) {
+            return;
+        }
+        m_spatial_dirty = false;
+        ME_TRACE_SCOPE("UpdateSpatialIndex");
+
+        if (m_world) {
+            m_spatial.Clear();
+            m_paths.Clear();
+            for (int index: m_world->GetResidentChunks()) {
+                SetChunkSolids(index, true);
+            }
+            return;
+        }
+        for (int row = 0; row < m_static_layer.GetRows(); ++row) {
+            for (int column = 0; column < m_static_layer.GetColumns(); ++column) {
+                SetTileSolid(column, row, IsSolidBlock(m_static_layer.GetTile(column, row)));
+            }
+        }
+    }
+
+    bool MEEngine::SetBlockLight(int id, int emission, int opacity) {
+        if (id < 0 || id >= BLOCK_ARRAY_SIZE || emission < 0 || emission > ME_LIGHT_MAX || opacity < 0 ||
+            opacity > ME_LIGHT_MAX) {
+            return false;
+        }
+        if (m_block_emission[id] != emission || m_block_opacity[id] != opacity) {
+            m_block_emission[id] = static_cast<uint8_t>(emission);
+            m_block_opacity[id] = static_cast<uint8_t>(opacity);
+            m_light_tiles_dirty = true;
+        }
+        return true;
+    }
+
+    bool MEEngine::SetLighting(bool enabled, int ambient, int air_falloff) {
+        if (ambient < 0 || ambient > ME_LIGHT_MAX || air_falloff < ME_LIGHT_MIN_FALLOFF || air_falloff > ME_LIGHT_MAX) {
+            return false;
+        }
+        m_light_ambient = ambient;
+        if (!enabled) {
+            m_lighting = false;
+            m_light.Resize(0, 0, air_falloff);
+            if (bgfx::isValid(m_light_texture)) {
+                bgfx::destroy(m_light_texture);
+                m_light_texture = BGFX_INVALID_HANDLE;
+            }
+            return true;
+        }
+        if (!m_lighting || m_air_falloff != air_falloff) {
+            m_light_tiles_dirty = true;
+        }
+        m_lighting = true;
+        m_air_falloff = air_falloff;
+        return true;
+    }
+
+    int MEEngine::GetLight(int column, int row) const {
+        if (!m_lighting || column < 0 || row < 0 || column >= m_light.GetColumns() || row >= m_light.GetRows()) {
+            return -1;
+        }
+        return m_light.GetLight(column, row);
+    }
+
+    void MEEngine::GetLightStats(ME_LightStats *stats) const {
+        *stats = m_light_stats;
+        stats->enabled = m_lighting ? 1 : 0;
+    }
+
+    void MEEngine::SetTileLight(int column, int row, int id) {
+        if (!m_lighting || m_light_tiles_dirty) {
+            return; // the whole grid is refreshed before the next relight anyway
+        }
+        bool block = id >= 0 && id < BLOCK_ARRAY_SIZE;
+        int emission = block ? m_block_emission[id] : 0;
+        int opacity = block ? m_block_opacity[id] : 0;
+        m_light.SetTile(column, row, emission, opacity > 0 ? opacity : m_air_falloff);
+    }
+
+    void MEEngine::SetChunkLight(int index, bool resident) {
+        if (!m_lighting || m_light_tiles_dirty) {
+            return;
+        }
+        const ME_Rect rect = m_world->GetChunkRect(index);
+        const int16_t *tiles = resident ? m_world->GetChunkTiles(index) : nullptr;
+        int chunk_size = static_cast<int>(m_world->GetHeader().chunk_size);
+        int column0 = rect.left / m_static_layer.GetTileWidth();
+        int row0 = rect.top / m_static_layer.GetTileHeight();
+        for (int y = 0; y < chunk_size; ++y) {
+            for (int x = 0; x < chunk_size; ++x) {
+                // unloaded chunks are lit as air, like they are empty to the spatial queries
+                SetTileLight(column0 + x, row0 + y, tiles ? tiles[y * chunk_size + x] : -1);
+            }
+        }
+    }
+
+    void MEEngine::RefreshLightTiles() {
+        m_light_tiles_dirty = false;
+        int columns = m_static_layer.GetColumns();
+        int rows = m_static_layer.GetRows();
+        if (columns != m_light.GetColumns() || rows != m_light.GetRows()) {
+            m_light.Resize(columns, rows, m_air_falloff);
+            if (bgfx::isValid(m_light_texture)) {
+                bgfx::destroy(m_light_texture);
+                m_light_texture = BGFX_INVALID_HANDLE;
+            }
+        }
+
+        // only the tiles whose light inputs changed are relit
+        if (m_world) {
+            for (int row = 0; row < rows; ++row) {
+                for (int column = 0; column < columns; ++column) {
+                    SetTileLight(column, row, -1);
+                }
+            }
+            for (int index: m_world->GetResidentChunks()) {
+                SetChunkLight(index, true);
+            }
+            return;
+        }
+        for (int row = 0; row < rows; ++row) {
+            for (int column = 0; column < columns; ++column) {
+                SetTileLight(column, row, m_static_layer.GetTile(column, row));
+            }
+        }
+    }
+
+    void MEEngine::UpdateLight() {
+        m_light_stats.relit_tiles = 0;
+        m_light_stats.update_ms = 0.0;
+        if (!m_lighting) {
+            return;
+        }
+        auto start = std::chrono::steady_clock::now();
+        if (m_light_tiles_dirty) {
+            ME_TRACE_SCOPE("RefreshLightTiles");
+            RefreshLightTiles();
+        }
+        m_light_stats.relit_tiles = m_light.Update(m_jobs);
+        m_light_stats.thread_count = m_jobs.GetThreadCount();
+        auto elapsed = std::chrono::steady_clock::now() - start;
+        m_light_stats.update_ms = std::chrono::duration<double, std::milli>(elapsed).count();
+        UploadLight();
+    }
+
+    void MEEngine::UploadLight() {
+        const ME_Rect changed = m_light.GetChanged();
+        if (changed.left >= changed.right || changed.top >= changed.bottom) {
+            return;
+        }
+        int columns = m_light.GetColumns();
+        int rows = m_light.GetRows();
+        if (!bgfx::isValid(m_light_texture)) {
+            uint32_t max_size = bgfx::getCaps()->limits.maxTextureSize;
+            if (static_cast<uint32_t>(columns) > max_size || static_cast<uint32_t>(rows) > max_size) {
+                // too large to draw, ME_GetLight still works
+                m_light.ClearChanged();
+                return;
+            }
+            // filtered, the light blends smoothly from the center of one tile to the next
+            m_light_texture = bgfx::createTexture2D(static_cast<uint16_t>(columns), static_cast<uint16_t>(rows), false,
+                                                    1, bgfx::TextureFormat::R8, BGFX_SAMPLER_UVW_CLAMP);
+        }
+
+        ME_TRACE_SCOPE("UploadLight");
+        int width = changed.right - changed.left;
+        int height = changed.bottom - changed.top;
+        const bgfx::Memory *memory = bgfx::alloc(static_cast<uint32_t>(width * height));
+        const uint8_t *light = m_light.GetLightData();
+        for (int row = 0; row < height; ++row) {
+            std::memcpy(memory->data + static_cast<size_t>(row) * width,
+                        light + static_cast<size_t>(changed.top + row) * columns + changed.left, width);
+        }
+        bgfx::updateTexture2D(m_light_texture, 0, 0, static_cast<uint16_t>(changed.left),
+                              static_cast<uint16_t>(changed.top), static_cast<uint16_t>(width),
+                              static_cast<uint16_t>(height), memory);
+        m_light.ClearChanged();
+    }
+
+    void MEEngine::DrawLight(const RenderTarget &target, int camera_x, int camera_y) {
+        if (!m_lighting || !m_static_layer.IsEnabled() || !bgfx::isValid(m_light_texture) ||
+            !bgfx::isValid(m_light_program)) {
+            return;
+        }
+        float resolution[4] = {static_cast<float>(target.width), static_cast<float>(target.height), 0.0f, 0.0f};
+        float tilemap[4] = {
+            static_cast<float>(camera_x), static_cast<float>(camera_y), target.scale, target.flip_y ? 1.0f : 0.0f
+        };
+        float grid[4] = {
+            static_cast<float>(m_static_layer.GetTileWidth()), static_cast<float>(m_static_layer.GetTileHeight()),
+            static_cast<float>(m_light.GetColumns()), static_cast<float>(m_light.GetRows())
+        };
+        float light[4] = {static_cast<float>(m_light_ambient) / ME_LIGHT_MAX, 0.0f, 0.0f, 0.0f};
+        bgfx::setUniform(m_u_resolution, resolution);
+        bgfx::setUniform(m_u_tilemap, tilemap);
+        bgfx::setUniform(m_u_tilemap_grid, grid);
+        bgfx::setUniform(m_u_light, light);
+        bgfx::setVertexBuffer(0, m_vbh);
+        bgfx::setIndexBuffer(m_ibh);
+        bgfx::setTexture(0, m_s_tex, m_light_texture);
+        bgfx::setState(BGFX_STATE_WRITE_RGB | BGFX_STATE_BLEND_MULTIPLY);
+        bgfx::submit(target.view, m_light_program);
+        ++m_frame_submits;
+    }
+
+    int MEEngine::QueryPoint(int x, int y) {
+        int column = 0;
+        int row = 0;
+        if (!m_static_layer.IsEnabled() || !m_spatial.GetTileAt(x, y, column, row)) {
+            return -1;
+        }
+        int id = GetStaticTile(column, row);
+        return id == m_world_placeholder && m_world ? -1 : id;
+    }
 
-    return ME_TRUE;
-}
+    int MEEngine::QueryAABB(const ME_AABB &box, ME_TileCoord *tiles, int capacity) {
+        UpdateSpatialIndex();
+        return m_spatial.QuerySolid(box, tiles, capacity);
+    }
 
-ME_API ME_BOOL ME_SetWindowTitle(ME_HANDLE handle, const char *title) {
-    auto *window = static_cast<ME::MEWindow *>(handle);
-    return window->SetTitle(title);
-}
+    bool MEEngine::Raycast(const ME_Ray &ray, ME_RaycastHit &hit) {
+        UpdateSpatialIndex();
+        if (!m_spatial.Raycast(ray, hit)) {
+            return false;
+        }
+        hit.block_id = GetStaticTile(hit.column, hit.row);
+        return true;
+    }
 
-ME_API ME_BOOL ME_LoadBlock(int id, const char *path) {
-    return MainboardEngine::MEEngine::RegistryBlock(id, path);
-}
+    int MEEngine::FindPaths(const ME_PathRequest *requests, int count) {
+        // the grid has to see block solidity changes before it is copied for the workers
+        UpdateSpatialIndex();
+        return m_paths.Submit(requests, count);
+    }
 
+    bool MEEngine::WaitPaths(int batch) {
+        ME_TRACE_SCOPE("WaitPaths");
+        return m_paths.Wait(batch);
+    }
 
-ME_API ME_BOOL ME_ClearBlock() {
-    return MainboardEngine::MEEngine::ClearBlock();
-}
+    int MEEngine::GetPaths(int batch, ME_PathResult *results, ME_TileCoord *tiles, int capacity) {
+        UpdateSpatialIndex();
+        return m_paths.GetResults(batch, results, tiles, capacity);
+    }
 
-namespace MainboardEngine {
-    static int GetRectWidth(ME_Rect *rect) {
-        return rect->right - rect->left;
+    bool MEEngine::ReleasePaths(int batch) {
+        return m_paths.Release(batch);
     }
 
-    static int GetRectHeight(ME_Rect *rect) {
-        return rect->bottom - rect->top;
+    int MEEngine::GetStaticTile(int column, int row) const {
+        if (!m_world) {
+            return m_static_layer.GetTile(column, row);
+        }
+        int id = -1;
+        if (!m_world->GetTile(column, row, id)) {
+            return m_world_placeholder;
+        }
+        return id;
     }
-}
 
-namespace MainboardEngine {
-    static bgfx::ShaderHandle loadShader(const char *filename) {
-        std::ifstream file(filename, std::ios::binary);
-        if (!file.is_open()) {
-            return BGFX_INVALID_HANDLE;
+    void MEEngine::CreateStaticCache() {
+        DestroyStaticCache();
+        for (auto &cache: m_static_cache) {
+            bgfx::TextureHandle texture = bgfx::createTexture2D(
+                m_screen_width, m_screen_height, false, 1, bgfx::TextureFormat::RGBA8,
+                BGFX_TEXTURE_RT | BGFX_SAMPLER_POINT | BGFX_SAMPLER_UVW_CLAMP);
+            cache = bgfx::createFrameBuffer(1, &texture, true);
         }
+        m_static_current = 0;
+        m_static_width = m_screen_width;
+        m_static_height = m_screen_height;
+        m_static_layer.InvalidateAll();
+    }
 
-        file.seekg(0, std::ios::end);
-        std::streamsize size = file.tellg();
-        file.seekg(0, std::ios::beg);
+    void MEEngine::DestroyStaticCache() {
+        for (auto &cache: m_static_cache) {
+            if (bgfx::isValid(cache)) {
+                bgfx::destroy(cache);
+            }
+            cache = BGFX_INVALID_HANDLE;
+        }
+    }
 
-        const bgfx::Memory *mem = bgfx::alloc(static_cast<uint32_t>(size + 1));
-        file.read(reinterpret_cast<char *>(mem->data), size);
-        mem->data[size] = '\0';
-        file.close();
+    Block MEEngine::GetStaticCacheBlock(int index) const {
+        // one "frame" as large as the target, so fs_tiled maps uv 0..1 onto the whole cache
+        Block block = {};
+        block.id = -1;
+        block.texture = bgfx::getTexture(m_static_cache[index]);
+        block.width = m_static_width;
+        block.height = m_static_height;
+        block.channels = 4;
+        block.frame_count = 1;
+        return block;
+    }
 
-        return bgfx::createShader(mem);
+    float MEEngine::GetCacheV(float y, uint16_t height) {
+        float v = y / static_cast<float>(height);
+        return bgfx::getCaps()->originBottomLeft ? 1.0f - v : v;
     }
 
-    bool MEEngine::Start(MEWindow *window) {
-        using namespace bgfx;
+    void MEEngine::UpdateStaticLayer() {
+        m_tilemap_ready = false;
+        if (!m_static_layer.IsEnabled() || m_screen_width == 0 || m_screen_height == 0) {
+            return;
+        }
+        ME_TRACE_SCOPE("UpdateStaticLayer");
+
+        // animated tiles pick their frame in fs_tilemap, nothing else to do for this frame. Below
+        // 1:1 the cache filters through the block mips, which the array doesn't have
+        m_tilemap_ready = CanUseTilemap() && PrepareTilemap();
+        bool tilemap = m_tilemap_ready && m_scale >= 1.0f;
+        if (m_tilemap_active && !tilemap) {
+            // the cache was left alone while the tile map was drawn
+            m_static_layer.InvalidateAll();
+        }
+        m_tilemap_active = tilemap;
+        if (m_tilemap_active) {
+            return;
+        }
 
-        auto temp_engine = new MEEngine();
-        temp_engine->m_window = window;
+        if (!m_soft && (!bgfx::isValid(m_static_cache[0]) || m_static_width != m_screen_width ||
+                        m_static_height != m_screen_height)) {
+            CreateStaticCache();
+        }
+        if (m_static_scale != m_scale) {
+            m_static_scale = m_scale;
+            m_static_layer.InvalidateAll();
+        }
 
-        for (int i = 0; i < BLOCK_ARRAY_SIZE; ++i) {
-            temp_engine->m_blocks[i] = std::nullopt;
+        ME_Rect view = {};
+        view.left = m_camera_x;
+        view.top = m_camera_y;
+        view.right = view.left + static_cast<int>(std::ceil(static_cast<float>(m_screen_width) / m_scale));
+        view.bottom = view.top + static_cast<int>(std::ceil(static_cast<float>(m_screen_height) / m_scale));
+
+        if (m_world) {
+            // never waits for the disk, chunks that are not there yet show the placeholder
+            // and are redrawn once they arrive
+            m_world->Update(view);
+            for (int index: m_world->GetArrivedChunks()) {
+                m_static_layer.Invalidate(m_world->GetChunkRect(index));
+                SetChunkSolids(index, true);
+                SetChunkLight(index, true);
+            }
+            for (int index: m_world->GetEvictedChunks()) {
+                SetChunkSolids(index, false);
+                SetChunkLight(index, false);
+            }
+        }
+        if (m_soft) {
+            // RenderSoftware draws every visible tile, there is no cache to bring up to date
+            m_static_layer.ClearDirty();
+            return;
         }
 
-        ME_Rect window_rect = temp_engine->m_window->GetSize();
-        Init init;
-        init.type = RendererType::Count;
-        init.resolution.width = GetRectWidth(&window_rect);
-        init.resolution.height = GetRectHeight(&window_rect);
-        init.resolution.reset = BGFX_RESET_VSYNC;
-        PlatformData platformData;
-        platformData.nwh = temp_engine->m_window->GetMEWindowHandle();
-        init.platformData = platformData;
+        // scrolling copies whole cache pixels, a fractional shift at this zoom redraws everything
+        float shift_x = static_cast<float>(view.left - m_static_layer.GetView().left) * m_scale;
+        float shift_y = static_cast<float>(view.top - m_static_layer.GetView().top) * m_scale;
+        if (shift_x != std::floor(shift_x) || shift_y != std::floor(shift_y)) {
+            m_static_layer.InvalidateAll();
+        }
 
-        auto stat = bgfx::init(init);
-        if (!stat) {
-            return false;
+        int dx = 0;
+        int dy = 0;
+        if (m_static_layer.Scroll(view, dx, dy)) {
+            CopyStaticCache(static_cast<int>(static_cast<float>(dx) * m_scale),
+                            static_cast<int>(static_cast<float>(dy) * m_scale));
+        }
+        DrawStaticDirtyRects();
+
+        // animated tiles go on top of the cache with the regular draws
+        for (int index: m_static_layer.GetLiveTiles()) {
+            int column = index % m_static_layer.GetColumns();
+            int row = index / m_static_layer.GetColumns();
+            ME_Rect rect = m_static_layer.GetTileRect(column, row);
+            if (rect.right <= view.left || rect.left >= view.right || rect.bottom <= view.top ||
+                rect.top >= view.bottom) {
+                continue;
+            }
+            DrawCommand command = {};
+            command.id = m_static_layer.GetTile(column, row);
+            command.sort_key = MakeSortKey(LAYER_STATIC_LIVE, command.id, static_cast<uint32_t>(m_draws.Size()));
+            command.x = rect.left - view.left;
+            command.y = rect.top - view.top;
+            if (!m_draws.Push(command)) {
+                break;
+            }
         }
+    }
 
-        setViewRect(0, 0, 0, init.resolution.width, init.resolution.height);
+    void MEEngine::CopyStaticCache(int shift_x, int shift_y) {
+        int next = 1 - m_static_current;
+        RenderTarget target = {VIEW_STATIC_COPY, 0, 0, m_static_width, m_static_height, 1.0f, 0.0f, false};
+        SetViewTarget(VIEW_STATIC_COPY, m_static_cache[next], m_static_width, m_static_height);
+
+        // target pixel p takes source pixel p + shift, the rest is left to the exposed strips
+        float width = static_cast<float>(m_static_width);
+        float height = static_cast<float>(m_static_height);
+        TexturedQuad quad = {};
+        quad.x0 = static_cast<float>(std::max(0, -shift_x));
+        quad.y0 = static_cast<float>(std::max(0, -shift_y));
+        quad.x1 = std::min(width, width - static_cast<float>(shift_x));
+        quad.y1 = std::min(height, height - static_cast<float>(shift_y));
+        quad.u0 = (quad.x0 + static_cast<float>(shift_x)) / width;
+        quad.u1 = (quad.x1 + static_cast<float>(shift_x)) / width;
+        quad.v0 = GetCacheV(quad.y0 + static_cast<float>(shift_y), m_static_height);
+        quad.v1 = GetCacheV(quad.y1 + static_cast<float>(shift_y), m_static_height);
+
+        Block source = GetStaticCacheBlock(m_static_current);
+        if (!SubmitQuads(target, &source, &quad, 1, 1.0f, 0.0f)) {
+            m_static_layer.InvalidateAll();
+            return;
+        }
+        m_static_current = next;
+    }
 
-        struct PosTexCoord {
-            float x, y, z;
-            float u, v;
-        };
+    void MEEngine::DrawStaticDirtyRects() {
+        const auto &dirty = m_static_layer.GetDirtyRects();
+        if (dirty.empty()) {
+            return;
+        }
+        ME_TRACE_SCOPE("DrawStaticDirtyRects");
 
-        static PosTexCoord quadVertices[] = {
-            {-1.0f, 1.0f, 0.0f, 0.0f, 0.0f},
-            {1.0f, 1.0f, 0.0f, 1.0f, 0.0f},
-            {-1.0f, -1.0f, 0.0f, 0.0f, 1.0f},
-            {1.0f, -1.0f, 0.0f, 1.0f, 1.0f}
+        RenderTarget target = {
+            VIEW_STATIC_FILL, 0, 0, m_static_width, m_static_height, m_scale, m_texture_lod, false
         };
+        SetViewTarget(VIEW_STATIC_FILL, m_static_cache[m_static_current], m_static_width, m_static_height);
+
+        const ME_Rect &view = m_static_layer.GetView();
+        int tile_width = m_static_layer.GetTileWidth();
+        int tile_height = m_static_layer.GetTileHeight();
+        MEFrameVector<TexturedQuad> backgrounds(&m_arena);
+        MEFrameVector<DrawCommand> tiles(&m_arena);
+        bool complete = true;
+        for (const auto &rect: dirty) {
+            // whole tiles, a tile cut by the rect is redrawn from its corner
+            int column_begin = std::max(0, FloorDiv(rect.left, tile_width));
+            int column_end = std::min(m_static_layer.GetColumns(), FloorDiv(rect.right - 1, tile_width) + 1);
+            int row_begin = std::max(0, FloorDiv(rect.top, tile_height));
+            int row_end = std::min(m_static_layer.GetRows(), FloorDiv(rect.bottom - 1, tile_height) + 1);
+
+            ME_Rect cover = rect;
+            if (column_begin < column_end && row_begin < row_end) {
+                ME_Rect span = {
+                    row_begin * tile_height, row_end * tile_height, column_begin * tile_width, column_end * tile_width
+                };
+                cover = MEStaticLayer::Union(rect, span);
+            }
+            TexturedQuad background = {};
+            background.x0 = static_cast<float>(cover.left - view.left) * m_scale;
+            background.y0 = static_cast<float>(cover.top - view.top) * m_scale;
+            background.x1 = static_cast<float>(cover.right - view.left) * m_scale;
+            background.y1 = static_cast<float>(cover.bottom - view.top) * m_scale;
+            background.u1 = 1.0f;
+            background.v1 = 1.0f;
+            complete = backgrounds.Push(background);
+
+            for (int row = row_begin; complete && row < row_end; ++row) {
+                for (int column = column_begin; complete && column < column_end; ++column) {
+                    int id = GetStaticTile(column, row);
+                    if (id < 0 || id >= BLOCK_ARRAY_SIZE || m_blocks[id] == std::nullopt) {
+                        continue;
+                    }
+                    // world tiles are baked as they are, the static layer tracks its animated ones
+                    if (!m_world && m_blocks[id].value().frame_count > 1) {
+                        continue;
+                    }
+                    DrawCommand command = {};
+                    command.sort_key = MakeSortKey(0, id, static_cast<uint32_t>(tiles.Size()));
+                    command.id = id;
+                    command.x = column * tile_width - view.left;
+                    command.y = row * tile_height - view.top;
+                    complete = tiles.Push(command);
+                }
+            }
+            if (!complete) {
+                break;
+            }
+        }
 
-        VertexLayout layout;
-        layout.begin()
-                .add(Attrib::Position, 3, AttribType::Float)
-                .add(Attrib::TexCoord0, 2, AttribType::Float)
-                .end();
-        VertexBufferHandle vbh = createVertexBuffer(makeRef(quadVertices, sizeof(quadVertices)), layout);
-        static const uint16_t quadIndices[] = {0, 1, 2, 1, 3, 2};
-        IndexBufferHandle ibh = createIndexBuffer(makeRef(quadIndices, sizeof(quadIndices)));
-        temp_engine->m_vbh = vbh;
-        temp_engine->m_ibh = ibh;
+        if (!complete) {
+            // out of heap memory, the arena spills to it first. The rects stay dirty and are redrawn next frame
+            return;
+        }
+        if (!SubmitQuads(target, &m_background_block, backgrounds.begin(), static_cast<uint32_t>(backgrounds.Size()),
+                         1.0f, 0.0f)) {
+            return;
+        }
+        std::sort(tiles.begin(), tiles.end(), [](const DrawCommand &a, const DrawCommand &b) {
+            return a.sort_key < b.sort_key;
+        });
+        SubmitSorted(target, tiles.begin(), tiles.Size());
+        m_static_layer.ClearDirty();
+    }
 
-        UniformHandle s_tex = createUniform("s_tex", UniformType::Sampler);
-        UniformHandle u_resolution = createUniform("u_resolution", UniformType::Vec4);
-        temp_engine->m_s_tex = s_tex;
-        temp_engine->m_u_resolution = u_resolution;
+    void MEEngine::CompositeStaticLayer() {
+        if (m_tilemap_active && m_static_layer.IsEnabled()) {
+            DrawTilemap(GetMainTarget(), m_camera_x, m_camera_y);
+            return;
+        }
+        if (!m_static_layer.IsEnabled() || !bgfx::isValid(m_static_cache[m_static_current])) {
+            return;
+        }
 
-        ShaderHandle vsh = BGFX_INVALID_HANDLE;
-        ShaderHandle fsh = BGFX_INVALID_HANDLE;
+        RenderTarget target = GetMainTarget();
+        TexturedQuad quad = {};
+        quad.x1 = static_cast<float>(m_static_width);
+        quad.y1 = static_cast<float>(m_static_height);
+        quad.u1 = 1.0f;
+        quad.v0 = GetCacheV(0.0f, m_static_height);
+        quad.v1 = GetCacheV(static_cast<float>(m_static_height), m_static_height);
 
-        auto renderer = getRendererType();
-        const char *shaderDir = nullptr;
+        Block cache = GetStaticCacheBlock(m_static_current);
+        SubmitQuads(target, &cache, &quad, 1, 1.0f, 0.0f);
+    }
 
-        switch (renderer) {
-            case RendererType::Direct3D11:
-            case RendererType::Direct3D12:
-                shaderDir = "dx11";
-                break;
-            case RendererType::OpenGL:
-                shaderDir = "glsl";
-                break;
-            case RendererType::Vulkan:
-                shaderDir = "spirv";
-                break;
-            default:
-                shaderDir = "dx11";
-                break;
-        }
+    void MEEngine::SetStaticLayerMode(int mode) {
+        m_static_mode = mode;
+    }
 
-        std::string vsPath = std::string("./shader/") + shaderDir + "/vs_fullscreen.bin";
-        std::string fsPath = std::string("./shader/") + shaderDir + "/fs_tiled.bin";
+    bool MEEngine::IsTilemapBlock(int id) const {
+        const Block &block = m_blocks[id].value();
+        // a quarter turn only fits a tile when the block is square
+        bool fits = block.width == m_static_layer.GetTileWidth() && block.height == m_static_layer.GetTileHeight() &&
+                    (!(block.orientation & ME_ORIENT_ROTATE_90) || block.width == block.height);
+        return bgfx::isValid(block.texture.value()) && !block.compressed && !block.view_target && fits;
+    }
 
-        // // auto path = _getcwd(nullptr, 0);
+    bool MEEngine::IsTilemapForeign(int id) const {
+        return id >= 0 && id < BLOCK_ARRAY_SIZE && m_blocks[id] != std::nullopt && m_tilemap_layers[id] < 0;
+    }
 
-        vsh = loadShader(vsPath.c_str());
-        fsh = loadShader(fsPath.c_str());
-        ProgramHandle program = BGFX_INVALID_HANDLE;
+    void MEEngine::InvalidateTilemap() {
+        if (bgfx::isValid(m_tilemap_ids)) {
+            bgfx::destroy(m_tilemap_ids);
+        }
+        m_tilemap_ids = BGFX_INVALID_HANDLE;
+        m_tilemap_dirty = {0, 0, 0, 0};
+        m_tilemap_blocks_dirty = true;
+    }
 
-        if (isValid(vsh) && isValid(fsh)) {
-            program = createProgram(vsh, fsh, true);
-            temp_engine->m_program = program;
-            temp_engine->m_vsh = vsh;
-            temp_engine->m_fsh = fsh;
-        } else {
+    bool MEEngine::CanUseTilemap() const {
+        // world tiles live in chunks on the stream thread, the software renderer reads the tiles itself
+        if (m_static_mode != ME_STATIC_LAYER_AUTO || m_world || m_soft || !bgfx::isValid(m_tilemap_program)) {
             return false;
         }
-        setViewClear(0, BGFX_CLEAR_COLOR | BGFX_CLEAR_DEPTH, 0x443355FF, 1.0f, 0);
-
-        g_engine = std::unique_ptr<MEEngine>(temp_engine);
+        const bgfx::Caps *caps = bgfx::getCaps();
+        const uint64_t required = BGFX_CAPS_TEXTURE_2D_ARRAY | BGFX_CAPS_TEXTURE_BLIT;
+        return (caps->supported & required) == required &&
+               (caps->formats[bgfx::TextureFormat::R16] & BGFX_CAPS_FORMAT_TEXTURE_2D) != 0 &&
+               (caps->formats[bgfx::TextureFormat::RGBA32F] & BGFX_CAPS_FORMAT_TEXTURE_2D) != 0 &&
+               static_cast<uint32_t>(m_static_layer.GetColumns()) <= caps->limits.maxTextureSize &&
+               static_cast<uint32_t>(m_static_layer.GetRows()) <= caps->limits.maxTextureSize &&
+               static_cast<uint32_t>(BLOCK_ARRAY_SIZE) <= caps->limits.maxTextureSize;
+    }
 
+    bool MEEngine::PrepareTilemap() {
+        if (m_tilemap_blocks_dirty) {
+            RebuildTilemapBlocks();
+        }
+        if (!bgfx::isValid(m_tilemap_blocks) || m_tilemap_foreign > 0) {
+            return false;
+        }
+        if (!bgfx::isValid(m_tilemap_ids)) {
+            // created without data so it stays mutable, tile edits are uploaded in place
+            int columns = m_static_layer.GetColumns();
+            int rows = m_static_layer.GetRows();
+            m_tilemap_ids = bgfx::createTexture2D(static_cast<uint16_t>(columns), static_cast<uint16_t>(rows),
+                                                  false, 1, bgfx::TextureFormat::R16,
+                                                  BGFX_SAMPLER_POINT | BGFX_SAMPLER_UVW_CLAMP);
+            m_tilemap_dirty = {0, rows, 0, columns};
+        }
+        UploadTilemapIds();
         return true;
     }
 
+    void MEEngine::RebuildTilemapBlocks() {
+        ME_TRACE_SCOPE("RebuildTilemapBlocks");
+        m_tilemap_blocks_dirty = false;
+        if (bgfx::isValid(m_tilemap_blocks)) {
+            bgfx::destroy(m_tilemap_blocks);
+        }
+        if (bgfx::isValid(m_tilemap_table)) {
+            bgfx::destroy(m_tilemap_table);
+        }
+        m_tilemap_blocks = BGFX_INVALID_HANDLE;
+        m_tilemap_table = BGFX_INVALID_HANDLE;
+
+        // every block that fits goes in, not only the placed ones, so placing another one later
+        // is still just an id update
+        uint32_t max_layers = bgfx::getCaps()->limits.maxTextureLayers;
+        int layers = 0;
+        for (int id = 0; id < BLOCK_ARRAY_SIZE; ++id) {
+            m_tilemap_layers[id] = -1;
+            if (m_blocks[id] == std::nullopt || m_blocks[id].value().variant_of >= 0 || !IsTilemapBlock(id)) {
+                continue;
+            }
+            int frames = m_blocks[id].value().frame_count;
+            if (static_cast<uint32_t>(layers + frames) > max_layers) {
+                continue;
+            }
+            m_tilemap_layers[id] = layers;
+            layers += frames;
+        }
+        // variants sample the layers of their base
+        for (int id = 0; id < BLOCK_ARRAY_SIZE; ++id) {
+            if (m_blocks[id] != std::nullopt && m_blocks[id].value().variant_of >= 0 && IsTilemapBlock(id)) {
+                m_tilemap_layers[id] = m_tilemap_layers[m_blocks[id].value().variant_of];
+            }
+        }
 
-    bool MEEngine::RegistryBlock(int id, std::string path) {
-        if (g_engine->m_blocks[id] != std::nullopt) {
-            return false;
+        m_tilemap_foreign = 0;
+        for (int row = 0; row < m_static_layer.GetRows(); ++row) {
+            for (int column = 0; column < m_static_layer.GetColumns(); ++column) {
+                if (IsTilemapForeign(m_static_layer.GetTile(column, row))) {
+                    ++m_tilemap_foreign;
+                }
+            }
+        }
+        if (layers == 0 || m_tilemap_foreign > 0) {
+            return;
         }
 
-        Block block = {};
-        block.id = id;
+        uint16_t tile_width = static_cast<uint16_t>(m_static_layer.GetTileWidth());
+        uint16_t tile_height = static_cast<uint16_t>(m_static_layer.GetTileHeight());
+        m_tilemap_blocks = bgfx::createTexture2D(tile_width, tile_height, false, static_cast<uint16_t>(layers),
+                                                 bgfx::TextureFormat::RGBA8,
+                                                 BGFX_TEXTURE_BLIT_DST | BGFX_SAMPLER_POINT | BGFX_SAMPLER_UVW_CLAMP);
+
+        // first row: x = first layer, y = frame count (0 when the block isn't in the array),
+        // z = frame duration, w = ME_ORIENT_*. Second row: the tint as RGBA
+        const bgfx::Memory *table = bgfx::alloc(BLOCK_ARRAY_SIZE * 8 * sizeof(float));
+        auto entries = reinterpret_cast<float *>(table->data);
+        auto tints = entries + BLOCK_ARRAY_SIZE * 4;
+        std::fill(entries, entries + BLOCK_ARRAY_SIZE * 8, 0.0f);
+        for (int id = 0; id < BLOCK_ARRAY_SIZE; ++id) {
+            int layer = m_tilemap_layers[id];
+            if (layer < 0) {
+                continue;
+            }
+            const Block &block = m_blocks[id].value();
+            entries[id * 4 + 3] = static_cast<float>(block.orientation);
+            for (int channel = 0; channel < 4; ++channel) {
+                tints[id * 4 + channel] = static_cast<float>((block.tint >> (24 - channel * 8)) & 0xFF) / 255.0f;
+            }
+            // the frames of a strip become consecutive layers, copied on the GPU once for the base
+            for (int frame = 0; frame < block.frame_count && block.variant_of < 0; ++frame) {
+                bgfx::blit(VIEW_STATIC_COPY, m_tilemap_blocks, 0, 0, 0, static_cast<uint16_t>(layer + frame),
+                           block.texture.value(), 0, 0, static_cast<uint16_t>(frame * tile_height), 0,
+                           tile_width, tile_height, 1);
+            }
+            entries[id * 4 + 0] = static_cast<float>(layer);
+            entries[id * 4 + 1] = static_cast<float>(block.frame_count);
+            entries[id * 4 + 2] = block.frame_count > 1 ? static_cast<float>(block.frame_duration_ms) / 1000.0f : 1.0f;
+        }
+        m_tilemap_table = bgfx::createTexture2D(BLOCK_ARRAY_SIZE, 2, false, 1, bgfx::TextureFormat::RGBA32F,
+                                                BGFX_SAMPLER_POINT | BGFX_SAMPLER_UVW_CLAMP, table);
+    }
 
-        auto data = stbi_load(path.c_str(), &block.width, &block.height, &block.channels, 4);
-        if (!data) {
-            return false;
+    void MEEngine::UploadTilemapIds() {
+        const ME_Rect dirty = m_tilemap_dirty;
+        if (dirty.left >= dirty.right || dirty.top >= dirty.bottom) {
+            return;
         }
-        auto texture = bgfx::createTexture2D(block.width, block.height, false, 1, bgfx::TextureFormat::RGBA8,
-                                             BGFX_TEXTURE_NONE | BGFX_SAMPLER_MIN_POINT | BGFX_SAMPLER_MAG_POINT,
-                                             bgfx::copy(data, block.width * block.height * 4));
-        // TODO how the hell can i know if the texture is created successfully
-        block.texture = texture;
-        stbi_image_free(data);
+        // 0 is an empty tile, block ids are stored one up. A single tile edit uploads 2 bytes
+        uint16_t width = static_cast<uint16_t>(dirty.right - dirty.left);
+        uint16_t height = static_cast<uint16_t>(dirty.bottom - dirty.top);
+        const bgfx::Memory *ids = bgfx::alloc(static_cast<uint32_t>(width) * height * sizeof(uint16_t));
+        auto values = reinterpret_cast<uint16_t *>(ids->data);
+        for (int row = dirty.top; row < dirty.bottom; ++row) {
+            for (int column = dirty.left; column < dirty.right; ++column) {
+                int id = m_static_layer.GetTile(column, row);
+                *values++ = static_cast<uint16_t>(id < 0 ? 0 : id + 1);
+            }
+        }
+        bgfx::updateTexture2D(m_tilemap_ids, 0, 0, static_cast<uint16_t>(dirty.left), static_cast<uint16_t>(dirty.top),
+                              width, height, ids);
+        m_tilemap_dirty = {0, 0, 0, 0};
+    }
 
-        g_engine->m_blocks[id] = block;
+    void MEEngine::DrawTilemap(const RenderTarget &target, int camera_x, int camera_y) {
+        // the whole layer in one draw, its cost depends on the target size and not on the tile count.
+        // Below 1:1 it point samples, good enough for previews and minimaps
+        float resolution[4] = {static_cast<float>(target.width), static_cast<float>(target.height), 0.0f, 0.0f};
+        float animation[4] = {0.0f, 0.0f, m_animation_time, 0.0f};
+        float tilemap[4] = {
+            static_cast<float>(camera_x), static_cast<float>(camera_y), target.scale, target.flip_y ? 1.0f : 0.0f
+        };
+        float grid[4] = {
+            static_cast<float>(m_static_layer.GetTileWidth()), static_cast<float>(m_static_layer.GetTileHeight()),
+            static_cast<float>(m_static_layer.GetColumns()), static_cast<float>(m_static_layer.GetRows())
+        };
+        bgfx::setUniform(m_u_resolution, resolution);
+        bgfx::setUniform(m_u_animation, animation);
+        bgfx::setUniform(m_u_tilemap, tilemap);
+        bgfx::setUniform(m_u_tilemap_grid, grid);
+        bgfx::setVertexBuffer(0, m_vbh);
+        bgfx::setIndexBuffer(m_ibh);
+        bgfx::setTexture(0, m_s_tile_ids, m_tilemap_ids);
+        bgfx::setTexture(1, m_s_tile_blocks, m_tilemap_blocks);
+        bgfx::setTexture(2, m_s_tile_table, m_tilemap_table);
+        bgfx::setState(BGFX_STATE_WRITE_RGB | BGFX_STATE_WRITE_A);
+        bgfx::submit(target.view, m_tilemap_program);
+        ++m_frame_submits;
+    }
 
-        return true;
+    void MEEngine::SetRenderScale(float scale) {
+        m_scale = scale;
+        m_texture_lod = GetTextureLod(scale);
     }
 
-    bool MEEngine::ClearBlock() {
-        for (int i = 0; i < BLOCK_ARRAY_SIZE; ++i) {
-            if (g_engine->m_blocks[i] != std::nullopt) {
-                auto block = &g_engine->m_blocks[i].value();
-                if (bgfx::isValid(block->texture.value())) {
-                    bgfx::destroy(block->texture.value());
-                }
-                g_engine->m_blocks[i] = std::nullopt;
-            }
-        }
+    float MEEngine::GetTextureLod(float scale) {
+        // sampled explicitly instead of from derivatives, fs_tiled wraps the uv every tile and
+        // the derivatives would jump to the smallest mip on tile borders
+        return scale < 1.0f ? -std::log2(scale) : 0.0f;
+    }
+
+    float MEEngine::GetAnimationTime() const {
+        // wrap where every animation restarts its loop anyway, so long sessions keep the float precise
+        // without a visible phase jump
+        auto elapsed = std::chrono::steady_clock::now() - m_start_time;
+        auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(elapsed).count() % m_animation_period_ms;
+        return static_cast<float>(ms) / 1000.0f;
+    }
 
+    bool MEEngine::BeginFrame() {
+        if (m_frame_open) {
+            return false;
+        }
+        m_frame_open = true;
         return true;
     }
 
+    int MEEngine::EndFrame() {
+        if (!m_frame_open) {
+            ++m_skipped_presents;
+            return m_last_frame;
+        }
+        m_frame_open = false;
+        return Render();
+    }
 
-    // bool MEEngine::RegistryRenderBlock(std::string block_name, int x, int y) {
-    //     RenderBlockCommand command = {};
-    //     command.block_name = block_name;
-    //     command.x = x;
-    //     command.y = y;
-    //     m_commands.push_back(command);
-    //
-    //     return true;
-    // }
-    //
-    bool MEEngine::RenderBlock(int id, int x, int y) {
-        if (m_blocks[id] == std::nullopt) {
-            return false;
+    int MEEngine::RenderFrame() {
+        if (m_frame_open) {
+            ++m_skipped_presents;
+            return m_last_frame;
         }
-        auto block = &m_blocks[id].value();
-        // bgfx::ViewId view_id = static_cast<bgfx::ViewId>(block->id);
+        return Render();
+    }
 
-        // bgfx::setViewRect(0, 0, 0, GetRectWidth(&window_rect), GetRectHeight(&window_rect));
+    int MEEngine::Render() {
+        ME_TRACE_SCOPE("Render");
+        m_frame_draws = static_cast<int>(m_draws.Size());
+        m_frame_submits = 0;
+        m_frame_occluded = 0;
+        m_frame_transparent = 0;
+        FinishBlockLoads();
+        UpdateStaticLayer();
+        UpdateLight();
+
+        auto now = std::chrono::steady_clock::now();
+        float step = std::chrono::duration<float>(now - m_last_update).count();
+        m_last_update = now;
+        m_particles.Update(std::min(step, MAX_PARTICLE_STEP), m_jobs);
+
+        {
+            ME_TRACE_SCOPE("FlushDraws");
+            FlushDraws();
+        }
 
-        if (!bgfx::isValid(m_program)) {
-            return false;
+        // the clear was set once in Start, bgfx keeps view state across frames
+        bgfx::touch(VIEW_MAIN);
+        int frame_num = 0;
+        {
+            ME_TRACE_SCOPE("bgfx::frame");
+            frame_num = bgfx::frame();
         }
-        if (!bgfx::isValid(m_blocks[id].value().texture.value())) {
-            return false;
+        m_last_frame = frame_num;
+        ++m_frame_count;
+        if (m_startup.first_frame_ms == 0.0 || (m_startup.loaded_ms == 0.0 && m_startup.pending_blocks == 0)) {
+            double since_initialize = std::chrono::duration<double, std::milli>(
+                std::chrono::steady_clock::now() - g_initialize_time).count();
+            if (m_startup.first_frame_ms == 0.0) {
+                m_startup.first_frame_ms = since_initialize;
+            }
+            if (m_startup.pending_blocks == 0) {
+                m_startup.loaded_ms = since_initialize;
+            }
         }
+        if (++m_presents_since_events > 1) {
+            ++m_wasted_frames;
+        }
+        m_animation_time = GetAnimationTime();
+
+        m_arena_used = m_arena.GetUsed();
+        m_draws.Clear();
+        m_text.Clear();
+        // atlases that filled up this frame start over, the text of the next frame refills them
+        for (auto &font: m_fonts) {
+            if (font) {
+                font->EndFrame();
+            }
+        }
+        m_arena.Reset();
+        MarkAllocFrame();
 
+        // the window rect is an OS call, query it once per frame instead of once per block
         auto window_rect = m_window->GetSize();
-        uint16_t screenW = static_cast<uint16_t>(GetRectWidth(&window_rect));
-        uint16_t screenH = static_cast<uint16_t>(GetRectHeight(&window_rect));
-
-        uint16_t viewX = static_cast<uint16_t>(x);
-        uint16_t viewY = static_cast<uint16_t>(y);
-        uint16_t viewWidth = static_cast<uint16_t>(block->width);
-        uint16_t viewHeight = static_cast<uint16_t>(block->height);
-        // bgfx::setViewRect(block->id, viewX, viewY, viewWidth, viewHeight);
-        bgfx::setScissor(viewX, viewY, viewWidth, viewHeight);
-        // bgfx::setViewRect(view_id, viewX, viewY, block->width, block->height);
-        // std::cout << "Rendering block ID " << block->id << " at (" << x << ", " << y << ") with size ("
-        // << block->width << "x" << block->height << ")" << std::endl;
-
-        // if (block->id == 0) {
-        //     bgfx::setViewClear(0, BGFX_CLEAR_COLOR | BGFX_CLEAR_DEPTH, 0x443355FF, 1.0f, 0);
-        // }
+        m_screen_width = static_cast<uint16_t>(GetRectWidth(&window_rect));
+        m_screen_height = static_cast<uint16_t>(GetRectHeight(&window_rect));
 
-        float resolution[4] = {
-            static_cast<float>(screenW),
-            static_cast<float>(screenH),
-            static_cast<float>(block->width),
-            static_cast<float>(block->height)
-        };
-        bgfx::setUniform(m_u_resolution, resolution);
-        bgfx::setVertexBuffer(0, m_vbh);
-        bgfx::setIndexBuffer(m_ibh);
-        bgfx::setTexture(0, m_s_tex, block->texture.value());
-        bgfx::setState(BGFX_STATE_WRITE_RGB | BGFX_STATE_WRITE_A);
-        bgfx::submit(0, m_program);
+        return frame_num;
+    }
 
+    bool MEHeadlessWindow::SetSize(int width, int height) {
+        m_width = width;
+        m_height = height;
         return true;
     }
 
-    int MEEngine::Render() {
-        bgfx::setViewClear(0, BGFX_CLEAR_COLOR | BGFX_CLEAR_DEPTH, 0x443355FF, 1.0f, 0);
-        bgfx::touch(0);
-        int frame_num = bgfx::frame();
-        return frame_num;
+    ME_Rect MEHeadlessWindow::GetSize() {
+        ME_Rect rect = {};
+        rect.right = m_width;
+        rect.bottom = m_height;
+        return rect;
+    }
+
+    bool MEHeadlessWindow::SetPosition(int, int) {
+        return true;
+    }
+
+    bool MEHeadlessWindow::SetTitle(const char *) {
+        return true;
+    }
+
+    void *MEHeadlessWindow::GetMEWindowHandle() {
+        return nullptr;
+    }
+
+    bool MEHeadlessPlatform::Initialize() {
+        return true;
+    }
+
+    void MEHeadlessPlatform::Shutdown() {
+    }
+
+    bool MEHeadlessPlatform::CreateWindow(int, int, int, int width, int height, const char *, MEWindow *&window) {
+        auto headless = new MEHeadlessWindow(width, height);
+        if (!MEEngine::Start(headless)) {
+            delete headless;
+            return false;
+        }
+        window = headless;
+        return true;
+    }
+
+    ME_MESSAGE_TYPE MEHeadlessPlatform::ProcessEvents(ME_HANDLE) {
+        return ME_NO_EVENT_MESSAGE;
+    }
+
+    void MEEngine::GetFrameStats(ME_FrameStats *stats) const {
+        stats->draw_count = m_frame_draws;
+        stats->submit_count = m_frame_submits;
+        stats->arena_used = static_cast<int>(m_arena_used);
+        stats->arena_capacity = static_cast<int>(m_arena.GetCapacity());
+        stats->arena_heap_allocations = m_arena.GetHeapAllocations();
+        stats->frame_count = m_frame_count;
+        stats->wasted_frames = m_wasted_frames;
+        stats->skipped_presents = m_skipped_presents;
+        stats->occluded_draws = m_frame_occluded;
+        stats->transparent_draws = m_frame_transparent;
     }
 
 
@@ -497,25 +3713,28 @@ namespace MainboardEngine {
             return true;
         }
 #ifdef __ME_USE_WAYLAND__
-m_platform= std::make_unique<WaylandPlatform>();
+        m_platform = std::make_unique<WaylandPlatform>();
 #endif
-if (!m_platform) {
+        if (!m_platform) {
             return false;
         }
         return m_platform->Initialize();
     }
 
-void LinuxPlatform::Shutdown() {
-    m_platform->Shutdown();
-}
+    void LinuxPlatform::Shutdown() {
+        if (m_platform) {
+            m_platform->Shutdown();
+        }
+    }
 
-MEWindow *LinuxPlatform::CreateWindow(int is_full_screen, int x, int y, int width, int height, const char *title) {
-    return m_platform->CreateWindow(is_full_screen, x, y, width, height, title);
-}
+    bool LinuxPlatform::CreateWindow(int is_full_screen, int x, int y, int width, int height, const char *title,
+                                     MEWindow *&window) {
+        return m_platform && m_platform->CreateWindow(is_full_screen, x, y, width, height, title, window);
+    }
 
-int LinuxPlatform::ProcessEvents(ME_HANDLE handle) {
-    return m_platform->ProcessEvents(handle);
-}
+    ME_MESSAGE_TYPE LinuxPlatform::ProcessEvents(ME_HANDLE handle) {
+        return m_platform ? m_platform->ProcessEvents(handle) : ME_NO_EVENT_MESSAGE;
+    }
 }
 
 namespace MainboardEngine {
@@ -596,12 +3815,13 @@ namespace MainboardEngine {
     void WaylandPlatform::Shutdown() {
     }
 
-    MEWindow *WaylandPlatform::CreateWindow(int is_full_screen, int x, int y, int width, int height,
-                                            const char *title) {
-        return nullptr;
+    bool WaylandPlatform::CreateWindow(int is_full_screen, int x, int y, int width, int height, const char *title,
+                                       MEWindow *&window) {
+        window = nullptr;
+        return false; // TODO: implement
     }
 
-    int WaylandPlatform::ProcessEvents(ME_HANDLE handle) {
+    ME_MESSAGE_TYPE WaylandPlatform::ProcessEvents(ME_HANDLE handle) {
         return ME_NO_EVENT_MESSAGE;
     }
 
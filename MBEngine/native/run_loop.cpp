@@ -0,0 +1,87 @@
+#include "include/run_loop.h"
+
+#include <algorithm>
+#include <thread>
+
+#if defined(_WIN32)
+#include <windows.h>
+#include <timeapi.h>
+#endif
+
+namespace MainboardEngine {
+    static MEFixedStep::Clock::duration ToDuration(double seconds) {
+        return std::chrono::duration_cast<MEFixedStep::Clock::duration>(std::chrono::duration<double>(seconds));
+    }
+
+    MEFixedStep::MEFixedStep(const ME_LoopDesc &desc) : m_tick(ToDuration(1.0 / desc.tick_rate)),
+                                                         m_frame(desc.frame_rate > 0.0
+                                                                     ? ToDuration(1.0 / desc.frame_rate)
+                                                                     : Clock::duration::zero()),
+                                                         m_max_ticks(desc.max_ticks_per_frame),
+                                                         m_accumulator(Clock::duration::zero()) {
+    }
+
+    bool MEFixedStep::IsValidDesc(const ME_LoopDesc &desc) {
+        // written so NaN fails every check, and a tick is at least a microsecond
+        return desc.tick_rate > 0.0 && desc.tick_rate <= 1000000.0 && desc.max_ticks_per_frame > 0 &&
+               desc.frame_rate >= 0.0 && desc.frame_rate <= 1000000.0;
+    }
+
+    void MEFixedStep::Start(Clock::time_point now) {
+        m_accumulator = Clock::duration::zero();
+        m_last = now;
+        m_next_frame = now;
+    }
+
+    int MEFixedStep::Advance(Clock::time_point now, int &dropped) {
+        m_accumulator += now - m_last;
+        m_last = now;
+        auto ticks = m_accumulator / m_tick;
+        m_accumulator -= ticks * m_tick;
+        dropped = 0;
+        if (ticks > m_max_ticks) {
+            // a hitch or a breakpoint, catching up would make the next frame even later
+            dropped = static_cast<int>(std::min<decltype(ticks)>(ticks - m_max_ticks, 0x7FFFFFFF));
+            ticks = m_max_ticks;
+        }
+        return static_cast<int>(ticks);
+    }
+
+    MEFixedStep::Clock::time_point MEFixedStep::NextFrame(Clock::time_point now) {
+        if (m_frame == Clock::duration::zero()) {
+            return now;
+        }
+        // paced from the last deadline so the rate holds on average, unless a frame ran late
+        m_next_frame += m_frame;
+        if (m_next_frame < now) {
+            m_next_frame = now;
+        }
+        return m_next_frame;
+    }
+
+    std::chrono::steady_clock::duration SleepUntil(std::chrono::steady_clock::time_point deadline) {
+        auto start = std::chrono::steady_clock::now();
+        if (deadline <= start) {
+            return std::chrono::steady_clock::duration::zero();
+        }
+        if (deadline - start > LOOP_SPIN_TIME) {
+            std::this_thread::sleep_until(deadline - LOOP_SPIN_TIME);
+        }
+        while (std::chrono::steady_clock::now() < deadline) {
+            std::this_thread::yield();
+        }
+        return std::chrono::steady_clock::now() - start;
+    }
+
+    METimerResolution::METimerResolution() {
+#if defined(_WIN32)
+        timeBeginPeriod(1);
+#endif
+    }
+
+    METimerResolution::~METimerResolution() {
+#if defined(_WIN32)
+        timeEndPeriod(1);
+#endif
+    }
+}
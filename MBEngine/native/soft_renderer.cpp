@@ -0,0 +1,273 @@
+#include "include/soft_renderer.h"
+#include "include/image_decoder.h"
+#include "include/trace.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define ME_HAS_SSE2
+#endif
+
+namespace MainboardEngine {
+    static void BlendPixelsScalar(uint8_t *dst, const uint8_t *src, int from, int to) {
+        for (int i = from; i < to; ++i) {
+            const uint8_t *s = src + i * 4;
+            uint8_t *d = dst + i * 4;
+            unsigned a = s[3];
+            if (a == 0) {
+                continue;
+            }
+            // alpha is blended as if the source alpha channel were 255, so it composes like the colors
+            for (int c = 0; c < 4; ++c) {
+                unsigned t = (c == 3 ? 255 : s[c]) * a + d[c] * (255 - a) + 128;
+                d[c] = static_cast<uint8_t>((t + (t >> 8)) >> 8);
+            }
+        }
+    }
+
+#ifdef ME_HAS_SSE2
+    // (s * a + d * (255 - a)) / 255 rounded, on 2 pixels of 16 bit lanes
+    static __m128i BlendHalf(__m128i s16, __m128i d16, __m128i alpha_lanes) {
+        __m128i a = _mm_shufflehi_epi16(_mm_shufflelo_epi16(s16, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(3, 3, 3, 3));
+        __m128i inverse = _mm_sub_epi16(_mm_set1_epi16(255), a);
+        s16 = _mm_or_si128(s16, alpha_lanes);
+        __m128i t = _mm_add_epi16(_mm_add_epi16(_mm_mullo_epi16(s16, a), _mm_mullo_epi16(d16, inverse)),
+                                  _mm_set1_epi16(128));
+        return _mm_srli_epi16(_mm_add_epi16(t, _mm_srli_epi16(t, 8)), 8);
+    }
+#endif
+
+    void BlendPixels(uint8_t *dst, const uint8_t *src, int count) {
+        int i = 0;
+#ifdef ME_HAS_SSE2
+        const __m128i zero = _mm_setzero_si128();
+        const __m128i alpha_lanes = _mm_set_epi16(0xFF, 0, 0, 0, 0xFF, 0, 0, 0);
+        const __m128i alpha_mask = _mm_set1_epi32(static_cast<int>(0xFF000000));
+        for (; i + 4 <= count; i += 4) {
+            __m128i s = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i * 4));
+            __m128i alpha = _mm_and_si128(s, alpha_mask);
+            // tiles are mostly cutouts, 4 clear or 4 solid texels need no arithmetic
+            int clear = _mm_movemask_epi8(_mm_cmpeq_epi32(alpha, zero));
+            if (clear == 0xFFFF) {
+                continue;
+            }
+            __m128i *d = reinterpret_cast<__m128i *>(dst + i * 4);
+            if (_mm_movemask_epi8(_mm_cmpeq_epi32(alpha, alpha_mask)) == 0xFFFF) {
+                _mm_storeu_si128(d, s);
+                continue;
+            }
+            __m128i v = _mm_loadu_si128(d);
+            __m128i lo = BlendHalf(_mm_unpacklo_epi8(s, zero), _mm_unpacklo_epi8(v, zero), alpha_lanes);
+            __m128i hi = BlendHalf(_mm_unpackhi_epi8(s, zero), _mm_unpackhi_epi8(v, zero), alpha_lanes);
+            _mm_storeu_si128(d, _mm_packus_epi16(lo, hi));
+        }
+#endif
+        BlendPixelsScalar(dst, src, i, count);
+    }
+
+    MESoftRenderer::MESoftRenderer(int texture_count) : m_width(0), m_height(0), m_bins_x(0),
+                                                        m_textures(texture_count) {
+    }
+
+    void MESoftRenderer::Resize(int width, int height) {
+        width = std::max(width, 0);
+        height = std::max(height, 0);
+        if (width == m_width && height == m_height) {
+            return;
+        }
+        m_width = width;
+        m_height = height;
+        m_bins_x = (width + SOFT_BIN_SIZE - 1) / SOFT_BIN_SIZE;
+        int bins_y = (height + SOFT_BIN_SIZE - 1) / SOFT_BIN_SIZE;
+        m_bins.assign(static_cast<size_t>(m_bins_x) * bins_y, {});
+        m_pixels.assign(static_cast<size_t>(width) * height * 4, 0);
+    }
+
+    void MESoftRenderer::SetTexture(int id, int width, int frame_height, int frame_count, int frame_duration_ms,
+                                    const uint8_t *rgba) {
+        if (id < 0 || id >= static_cast<int>(m_textures.size()) || width <= 0 || frame_height <= 0 ||
+            frame_count <= 0) {
+            return;
+        }
+        auto texture = std::make_unique<Texture>();
+        texture->width = width;
+        texture->frame_height = frame_height;
+        texture->frame_count = frame_count;
+        texture->frame_duration_ms = frame_duration_ms;
+        size_t pixel_count = static_cast<size_t>(width) * frame_height * frame_count;
+        texture->pixels.assign(rgba, rgba + pixel_count * 4);
+        texture->opaque = !ProcessPixels(texture->pixels.data(), pixel_count, 0);
+        m_textures[id] = std::move(texture);
+    }
+
+    void MESoftRenderer::RemoveTexture(int id) {
+        if (id >= 0 && id < static_cast<int>(m_textures.size())) {
+            m_textures[id].reset();
+        }
+    }
+
+    void MESoftRenderer::Render(const MESoftDraw *draws, size_t count, float scale, float time, uint32_t clear,
+                                MEJobPool &jobs) {
+        ME_TRACE_SCOPE("SoftRender");
+        for (auto &bin: m_bins) {
+            bin.clear();
+        }
+        m_rects.resize(count);
+        for (size_t i = 0; i < count && scale > 0.0f; ++i) {
+            int id = draws[i].id;
+            if (id < 0 || id >= static_cast<int>(m_textures.size()) || !m_textures[id]) {
+                continue;
+            }
+            const Texture &texture = *m_textures[id];
+            DrawRect &rect = m_rects[i];
+            rect.x = static_cast<float>(draws[i].x) * scale;
+            rect.y = static_cast<float>(draws[i].y) * scale;
+            rect.tint = draws[i].tint;
+            rect.orientation = draws[i].orientation & 15;
+            bool turned = (rect.orientation & 4) != 0;
+            rect.width = turned ? texture.frame_height : texture.width;
+            rect.height = turned ? texture.width : texture.frame_height;
+            // pixels whose centers fall inside the quad, as the rasterizer picks them
+            rect.left = std::max(0, static_cast<int>(std::ceil(rect.x - 0.5f)));
+            rect.top = std::max(0, static_cast<int>(std::ceil(rect.y - 0.5f)));
+            rect.right = std::min(m_width, static_cast<int>(std::ceil(rect.x + rect.width * scale - 0.5f)));
+            rect.bottom = std::min(m_height, static_cast<int>(std::ceil(rect.y + rect.height * scale - 0.5f)));
+            if (rect.left >= rect.right || rect.top >= rect.bottom) {
+                continue;
+            }
+            // as fs_tiled picks the frame
+            int frame = 0;
+            if (texture.frame_count > 1) {
+                float duration = static_cast<float>(texture.frame_duration_ms) / 1000.0f;
+                frame = static_cast<int>(std::floor(std::fmod(time / duration, static_cast<float>(texture.frame_count))));
+                frame = std::min(std::max(frame, 0), texture.frame_count - 1);
+            }
+            rect.texture = &texture;
+            rect.frame = texture.pixels.data() + static_cast<size_t>(frame) * texture.frame_height * texture.width * 4;
+
+            for (int by = rect.top / SOFT_BIN_SIZE; by <= (rect.bottom - 1) / SOFT_BIN_SIZE; ++by) {
+                for (int bx = rect.left / SOFT_BIN_SIZE; bx <= (rect.right - 1) / SOFT_BIN_SIZE; ++bx) {
+                    m_bins[static_cast<size_t>(by) * m_bins_x + bx].push_back(static_cast<uint32_t>(i));
+                }
+            }
+        }
+
+        uint8_t color[4] = {static_cast<uint8_t>(clear >> 24), static_cast<uint8_t>(clear >> 16),
+                            static_cast<uint8_t>(clear >> 8), static_cast<uint8_t>(clear)};
+        jobs.ParallelFor(m_bins.size(), 1, [&](size_t begin, size_t end) {
+            for (size_t bin = begin; bin < end; ++bin) {
+                DrawBin(static_cast<int>(bin), scale, color);
+            }
+        });
+    }
+
+    void MESoftRenderer::DrawBin(int bin, float scale, const uint8_t clear[4]) {
+        int bin_left = bin % m_bins_x * SOFT_BIN_SIZE;
+        int bin_top = bin / m_bins_x * SOFT_BIN_SIZE;
+        int bin_right = std::min(bin_left + SOFT_BIN_SIZE, m_width);
+        int bin_bottom = std::min(bin_top + SOFT_BIN_SIZE, m_height);
+        size_t stride = static_cast<size_t>(m_width) * 4;
+
+        uint8_t *row = m_pixels.data() + bin_top * stride + bin_left * 4;
+        for (int x = 0; x < bin_right - bin_left; ++x) {
+            std::memcpy(row + x * 4, clear, 4);
+        }
+        for (int y = bin_top + 1; y < bin_bottom; ++y) {
+            std::memcpy(m_pixels.data() + y * stride + bin_left * 4, row, (bin_right - bin_left) * 4);
+        }
+
+        // texel column of each pixel of the span, texels of a scaled row are gathered before blending
+        int columns[SOFT_BIN_SIZE];
+        alignas(16) uint8_t texels[SOFT_BIN_SIZE * 4];
+        bool unscaled = scale == 1.0f;
+        for (uint32_t index: m_bins[bin]) {
+            const DrawRect &rect = m_rects[index];
+            const Texture &texture = *rect.texture;
+            int left = std::max(rect.left, bin_left);
+            int right = std::min(rect.right, bin_right);
+            int top = std::max(rect.top, bin_top);
+            int bottom = std::min(rect.bottom, bin_bottom);
+            int span = right - left;
+            bool plain = rect.orientation == 0 && rect.tint == 0xFFFFFFFF;
+            if (!unscaled || !plain) {
+                for (int x = 0; x < span; ++x) {
+                    int u = unscaled ? left + x - static_cast<int>(rect.x)
+                                     : static_cast<int>((static_cast<float>(left + x) + 0.5f - rect.x) / scale);
+                    columns[x] = std::min(std::max(u, 0), rect.width - 1);
+                }
+            }
+            // a translucent tint makes every texel translucent
+            bool opaque = texture.opaque && (rect.tint & 0xFF) == 0xFF;
+            for (int y = top; y < bottom; ++y) {
+                int v = unscaled ? y - static_cast<int>(rect.y)
+                                 : static_cast<int>((static_cast<float>(y) + 0.5f - rect.y) / scale);
+                v = std::min(std::max(v, 0), rect.height - 1);
+                const uint8_t *source = rect.frame + static_cast<size_t>(v) * texture.width * 4;
+                uint8_t *target = m_pixels.data() + y * stride + left * 4;
+                if (!plain) {
+                    GatherRow(rect, columns, span, v, texels);
+                    source = texels;
+                } else if (unscaled) {
+                    source += (left - static_cast<int>(rect.x)) * 4;
+                } else {
+                    for (int x = 0; x < span; ++x) {
+                        std::memcpy(texels + x * 4, source + columns[x] * 4, 4);
+                    }
+                    source = texels;
+                }
+                if (opaque) {
+                    std::memcpy(target, source, span * 4);
+                } else {
+                    BlendPixels(target, source, span);
+                }
+            }
+        }
+    }
+
+    void MESoftRenderer::GatherRow(const DrawRect &rect, const int *columns, int span, int v, uint8_t *texels) const {
+        const Texture &texture = *rect.texture;
+        int turns = (rect.orientation >> 2) & 3;
+        uint8_t tint[4] = {static_cast<uint8_t>(rect.tint >> 24), static_cast<uint8_t>(rect.tint >> 16),
+                           static_cast<uint8_t>(rect.tint >> 8), static_cast<uint8_t>(rect.tint)};
+        for (int x = 0; x < span; ++x) {
+            // texel of the drawn block back to the texture: the quarter turns are undone, then the flips
+            int u = columns[x];
+            int row = v;
+            int width = rect.width;
+            int height = rect.height;
+            for (int turn = 0; turn < turns; ++turn) {
+                int turned = row;
+                row = width - 1 - u;
+                u = turned;
+                std::swap(width, height);
+            }
+            if (rect.orientation & 1) {
+                u = texture.width - 1 - u;
+            }
+            if (rect.orientation & 2) {
+                row = texture.frame_height - 1 - row;
+            }
+            const uint8_t *texel = rect.frame + (static_cast<size_t>(row) * texture.width + u) * 4;
+            for (int c = 0; c < 4; ++c) {
+                unsigned t = texel[c] * tint[c] + 128;
+                texels[x * 4 + c] = static_cast<uint8_t>((t + (t >> 8)) >> 8);
+            }
+        }
+    }
+
+    bool MESoftRenderer::SavePng(const char *path) const {
+        ME_TRACE_SCOPE("SaveFramePng");
+        std::vector<uint8_t> png;
+        EncodePng(m_pixels.data(), m_width, m_height, png);
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        if (!file.is_open()) {
+            return false;
+        }
+        file.write(reinterpret_cast<const char *>(png.data()), static_cast<std::streamsize>(png.size()));
+        return static_cast<bool>(file);
+    }
+}
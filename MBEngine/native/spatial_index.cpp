@@ -0,0 +1,196 @@
+#include "include/spatial_index.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+namespace MainboardEngine {
+    static int PopCount(uint64_t value) {
+#ifdef _MSC_VER
+        return static_cast<int>(__popcnt64(value));
+#else
+        return __builtin_popcountll(value);
+#endif
+    }
+
+    static int LowestBit(uint64_t value) {
+#ifdef _MSC_VER
+        unsigned long index;
+        _BitScanForward64(&index, value);
+        return static_cast<int>(index);
+#else
+        return __builtin_ctzll(value);
+#endif
+    }
+
+    static int FloorDiv(int value, int divisor) {
+        return value >= 0 ? value / divisor : -((-value + divisor - 1) / divisor);
+    }
+
+    // bits of a brick covering columns [column0, column1] and rows [row0, row1], all inside the brick
+    static uint64_t BrickMask(int column0, int column1, int row0, int row1) {
+        uint64_t row_bits = (0xFFull >> (SPATIAL_BRICK_SIZE - 1 - column1)) & (0xFFull << column0);
+        uint64_t rows = (~0ull >> (8 * (SPATIAL_BRICK_SIZE - 1 - row1))) & (~0ull << (8 * row0));
+        return (row_bits * 0x0101010101010101ull) & rows;
+    }
+
+    MESpatialIndex::MESpatialIndex() : m_tile_width(1), m_tile_height(1), m_columns(0), m_rows(0), m_bricks_x(0),
+                                       m_bricks_y(0) {
+    }
+
+    void MESpatialIndex::Resize(int tile_width, int tile_height, int columns, int rows) {
+        m_tile_width = std::max(tile_width, 1);
+        m_tile_height = std::max(tile_height, 1);
+        m_columns = std::max(columns, 0);
+        m_rows = std::max(rows, 0);
+        m_bricks_x = (m_columns + SPATIAL_BRICK_SIZE - 1) / SPATIAL_BRICK_SIZE;
+        m_bricks_y = (m_rows + SPATIAL_BRICK_SIZE - 1) / SPATIAL_BRICK_SIZE;
+        m_bricks.assign(static_cast<size_t>(m_bricks_x) * m_bricks_y, 0);
+    }
+
+    void MESpatialIndex::Clear() {
+        std::fill(m_bricks.begin(), m_bricks.end(), 0);
+    }
+
+    void MESpatialIndex::SetSolid(int column, int row, bool solid) {
+        if (column < 0 || row < 0 || column >= m_columns || row >= m_rows) {
+            return;
+        }
+        uint64_t bit = 1ull << ((row % SPATIAL_BRICK_SIZE) * SPATIAL_BRICK_SIZE + column % SPATIAL_BRICK_SIZE);
+        uint64_t &brick = m_bricks[(row / SPATIAL_BRICK_SIZE) * m_bricks_x + column / SPATIAL_BRICK_SIZE];
+        brick = solid ? brick | bit : brick & ~bit;
+    }
+
+    bool MESpatialIndex::GetTileAt(int x, int y, int &column, int &row) const {
+        column = FloorDiv(x, m_tile_width);
+        row = FloorDiv(y, m_tile_height);
+        return column >= 0 && row >= 0 && column < m_columns && row < m_rows;
+    }
+
+    int MESpatialIndex::CountSolid(const ME_AABB &box) const {
+        return QuerySolid(box, nullptr, 0);
+    }
+
+    int MESpatialIndex::QuerySolid(const ME_AABB &box, ME_TileCoord *tiles, int capacity) const {
+        if (box.width <= 0 || box.height <= 0) {
+            return 0;
+        }
+        int column0 = std::max(FloorDiv(box.x, m_tile_width), 0);
+        int row0 = std::max(FloorDiv(box.y, m_tile_height), 0);
+        int column1 = std::min(FloorDiv(box.x + box.width - 1, m_tile_width), m_columns - 1);
+        int row1 = std::min(FloorDiv(box.y + box.height - 1, m_tile_height), m_rows - 1);
+        if (column0 > column1 || row0 > row1) {
+            return 0;
+        }
+
+        int count = 0;
+        for (int brick_y = row0 / SPATIAL_BRICK_SIZE; brick_y <= row1 / SPATIAL_BRICK_SIZE; ++brick_y) {
+            int base_row = brick_y * SPATIAL_BRICK_SIZE;
+            int local_row0 = std::max(row0 - base_row, 0);
+            int local_row1 = std::min(row1 - base_row, SPATIAL_BRICK_SIZE - 1);
+            for (int brick_x = column0 / SPATIAL_BRICK_SIZE; brick_x <= column1 / SPATIAL_BRICK_SIZE; ++brick_x) {
+                uint64_t brick = m_bricks[brick_y * m_bricks_x + brick_x];
+                if (!brick) {
+                    continue;
+                }
+                int base_column = brick_x * SPATIAL_BRICK_SIZE;
+                uint64_t solid = brick & BrickMask(std::max(column0 - base_column, 0),
+                                                   std::min(column1 - base_column, SPATIAL_BRICK_SIZE - 1),
+                                                   local_row0, local_row1);
+                if (!tiles) {
+                    count += PopCount(solid);
+                    continue;
+                }
+                while (solid) {
+                    int bit = LowestBit(solid);
+                    solid &= solid - 1;
+                    if (count < capacity) {
+                        tiles[count].column = base_column + bit % SPATIAL_BRICK_SIZE;
+                        tiles[count].row = base_row + bit / SPATIAL_BRICK_SIZE;
+                    }
+                    ++count;
+                }
+            }
+        }
+
+        return count;
+    }
+
+    bool MESpatialIndex::Raycast(const ME_Ray &ray, ME_RaycastHit &hit) const {
+        hit = {};
+        hit.block_id = -1;
+
+        float width = static_cast<float>(m_tile_width);
+        float height = static_cast<float>(m_tile_height);
+        int column = static_cast<int>(std::floor(ray.x / width));
+        int row = static_cast<int>(std::floor(ray.y / height));
+        auto report = [&](float distance, int normal_x, int normal_y, float dir_x, float dir_y) {
+            hit.hit = ME_TRUE;
+            hit.column = column;
+            hit.row = row;
+            hit.distance = distance;
+            hit.x = ray.x + dir_x * distance;
+            hit.y = ray.y + dir_y * distance;
+            hit.normal_x = normal_x;
+            hit.normal_y = normal_y;
+            return true;
+        };
+
+        float length = std::sqrt(ray.dir_x * ray.dir_x + ray.dir_y * ray.dir_y);
+        if (IsSolid(column, row)) {
+            return report(0.0f, 0, 0, 0.0f, 0.0f);
+        }
+        if (length == 0.0f) {
+            return false;
+        }
+        float dir_x = ray.dir_x / length;
+        float dir_y = ray.dir_y / length;
+
+        // Amanatides & Woo: distance to the next vertical / horizontal tile border along the ray
+        const float infinity = std::numeric_limits<float>::infinity();
+        int step_x = dir_x > 0.0f ? 1 : (dir_x < 0.0f ? -1 : 0);
+        int step_y = dir_y > 0.0f ? 1 : (dir_y < 0.0f ? -1 : 0);
+        float delta_x = step_x ? width / std::fabs(dir_x) : infinity;
+        float delta_y = step_y ? height / std::fabs(dir_y) : infinity;
+        float next_x = step_x > 0
+                           ? (static_cast<float>(column + 1) * width - ray.x) / dir_x
+                           : (step_x < 0 ? (ray.x - static_cast<float>(column) * width) / -dir_x : infinity);
+        float next_y = step_y > 0
+                           ? (static_cast<float>(row + 1) * height - ray.y) / dir_y
+                           : (step_y < 0 ? (ray.y - static_cast<float>(row) * height) / -dir_y : infinity);
+
+        while (true) {
+            // outside the grid and moving away from it, nothing left to hit
+            if ((column < 0 && step_x <= 0) || (column >= m_columns && step_x >= 0) ||
+                (row < 0 && step_y <= 0) || (row >= m_rows && step_y >= 0)) {
+                return false;
+            }
+
+            float distance;
+            int normal_x = 0;
+            int normal_y = 0;
+            if (next_x < next_y) {
+                distance = next_x;
+                next_x += delta_x;
+                column += step_x;
+                normal_x = -step_x;
+            } else {
+                distance = next_y;
+                next_y += delta_y;
+                row += step_y;
+                normal_y = -step_y;
+            }
+            if (distance > ray.max_distance) {
+                return false;
+            }
+
+            if (IsSolid(column, row)) {
+                return report(distance, normal_x, normal_y, dir_x, dir_y);
+            }
+        }
+    }
+}
@@ -0,0 +1,85 @@
+#ifdef me_alloc_test
+#include "mainboard_engine.h"
+
+#include <event_message_type.h>
+#include <iostream>
+
+// needs a library built with -DME_ALLOC_TRACKING=ON
+int execute() {
+    using namespace std;
+
+    ME_AllocStats stats = {};
+    ME_GetAllocStats(&stats);
+    if (!stats.enabled) {
+        cout << "Allocation tracking is not compiled in, skipped." << endl;
+        return 0;
+    }
+
+    ME_Initialize();
+    auto window = ME_CreateWindow(0, 100, 100, 800, 600, "Alloc Test");
+    if (!window) {
+        cout << "Failed to create window." << endl;
+        return 1;
+    }
+    if (!ME_LoadBlock(0, "./native/tests/Ice_Block_(placed).png") ||
+        !ME_LoadBlock(1, "./native/tests/Cobalt_Brick_(placed).png")) {
+        cout << "Image not loaded!" << endl;
+        return 1;
+    }
+    ME_SetStaticLayer(32, 32, 100, 100);
+    for (int row = 0; row < 100; ++row) {
+        for (int column = 0; column < 100; ++column) {
+            ME_SetStaticTile(column, row, (row + column) % 2);
+        }
+    }
+
+    const char *names[ME_ALLOC_SUBSYSTEM_COUNT] = {
+        "other", "platform", "render", "resources", "world stream", "queries", "bgfx"
+    };
+    int ids[256];
+    int xs[256];
+    int ys[256];
+    for (int frame = 0; frame < 300; ++frame) {
+        // scrolling camera and moving sprites, the arena and caches settle in the first frames
+        for (int i = 0; i < 256; ++i) {
+            ids[i] = i % 2;
+            xs[i] = (i * 37 + frame) % 800;
+            ys[i] = (i * 53) % 600;
+        }
+        ME_RenderBlocks(ids, xs, ys, 256);
+        ME_SetCamera(frame, frame / 2);
+        ME_RenderFrame(window);
+        if (ME_ProcessEvents(window) == ME_QUIT_MESSAGE) {
+            break;
+        }
+        if (frame < 60) {
+            continue;
+        }
+
+        ME_GetAllocStats(&stats);
+        for (int subsystem = 0; subsystem < ME_ALLOC_SUBSYSTEM_COUNT; ++subsystem) {
+            // bgfx and the OS event loop are outside of our control, report them only
+            if (subsystem == ME_ALLOC_BGFX || subsystem == ME_ALLOC_PLATFORM) {
+                continue;
+            }
+            if (stats.frame[subsystem].allocations != 0) {
+                cout << "Steady frame " << frame << " allocated " << stats.frame[subsystem].allocations << " times ("
+                        << stats.frame[subsystem].bytes << " bytes) in " << names[subsystem] << endl;
+                return 1;
+            }
+        }
+    }
+
+    for (int subsystem = 0; subsystem < ME_ALLOC_SUBSYSTEM_COUNT; ++subsystem) {
+        cout << names[subsystem] << ": " << stats.total[subsystem].allocations << " allocations, "
+                << stats.total[subsystem].bytes << " bytes, last frame " << stats.frame[subsystem].allocations
+                << endl;
+    }
+    cout << "live bytes: " << stats.live_bytes << endl;
+
+    ME_DestroyWindow(window);
+
+    return 0;
+}
+
+#endif
@@ -0,0 +1,96 @@
+#ifdef me_block_variant_test
+#include "mainboard_engine.h"
+
+#include <iostream>
+#include <vector>
+
+int execute() {
+    using namespace std;
+
+    // the software renderer lets the frame be read back and compared pixel by pixel
+    if (!ME_SetRendererType(ME_RENDERER_SOFTWARE)) {
+        cout << "Software renderer not available" << endl;
+        return 1;
+    }
+    // chosen before ME_Initialize, the engine starts without the window system
+    if (!ME_Initialize()) {
+        cout << "Failed to initialize" << endl;
+        return 1;
+    }
+    const int width = 256;
+    const int height = 64;
+    auto window = ME_CreateWindow(0, 0, 0, width, height, "Block Variant Test");
+    if (!window) {
+        cout << "Failed to create window." << endl;
+        return 1;
+    }
+    if (!ME_LoadBlock(0, "./native/tests/Cobalt_Brick_(placed).png")) {
+        cout << "Image not loaded!" << endl;
+        return 1;
+    }
+    if (!ME_RegisterBlockVariant(1, 0, ME_TINT_NONE, ME_ORIENT_FLIP_X) ||
+        !ME_RegisterBlockVariant(2, 0, 0xFF000080u, ME_ORIENT_NONE)) {
+        cout << "Variants not registered" << endl;
+        return 1;
+    }
+    // a variant can't be the base of another, nor take an id in use
+    if (ME_RegisterBlockVariant(3, 1, ME_TINT_NONE, ME_ORIENT_NONE) ||
+        ME_RegisterBlockVariant(0, 2, ME_TINT_NONE, ME_ORIENT_NONE) ||
+        ME_RegisterBlockVariant(4, 5, ME_TINT_NONE, ME_ORIENT_NONE)) {
+        cout << "Bad variant accepted" << endl;
+        return 1;
+    }
+
+    // base, mirrored variant, base turned twice per draw, tinted variant
+    ME_RenderBlock(0, 0, 0);
+    ME_RenderBlock(1, 64, 0);
+    ME_RenderBlockEx(0, 128, 0, ME_TINT_NONE, ME_ORIENT_ROTATE_180);
+    ME_RenderBlock(2, 192, 0);
+    ME_RenderFrame(window);
+
+    vector<unsigned char> frame(static_cast<size_t>(width) * height * 4);
+    int frame_width = 0;
+    int frame_height = 0;
+    if (!ME_ReadFramePixels(frame.data(), static_cast<int>(frame.size()), &frame_width, &frame_height)) {
+        cout << "Frame wasn't read" << endl;
+        return 1;
+    }
+    auto pixel = [&](int x, int y) {
+        return &frame[(static_cast<size_t>(y) * width + x) * 4];
+    };
+
+    // the test block is 48 x 48, every copy fits in its own column
+    const int size = 48;
+    for (int y = 0; y < size; ++y) {
+        for (int x = 0; x < size; ++x) {
+            const unsigned char *base = pixel(x, y);
+            const unsigned char *mirrored = pixel(64 + size - 1 - x, y);
+            const unsigned char *turned = pixel(128 + size - 1 - x, size - 1 - y);
+            const unsigned char *tinted = pixel(192 + x, y);
+            for (int c = 0; c < 3; ++c) {
+                if (mirrored[c] != base[c] || turned[c] != base[c]) {
+                    cout << "Orientation differs at " << x << ", " << y << endl;
+                    return 1;
+                }
+            }
+            // the tint has no green and half the alpha, the clear color's green shows through at least half
+            bool covered = base[0] != 0x44 || base[1] != 0x33 || base[2] != 0x55;
+            if (covered && (tinted[1] >= 0x33 || tinted[1] < 0x33 / 2)) {
+                cout << "Tint wasn't applied at " << x << ", " << y << endl;
+                return 1;
+            }
+        }
+    }
+
+    // variants go with ME_ClearBlock
+    ME_ClearBlock();
+    if (ME_RenderBlock(1, 0, 0)) {
+        cout << "Variant outlived its base" << endl;
+        return 1;
+    }
+
+    ME_DestroyWindow(window);
+    return 0;
+}
+
+#endif
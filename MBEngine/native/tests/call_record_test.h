@@ -0,0 +1,64 @@
+#ifdef me_call_record_test
+#include "mainboard_engine.h"
+
+#include <event_message_type.h>
+#include <iostream>
+
+int execute() {
+    using namespace std;
+
+    const char *path = "./call_record_test.mbrec";
+    if (!ME_RecordStart(path)) {
+        cout << "Failed to start recording." << endl;
+        return 1;
+    }
+    ME_Initialize();
+    auto window = ME_CreateWindow(0, 100, 100, 800, 600, "Call Record Test");
+    if (!window) {
+        cout << "Failed to create window." << endl;
+        return 1;
+    }
+    if (!ME_LoadBlock(0, "./native/tests/Ice_Block_(placed).png") ||
+        !ME_LoadBlock(1, "./native/tests/Cobalt_Brick_(placed).png")) {
+        cout << "Image not loaded!" << endl;
+        return 1;
+    }
+
+    // initialize, create window, 2 loads and the final destroy, then 5 calls per frame
+    const int frames = 120;
+    int ids[2] = {0, 1};
+    int xs[2] = {0, 0};
+    int ys[2] = {0, 64};
+    for (int frame = 0; frame < frames; ++frame) {
+        xs[0] = frame * 4;
+        xs[1] = frame * 2;
+        ME_RenderBlocks(ids, xs, ys, 2);
+        ME_RenderBlock(1, 400, frame * 3);
+        ME_SetCamera(frame, 0);
+        ME_RenderFrame(window);
+        ME_ProcessEvents(window);
+    }
+    ME_DestroyWindow(window);
+    if (!ME_RecordStop()) {
+        cout << "Failed to write the recording." << endl;
+        return 1;
+    }
+
+    // the same session again, flat out
+    ME_ClearBlock();
+    ME_ReplayStats stats = {};
+    if (!ME_Replay(path, 0, &stats)) {
+        cout << "Failed to replay." << endl;
+        return 1;
+    }
+    cout << stats.call_count << " calls, " << stats.frame_count << " frames in " << stats.elapsed_ms
+            << " ms, recorded " << stats.recorded_ms << " ms, worst frame " << stats.max_frame_ms << " ms" << endl;
+    if (stats.frame_count != frames || stats.call_count != 5 + frames * 5) {
+        cout << "Replay did not issue the recorded calls" << endl;
+        return 1;
+    }
+
+    return 0;
+}
+
+#endif
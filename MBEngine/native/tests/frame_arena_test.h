@@ -0,0 +1,118 @@
+#ifdef me_frame_arena_test
+#include "mainboard_engine.h"
+#include "frame_arena.h"
+
+#include <string>
+#include <event_message_type.h>
+#include <iostream>
+
+static bool arena_unit_test() {
+    using namespace std;
+    using namespace MainboardEngine;
+
+    MEFrameArena arena(1024);
+    MEFrameVector<int> list(&arena);
+    int allocations_after_warmup = 0;
+    for (int frame = 0; frame < 8; ++frame) {
+        // the first frame outgrows 1 KB, the rest of it spills to the heap and nothing is dropped
+        for (int i = 0; i < 1000; ++i) {
+            if (!list.Push(i)) {
+                cout << "Push failed in frame " << frame << endl;
+                return false;
+            }
+        }
+        list.Clear();
+        arena.Reset();
+        if (frame == 3) {
+            allocations_after_warmup = arena.GetHeapAllocations();
+        }
+    }
+    // 1 KB overflows on the first frame, the arena must have grown and then settled
+    if (allocations_after_warmup < 2 || arena.GetHeapAllocations() != allocations_after_warmup) {
+        cout << "Arena allocated " << arena.GetHeapAllocations() << " times" << endl;
+        return false;
+    }
+
+    for (int i = 0; i < 1000; ++i) {
+        if (!list.Push(i)) {
+            cout << "Push failed after growth" << endl;
+            return false;
+        }
+    }
+    for (int i = 0; i < 1000; ++i) {
+        if (list[i] != i) {
+            cout << "Wrong value at " << i << endl;
+            return false;
+        }
+    }
+
+    return true;
+}
+
+int execute() {
+    using namespace std;
+    if (!arena_unit_test()) {
+        return 1;
+    }
+
+    ME_Initialize();
+    auto window = ME_CreateWindow(0, 100, 100, 800, 600, "Frame Arena Test");
+    if (!window) {
+        cout << "Failed to create window." << endl;
+        return 1;
+    }
+    if (!ME_LoadBlock(0, "./native/tests/Ice_Block_(placed).png")) {
+        cout << "Image not loaded!" << endl;
+        return 1;
+    }
+
+    const int warmup_frames = 10;
+    const int measured_frames = 300;
+    int allocations_after_warmup = 0;
+    ME_FrameStats stats = {};
+    // the arena counter only sees the arena, the instrumented build counts every operator new
+    ME_AllocStats alloc_stats = {};
+    ME_GetAllocStats(&alloc_stats);
+    bool heap_tracked = alloc_stats.enabled != 0;
+
+    for (int frame = 0; frame < warmup_frames + measured_frames; ++frame) {
+        // 20000 draws outgrow the initial arena on the first frame
+        for (int i = 0; i < 20000; ++i) {
+            ME_RenderBlock(0, (i % 200) * 4, (i / 200) * 6);
+        }
+        ME_RenderFrame(window);
+        ME_ProcessEvents(window);
+        ME_GetFrameStats(&stats);
+
+        if (frame == warmup_frames - 1) {
+            allocations_after_warmup = stats.arena_heap_allocations;
+            ME_ResetAllocStats();
+        }
+    }
+
+    cout << "draws: " << stats.draw_count << ", submits: " << stats.submit_count
+            << ", arena: " << stats.arena_used << "/" << stats.arena_capacity << endl;
+
+    if (stats.arena_heap_allocations != allocations_after_warmup) {
+        cout << "Steady state frames allocated: " << stats.arena_heap_allocations - allocations_after_warmup
+                << endl;
+        return 1;
+    }
+    if (heap_tracked) {
+        // recording draws and rendering them, bgfx and the OS event loop are not ours to count
+        ME_GetAllocStats(&alloc_stats);
+        if (alloc_stats.total[ME_ALLOC_RENDER].allocations != 0) {
+            cout << "Steady state frames made " << alloc_stats.total[ME_ALLOC_RENDER].allocations
+                    << " heap allocations" << endl;
+            return 1;
+        }
+    } else {
+        cout << "Allocation tracking is not compiled in, only the arena was checked." << endl;
+    }
+
+    ME_DestroyWindow(window);
+
+    return 0;
+}
+
+#endif
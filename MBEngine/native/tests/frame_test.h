@@ -0,0 +1,64 @@
+#ifdef me_frame_test
+#include "mainboard_engine.h"
+
+#include <event_message_type.h>
+#include <iostream>
+
+int execute() {
+    using namespace std;
+
+    ME_Initialize();
+    auto window = ME_CreateWindow(0, 100, 100, 800, 600, "Frame Test");
+    if (!window) {
+        cout << "Failed to create window." << endl;
+        return 1;
+    }
+    if (!ME_LoadBlock(0, "./native/tests/Ice_Block_(placed).png")) {
+        cout << "Image not loaded!" << endl;
+        return 1;
+    }
+
+    // the old java loop: a processor presents, then events, then the loop presents again
+    ME_FrameStats stats = {};
+    for (int frame = 0; frame < 60; ++frame) {
+        ME_RenderBlock(0, frame * 4, 100);
+        ME_RenderFrame(window);
+        if (ME_ProcessEvents(window) == ME_QUIT_MESSAGE) {
+            return 0;
+        }
+        ME_RenderFrame(window);
+    }
+    ME_GetFrameStats(&stats);
+    int presented = stats.frame_count;
+    int wasted = stats.wasted_frames;
+    cout << presented << " frames presented, " << wasted << " wasted" << endl;
+    if (presented != 120 || wasted != 59) {
+        cout << "Expected 120 frames with 59 wasted" << endl;
+        return 1;
+    }
+
+    // explicit frames: the processor's present is skipped, the loop presents once
+    for (int frame = 0; frame < 60; ++frame) {
+        if (ME_ProcessEvents(window) == ME_QUIT_MESSAGE) {
+            return 0;
+        }
+        if (!ME_BeginFrame(window) || ME_BeginFrame(window)) {
+            cout << "Nested frame accepted" << endl;
+            return 1;
+        }
+        ME_RenderBlock(0, frame * 4, 100);
+        ME_RenderFrame(window);
+        ME_EndFrame(window);
+    }
+    ME_EndFrame(window);
+    ME_GetFrameStats(&stats);
+    cout << stats.frame_count - presented << " frames presented, " << stats.skipped_presents << " skipped" << endl;
+    if (stats.frame_count - presented != 60 || stats.wasted_frames != wasted || stats.skipped_presents != 61) {
+        cout << "Expected one present per frame" << endl;
+        return 1;
+    }
+    ME_DestroyWindow(window);
+    return 0;
+}
+
+#endif
@@ -0,0 +1,99 @@
+#ifdef me_light_test
+#include "mainboard_engine.h"
+
+#include <event_message_type.h>
+#include <iostream>
+
+int execute() {
+    using namespace std;
+
+    ME_Initialize();
+    auto window = ME_CreateWindow(0, 100, 100, 800, 600, "Light Test");
+    if (!window) {
+        cout << "Failed to create window." << endl;
+        return 1;
+    }
+    if (!ME_LoadBlock(0, "./native/tests/Ice_Block_(placed).png") ||
+        !ME_LoadBlock(1, "./native/tests/Cobalt_Brick_(placed).png")) {
+        cout << "Image not loaded!" << endl;
+        return 1;
+    }
+
+    // ground of bricks under open air, a torch (ice) every 32 columns in the top layer of ground
+    const int columns = 4000;
+    const int rows = 1200;
+    const int ground = 300;
+    ME_SetStaticLayer(16, 16, columns, rows);
+    for (int row = ground; row < rows; ++row) {
+        for (int column = 0; column < columns; ++column) {
+            ME_SetStaticTile(column, row, row == ground && column % 32 == 0 ? 0 : 1);
+        }
+    }
+    if (!ME_SetBlockLight(0, 240, 0) || !ME_SetBlockLight(1, 0, 64) || ME_SetBlockLight(0, 256, 0) ||
+        ME_SetLighting(ME_TRUE, 0, 4)) {
+        cout << "Light values not checked" << endl;
+        return 1;
+    }
+    if (!ME_SetLighting(ME_TRUE, 32, 16)) {
+        cout << "Failed to enable lighting" << endl;
+        return 1;
+    }
+    ME_SetCamera(0, ground * 16 - 300);
+
+    ME_LightStats stats = {};
+    ME_RenderFrame(window);
+    ME_GetLightStats(&stats);
+    cout << "Full relight of " << stats.relit_tiles << " tiles on " << stats.thread_count << " threads, "
+         << stats.update_ms << " ms" << endl;
+    if (stats.relit_tiles != columns * rows) {
+        cout << "Expected the whole layer relit" << endl;
+        return 1;
+    }
+    // one air tile away loses the air falloff, one brick away the brick opacity
+    if (ME_GetLight(32, ground) != 240 || ME_GetLight(32, ground - 1) != 224 ||
+        ME_GetLight(32, ground + 1) != 176 || ME_GetLight(16, ground + 600) != 0 || ME_GetLight(columns, 0) != -1) {
+        cout << "Unexpected light levels " << ME_GetLight(32, ground - 1) << " " << ME_GetLight(32, ground + 1)
+             << endl;
+        return 1;
+    }
+
+    // digging next to a torch only relights the tiles its light could reach
+    double edit_ms = 0.0;
+    int edits = 0;
+    for (int frame = 0; frame < 120; ++frame) {
+        if (frame % 2 == 0) {
+            ME_SetStaticTile(100 + frame, ground + 1, -1);
+        }
+        ME_RenderFrame(window);
+        if (ME_ProcessEvents(window) == ME_QUIT_MESSAGE) {
+            break;
+        }
+        ME_GetLightStats(&stats);
+        if (frame % 2 == 0) {
+            edit_ms += stats.update_ms;
+            ++edits;
+            int reach = 2 * (ME_LIGHT_MAX / ME_LIGHT_MIN_FALLOFF) + 1;
+            if (stats.relit_tiles > reach * reach) {
+                cout << "An edit relit " << stats.relit_tiles << " tiles" << endl;
+                return 1;
+            }
+        } else if (stats.relit_tiles != 0) {
+            cout << "Relit without an edit" << endl;
+            return 1;
+        }
+    }
+    cout << "Single tile edit " << (edits ? edit_ms / edits : 0.0) << " ms" << endl;
+    if (ME_GetLight(100, ground + 1) <= ME_GetLight(90, ground + 1)) {
+        cout << "Light didn't get into the dug out tile" << endl;
+        return 1;
+    }
+
+    if (!ME_SetLighting(ME_FALSE, 0, 16) || ME_GetLight(32, ground) != -1) {
+        cout << "Lighting not disabled" << endl;
+        return 1;
+    }
+    ME_DestroyWindow(window);
+    return 0;
+}
+
+#endif
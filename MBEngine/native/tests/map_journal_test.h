@@ -0,0 +1,81 @@
+#ifdef me_map_journal_test
+#include "mainboard_engine.h"
+
+#include <cstdio>
+#include <iostream>
+
+int execute() {
+    using namespace std;
+
+    ME_Initialize();
+    auto window = ME_CreateWindow(0, 100, 100, 800, 600, "Map Journal Test");
+    if (!window) {
+        cout << "Failed to create window." << endl;
+        return 1;
+    }
+    if (!ME_LoadBlock(0, "./native/tests/Ice_Block_(placed).png") ||
+        !ME_LoadBlock(1, "./native/tests/Cobalt_Brick_(placed).png")) {
+        cout << "Image not loaded!" << endl;
+        return 1;
+    }
+
+    const char *path = "./map_journal_test.mbworld";
+    remove(path);
+    remove("./map_journal_test.mbworld.journal");
+    remove("./map_journal_test.mbworld.journal.old");
+
+    // a new map is the static layer as it is
+    const int size = 512;
+    ME_SetStaticLayer(32, 32, size, size);
+    if (ME_SetTile(0, 0, 1) || !ME_OpenMap(path)) {
+        cout << "Map wasn't created" << endl;
+        return 1;
+    }
+    ME_FillRect(0, 0, size, size, 0);
+    ME_FillRect(100, 100, 1000, 1000, 1); // clipped
+    ME_SetTile(10, 10, 1);
+    ME_MapStats stats = {};
+    if (!ME_SaveMap() || !ME_GetMapStats(&stats) || stats.journal_records != 3 || stats.pending_edits != 0) {
+        cout << "Edits weren't saved" << endl;
+        return 1;
+    }
+    cout << "3 edits saved in " << stats.last_save_ms << " ms, journal " << stats.journal_bytes << " B" << endl;
+
+    // the saved edits come back, the unsaved one is saved by ME_CloseMap
+    ME_SetTile(11, 10, 1);
+    ME_CloseMap();
+    ME_SetStaticLayer(32, 32, 1, 1);
+    if (!ME_OpenMap(path) || ME_QueryPoint(10 * 32 + 1, 10 * 32 + 1) != 1 ||
+        ME_QueryPoint(11 * 32 + 1, 10 * 32 + 1) != 1 || ME_QueryPoint(1, 1) != 0 ||
+        ME_QueryPoint(size * 32 - 1, size * 32 - 1) != 1) {
+        cout << "Map didn't reload" << endl;
+        return 1;
+    }
+
+    // a save takes the edits since the last one, however large the map is
+    for (int i = 0; i < 20000; ++i) {
+        ME_SetTile((i * 7) % size, (i * 13) % size, i % 2);
+    }
+    ME_SaveMap();
+    ME_GetMapStats(&stats);
+    cout << "20000 edits saved in " << stats.last_save_ms << " ms, journal " << stats.journal_bytes << " B, base "
+         << stats.base_bytes << " B" << endl;
+    ME_SetTile(3, 4, 1);
+    if (!ME_CompactMap()) {
+        cout << "Map wasn't compacted" << endl;
+        return 1;
+    }
+    ME_CloseMap();
+    ME_SetStaticLayer(32, 32, 1, 1);
+    if (!ME_OpenMap(path) || ME_QueryPoint(3 * 32 + 1, 4 * 32 + 1) != 1 || !ME_GetMapStats(&stats) ||
+        stats.journal_records != 0) {
+        cout << "Compacted map didn't reload" << endl;
+        return 1;
+    }
+    ME_CloseMap();
+
+    ME_DestroyWindow(window);
+    return 0;
+}
+
+#endif
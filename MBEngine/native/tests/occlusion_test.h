@@ -0,0 +1,117 @@
+#ifdef me_occlusion_test
+#include "mainboard_engine.h"
+
+#include <iostream>
+#include <vector>
+
+int execute() {
+    using namespace std;
+
+    // the software renderer culls like the GPU path and lets the frames be compared
+    if (!ME_SetRendererType(ME_RENDERER_SOFTWARE)) {
+        cout << "Software renderer not available" << endl;
+        return 1;
+    }
+    // chosen before ME_Initialize, the engine starts without the window system
+    if (!ME_Initialize()) {
+        cout << "Failed to initialize" << endl;
+        return 1;
+    }
+    const int width = 320;
+    const int height = 240;
+    auto window = ME_CreateWindow(0, 0, 0, width, height, "Occlusion Test");
+    if (!window) {
+        cout << "Failed to create window." << endl;
+        return 1;
+    }
+    // mixed, opaque and fully transparent 48 x 48 blocks
+    if (!ME_LoadBlock(0, "./native/tests/Ice_Block_(placed).png") ||
+        !ME_LoadBlock(1, "./native/tests/Stone_Block.png") ||
+        !ME_LoadBlock(2, "./native/tests/Empty_Block.png") ||
+        !ME_RegisterBlockVariant(3, 1, 0xFFFFFF80u, ME_ORIENT_ROTATE_90) ||
+        !ME_RegisterBlockVariant(4, 1, 0xFF0000FFu, ME_ORIENT_NONE)) {
+        cout << "Blocks not loaded!" << endl;
+        return 1;
+    }
+    auto read_frame = [&](vector<unsigned char> &frame) {
+        frame.resize(static_cast<size_t>(width) * height * 4);
+        int frame_width = 0;
+        int frame_height = 0;
+        return ME_ReadFramePixels(frame.data(), static_cast<int>(frame.size()), &frame_width, &frame_height);
+    };
+
+    // blocks draw in call order, later ones on top
+    ME_RenderBlock(0, 20, 20);
+    ME_RenderBlock(1, 20, 20); // hides the ice block
+    ME_RenderBlock(0, 100, 20);
+    ME_RenderBlock(2, 100, 20); // draws nothing
+    ME_RenderBlock(0, 180, 20);
+    ME_RenderBlock(3, 180, 20); // translucent, the ice block shows through
+    ME_RenderBlock(0, 30, 100);
+    ME_RenderBlock(1, 20, 100); // covers only part of it
+    ME_RenderBlockEx(0, 100, 100, 0xFFFFFF00u, ME_ORIENT_NONE); // tinted invisible
+    ME_RenderFrame(window);
+    ME_FrameStats stats = {};
+    ME_GetFrameStats(&stats);
+    if (stats.occluded_draws != 1 || stats.transparent_draws != 2) {
+        cout << "Occluded " << stats.occluded_draws << ", transparent " << stats.transparent_draws << endl;
+        return 1;
+    }
+    vector<unsigned char> culled;
+    if (!read_frame(culled)) {
+        cout << "Frame wasn't read" << endl;
+        return 1;
+    }
+
+    // the same frame without the draws that were skipped must look the same
+    ME_RenderBlock(1, 20, 20);
+    ME_RenderBlock(0, 100, 20);
+    ME_RenderBlock(0, 180, 20);
+    ME_RenderBlock(3, 180, 20);
+    ME_RenderBlock(0, 30, 100);
+    ME_RenderBlock(1, 20, 100);
+    ME_RenderFrame(window);
+    ME_GetFrameStats(&stats);
+    vector<unsigned char> reference;
+    read_frame(reference);
+    if (stats.occluded_draws != 0 || stats.transparent_draws != 0 || culled != reference) {
+        cout << "Skipped draws changed the frame" << endl;
+        return 1;
+    }
+
+    // the id doesn't matter, a lower id drawn later hides a higher one and not the other way around
+    ME_RenderBlock(4, 20, 20);
+    ME_RenderBlock(1, 20, 20); // hides the red stone
+    ME_RenderBlock(1, 100, 20);
+    ME_RenderBlock(4, 100, 20); // hides the plain stone
+    ME_RenderBlock(4, 180, 20);
+    ME_RenderBlock(0, 180, 20); // mixed, the red stone stays under it
+    ME_RenderFrame(window);
+    ME_GetFrameStats(&stats);
+    vector<unsigned char> ordered;
+    read_frame(ordered);
+    auto green = [&](int x, int y) {
+        return ordered[(static_cast<size_t>(y) * width + x) * 4 + 1];
+    };
+    if (stats.occluded_draws != 2 || green(44, 44) == 0 || green(124, 44) != 0) {
+        cout << "Culling didn't follow the call order" << endl;
+        return 1;
+    }
+
+    // static tiles under an opaque block are skipped as well
+    ME_SetStaticLayer(48, 48, 4, 4);
+    ME_SetStaticTile(0, 0, 0);
+    ME_SetStaticTile(1, 0, 2);
+    ME_RenderBlock(1, 0, 0);
+    ME_RenderFrame(window);
+    ME_GetFrameStats(&stats);
+    if (stats.occluded_draws != 1 || stats.transparent_draws != 1) {
+        cout << "Static tiles weren't skipped" << endl;
+        return 1;
+    }
+
+    ME_DestroyWindow(window);
+    return 0;
+}
+
+#endif
@@ -0,0 +1,107 @@
+#ifdef me_particle_test
+#include "mainboard_engine.h"
+
+#include <event_message_type.h>
+#include <iostream>
+
+int execute() {
+    using namespace std;
+
+    ME_Initialize();
+    auto window = ME_CreateWindow(0, 100, 100, 800, 600, "Particle Test");
+    if (!window) {
+        cout << "Failed to create window." << endl;
+        return 1;
+    }
+    if (!ME_LoadBlock(0, "./native/tests/Ice_Block_(placed).png")) {
+        cout << "Image not loaded!" << endl;
+        return 1;
+    }
+
+    // weather: 100k particles per second living 2 seconds, about 200k alive at once
+    ME_EmitterDesc snow = {};
+    snow.x = 400.0f;
+    snow.y = -20.0f;
+    snow.width = 800.0f;
+    snow.rate = 100000.0f;
+    snow.lifetime_min = 1.5f;
+    snow.lifetime_max = 2.5f;
+    snow.speed_min = 40.0f;
+    snow.speed_max = 120.0f;
+    snow.direction = 90.0f;
+    snow.spread = 30.0f;
+    snow.gravity_y = 60.0f;
+    snow.drag = 0.2f;
+    snow.size_start = 3.0f;
+    snow.size_end = 1.0f;
+    snow.color_start = 0xFFFFFFFF;
+    snow.color_end = 0xFFFFFF00;
+    snow.block_id = -1;
+    int weather = ME_CreateEmitter(&snow);
+
+    // block break dust, textured with the block, only bursts
+    ME_EmitterDesc dust = snow;
+    dust.width = 16.0f;
+    dust.height = 16.0f;
+    dust.rate = 0.0f;
+    dust.lifetime_min = 0.3f;
+    dust.lifetime_max = 0.6f;
+    dust.direction = -90.0f;
+    dust.spread = 120.0f;
+    dust.gravity_y = 400.0f;
+    dust.size_start = 6.0f;
+    dust.size_end = 2.0f;
+    dust.block_id = 0;
+    int breaks = ME_CreateEmitter(&dust);
+    if (weather < 0 || breaks < 0) {
+        cout << "Failed to create emitters" << endl;
+        return 1;
+    }
+    ME_EmitterDesc invalid = snow;
+    invalid.lifetime_min = 0.0f;
+    if (ME_CreateEmitter(&invalid) >= 0 || ME_EmitParticles(ME_MAX_EMITTERS, 0.0f, 0.0f, 10)) {
+        cout << "Invalid emitter accepted" << endl;
+        return 1;
+    }
+
+    ME_ParticleStats stats = {};
+    ME_FrameStats frame_stats = {};
+    double update_ms = 0.0;
+    int measured = 0;
+    for (int frame = 0; frame < 600; ++frame) {
+        if (frame % 20 == 0) {
+            ME_EmitParticles(breaks, static_cast<float>(100 + frame % 600), 400.0f, 64);
+        }
+        ME_RenderBlock(0, 100, 400);
+        ME_RenderFrame(window);
+        if (ME_ProcessEvents(window) == ME_QUIT_MESSAGE) {
+            break;
+        }
+        ME_GetParticleStats(&stats);
+        ME_GetFrameStats(&frame_stats);
+        if (frame >= 300) {
+            update_ms += stats.update_ms;
+            ++measured;
+        }
+    }
+    cout << stats.live_count << " particles on " << stats.thread_count << " threads, update "
+         << (measured ? update_ms / measured : 0.0) << " ms" << endl;
+    if (stats.live_count < 150000 || stats.emitter_count != 2) {
+        cout << "Expected about 200k live particles in 2 emitters" << endl;
+        return 1;
+    }
+    // the block, one draw per emitter
+    if (frame_stats.submit_count > 3) {
+        cout << "Particles submitted " << frame_stats.submit_count << " draws" << endl;
+        return 1;
+    }
+
+    if (!ME_DestroyEmitter(weather) || ME_DestroyEmitter(weather)) {
+        cout << "Emitter destroyed twice" << endl;
+        return 1;
+    }
+    ME_DestroyWindow(window);
+    return 0;
+}
+
+#endif
@@ -0,0 +1,111 @@
+#ifdef me_path_test
+#include "mainboard_engine.h"
+
+#include <chrono>
+#include <iostream>
+#include <vector>
+
+int execute() {
+    using namespace std;
+
+    ME_Initialize();
+    auto window = ME_CreateWindow(0, 100, 100, 800, 600, "Path Test");
+    if (!window) {
+        cout << "Failed to create window." << endl;
+        return 1;
+    }
+    ME_BlockDesc solid = {1, 0, ME_BLOCK_FLAG_SOLID};
+    if (!ME_LoadBlock(0, "./native/tests/Ice_Block_(placed).png") ||
+        !ME_LoadBlockEx(1, "./native/tests/Cobalt_Brick_(placed).png", &solid)) {
+        cout << "Image not loaded!" << endl;
+        return 1;
+    }
+
+    // a brick wall on column 50 with a door at row 90
+    const int columns = 256;
+    const int rows = 128;
+    ME_SetStaticLayer(32, 32, columns, rows);
+    for (int row = 0; row < rows; ++row) {
+        for (int column = 0; column < columns; ++column) {
+            ME_SetStaticTile(column, row, column == 50 && row != 90 ? 1 : 0);
+        }
+    }
+
+    ME_PathRequest requests[] = {
+        {10, 10, 100, 10, ME_PATH_DIAGONAL, 0},
+        {10, 10, 100, 10, 0, 0},
+        {10, 10, 50, 10, ME_PATH_DIAGONAL, 0}, // goal inside the wall
+        {10, 10, 100, 10, ME_PATH_DIAGONAL, 1}, // gives up after the start
+    };
+    const int count = sizeof(requests) / sizeof(requests[0]);
+    int batch = ME_FindPaths(requests, count);
+    if (batch < 0 || !ME_WaitPaths(batch)) {
+        cout << "Paths weren't solved" << endl;
+        return 1;
+    }
+    ME_PathResult results[count];
+    vector<ME_TileCoord> tiles(4096);
+    int total = ME_GetPaths(batch, results, tiles.data(), static_cast<int>(tiles.size()));
+    if (total <= 0 || results[0].status != ME_PATH_FOUND || results[1].status != ME_PATH_FOUND ||
+        results[2].status != ME_PATH_INVALID || results[3].status != ME_PATH_NONE) {
+        cout << "Wrong path status" << endl;
+        return 1;
+    }
+    // every path goes through the door
+    bool door = false;
+    for (int i = 0; i < results[0].length; ++i) {
+        const ME_TileCoord &tile = tiles[results[0].offset + i];
+        door |= tile.column == 50 && tile.row == 90;
+    }
+    // 4 neighbour steps: 40 right, 80 down through the door and back up, 50 right
+    if (!door || results[1].length != 40 + 80 * 2 + 50 + 1 || results[0].cost >= results[1].cost) {
+        cout << "Path doesn't take the door" << endl;
+        return 1;
+    }
+
+    // closing the door blocks the paths through it, solving again finds none
+    ME_SetStaticTile(50, 90, 1);
+    ME_GetPaths(batch, results, tiles.data(), static_cast<int>(tiles.size()));
+    if (results[0].status != ME_PATH_BLOCKED || results[1].status != ME_PATH_BLOCKED) {
+        cout << "Closed door didn't block the paths" << endl;
+        return 1;
+    }
+    ME_ReleasePaths(batch);
+    batch = ME_FindPaths(requests, 1);
+    ME_WaitPaths(batch);
+    ME_GetPaths(batch, results, nullptr, 0);
+    if (results[0].status != ME_PATH_NONE || ME_GetPaths(batch + 1, results, nullptr, 0) != -1) {
+        cout << "Path went through a closed door" << endl;
+        return 1;
+    }
+    ME_ReleasePaths(batch);
+
+    // a crowd finding its way across the map, one batch
+    ME_SetStaticTile(50, 90, 0);
+    const int crowd = 5000;
+    vector<ME_PathRequest> walkers(crowd);
+    for (int i = 0; i < crowd; ++i) {
+        walkers[i] = {(i * 7) % 50, (i * 13) % rows, 51 + (i * 11) % 200, (i * 17) % rows, ME_PATH_DIAGONAL, 0};
+    }
+    auto start = chrono::steady_clock::now();
+    batch = ME_FindPaths(walkers.data(), crowd);
+    ME_WaitPaths(batch);
+    auto elapsed = chrono::duration_cast<chrono::microseconds>(chrono::steady_clock::now() - start).count();
+    vector<ME_PathResult> crowd_results(crowd);
+    int crowd_tiles = ME_GetPaths(batch, crowd_results.data(), nullptr, 0);
+    int found = 0;
+    for (auto &result: crowd_results) {
+        found += result.status == ME_PATH_FOUND ? 1 : 0;
+    }
+    cout << crowd << " paths took " << elapsed << " us, " << found << " found, " << crowd_tiles << " tiles" << endl;
+    ME_ReleasePaths(batch);
+    if (found != crowd) {
+        cout << "Some walkers got no path" << endl;
+        return 1;
+    }
+
+    ME_DestroyWindow(window);
+    return 0;
+}
+
+#endif
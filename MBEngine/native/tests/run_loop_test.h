@@ -0,0 +1,105 @@
+#ifdef me_run_loop_test
+#include "mainboard_engine.h"
+
+#include <event_message_type.h>
+#include <chrono>
+#include <iostream>
+#include <thread>
+
+struct LoopTestState {
+    int ticks;
+    int frames;
+    int x; // moved every tick, drawn between the last two positions
+    bool bad_alpha;
+    bool hitch;
+};
+
+static void LoopTestTick(double dt, void *user_data) {
+    auto *state = static_cast<LoopTestState *>(user_data);
+    ++state->ticks;
+    state->x += 4;
+    if (state->hitch) {
+        // much longer than max_ticks_per_frame ticks, the loop must not try to catch up
+        state->hitch = false;
+        std::this_thread::sleep_for(std::chrono::milliseconds(500));
+    }
+}
+
+static void LoopTestFrame(double alpha, void *user_data) {
+    auto *state = static_cast<LoopTestState *>(user_data);
+    state->bad_alpha = state->bad_alpha || alpha < 0.0 || alpha >= 1.0;
+    ME_RenderBlock(0, state->x - 4 + static_cast<int>(alpha * 4.0), 200);
+    if (++state->frames == 120) {
+        ME_StopLoop();
+    }
+}
+
+int execute() {
+    using namespace std;
+
+    ME_Initialize();
+    auto window = ME_CreateWindow(0, 100, 100, 800, 600, "Run Loop Test");
+    if (!window) {
+        cout << "Failed to create window." << endl;
+        return 1;
+    }
+    if (!ME_LoadBlock(0, "./native/tests/Ice_Block_(placed).png")) {
+        cout << "Image not loaded!" << endl;
+        return 1;
+    }
+
+    LoopTestState state = {};
+    ME_LoopDesc desc = {};
+    desc.tick_rate = 0.0;
+    desc.max_ticks_per_frame = 4;
+    if (ME_RunLoop(window, &desc) != -1) {
+        cout << "Invalid loop accepted" << endl;
+        return 1;
+    }
+
+    // frames capped at 60, two per tick
+    desc.tick_rate = 30.0;
+    desc.frame_rate = 60.0;
+    desc.update = LoopTestTick;
+    desc.render = LoopTestFrame;
+    desc.user_data = &state;
+    auto start = chrono::steady_clock::now();
+    if (ME_RunLoop(window, &desc) == ME_QUIT_MESSAGE) {
+        return 0;
+    }
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    ME_LoopStats stats = {};
+    ME_GetLoopStats(&stats);
+    cout << stats.frame_count << " frames and " << stats.tick_count << " ticks in " << seconds << " s, slept "
+         << stats.sleep_ms << " ms" << endl;
+    if (stats.frame_count != 120 || state.bad_alpha) {
+        cout << "Unexpected frames or alpha" << endl;
+        return 1;
+    }
+    // simulation speed follows the clock, not the frame rate
+    if (stats.tick_count < static_cast<long long>(seconds * 30.0) - 2 ||
+        stats.tick_count > static_cast<long long>(seconds * 30.0) + 2) {
+        cout << "Ticks don't match the elapsed time" << endl;
+        return 1;
+    }
+    if (seconds < 1.8 || stats.sleep_ms <= 0.0) {
+        cout << "Frame rate cap not honored" << endl;
+        return 1;
+    }
+
+    // a hitch drops ticks instead of spiraling
+    state = {};
+    state.hitch = true;
+    if (ME_RunLoop(window, &desc) == ME_QUIT_MESSAGE) {
+        return 0;
+    }
+    ME_GetLoopStats(&stats);
+    if (stats.dropped_ticks < 5) {
+        cout << "Hitch not clamped, dropped " << stats.dropped_ticks << endl;
+        return 1;
+    }
+    ME_DestroyWindow(window);
+    return 0;
+}
+
+#endif
@@ -0,0 +1,100 @@
+#ifdef me_soft_render_test
+#include "mainboard_engine.h"
+
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <vector>
+
+int execute() {
+    using namespace std;
+
+    // no GPU or display needed, the window only has a size
+    if (!ME_SetRendererType(ME_RENDERER_SOFTWARE)) {
+        cout << "Software renderer not available" << endl;
+        return 1;
+    }
+    // chosen before ME_Initialize, the engine starts without the window system
+    if (!ME_Initialize()) {
+        cout << "Failed to initialize" << endl;
+        return 1;
+    }
+    const int width = 320;
+    const int height = 240;
+    auto window = ME_CreateWindow(0, 0, 0, width, height, "Soft Render Test");
+    if (!window) {
+        cout << "Failed to create window." << endl;
+        return 1;
+    }
+    if (!ME_LoadBlock(0, "./native/tests/Ice_Block_(placed).png") ||
+        !ME_LoadBlock(1, "./native/tests/Cobalt_Brick_(placed).png")) {
+        cout << "Image not loaded!" << endl;
+        return 1;
+    }
+
+    // a checkerboard of static tiles with the right part left empty, blocks over it and off the edges
+    ME_SetStaticLayer(32, 32, 6, 8);
+    for (int row = 0; row < 8; ++row) {
+        for (int column = 0; column < 6; ++column) {
+            ME_SetStaticTile(column, row, (column + row) % 2);
+        }
+    }
+    ME_SetCamera(8, 0);
+    ME_RenderBlock(1, 150, 40);
+    ME_RenderBlock(0, 166, 56);
+    ME_RenderBlock(1, -10, 200);
+    ME_RenderBlock(0, width - 16, height - 16);
+    ME_RenderFrame(window);
+
+    int frame_width = 0;
+    int frame_height = 0;
+    if (ME_ReadFramePixels(nullptr, 0, &frame_width, &frame_height) || frame_width != width ||
+        frame_height != height) {
+        cout << "Frame size is " << frame_width << "x" << frame_height << endl;
+        return 1;
+    }
+    vector<unsigned char> frame(static_cast<size_t>(width) * height * 4);
+    if (!ME_ReadFramePixels(frame.data(), static_cast<int>(frame.size()), &frame_width, &frame_height)) {
+        cout << "Frame wasn't read" << endl;
+        return 1;
+    }
+    // nothing covers the top right corner, it keeps the clear color
+    const unsigned char *corner = &frame[(width - 1) * 4];
+    if (corner[0] != 0x44 || corner[1] != 0x33 || corner[2] != 0x55 || corner[3] != 0xFF) {
+        cout << "Background isn't the clear color" << endl;
+        return 1;
+    }
+    ME_SaveFramePng("./soft_render_test.png");
+
+    // the first run keeps the frame as the golden image, later runs must match it exactly
+    const char *golden_path = "./soft_render_golden.rgba";
+    ifstream golden_file(golden_path, ios::binary);
+    if (!golden_file.is_open()) {
+        ofstream(golden_path, ios::binary).write(reinterpret_cast<const char *>(frame.data()),
+                                                 static_cast<streamsize>(frame.size()));
+        cout << "Golden image written to " << golden_path << endl;
+    } else {
+        vector<unsigned char> golden((istreambuf_iterator<char>(golden_file)), istreambuf_iterator<char>());
+        if (golden != frame) {
+            cout << "Frame differs from " << golden_path << ", see ./soft_render_test.png" << endl;
+            return 1;
+        }
+    }
+
+    // zoomed out the same blocks cover a quarter of the area
+    ME_SetRenderScale(0.5f);
+    ME_RenderBlock(1, 0, 0);
+    ME_RenderFrame(window);
+    vector<unsigned char> zoomed(frame.size());
+    ME_ReadFramePixels(zoomed.data(), static_cast<int>(zoomed.size()), &frame_width, &frame_height);
+    if (zoomed == frame) {
+        cout << "Render scale was ignored" << endl;
+        return 1;
+    }
+
+    ME_DestroyWindow(window);
+    return 0;
+}
+
+#endif
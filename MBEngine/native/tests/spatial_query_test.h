@@ -0,0 +1,105 @@
+#ifdef me_spatial_query_test
+#include "mainboard_engine.h"
+
+#include <chrono>
+#include <event_message_type.h>
+#include <iostream>
+#include <vector>
+
+int execute() {
+    using namespace std;
+
+    ME_Initialize();
+    auto window = ME_CreateWindow(0, 100, 100, 800, 600, "Spatial Query Test");
+    if (!window) {
+        cout << "Failed to create window." << endl;
+        return 1;
+    }
+    ME_BlockDesc solid = {1, 0, ME_BLOCK_FLAG_SOLID};
+    if (!ME_LoadBlock(0, "./native/tests/Ice_Block_(placed).png") ||
+        !ME_LoadBlockEx(1, "./native/tests/Cobalt_Brick_(placed).png", &solid)) {
+        cout << "Image not loaded!" << endl;
+        return 1;
+    }
+
+    // ice sky, a brick floor on row 10 and a brick wall on column 20
+    const int columns = 256;
+    const int rows = 64;
+    ME_SetStaticLayer(32, 32, columns, rows);
+    for (int row = 0; row < rows; ++row) {
+        for (int column = 0; column < columns; ++column) {
+            ME_SetStaticTile(column, row, row == 10 || column == 20 ? 1 : 0);
+        }
+    }
+
+    if (ME_QueryPoint(32 * 5 + 3, 32 * 10 + 7) != 1 || ME_QueryPoint(40, 40) != 0 || ME_QueryPoint(-1, 0) != -1) {
+        cout << "Point query returned the wrong block" << endl;
+        return 1;
+    }
+
+    // standing on the floor touches nothing, sinking one pixel touches two floor tiles
+    ME_AABB player = {40, 32 * 10 - 48, 48, 48};
+    ME_TileCoord touched[8];
+    if (ME_QueryAABB(&player, touched, 8) != 0) {
+        cout << "Player above the floor overlaps solid tiles" << endl;
+        return 1;
+    }
+    player.y += 1;
+    if (ME_QueryAABB(&player, touched, 8) != 2 || touched[0].row != 10) {
+        cout << "Player in the floor must overlap two tiles" << endl;
+        return 1;
+    }
+
+    ME_Ray ray = {32.0f * 2 + 16, 32.0f * 3 + 16, 1.0f, 0.0f, 10000.0f};
+    ME_RaycastHit hit = {};
+    if (!ME_Raycast(&ray, &hit) || hit.column != 20 || hit.block_id != 1 || hit.normal_x != -1 ||
+        hit.x != 32.0f * 20) {
+        cout << "Ray missed the wall" << endl;
+        return 1;
+    }
+    ray.max_distance = 100.0f;
+    if (ME_Raycast(&ray, &hit)) {
+        cout << "Ray went past its max distance" << endl;
+        return 1;
+    }
+
+    // a crowd of entities, one batched call per frame
+    const int count = 10000;
+    vector<ME_AABB> boxes(count);
+    vector<int> solid_counts(count);
+    for (int i = 0; i < count; ++i) {
+        boxes[i] = {(i * 37) % (columns * 32), (i * 53) % (rows * 32), 24, 40};
+    }
+    auto start = chrono::steady_clock::now();
+    int touching = ME_QueryAABBs(boxes.data(), count, solid_counts.data());
+    auto elapsed = chrono::duration_cast<chrono::microseconds>(chrono::steady_clock::now() - start).count();
+    cout << count << " box queries took " << elapsed << " us, " << touching << " touch the map" << endl;
+    if (ME_QueryAABBs(boxes.data(), count, nullptr) != -1 || ME_QueryAABBs(nullptr, -1, nullptr) != -1 ||
+        ME_Raycasts(nullptr, 1, nullptr) != -1 || ME_QueryPoints(nullptr, nullptr, 1, nullptr) != -1) {
+        cout << "Batched queries accepted missing arrays" << endl;
+        return 1;
+    }
+
+    // reloading the bricks without the flag takes them out of the index
+    ME_ClearBlock();
+    ME_LoadBlock(0, "./native/tests/Ice_Block_(placed).png");
+    ME_LoadBlock(1, "./native/tests/Cobalt_Brick_(placed).png");
+    ray.max_distance = 10000.0f;
+    if (ME_Raycast(&ray, &hit)) {
+        cout << "Ray hit a block that is no longer solid" << endl;
+        return 1;
+    }
+
+    for (int frame = 0; frame < 60; ++frame) {
+        ME_RenderFrame(window);
+        if (ME_ProcessEvents(window) == ME_QUIT_MESSAGE) {
+            break;
+        }
+    }
+
+    ME_DestroyWindow(window);
+
+    return 0;
+}
+
+#endif
@@ -0,0 +1,69 @@
+#ifdef me_startup_test
+#include "mainboard_engine.h"
+
+#include <event_message_type.h>
+#include <iostream>
+
+int execute() {
+    using namespace std;
+
+    ME_Initialize();
+    auto window = ME_CreateWindow(0, 100, 100, 800, 600, "Startup Test");
+    if (!window) {
+        cout << "Failed to create window." << endl;
+        return 1;
+    }
+
+    // the map is set up while its blocks decode, the first frame doesn't wait for them
+    if (!ME_LoadBlockAsync(0, "./native/tests/Ice_Block_(placed).png", nullptr) ||
+        !ME_LoadBlockAsync(1, "./native/tests/Cobalt_Brick_(placed).png", nullptr) ||
+        !ME_LoadBlockAsync(2, "./native/tests/missing.png", nullptr)) {
+        cout << "Failed to queue blocks" << endl;
+        return 1;
+    }
+    if (ME_LoadBlockAsync(0, "./native/tests/Ice_Block_(placed).png", nullptr) ||
+        ME_LoadBlock(1, "./native/tests/Cobalt_Brick_(placed).png")) {
+        cout << "Pending id loaded twice" << endl;
+        return 1;
+    }
+    ME_SetStaticLayer(16, 16, 50, 38);
+    for (int row = 20; row < 38; ++row) {
+        for (int column = 0; column < 50; ++column) {
+            if (!ME_SetStaticTile(column, row, (column + row) % 2)) {
+                cout << "Pending block can't be placed" << endl;
+                return 1;
+            }
+        }
+    }
+
+    ME_StartupStats stats = {};
+    for (int frame = 0; frame < 600; ++frame) {
+        if (ME_ProcessEvents(window) == ME_QUIT_MESSAGE) {
+            return 0;
+        }
+        ME_RenderBlock(0, 100, 100);
+        ME_RenderFrame(window);
+        ME_GetStartupStats(&stats);
+        if (stats.loaded_ms > 0.0) {
+            break;
+        }
+    }
+    cout << "window " << stats.window_ms << " ms, first frame " << stats.first_frame_ms << " ms, loaded "
+         << stats.loaded_ms << " ms" << endl;
+    if (stats.first_frame_ms < stats.window_ms || stats.loaded_ms < stats.first_frame_ms) {
+        cout << "Startup milestones out of order" << endl;
+        return 1;
+    }
+    if (stats.pending_blocks != 0 || stats.async_blocks != 2 || stats.failed_blocks != 1) {
+        cout << "Expected 2 blocks loaded and 1 failed" << endl;
+        return 1;
+    }
+    if (!ME_RenderBlock(1, 200, 100)) {
+        cout << "Loaded block not drawable" << endl;
+        return 1;
+    }
+    ME_DestroyWindow(window);
+    return 0;
+}
+
+#endif
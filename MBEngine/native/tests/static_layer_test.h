@@ -0,0 +1,125 @@
+#ifdef me_static_layer_test
+#include "mainboard_engine.h"
+#include "static_layer.h"
+
+#include <string>
+#include <event_message_type.h>
+#include <iostream>
+
+static bool static_layer_unit_test() {
+    using namespace std;
+    using namespace MainboardEngine;
+
+    MEStaticLayer layer;
+    layer.Resize(32, 32, 100, 100);
+    int dx = 0;
+    int dy = 0;
+    ME_Rect view = {0, 600, 0, 800};
+    if (layer.Scroll(view, dx, dy) || layer.GetDirtyRects().size() != 1) {
+        cout << "First frame must redraw the whole view" << endl;
+        return false;
+    }
+    layer.ClearDirty();
+
+    if (layer.Scroll(view, dx, dy) || !layer.GetDirtyRects().empty()) {
+        cout << "Still camera must not redraw anything" << endl;
+        return false;
+    }
+
+    // two neighbouring edits merge into one rect
+    layer.SetTile(1, 1, 3, false);
+    layer.SetTile(2, 1, 3, false);
+    auto &edits = layer.GetDirtyRects();
+    if (edits.size() != 1 || edits[0].left != 32 || edits[0].right != 96 || edits[0].top != 32) {
+        cout << "Tile edits were not merged" << endl;
+        return false;
+    }
+    layer.ClearDirty();
+
+    // scrolling right and down exposes one column strip and one row strip
+    ME_Rect moved = {5, 605, 10, 810};
+    if (!layer.Scroll(moved, dx, dy) || dx != 10 || dy != 5) {
+        cout << "Small scroll must reuse the cache" << endl;
+        return false;
+    }
+    auto &strips = layer.GetDirtyRects();
+    int dirty_pixels = 0;
+    for (auto &rect: strips) {
+        dirty_pixels += (rect.right - rect.left) * (rect.bottom - rect.top);
+    }
+    if (strips.size() != 2 || dirty_pixels != 10 * 600 + 5 * 800) {
+        cout << "Exposed strips cover " << dirty_pixels << " pixels" << endl;
+        return false;
+    }
+    layer.ClearDirty();
+
+    // jumping further than the screen redraws everything
+    ME_Rect jumped = {5, 605, 2000, 2800};
+    if (layer.Scroll(jumped, dx, dy) || layer.GetDirtyRects().size() != 1) {
+        cout << "Jump must redraw the whole view" << endl;
+        return false;
+    }
+    layer.ClearDirty();
+
+    // edits outside the view are dropped, they are redrawn when scrolled in
+    layer.SetTile(0, 0, 1, false);
+    if (!layer.GetDirtyRects().empty()) {
+        cout << "Edit outside the view was kept" << endl;
+        return false;
+    }
+
+    return true;
+}
+
+int execute() {
+    using namespace std;
+    if (!static_layer_unit_test()) {
+        return 1;
+    }
+
+    ME_Initialize();
+    auto window = ME_CreateWindow(0, 100, 100, 800, 600, "Static Layer Test");
+    if (!window) {
+        cout << "Failed to create window." << endl;
+        return 1;
+    }
+    if (!ME_LoadBlock(0, "./native/tests/Ice_Block_(placed).png") ||
+        !ME_LoadBlock(1, "./native/tests/Cobalt_Brick_(placed).png")) {
+        cout << "Image not loaded!" << endl;
+        return 1;
+    }
+
+    const int columns = 200;
+    const int rows = 200;
+    ME_SetStaticLayer(32, 32, columns, rows);
+    for (int row = 0; row < rows; ++row) {
+        for (int column = 0; column < columns; ++column) {
+            ME_SetStaticTile(column, row, (row + column) % 2);
+        }
+    }
+
+    ME_FrameStats stats = {};
+    for (int frame = 0; frame < 600; ++frame) {
+        // still for a while, then scroll diagonally
+        int offset = frame < 300 ? 0 : (frame - 300) * 2;
+        ME_SetCamera(offset, offset / 2);
+        ME_RenderFrame(window);
+        if (ME_ProcessEvents(window) == ME_QUIT_MESSAGE) {
+            break;
+        }
+        ME_GetFrameStats(&stats);
+
+        // a still camera only composites the cache
+        if (frame > 2 && frame < 300 && stats.submit_count != 1) {
+            cout << "Still frame " << frame << " submitted " << stats.submit_count << " draws" << endl;
+            return 1;
+        }
+    }
+    cout << "Scrolling frame submits: " << stats.submit_count << endl;
+
+    ME_DestroyWindow(window);
+
+    return 0;
+}
+
+#endif
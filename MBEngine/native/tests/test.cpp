@@ -3,9 +3,47 @@
 // #define me_wayland_window_test
 // #define me_window_test
 #define me_engine_render_test
+// #define me_frame_arena_test
+// #define me_static_layer_test
+// #define me_world_stream_test
+// #define me_spatial_query_test
+// #define me_call_record_test
+// #define me_alloc_test
+// #define me_tilemap_test
+// #define me_view_test
+// #define me_text_test
+// #define me_particle_test
+// #define me_light_test
+// #define me_run_loop_test
+// #define me_frame_test
+// #define me_startup_test
+// #define me_path_test
+// #define me_map_journal_test
+// #define me_soft_render_test
+// #define me_block_variant_test
+// #define me_occlusion_test
 #include <win32_window_test.h>
 #include <bgfx_test.h>
 #include <engine_render_test.h>
+#include <frame_arena_test.h>
+#include <static_layer_test.h>
+#include <world_stream_test.h>
+#include <spatial_query_test.h>
+#include <call_record_test.h>
+#include <alloc_test.h>
+#include <tilemap_test.h>
+#include <view_test.h>
+#include <text_test.h>
+#include <particle_test.h>
+#include <light_test.h>
+#include <run_loop_test.h>
+#include <frame_test.h>
+#include <startup_test.h>
+#include <path_test.h>
+#include <map_journal_test.h>
+#include <soft_render_test.h>
+#include <block_variant_test.h>
+#include <occlusion_test.h>
 
 #ifdef me_wayland_window_test
 #include <wayland_window_test.h>
@@ -0,0 +1,55 @@
+#ifdef me_text_test
+#include "mainboard_engine.h"
+
+#include <event_message_type.h>
+#include <iostream>
+#include <string>
+
+int execute() {
+    using namespace std;
+
+    ME_Initialize();
+    auto window = ME_CreateWindow(0, 100, 100, 800, 600, "Text Test");
+    if (!window) {
+        cout << "Failed to create window." << endl;
+        return 1;
+    }
+    const char *font_path = "C:/Windows/Fonts/consola.ttf";
+    if (!ME_LoadFont(0, font_path, 14.0f, ME_FONT_FLAG_NONE) ||
+        !ME_LoadFont(1, font_path, 32.0f, ME_FONT_FLAG_SDF)) {
+        cout << "Font not loaded!" << endl;
+        return 1;
+    }
+    if (ME_LoadFont(ME_MAX_FONTS, font_path, 14.0f, ME_FONT_FLAG_NONE) || ME_DrawText(2, 0, 0, "x", 0xFFFFFFFF)) {
+        cout << "Font id out of range accepted" << endl;
+        return 1;
+    }
+
+    ME_FrameStats stats = {};
+    for (int frame = 0; frame < 300; ++frame) {
+        // a HUD of 400 labels, one submit per font whatever the count
+        for (int i = 0; i < 400; ++i) {
+            string label = "Label " + to_string(i) + " \xC3\xA9\xE2\x82\xAC";
+            ME_DrawText(0, (i % 8) * 100, (i / 8) * 12, label.c_str(), 0xFFFFFFFF);
+        }
+        ME_DrawTextScaled(1, 200, 250, 2.0f + (frame % 60) / 30.0f, "Scaled\nSDF text", 0xFFCC00FF);
+        ME_RenderFrame(window);
+        if (ME_ProcessEvents(window) == ME_QUIT_MESSAGE) {
+            break;
+        }
+        ME_GetFrameStats(&stats);
+    }
+    if (stats.submit_count != 2) {
+        cout << "Text of 2 fonts submitted " << stats.submit_count << " draws" << endl;
+        return 1;
+    }
+
+    if (!ME_UnloadFont(1) || ME_UnloadFont(1) || ME_DrawText(1, 0, 0, "x", 0xFFFFFFFF)) {
+        cout << "Unloaded font still usable" << endl;
+        return 1;
+    }
+    ME_DestroyWindow(window);
+    return 0;
+}
+
+#endif
@@ -0,0 +1,75 @@
+#ifdef me_tilemap_test
+#include "mainboard_engine.h"
+
+#include <event_message_type.h>
+#include <iostream>
+
+int execute() {
+    using namespace std;
+
+    ME_Initialize();
+    auto window = ME_CreateWindow(0, 100, 100, 800, 600, "Tile Map Test");
+    if (!window) {
+        cout << "Failed to create window." << endl;
+        return 1;
+    }
+    if (!ME_LoadBlock(0, "./native/tests/Ice_Block_(placed).png") ||
+        !ME_LoadBlock(1, "./native/tests/Cobalt_Brick_(placed).png")) {
+        cout << "Image not loaded!" << endl;
+        return 1;
+    }
+
+    const int columns = 1000;
+    const int rows = 1000;
+    ME_SetStaticLayer(32, 32, columns, rows);
+    for (int row = 0; row < rows; ++row) {
+        for (int column = 0; column < columns; ++column) {
+            ME_SetStaticTile(column, row, (row + column) % 2);
+        }
+    }
+    if (!ME_SetStaticLayerMode(ME_STATIC_LAYER_AUTO)) {
+        cout << "Mode not accepted" << endl;
+        return 1;
+    }
+
+    ME_FrameStats stats = {};
+    for (int frame = 0; frame < 600; ++frame) {
+        // scrolling and editing every frame, the cache would redraw strips and tiles here
+        ME_SetCamera(frame * 3, frame);
+        ME_SetStaticTile(frame % columns, frame % rows, frame % 3 == 0 ? -1 : frame % 2);
+        ME_RenderFrame(window);
+        if (ME_ProcessEvents(window) == ME_QUIT_MESSAGE) {
+            break;
+        }
+        ME_GetFrameStats(&stats);
+
+        if (frame == 1 && stats.submit_count != 1) {
+            cout << "Tile map path not available (renderer caps or fs_tilemap.bin), skipped" << endl;
+            ME_DestroyWindow(window);
+            return 0;
+        }
+        if (frame > 1 && stats.submit_count != 1) {
+            cout << "Tile map frame " << frame << " submitted " << stats.submit_count << " draws" << endl;
+            return 1;
+        }
+    }
+
+    // back to the cache, scrolling redraws the exposed strips again
+    ME_SetStaticLayerMode(ME_STATIC_LAYER_CACHED);
+    for (int frame = 0; frame < 10; ++frame) {
+        ME_SetCamera(frame * 3, frame);
+        ME_RenderFrame(window);
+        ME_ProcessEvents(window);
+    }
+    ME_GetFrameStats(&stats);
+    if (stats.submit_count <= 1) {
+        cout << "Cached scrolling frame submitted " << stats.submit_count << " draws" << endl;
+        return 1;
+    }
+
+    ME_DestroyWindow(window);
+
+    return 0;
+}
+
+#endif
@@ -0,0 +1,91 @@
+#ifdef me_view_test
+#include "mainboard_engine.h"
+
+#include <event_message_type.h>
+#include <iostream>
+
+int execute() {
+    using namespace std;
+
+    ME_Initialize();
+    auto window = ME_CreateWindow(0, 100, 100, 800, 600, "View Test");
+    if (!window) {
+        cout << "Failed to create window." << endl;
+        return 1;
+    }
+    if (!ME_LoadBlock(0, "./native/tests/Ice_Block_(placed).png") ||
+        !ME_LoadBlock(1, "./native/tests/Cobalt_Brick_(placed).png")) {
+        cout << "Image not loaded!" << endl;
+        return 1;
+    }
+
+    const int columns = 100;
+    const int rows = 100;
+    ME_SetStaticLayer(32, 32, columns, rows);
+    for (int row = 0; row < rows; ++row) {
+        for (int column = 0; column < columns; ++column) {
+            ME_SetStaticTile(column, row, (row + column) % 2);
+        }
+    }
+
+    // whole map at 1/16 into block 10, drawn in the corner of the main view
+    ME_ViewDesc minimap = {0, 0, 200, 200, 0, 0, 200.0f / (columns * 32), ME_VIEW_LAYER_STATIC, 10};
+    int minimap_view = ME_CreateView(&minimap);
+    if (minimap_view < 0 || ME_LoadBlock(10, "./native/tests/Ice_Block_(placed).png")) {
+        cout << "Offscreen view must own its target block" << endl;
+        return 1;
+    }
+    ME_ViewDesc taken = minimap;
+    taken.target_block_id = 0;
+    if (ME_CreateView(&taken) >= 0) {
+        cout << "View created over a loaded block" << endl;
+        return 1;
+    }
+
+    // editor style preview of another part of the map in the bottom right
+    ME_ViewDesc preview = {500, 350, 300, 250, 1600, 1600, 2.0f, ME_VIEW_LAYER_ALL, -1};
+    int preview_view = ME_CreateView(&preview);
+    if (preview_view < 0) {
+        cout << "Failed to create preview view" << endl;
+        return 1;
+    }
+
+    ME_FrameStats stats = {};
+    for (int frame = 0; frame < 300; ++frame) {
+        // far off the main view and the preview, culled everywhere
+        for (int i = 0; i < 1000; ++i) {
+            ME_RenderBlock(0, -5000 - i * 32, 100);
+        }
+        ME_RenderBlock(10, 0, 0);
+        preview.camera_x = 1600 + frame;
+        ME_UpdateView(preview_view, &preview);
+        ME_RenderFrame(window);
+        if (ME_ProcessEvents(window) == ME_QUIT_MESSAGE) {
+            break;
+        }
+        ME_GetFrameStats(&stats);
+    }
+    if (stats.draw_count != 1001) {
+        cout << "Recorded " << stats.draw_count << " draws" << endl;
+        return 1;
+    }
+    // static layer and minimap in the main view, the static layer of the minimap and the preview,
+    // nothing of the 1000 culled blocks
+    if (stats.submit_count > 8) {
+        cout << "Culled frame submitted " << stats.submit_count << " draws" << endl;
+        return 1;
+    }
+
+    if (!ME_DestroyView(minimap_view) || ME_DestroyView(minimap_view) ||
+        !ME_LoadBlock(10, "./native/tests/Ice_Block_(placed).png")) {
+        cout << "Destroying the view must free its block" << endl;
+        return 1;
+    }
+    ME_DestroyView(preview_view);
+
+    ME_DestroyWindow(window);
+
+    return 0;
+}
+
+#endif
@@ -0,0 +1,73 @@
+#ifdef me_world_stream_test
+#include "mainboard_engine.h"
+
+#include <string>
+#include <vector>
+#include <event_message_type.h>
+#include <iostream>
+
+int execute() {
+    using namespace std;
+    ME_Initialize();
+    auto window = ME_CreateWindow(0, 100, 100, 800, 600, "World Stream Test");
+    if (!window) {
+        cout << "Failed to create window." << endl;
+        return 1;
+    }
+    if (!ME_LoadBlock(0, "./native/tests/Ice_Block_(placed).png") ||
+        !ME_LoadBlock(1, "./native/tests/Cobalt_Brick_(placed).png")) {
+        cout << "Image not loaded!" << endl;
+        return 1;
+    }
+
+    // 4096 * 4096 tiles, far more than the budget below can hold decoded
+    const int columns = 4096;
+    const int rows = 4096;
+    vector<short> tiles(static_cast<size_t>(columns) * rows);
+    for (int row = 0; row < rows; ++row) {
+        for (int column = 0; column < columns; ++column) {
+            tiles[static_cast<size_t>(row) * columns + column] = static_cast<short>((row / 8 + column / 16) % 2);
+        }
+    }
+    if (!ME_WriteWorld("./native/tests/stream_test.mbworld", 32, 32, columns, rows, tiles.data())) {
+        cout << "Failed to write world." << endl;
+        return 1;
+    }
+    tiles = vector<short>();
+
+    const int budget_kb = 2048;
+    if (!ME_OpenWorld("./native/tests/stream_test.mbworld", 1, budget_kb)) {
+        cout << "Failed to open world." << endl;
+        return 1;
+    }
+
+    ME_WorldStats stats = {};
+    for (int frame = 0; frame < 1200; ++frame) {
+        // fly diagonally across the world
+        ME_SetCamera(frame * 24, frame * 12);
+        ME_RenderFrame(window);
+        if (ME_ProcessEvents(window) == ME_QUIT_MESSAGE) {
+            break;
+        }
+
+        ME_GetWorldStats(&stats);
+        if (stats.resident_bytes > stats.budget_bytes) {
+            cout << "Frame " << frame << " keeps " << stats.resident_bytes << " bytes decoded" << endl;
+            return 1;
+        }
+    }
+
+    cout << "loaded: " << stats.loaded_total << ", evicted: " << stats.evicted_total
+            << ", resident: " << stats.resident_chunks << endl;
+    if (stats.loaded_total == 0 || stats.evicted_total == 0) {
+        cout << "Nothing was streamed" << endl;
+        return 1;
+    }
+
+    ME_CloseWorld();
+    ME_DestroyWindow(window);
+
+    return 0;
+}
+
+#endif
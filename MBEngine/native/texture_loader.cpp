@@ -0,0 +1,337 @@
+#include "include/texture_loader.h"
+#include "include/trace.h"
+
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define ME_HAS_SSE2
+#endif
+
+#include <bimg/encode.h>
+#include <bx/allocator.h>
+#include <bx/error.h>
+
+namespace MainboardEngine {
+    struct TextureCacheHeader {
+        char magic[4];
+        uint32_t version;
+        uint32_t format;
+        uint32_t width;
+        uint32_t height;
+        uint32_t num_mips;
+        uint32_t size;
+    };
+
+    static const char TEXTURE_CACHE_MAGIC[4] = {'M', 'B', 'T', 'X'};
+    constexpr uint32_t TEXTURE_CACHE_VERSION = 2;
+
+    struct CompressedFormat {
+        bgfx::TextureFormat::Enum format;
+        const char *name;
+        int block_bytes; // bytes per 4x4 block
+    };
+
+    static const CompressedFormat COMPRESSED_FORMATS[] = {
+        {bgfx::TextureFormat::BC1, "BC1", 8},
+        {bgfx::TextureFormat::BC3, "BC3", 16},
+        {bgfx::TextureFormat::BC7, "BC7", 16},
+        {bgfx::TextureFormat::ETC2, "ETC2", 8},
+        {bgfx::TextureFormat::ETC2A, "ETC2A", 16},
+        {bgfx::TextureFormat::ASTC4x4, "ASTC4x4", 16},
+    };
+
+    // in order of preference, desktop formats first
+    static const bgfx::TextureFormat::Enum OPAQUE_CANDIDATES[] = {
+        bgfx::TextureFormat::BC1, bgfx::TextureFormat::ETC2, bgfx::TextureFormat::ASTC4x4
+    };
+    static const bgfx::TextureFormat::Enum ALPHA_CANDIDATES[] = {
+        bgfx::TextureFormat::BC7, bgfx::TextureFormat::BC3, bgfx::TextureFormat::ETC2A, bgfx::TextureFormat::ASTC4x4
+    };
+
+    static const CompressedFormat *FindCompressedFormat(bgfx::TextureFormat::Enum format) {
+        for (const auto &compressed: COMPRESSED_FORMATS) {
+            if (compressed.format == format) {
+                return &compressed;
+            }
+        }
+        return nullptr;
+    }
+
+    static bool IsFormatSupported(bgfx::TextureFormat::Enum format) {
+        const bgfx::Caps *caps = bgfx::getCaps();
+        return caps && (caps->formats[format] & BGFX_CAPS_FORMAT_TEXTURE_2D) != 0;
+    }
+
+    bgfx::TextureFormat::Enum ChooseCompressedFormat(bool has_alpha) {
+        if (has_alpha) {
+            for (auto format: ALPHA_CANDIDATES) {
+                if (IsFormatSupported(format)) {
+                    return format;
+                }
+            }
+        } else {
+            for (auto format: OPAQUE_CANDIDATES) {
+                if (IsFormatSupported(format)) {
+                    return format;
+                }
+            }
+        }
+        return bgfx::TextureFormat::RGBA8;
+    }
+
+    bool CanCompress(int width, int frame_height) {
+        return width > 0 && frame_height > 0 && width % 4 == 0 && frame_height % 4 == 0;
+    }
+
+    int GetMipCount(int width, int height) {
+        int count = 1;
+        int size = std::max(width, height);
+        while (size > 1) {
+            size >>= 1;
+            ++count;
+        }
+        return count;
+    }
+
+    static void DownsampleScalar(const uint8_t *row0, const uint8_t *row1, uint8_t *dst, int from, int to) {
+        for (int x = from; x < to; ++x) {
+            const uint8_t *a = row0 + x * 8;
+            const uint8_t *b = row1 + x * 8;
+            for (int c = 0; c < 4; ++c) {
+                dst[x * 4 + c] = static_cast<uint8_t>((a[c] + a[c + 4] + b[c] + b[c + 4] + 2) >> 2);
+            }
+        }
+    }
+
+    // one output row from two input rows, `width` is the output width and the input is exactly twice as wide
+    static void DownsampleRow(const uint8_t *row0, const uint8_t *row1, uint8_t *dst, int width) {
+        int x = 0;
+#ifdef ME_HAS_SSE2
+        const __m128i zero = _mm_setzero_si128();
+        const __m128i round = _mm_set1_epi16(2);
+        // 8 input pixels per row -> 4 output pixels, channels widened to 16 bit
+        for (; x + 4 <= width; x += 4) {
+            __m128i a0 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(row0 + x * 8));
+            __m128i a1 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(row0 + x * 8 + 16));
+            __m128i b0 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(row1 + x * 8));
+            __m128i b1 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(row1 + x * 8 + 16));
+
+            // vertical sums, two pixels per register
+            __m128i s01 = _mm_add_epi16(_mm_unpacklo_epi8(a0, zero), _mm_unpacklo_epi8(b0, zero));
+            __m128i s23 = _mm_add_epi16(_mm_unpackhi_epi8(a0, zero), _mm_unpackhi_epi8(b0, zero));
+            __m128i s45 = _mm_add_epi16(_mm_unpacklo_epi8(a1, zero), _mm_unpacklo_epi8(b1, zero));
+            __m128i s67 = _mm_add_epi16(_mm_unpackhi_epi8(a1, zero), _mm_unpackhi_epi8(b1, zero));
+
+            // horizontal sums land in the low half of each register
+            __m128i h0 = _mm_add_epi16(s01, _mm_srli_si128(s01, 8));
+            __m128i h1 = _mm_add_epi16(s23, _mm_srli_si128(s23, 8));
+            __m128i h2 = _mm_add_epi16(s45, _mm_srli_si128(s45, 8));
+            __m128i h3 = _mm_add_epi16(s67, _mm_srli_si128(s67, 8));
+
+            __m128i lo = _mm_srli_epi16(_mm_add_epi16(_mm_unpacklo_epi64(h0, h1), round), 2);
+            __m128i hi = _mm_srli_epi16(_mm_add_epi16(_mm_unpacklo_epi64(h2, h3), round), 2);
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + x * 4), _mm_packus_epi16(lo, hi));
+        }
+#endif
+        DownsampleScalar(row0, row1, dst, x, width);
+    }
+
+    void BuildMipChain(const uint8_t *rgba, int width, int height, std::vector<uint8_t> &chain) {
+        ME_TRACE_SCOPE("BuildMipChain");
+        size_t total = 0;
+        for (int w = width, h = height;; w = std::max(1, w / 2), h = std::max(1, h / 2)) {
+            total += static_cast<size_t>(w) * h * 4;
+            if (w == 1 && h == 1) {
+                break;
+            }
+        }
+        chain.resize(total);
+        std::memcpy(chain.data(), rgba, static_cast<size_t>(width) * height * 4);
+
+        size_t src_offset = 0;
+        int src_w = width;
+        int src_h = height;
+        while (src_w > 1 || src_h > 1) {
+            int dst_w = std::max(1, src_w / 2);
+            int dst_h = std::max(1, src_h / 2);
+            size_t dst_offset = src_offset + static_cast<size_t>(src_w) * src_h * 4;
+            const uint8_t *src = chain.data() + src_offset;
+            uint8_t *dst = chain.data() + dst_offset;
+            size_t src_stride = static_cast<size_t>(src_w) * 4;
+
+            for (int y = 0; y < dst_h; ++y) {
+                const uint8_t *row0 = src + std::min(y * 2, src_h - 1) * src_stride;
+                const uint8_t *row1 = src + std::min(y * 2 + 1, src_h - 1) * src_stride;
+                uint8_t *out = dst + static_cast<size_t>(y) * dst_w * 4;
+                if (src_w > 1) {
+                    DownsampleRow(row0, row1, out, dst_w);
+                } else {
+                    // single column, only average vertically
+                    for (int c = 0; c < 4; ++c) {
+                        out[c] = static_cast<uint8_t>((row0[c] + row1[c] + 1) >> 1);
+                    }
+                }
+            }
+
+            src_offset = dst_offset;
+            src_w = dst_w;
+            src_h = dst_h;
+        }
+    }
+
+    static bool EncodeLevel(bx::AllocatorI *allocator, const uint8_t *rgba, int width, int height,
+                            const CompressedFormat *compressed, std::vector<uint8_t> &out) {
+        // levels below 4x4 still take a whole block, pad them by repeating the edge pixels
+        int padded_w = (width + 3) & ~3;
+        int padded_h = (height + 3) & ~3;
+        std::vector<uint8_t> padded;
+        if (padded_w != width || padded_h != height) {
+            padded.resize(static_cast<size_t>(padded_w) * padded_h * 4);
+            for (int y = 0; y < padded_h; ++y) {
+                for (int x = 0; x < padded_w; ++x) {
+                    const uint8_t *src = rgba + (std::min(y, height - 1) * width + std::min(x, width - 1)) * 4;
+                    std::memcpy(&padded[(static_cast<size_t>(y) * padded_w + x) * 4], src, 4);
+                }
+            }
+            rgba = padded.data();
+        }
+
+        size_t offset = out.size();
+        out.resize(offset + static_cast<size_t>(padded_w / 4) * (padded_h / 4) * compressed->block_bytes);
+
+        bx::Error err;
+        return bimg::imageEncodeFromRgba8(allocator, out.data() + offset, rgba, padded_w, padded_h, 1,
+                                          static_cast<bimg::TextureFormat::Enum>(compressed->format),
+                                          bimg::Quality::Highest, &err);
+    }
+
+    bool EncodeTexture(const uint8_t *rgba, int width, int height, bgfx::TextureFormat::Enum format, bool mips,
+                       METextureData &texture) {
+        ME_TRACE_SCOPE("EncodeTexture");
+        const CompressedFormat *compressed = FindCompressedFormat(format);
+        if (!compressed || width % 4 != 0 || height % 4 != 0) {
+            return false;
+        }
+
+        texture.format = format;
+        texture.width = width;
+        texture.height = height;
+        texture.num_mips = mips ? GetMipCount(width, height) : 1;
+        texture.data.clear();
+
+        bx::DefaultAllocator allocator;
+        if (!mips) {
+            return EncodeLevel(&allocator, rgba, width, height, compressed, texture.data);
+        }
+
+        std::vector<uint8_t> chain;
+        BuildMipChain(rgba, width, height, chain);
+        size_t offset = 0;
+        int w = width;
+        int h = height;
+        for (int level = 0; level < texture.num_mips; ++level) {
+            if (!EncodeLevel(&allocator, chain.data() + offset, w, h, compressed, texture.data)) {
+                return false;
+            }
+            offset += static_cast<size_t>(w) * h * 4;
+            w = std::max(1, w / 2);
+            h = std::max(1, h / 2);
+        }
+
+        return true;
+    }
+
+    std::string GetTextureCachePath(const std::string &path, bgfx::TextureFormat::Enum format, bool mips) {
+        return path + "." + GetTextureFormatName(format) + (mips ? ".mips" : "") + ".mbtx";
+    }
+
+    bool LoadTextureCache(const std::string &path, bgfx::TextureFormat::Enum format, bool mips,
+                          METextureData &texture) {
+        namespace fs = std::filesystem;
+
+        std::string cache_path = GetTextureCachePath(path, format, mips);
+        std::error_code ec;
+        auto cache_time = fs::last_write_time(cache_path, ec);
+        if (ec) {
+            return false;
+        }
+        auto source_time = fs::last_write_time(path, ec);
+        if (!ec && source_time > cache_time) {
+            return false;
+        }
+
+        std::ifstream file(cache_path, std::ios::binary);
+        if (!file.is_open()) {
+            return false;
+        }
+
+        TextureCacheHeader header = {};
+        file.read(reinterpret_cast<char *>(&header), sizeof(header));
+        if (!file || std::memcmp(header.magic, TEXTURE_CACHE_MAGIC, sizeof(header.magic)) != 0 ||
+            header.version != TEXTURE_CACHE_VERSION || header.format != static_cast<uint32_t>(format) ||
+            (header.num_mips > 1) != mips) {
+            return false;
+        }
+        // a cache written by another build or cut short is a miss, the texture is encoded again
+        if (header.width == 0 || header.height == 0 || header.width > UINT16_MAX || header.height > UINT16_MAX ||
+            header.num_mips != static_cast<uint32_t>(mips ? GetMipCount(header.width, header.height) : 1)) {
+            return false;
+        }
+        uint32_t expected = bimg::imageGetSize(nullptr, static_cast<uint16_t>(header.width),
+                                               static_cast<uint16_t>(header.height), 1, false, mips, 1,
+                                               static_cast<bimg::TextureFormat::Enum>(format));
+        if (header.size != expected) {
+            return false;
+        }
+
+        texture.format = format;
+        texture.width = static_cast<int>(header.width);
+        texture.height = static_cast<int>(header.height);
+        texture.num_mips = static_cast<int>(header.num_mips);
+        texture.data.resize(header.size);
+        file.read(reinterpret_cast<char *>(texture.data.data()), header.size);
+
+        return static_cast<bool>(file);
+    }
+
+    bool WriteTextureCache(const std::string &path, const METextureData &texture) {
+        std::ofstream file(GetTextureCachePath(path, texture.format, texture.num_mips > 1),
+                           std::ios::binary | std::ios::trunc);
+        if (!file.is_open()) {
+            return false;
+        }
+
+        TextureCacheHeader header = {};
+        std::memcpy(header.magic, TEXTURE_CACHE_MAGIC, sizeof(header.magic));
+        header.version = TEXTURE_CACHE_VERSION;
+        header.format = static_cast<uint32_t>(texture.format);
+        header.width = static_cast<uint32_t>(texture.width);
+        header.height = static_cast<uint32_t>(texture.height);
+        header.num_mips = static_cast<uint32_t>(texture.num_mips);
+        header.size = static_cast<uint32_t>(texture.data.size());
+
+        file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+        file.write(reinterpret_cast<const char *>(texture.data.data()), static_cast<std::streamsize>(header.size));
+
+        return static_cast<bool>(file);
+    }
+
+    const char *GetTextureFormatName(bgfx::TextureFormat::Enum format) {
+        const CompressedFormat *compressed = FindCompressedFormat(format);
+        return compressed ? compressed->name : "RGBA8";
+    }
+
+    bool ParseTextureFormat(const char *name, bgfx::TextureFormat::Enum &format) {
+        for (const auto &compressed: COMPRESSED_FORMATS) {
+            if (std::strcmp(compressed.name, name) == 0) {
+                format = compressed.format;
+                return true;
+            }
+        }
+        return false;
+    }
+}
@@ -0,0 +1,128 @@
+// Decode throughput of every image backend and of the pixel post-processing kernels:
+//   me_image_bench [image ...] [--loops N]
+// Each image is decoded as it is by stb_image and re-encoded to QOI for the QOI backend. MB/s are of
+// decoded RGBA8 output, so backends reading different file sizes compare fairly.
+#define STB_IMAGE_IMPLEMENTATION
+#include <stb_image.h>
+
+#include "image_decoder.h"
+
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+using namespace MainboardEngine;
+
+static double ToMegabytesPerSecond(size_t bytes, std::chrono::steady_clock::duration elapsed) {
+    double seconds = std::chrono::duration<double>(elapsed).count();
+    return seconds > 0.0 ? static_cast<double>(bytes) / (1024.0 * 1024.0) / seconds : 0.0;
+}
+
+static void Report(const char *name, size_t input, size_t bytes, std::chrono::steady_clock::duration elapsed) {
+    std::cout << "  " << std::left << std::setw(22) << name << std::right << std::setw(10) << input << " B in "
+              << std::setw(10) << std::fixed << std::setprecision(1) << ToMegabytesPerSecond(bytes, elapsed)
+              << " MB/s" << std::endl;
+}
+
+static bool BenchDecoder(const MEImageDecoder &decoder, const std::vector<uint8_t> &file, uint32_t flags,
+                         int loops) {
+    size_t bytes = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < loops; ++i) {
+        MEDecodedImage image = {};
+        if (!decoder.Decode(file.data(), file.size(), flags, image)) {
+            return false;
+        }
+        bytes += static_cast<size_t>(image.width) * image.height * 4;
+    }
+    Report(decoder.GetName(), file.size(), bytes, std::chrono::steady_clock::now() - start);
+    return true;
+}
+
+// false when the kernel's alpha answer differs from the decoder's, none of them changes the alpha
+static bool BenchKernel(const char *name, const MEDecodedImage &image, uint32_t flags, int loops) {
+    size_t count = static_cast<size_t>(image.width) * image.height;
+    std::vector<uint8_t> pixels(image.pixels.get(), image.pixels.get() + count * 4);
+    auto start = std::chrono::steady_clock::now();
+    bool has_alpha = image.has_alpha;
+    for (int i = 0; i < loops; ++i) {
+        has_alpha = ProcessPixels(pixels.data(), count, flags);
+    }
+    Report(name, count * 4, count * 4 * loops, std::chrono::steady_clock::now() - start);
+    return has_alpha == image.has_alpha;
+}
+
+int main(int argc, char **argv) {
+    using namespace std;
+    vector<string> paths;
+    int loops = 200;
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "--loops") == 0 && i + 1 < argc) {
+            loops = atoi(argv[++i]);
+        } else {
+            paths.emplace_back(argv[i]);
+        }
+    }
+    if (paths.empty()) {
+        paths = {"./native/tests/Ice_Block_(placed).png", "./native/tests/Cobalt_Brick_(placed).png"};
+    }
+    if (loops <= 0) {
+        cout << "usage: me_image_bench [image ...] [--loops N]" << endl;
+        return 1;
+    }
+
+    const MEImageDecoder *qoi = nullptr;
+    const MEImageDecoder *stb = nullptr;
+    for (auto decoder: GetImageDecoders()) {
+        if (strcmp(decoder->GetName(), "qoi") == 0) {
+            qoi = decoder;
+        } else if (strcmp(decoder->GetName(), "stb_image") == 0) {
+            stb = decoder;
+        }
+    }
+
+    int failed = 0;
+    for (auto &path: paths) {
+        ifstream in(path, ios::binary);
+        vector<uint8_t> file((istreambuf_iterator<char>(in)), istreambuf_iterator<char>());
+        MEDecodedImage image = {};
+        if (file.empty() || !DecodeImage(file.data(), file.size(), 0, image)) {
+            cout << path << ": can't decode" << endl;
+            ++failed;
+            continue;
+        }
+        cout << path << " " << image.width << "x" << image.height << ", "
+             << (image.has_alpha ? "alpha" : "opaque") << endl;
+
+        vector<uint8_t> encoded;
+        EncodeQoi(image.pixels.get(), image.width, image.height, encoded);
+        // the pixels don't match when the encoder or the decoder is wrong, there's no point timing it then
+        MEDecodedImage check = {};
+        size_t size = static_cast<size_t>(image.width) * image.height * 4;
+        if (!qoi->Decode(encoded.data(), encoded.size(), 0, check) ||
+            memcmp(check.pixels.get(), image.pixels.get(), size) != 0 || check.has_alpha != image.has_alpha) {
+            cout << "  qoi round trip mismatch" << endl;
+            ++failed;
+            continue;
+        }
+
+        if (!BenchDecoder(*stb, file, 0, loops) || !BenchDecoder(*qoi, encoded, 0, loops)) {
+            ++failed;
+        }
+        bool kernels_agree = BenchKernel("opacity", image, 0, loops);
+        kernels_agree &= BenchKernel("premultiply", image, PIXEL_PREMULTIPLY, loops);
+        kernels_agree &= BenchKernel("swizzle", image, PIXEL_SWIZZLE_BGRA, loops);
+        kernels_agree &= BenchKernel("premultiply+swizzle", image, PIXEL_PREMULTIPLY | PIXEL_SWIZZLE_BGRA, loops);
+        if (!kernels_agree) {
+            cout << "  kernel alpha mismatch" << endl;
+            ++failed;
+        }
+    }
+    return failed == 0 ? 0 : 1;
+}
@@ -0,0 +1,71 @@
+// Replays a recording made with ME_RecordStart, e.g. to benchmark a session reported from production:
+//   me_replay session.mbrec [--realtime] [--renderer noop|d3d11|d3d12|opengl|vulkan|metal] [--loops N]
+// Run it from the directory the session ran in, block and world paths are replayed as recorded.
+#include "mainboard_engine.h"
+
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+
+static int ParseRenderer(const char *name) {
+    static const struct {
+        const char *name;
+        int type;
+    } renderers[] = {
+        {"auto", ME_RENDERER_AUTO},
+        {"noop", ME_RENDERER_NOOP},
+        {"d3d11", ME_RENDERER_DIRECT3D11},
+        {"d3d12", ME_RENDERER_DIRECT3D12},
+        {"opengl", ME_RENDERER_OPENGL},
+        {"vulkan", ME_RENDERER_VULKAN},
+        {"metal", ME_RENDERER_METAL},
+    };
+    for (auto &renderer: renderers) {
+        if (std::strcmp(renderer.name, name) == 0) {
+            return renderer.type;
+        }
+    }
+    return -1;
+}
+
+int main(int argc, char **argv) {
+    using namespace std;
+    if (argc < 2) {
+        cout << "usage: me_replay <recording> [--realtime] [--renderer name] [--loops N]" << endl;
+        return 1;
+    }
+
+    const char *path = argv[1];
+    int flags = 0;
+    int loops = 1;
+    for (int i = 2; i < argc; ++i) {
+        if (strcmp(argv[i], "--realtime") == 0) {
+            flags |= ME_REPLAY_REALTIME;
+        } else if (strcmp(argv[i], "--renderer") == 0 && i + 1 < argc) {
+            int type = ParseRenderer(argv[++i]);
+            if (type < 0 || !ME_SetRendererType(type)) {
+                cout << "Unknown renderer " << argv[i] << endl;
+                return 1;
+            }
+        } else if (strcmp(argv[i], "--loops") == 0 && i + 1 < argc) {
+            loops = atoi(argv[++i]);
+        } else {
+            cout << "Unknown option " << argv[i] << endl;
+            return 1;
+        }
+    }
+
+    for (int loop = 0; loop < loops; ++loop) {
+        ME_ReplayStats stats = {};
+        if (!ME_Replay(path, flags, &stats)) {
+            cout << "Failed to replay " << path << endl;
+            return 1;
+        }
+        double frame_ms = stats.frame_count > 0 ? stats.elapsed_ms / stats.frame_count : 0.0;
+        cout << "replay " << loop << ": " << stats.call_count << " calls, " << stats.frame_count << " frames in "
+                << stats.elapsed_ms << " ms (recorded " << stats.recorded_ms << " ms), " << frame_ms
+                << " ms/frame, worst " << stats.max_frame_ms << " ms" << endl;
+    }
+
+    return 0;
+}
@@ -0,0 +1,146 @@
+#include "include/trace.h"
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace MainboardEngine {
+    std::atomic<bool> g_trace_enabled(false);
+    // bumped by every ME_TraceStart, rings of an older session have nothing to dump
+    static std::atomic<uint64_t> g_trace_session(1);
+
+    // events kept per thread, older ones are overwritten once the ring is full
+    constexpr uint64_t TRACE_BUFFER_SIZE = 1 << 16;
+
+    struct TraceEvent {
+        const char *name;
+        uint64_t start;
+        uint64_t end;
+    };
+
+    // Single producer ring, only the owning thread writes, other threads never reset it. sequence is
+    // odd while the owner is writing, the dump waits for it to be even after tracing stopped and
+    // reads the rest once that store is acquired
+    struct TraceBuffer {
+        std::atomic<uint64_t> sequence{0};
+        uint64_t head = 0;
+        uint64_t session = 0;
+        uint64_t begin = 0; // head when the owner first wrote in `session`
+        int thread_index = 0;
+        TraceEvent events[TRACE_BUFFER_SIZE];
+    };
+
+    static std::mutex g_trace_buffers_mutex;
+    static std::vector<std::unique_ptr<TraceBuffer> > g_trace_buffers;
+    static const auto g_trace_epoch = std::chrono::steady_clock::now();
+
+    static TraceBuffer *GetThreadBuffer() {
+        // buffers outlive their threads so events of finished workers still get dumped
+        thread_local TraceBuffer *buffer = nullptr;
+        if (!buffer) {
+            auto created = std::make_unique<TraceBuffer>();
+            std::lock_guard<std::mutex> lock(g_trace_buffers_mutex);
+            created->thread_index = static_cast<int>(g_trace_buffers.size());
+            buffer = created.get();
+            g_trace_buffers.push_back(std::move(created));
+        }
+        return buffer;
+    }
+
+    uint64_t GetTraceTimestamp() {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - g_trace_epoch).count());
+    }
+
+    void RecordTraceEvent(const char *name, uint64_t start, uint64_t end) {
+        TraceBuffer *buffer = GetThreadBuffer();
+        uint64_t sequence = buffer->sequence.load(std::memory_order_relaxed);
+        // the scope may have started before ME_TraceStop. Marking the ring busy before looking at the
+        // flag again, both sequentially consistent, means the stop either sees the mark and waits for
+        // it or this sees the flag cleared and drops the event
+        buffer->sequence.store(sequence + 1, std::memory_order_seq_cst);
+        if (g_trace_enabled.load(std::memory_order_seq_cst)) {
+            uint64_t session = g_trace_session.load(std::memory_order_relaxed);
+            if (buffer->session != session) {
+                buffer->session = session;
+                buffer->begin = buffer->head;
+            }
+            buffer->events[buffer->head % TRACE_BUFFER_SIZE] = {name, start, end};
+            ++buffer->head;
+        }
+        buffer->sequence.store(sequence + 2, std::memory_order_release);
+    }
+
+    void ResetTrace() {
+        // each owner starts its ring over when it first writes in the new session
+        g_trace_session.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    void StopTrace() {
+        g_trace_enabled.store(false, std::memory_order_seq_cst);
+        std::lock_guard<std::mutex> lock(g_trace_buffers_mutex);
+        for (auto &buffer: g_trace_buffers) {
+            // an event that saw tracing on is finished within a few stores
+            while (buffer->sequence.load(std::memory_order_seq_cst) & 1) {
+                std::this_thread::yield();
+            }
+        }
+    }
+
+    static void WriteJsonString(std::ofstream &file, const char *text) {
+        file << '"';
+        for (const char *c = text; *c; ++c) {
+            if (*c == '"' || *c == '\\') {
+                file << '\\';
+            }
+            file << *c;
+        }
+        file << '"';
+    }
+
+    bool WriteTrace(const char *path) {
+        std::ofstream file(path, std::ios::trunc);
+        if (!file.is_open()) {
+            return false;
+        }
+
+        std::lock_guard<std::mutex> lock(g_trace_buffers_mutex);
+        file << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+        bool first = true;
+        uint64_t session = g_trace_session.load(std::memory_order_relaxed);
+        for (auto &buffer: g_trace_buffers) {
+            // StopTrace saw every ring idle, owners don't write again until tracing restarts
+            buffer->sequence.load(std::memory_order_acquire);
+            if (buffer->session != session) {
+                continue;
+            }
+            uint64_t head = buffer->head;
+            uint64_t begin = std::max(buffer->begin, head > TRACE_BUFFER_SIZE ? head - TRACE_BUFFER_SIZE : 0);
+            if (begin == head) {
+                continue;
+            }
+
+            file << (first ? "" : ",") << "\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":"
+                    << buffer->thread_index << ",\"args\":{\"name\":\"ME thread " << buffer->thread_index << "\"}}";
+            first = false;
+
+            for (uint64_t i = begin; i < head; ++i) {
+                const TraceEvent &event = buffer->events[i % TRACE_BUFFER_SIZE];
+                // timestamps are in microseconds, keep the nanoseconds as decimals
+                file << ",\n{\"name\":";
+                WriteJsonString(file, event.name);
+                file << ",\"cat\":\"engine\",\"ph\":\"X\",\"pid\":1,\"tid\":" << buffer->thread_index
+                        << ",\"ts\":" << event.start / 1000 << '.' << event.start % 1000 / 100
+                        << ",\"dur\":" << (event.end - event.start) / 1000 << '.'
+                        << (event.end - event.start) % 1000 / 100 << '}';
+            }
+        }
+        file << "\n]}\n";
+
+        return static_cast<bool>(file);
+    }
+}
@@ -0,0 +1,483 @@
+#include "include/world_stream.h"
+#include "include/trace.h"
+#include "include/alloc_tracker.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace MainboardEngine {
+    static const char WORLD_MAGIC[4] = {'M', 'B', 'W', 'D'};
+    constexpr uint32_t WORLD_VERSION = 1;
+    // how far ahead of the camera motion chunks are requested
+    constexpr float WORLD_PREFETCH_SECONDS = 0.5f;
+
+    static int FloorDiv(int value, int divisor) {
+        return value >= 0 ? value / divisor : -((-value + divisor - 1) / divisor);
+    }
+
+    MEWorldWriter::MEWorldWriter() : m_header(), m_chunks_x(0) {
+    }
+
+    bool MEWorldWriter::Open(const char *path, int tile_width, int tile_height, int columns, int rows,
+                             int chunk_size) {
+        if (tile_width <= 0 || tile_height <= 0 || columns <= 0 || rows <= 0 || chunk_size <= 0 ||
+            chunk_size > 256) {
+            return false;
+        }
+        std::memcpy(m_header.magic, WORLD_MAGIC, sizeof(WORLD_MAGIC));
+        m_header.version = WORLD_VERSION;
+        m_header.tile_width = static_cast<uint32_t>(tile_width);
+        m_header.tile_height = static_cast<uint32_t>(tile_height);
+        m_header.columns = static_cast<uint32_t>(columns);
+        m_header.rows = static_cast<uint32_t>(rows);
+        m_header.chunk_size = static_cast<uint32_t>(chunk_size);
+        m_header.reserved = 0;
+
+        m_chunks_x = (m_header.columns + chunk_size - 1) / chunk_size;
+        uint32_t chunks_y = (m_header.rows + chunk_size - 1) / chunk_size;
+        m_entries.assign(static_cast<size_t>(m_chunks_x) * chunks_y, MEWorldChunkEntry{0, 0, WORLD_CHUNK_RAW});
+
+        m_file.open(path, std::ios::binary | std::ios::trunc);
+        if (!m_file.is_open()) {
+            return false;
+        }
+        // the table is rewritten by Close once every offset is known
+        m_file.write(reinterpret_cast<const char *>(&m_header), sizeof(m_header));
+        m_file.write(reinterpret_cast<const char *>(m_entries.data()),
+                     static_cast<std::streamsize>(m_entries.size() * sizeof(MEWorldChunkEntry)));
+
+        return m_file.good();
+    }
+
+    bool MEWorldWriter::WriteChunk(int chunk_x, int chunk_y, const int16_t *tiles) {
+        size_t index = static_cast<size_t>(chunk_y) * m_chunks_x + chunk_x;
+        if (!m_file.is_open() || chunk_x < 0 || chunk_y < 0 || static_cast<uint32_t>(chunk_x) >= m_chunks_x ||
+            index >= m_entries.size()) {
+            return false;
+        }
+
+        // terrain is mostly long runs of the same block
+        size_t count = static_cast<size_t>(m_header.chunk_size) * m_header.chunk_size;
+        m_encoded.clear();
+        size_t start = 0;
+        while (start < count) {
+            size_t end = start + 1;
+            while (end < count && end - start < UINT16_MAX && tiles[end] == tiles[start]) {
+                ++end;
+            }
+            uint16_t run = static_cast<uint16_t>(end - start);
+            const auto *run_bytes = reinterpret_cast<const uint8_t *>(&run);
+            const auto *id_bytes = reinterpret_cast<const uint8_t *>(&tiles[start]);
+            m_encoded.insert(m_encoded.end(), run_bytes, run_bytes + sizeof(run));
+            m_encoded.insert(m_encoded.end(), id_bytes, id_bytes + sizeof(int16_t));
+            start = end;
+        }
+
+        MEWorldChunkEntry &entry = m_entries[index];
+        entry.offset = static_cast<uint64_t>(m_file.tellp());
+        if (m_encoded.size() < count * sizeof(int16_t)) {
+            entry.encoding = WORLD_CHUNK_RLE;
+            entry.size = static_cast<uint32_t>(m_encoded.size());
+            m_file.write(reinterpret_cast<const char *>(m_encoded.data()), static_cast<std::streamsize>(entry.size));
+        } else {
+            entry.encoding = WORLD_CHUNK_RAW;
+            entry.size = static_cast<uint32_t>(count * sizeof(int16_t));
+            m_file.write(reinterpret_cast<const char *>(tiles), static_cast<std::streamsize>(entry.size));
+        }
+
+        return m_file.good();
+    }
+
+    bool MEWorldWriter::Close() {
+        if (!m_file.is_open()) {
+            return false;
+        }
+        m_file.seekp(sizeof(MEWorldHeader));
+        m_file.write(reinterpret_cast<const char *>(m_entries.data()),
+                     static_cast<std::streamsize>(m_entries.size() * sizeof(MEWorldChunkEntry)));
+        bool state = m_file.good();
+        m_file.close();
+
+        return state;
+    }
+
+    bool MEWorldWriter::WriteWorld(const char *path, int tile_width, int tile_height, int columns, int rows,
+                                   const int16_t *tiles) {
+        MEWorldWriter writer;
+        if (!writer.Open(path, tile_width, tile_height, columns, rows)) {
+            return false;
+        }
+
+        const int chunk_size = static_cast<int>(WORLD_CHUNK_SIZE);
+        std::vector<int16_t> chunk(static_cast<size_t>(chunk_size) * chunk_size);
+        for (int chunk_y = 0; chunk_y * chunk_size < rows; ++chunk_y) {
+            for (int chunk_x = 0; chunk_x * chunk_size < columns; ++chunk_x) {
+                for (int y = 0; y < chunk_size; ++y) {
+                    for (int x = 0; x < chunk_size; ++x) {
+                        int column = chunk_x * chunk_size + x;
+                        int row = chunk_y * chunk_size + y;
+                        chunk[y * chunk_size + x] = column < columns && row < rows
+                                                        ? tiles[static_cast<size_t>(row) * columns + column]
+                                                        : -1;
+                    }
+                }
+                if (!writer.WriteChunk(chunk_x, chunk_y, chunk.data())) {
+                    return false;
+                }
+            }
+        }
+
+        return writer.Close();
+    }
+
+    static bool ReadHeader(const MEMappedFile &file, MEWorldHeader &header) {
+        if (file.GetSize() < sizeof(MEWorldHeader)) {
+            return false;
+        }
+        std::memcpy(&header, file.GetData(), sizeof(MEWorldHeader));
+        if (std::memcmp(header.magic, WORLD_MAGIC, sizeof(WORLD_MAGIC)) != 0 || header.version != WORLD_VERSION ||
+            header.chunk_size == 0 || header.columns == 0 || header.rows == 0 || header.tile_width == 0 ||
+            header.tile_height == 0) {
+            return false;
+        }
+        size_t chunks_x = (header.columns + header.chunk_size - 1) / header.chunk_size;
+        size_t chunks_y = (header.rows + header.chunk_size - 1) / header.chunk_size;
+        return file.GetSize() >= sizeof(MEWorldHeader) + chunks_x * chunks_y * sizeof(MEWorldChunkEntry);
+    }
+
+    void DecodeWorldChunk(const uint8_t *file, size_t file_size, const MEWorldChunkEntry &entry, int16_t *tiles,
+                          size_t count) {
+        // a truncated or damaged chunk reads as empty instead of taking the engine down
+        if (entry.size == 0 || entry.offset > file_size || entry.size > file_size - entry.offset) {
+            std::fill(tiles, tiles + count, static_cast<int16_t>(-1));
+            return;
+        }
+
+        const uint8_t *data = file + entry.offset;
+        if (entry.encoding == WORLD_CHUNK_RAW) {
+            size_t size = std::min(static_cast<size_t>(entry.size), count * sizeof(int16_t));
+            std::memcpy(tiles, data, size);
+            std::fill(tiles + size / sizeof(int16_t), tiles + count, static_cast<int16_t>(-1));
+            return;
+        }
+
+        size_t written = 0;
+        for (uint32_t offset = 0; offset + 4 <= entry.size && written < count; offset += 4) {
+            uint16_t run;
+            int16_t id;
+            std::memcpy(&run, data + offset, sizeof(run));
+            std::memcpy(&id, data + offset + 2, sizeof(id));
+            size_t end = std::min(count, written + run);
+            std::fill(tiles + written, tiles + end, id);
+            written = end;
+        }
+        std::fill(tiles + written, tiles + count, static_cast<int16_t>(-1));
+    }
+
+    bool ReadWorld(const char *path, MEWorldHeader &header, std::vector<int16_t> &tiles) {
+        MEMappedFile file;
+        if (!file.Open(path) || !ReadHeader(file, header)) {
+            return false;
+        }
+        const auto *entries = reinterpret_cast<const MEWorldChunkEntry *>(file.GetData() + sizeof(MEWorldHeader));
+        int chunk_size = static_cast<int>(header.chunk_size);
+        int columns = static_cast<int>(header.columns);
+        int rows = static_cast<int>(header.rows);
+        int chunks_x = (columns + chunk_size - 1) / chunk_size;
+        std::vector<int16_t> chunk(static_cast<size_t>(chunk_size) * chunk_size);
+        tiles.resize(static_cast<size_t>(columns) * rows);
+        for (int chunk_y = 0; chunk_y * chunk_size < rows; ++chunk_y) {
+            for (int chunk_x = 0; chunk_x < chunks_x; ++chunk_x) {
+                DecodeWorldChunk(file.GetData(), file.GetSize(), entries[chunk_y * chunks_x + chunk_x], chunk.data(),
+                                 chunk.size());
+                int width = std::min(chunk_size, columns - chunk_x * chunk_size);
+                int height = std::min(chunk_size, rows - chunk_y * chunk_size);
+                for (int y = 0; y < height; ++y) {
+                    std::memcpy(&tiles[static_cast<size_t>(chunk_y * chunk_size + y) * columns + chunk_x * chunk_size],
+                                &chunk[static_cast<size_t>(y) * chunk_size], width * sizeof(int16_t));
+                }
+            }
+        }
+        return true;
+    }
+
+    MEWorldStream::MEWorldStream() : m_header(), m_entries(nullptr), m_chunks_x(0), m_chunks_y(0),
+                                     m_chunk_bytes(0), m_budget(0), m_last_view{0, 0, 0, 0},
+                                     m_has_last_view(false), m_velocity_x(0.0f), m_velocity_y(0.0f),
+                                     m_loaded_total(0), m_evicted_total(0), m_requested_count(0),
+                                     m_finished_count(0), m_stop(false) {
+    }
+
+    MEWorldStream::~MEWorldStream() {
+        Close();
+    }
+
+    bool MEWorldStream::Open(const char *path, size_t budget_bytes) {
+        Close();
+        if (!m_file.Open(path) || !ReadHeader(m_file, m_header)) {
+            m_file.Close();
+            return false;
+        }
+        m_chunks_x = static_cast<int>((m_header.columns + m_header.chunk_size - 1) / m_header.chunk_size);
+        m_chunks_y = static_cast<int>((m_header.rows + m_header.chunk_size - 1) / m_header.chunk_size);
+        size_t chunk_count = static_cast<size_t>(m_chunks_x) * m_chunks_y;
+        m_entries = reinterpret_cast<const MEWorldChunkEntry *>(m_file.GetData() + sizeof(MEWorldHeader));
+
+        m_chunk_bytes = static_cast<size_t>(m_header.chunk_size) * m_header.chunk_size * sizeof(int16_t);
+        m_budget = budget_bytes;
+        m_chunks.clear();
+        m_chunks.resize(chunk_count);
+        m_states.assign(chunk_count, CHUNK_ABSENT);
+        m_wanted_mask.assign(chunk_count, 0);
+        m_has_last_view = false;
+        m_velocity_x = 0.0f;
+        m_velocity_y = 0.0f;
+        m_stop = false;
+        m_worker = std::thread(&MEWorldStream::WorkerLoop, this);
+
+        return true;
+    }
+
+    void MEWorldStream::Close() {
+        if (m_worker.joinable()) {
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_stop = true;
+            }
+            m_wake.notify_one();
+            m_worker.join();
+        }
+        m_queue.clear();
+        m_finished.clear();
+        m_finished_count.store(0, std::memory_order_relaxed);
+        m_chunks.clear();
+        m_states.clear();
+        m_resident.clear();
+        m_wanted.clear();
+        m_posted.clear();
+        m_wanted_mask.clear();
+        m_arrived.clear();
+        m_evicted.clear();
+        m_requested_count = 0;
+        m_loaded_total = 0;
+        m_evicted_total = 0;
+        m_entries = nullptr;
+        m_file.Close();
+    }
+
+    void MEWorldStream::WorkerLoop() {
+        ME_ALLOC_SCOPE(ME_ALLOC_WORLD_STREAM);
+        while (true) {
+            DecodedChunk chunk;
+            {
+                std::unique_lock<std::mutex> lock(m_mutex);
+                m_wake.wait(lock, [this] { return m_stop || !m_queue.empty(); });
+                if (m_stop) {
+                    return;
+                }
+                chunk.index = m_queue.front();
+                m_queue.pop_front();
+            }
+
+            chunk.tiles.reset(new int16_t[m_chunk_bytes / sizeof(int16_t)]);
+            {
+                ME_TRACE_SCOPE("DecodeChunk");
+                DecodeChunk(chunk.index, chunk.tiles.get());
+            }
+
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_finished.push_back(std::move(chunk));
+            m_finished_count.fetch_add(1, std::memory_order_release);
+        }
+    }
+
+    void MEWorldStream::DecodeChunk(int index, int16_t *tiles) const {
+        DecodeWorldChunk(m_file.GetData(), m_file.GetSize(), m_entries[index], tiles,
+                         m_chunk_bytes / sizeof(int16_t));
+    }
+
+    ME_Rect MEWorldStream::GetChunkRect(int index) const {
+        int chunk_width = static_cast<int>(m_header.chunk_size * m_header.tile_width);
+        int chunk_height = static_cast<int>(m_header.chunk_size * m_header.tile_height);
+        ME_Rect rect;
+        rect.left = (index % m_chunks_x) * chunk_width;
+        rect.top = (index / m_chunks_x) * chunk_height;
+        rect.right = rect.left + chunk_width;
+        rect.bottom = rect.top + chunk_height;
+        return rect;
+    }
+
+    void MEWorldStream::AddWanted(int chunk_x0, int chunk_y0, int chunk_x1, int chunk_y1, float center_x,
+                                  float center_y, size_t first) {
+        chunk_x0 = std::max(chunk_x0, 0);
+        chunk_y0 = std::max(chunk_y0, 0);
+        chunk_x1 = std::min(chunk_x1, m_chunks_x - 1);
+        chunk_y1 = std::min(chunk_y1, m_chunks_y - 1);
+        for (int chunk_y = chunk_y0; chunk_y <= chunk_y1; ++chunk_y) {
+            for (int chunk_x = chunk_x0; chunk_x <= chunk_x1; ++chunk_x) {
+                int index = chunk_y * m_chunks_x + chunk_x;
+                if (!m_wanted_mask[index]) {
+                    m_wanted_mask[index] = 1;
+                    m_wanted.push_back(index);
+                }
+            }
+        }
+
+        // nearest first, the worker takes the queue in order
+        float chunk_width = static_cast<float>(m_header.chunk_size * m_header.tile_width);
+        float chunk_height = static_cast<float>(m_header.chunk_size * m_header.tile_height);
+        auto distance = [&](int index) {
+            float x = (static_cast<float>(index % m_chunks_x) + 0.5f) * chunk_width - center_x;
+            float y = (static_cast<float>(index / m_chunks_x) + 0.5f) * chunk_height - center_y;
+            return x * x + y * y;
+        };
+        std::sort(m_wanted.begin() + static_cast<std::ptrdiff_t>(first), m_wanted.end(),
+                  [&](int a, int b) { return distance(a) < distance(b); });
+    }
+
+    void MEWorldStream::Evict(float center_x, float center_y) {
+        float chunk_width = static_cast<float>(m_header.chunk_size * m_header.tile_width);
+        float chunk_height = static_cast<float>(m_header.chunk_size * m_header.tile_height);
+        while (m_resident.size() * m_chunk_bytes > m_budget) {
+            // furthest chunk that is neither visible nor about to be
+            size_t victim = m_resident.size();
+            float victim_distance = -1.0f;
+            for (size_t i = 0; i < m_resident.size(); ++i) {
+                int index = m_resident[i];
+                if (m_wanted_mask[index]) {
+                    continue;
+                }
+                float x = (static_cast<float>(index % m_chunks_x) + 0.5f) * chunk_width - center_x;
+                float y = (static_cast<float>(index / m_chunks_x) + 0.5f) * chunk_height - center_y;
+                float distance = x * x + y * y;
+                if (distance > victim_distance) {
+                    victim = i;
+                    victim_distance = distance;
+                }
+            }
+            if (victim == m_resident.size()) {
+                return; // everything left is needed, the budget is too small for the view
+            }
+
+            int index = m_resident[victim];
+            m_chunks[index].reset();
+            m_states[index] = CHUNK_ABSENT;
+            m_resident[victim] = m_resident.back();
+            m_resident.pop_back();
+            m_evicted.push_back(index);
+            ++m_evicted_total;
+        }
+    }
+
+    void MEWorldStream::Update(const ME_Rect &view) {
+        if (!m_entries) {
+            return;
+        }
+        m_arrived.clear();
+        m_evicted.clear();
+
+        // the lock is only taken when the worker finished something
+        if (m_finished_count.load(std::memory_order_acquire) > 0) {
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_received.swap(m_finished);
+                m_finished_count.store(0, std::memory_order_relaxed);
+            }
+            for (auto &chunk: m_received) {
+                if (m_states[chunk.index] != CHUNK_REQUESTED) {
+                    continue;
+                }
+                m_chunks[chunk.index] = std::move(chunk.tiles);
+                m_states[chunk.index] = CHUNK_RESIDENT;
+                --m_requested_count;
+                m_resident.push_back(chunk.index);
+                m_arrived.push_back(chunk.index);
+                ++m_loaded_total;
+            }
+            m_received.clear();
+        }
+
+        // camera velocity, smoothed so a single jittery frame does not redirect the prefetch
+        auto now = std::chrono::steady_clock::now();
+        if (m_has_last_view) {
+            float seconds = std::chrono::duration<float>(now - m_last_update).count();
+            if (seconds > 0.0f) {
+                float velocity_x = static_cast<float>(view.left - m_last_view.left) / seconds;
+                float velocity_y = static_cast<float>(view.top - m_last_view.top) / seconds;
+                m_velocity_x = m_velocity_x * 0.8f + velocity_x * 0.2f;
+                m_velocity_y = m_velocity_y * 0.8f + velocity_y * 0.2f;
+            }
+        }
+        m_last_view = view;
+        m_last_update = now;
+        m_has_last_view = true;
+
+        for (int index: m_wanted) {
+            m_wanted_mask[index] = 0;
+        }
+        m_wanted.clear();
+
+        int chunk_width = static_cast<int>(m_header.chunk_size * m_header.tile_width);
+        int chunk_height = static_cast<int>(m_header.chunk_size * m_header.tile_height);
+        float center_x = static_cast<float>(view.left + view.right) * 0.5f;
+        float center_y = static_cast<float>(view.top + view.bottom) * 0.5f;
+
+        // what is on screen, then a ring of one chunk, then where the camera is heading
+        int visible_x0 = FloorDiv(view.left, chunk_width);
+        int visible_y0 = FloorDiv(view.top, chunk_height);
+        int visible_x1 = FloorDiv(view.right - 1, chunk_width);
+        int visible_y1 = FloorDiv(view.bottom - 1, chunk_height);
+        AddWanted(visible_x0, visible_y0, visible_x1, visible_y1, center_x, center_y, 0);
+
+        size_t visible_count = m_wanted.size();
+        int ahead_x = static_cast<int>(m_velocity_x * WORLD_PREFETCH_SECONDS);
+        int ahead_y = static_cast<int>(m_velocity_y * WORLD_PREFETCH_SECONDS);
+        AddWanted(std::min(visible_x0 - 1, FloorDiv(view.left + ahead_x, chunk_width)),
+                  std::min(visible_y0 - 1, FloorDiv(view.top + ahead_y, chunk_height)),
+                  std::max(visible_x1 + 1, FloorDiv(view.right - 1 + ahead_x, chunk_width)),
+                  std::max(visible_y1 + 1, FloorDiv(view.bottom - 1 + ahead_y, chunk_height)),
+                  center_x + static_cast<float>(ahead_x), center_y + static_cast<float>(ahead_y), visible_count);
+
+        // prefetching past the budget would only evict chunks that are needed again soon
+        size_t affordable = std::max(visible_count, m_budget / m_chunk_bytes);
+        while (m_wanted.size() > affordable) {
+            m_wanted_mask[m_wanted.back()] = 0;
+            m_wanted.pop_back();
+        }
+
+        if (m_wanted != m_posted) {
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                // requests the worker has not picked up yet are replaced, the one it is decoding stays
+                for (int index: m_queue) {
+                    if (m_states[index] == CHUNK_REQUESTED) {
+                        m_states[index] = CHUNK_ABSENT;
+                        --m_requested_count;
+                    }
+                }
+                m_queue.clear();
+                for (int index: m_wanted) {
+                    if (m_states[index] == CHUNK_ABSENT) {
+                        m_states[index] = CHUNK_REQUESTED;
+                        ++m_requested_count;
+                        m_queue.push_back(index);
+                    }
+                }
+            }
+            m_wake.notify_one();
+            m_posted = m_wanted;
+        }
+
+        Evict(center_x, center_y);
+    }
+
+    void MEWorldStream::GetStats(ME_WorldStats *stats) {
+        stats->resident_chunks = static_cast<int>(m_resident.size());
+        stats->requested_chunks = m_requested_count;
+        stats->resident_bytes = static_cast<int>(m_resident.size() * m_chunk_bytes);
+        stats->budget_bytes = static_cast<int>(m_budget);
+        stats->loaded_total = m_loaded_total;
+        stats->evicted_total = m_evicted_total;
+    }
+}
@@ -0,0 +1,26 @@
+$input v_texcoord0
+
+#include <bgfx_shader.sh>
+
+SAMPLER2D(s_tex, 0); // one texel per tile, light level
+uniform vec4 u_resolution; // x = width, y = height of the screen
+uniform vec4 u_tilemap; // xy = camera in layer pixels, z = render scale, w = 1 to flip vertically
+uniform vec4 u_tilemap_grid; // xy = tile size, zw = columns, rows
+uniform vec4 u_light; // x = ambient light
+
+void main()
+{
+    // Same layer pixel as fs_tilemap, the output multiplies what is already in the target
+    vec2 texcoord = vec2(v_texcoord0.x, mix(v_texcoord0.y, 1.0 - v_texcoord0.y, u_tilemap.w));
+    vec2 position = u_tilemap.xy + texcoord * u_resolution.xy / u_tilemap.z;
+    vec2 tile = position / u_tilemap_grid.xy;
+    if (tile.x < 0.0 || tile.y < 0.0 || tile.x >= u_tilemap_grid.z || tile.y >= u_tilemap_grid.w)
+    {
+        gl_FragColor = vec4(1.0, 1.0, 1.0, 1.0);
+        return;
+    }
+
+    // Filtered between tile centers so light fades smoothly instead of in steps
+    float light = max(texture2DLod(s_tex, tile / u_tilemap_grid.zw, 0.0).x, u_light.x);
+    gl_FragColor = vec4(light, light, light, 1.0);
+}
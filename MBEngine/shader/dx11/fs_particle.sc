@@ -0,0 +1,10 @@
+$input v_texcoord0, v_color0
+
+#include <bgfx_shader.sh>
+
+SAMPLER2D(s_tex, 0); // block texture, or 1x1 white for plain squares
+
+void main()
+{
+    gl_FragColor = texture2D(s_tex, v_texcoord0) * v_color0;
+}
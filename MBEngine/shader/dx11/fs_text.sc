@@ -0,0 +1,19 @@
+$input v_texcoord0, v_color0
+
+#include <bgfx_shader.sh>
+
+SAMPLER2D(s_tex, 0); // glyph atlas, R8
+uniform vec4 u_text; // x = 1 when the atlas holds signed distance fields
+
+void main()
+{
+    float value = texture2D(s_tex, v_texcoord0).x;
+    float coverage = value;
+    if (u_text.x > 0.5)
+    {
+        // 0.5 is the outline, smooth over one screen pixel whatever the scale
+        float width = max(fwidth(value), 0.0001);
+        coverage = smoothstep(0.5 - width * 0.5, 0.5 + width * 0.5, value);
+    }
+    gl_FragColor = vec4(v_color0.rgb, v_color0.a * coverage);
+}
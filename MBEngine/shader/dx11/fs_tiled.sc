@@ -1,9 +1,11 @@
-$input v_texcoord0
+$input v_texcoord0, v_color0
 
 #include <bgfx_shader.sh>
 
 SAMPLER2D(s_tex, 0);
-uniform vec4 u_resolution; // x = width, y = height, z = texWidth, w = texHeight
+uniform vec4 u_resolution; // x = width, y = height, z = texWidth, w = texHeight (of one frame, on screen)
+uniform vec4 u_animation; // x = frame count, y = frame duration in seconds, z = time in seconds
+uniform vec4 u_sampling; // x = mip level, above 0 only when the map is drawn below 1:1
 
 void main()
 {
@@ -12,7 +14,13 @@ void main()
     vec2 tileCount = u_resolution.xy / u_resolution.zw;
 
     // Scale UVs to repeat the texture across the screen
-    vec2 tiledUV = v_texcoord0 * tileCount;
+    vec2 tiledUV = fract(v_texcoord0 * tileCount);
 
-    gl_FragColor = texture2D(s_tex, tiledUV);
-}
\ No newline at end of file
+    // Frames are stacked vertically, pick the current one from the global time
+    float frame = floor(mod(u_animation.z / u_animation.y, u_animation.x));
+    tiledUV.y = (tiledUV.y + frame) / u_animation.x;
+
+    // Explicit level, derivatives of the wrapped uv would break at every tile border.
+    // The vertex color is the block's tint, white unless it was drawn tinted
+    gl_FragColor = texture2DLod(s_tex, tiledUV, u_sampling.x) * v_color0;
+}
@@ -0,0 +1,66 @@
+$input v_texcoord0
+
+#include <bgfx_shader.sh>
+
+SAMPLER2D(s_tile_ids, 0); // one texel per tile, block id + 1, 0 = empty
+SAMPLER2DARRAY(s_tile_blocks, 1); // one layer per block frame
+// two texels per block id, row 0: x = first layer, y = frame count, z = frame duration, w = ME_ORIENT_*,
+// row 1: the tint
+SAMPLER2D(s_tile_table, 2);
+uniform vec4 u_resolution; // x = width, y = height of the screen
+uniform vec4 u_animation; // z = time in seconds
+uniform vec4 u_tilemap; // xy = camera in layer pixels, z = render scale, w = 1 to flip vertically
+uniform vec4 u_tilemap_grid; // xy = tile size, zw = columns, rows
+
+#define BLOCK_TABLE_SIZE 1024.0
+
+void main()
+{
+    // Layer pixel under this screen pixel, offscreen targets of bottom-left origin renderers are
+    // drawn upside down so they sample like any block texture
+    vec2 texcoord = vec2(v_texcoord0.x, mix(v_texcoord0.y, 1.0 - v_texcoord0.y, u_tilemap.w));
+    vec2 position = u_tilemap.xy + texcoord * u_resolution.xy / u_tilemap.z;
+    vec2 tile = floor(position / u_tilemap_grid.xy);
+    if (tile.x < 0.0 || tile.y < 0.0 || tile.x >= u_tilemap_grid.z || tile.y >= u_tilemap_grid.w)
+    {
+        discard;
+    }
+
+    float id = floor(texture2DLod(s_tile_ids, (tile + 0.5) / u_tilemap_grid.zw, 0.0).x * 65535.0 + 0.5) - 1.0;
+    if (id < 0.0)
+    {
+        discard;
+    }
+
+    // Blocks that aren't in the array have no frames, left to the clear color like the cache does
+    vec4 entry = texture2DLod(s_tile_table, vec2((id + 0.5) / BLOCK_TABLE_SIZE, 0.25), 0.0);
+    if (entry.y < 1.0)
+    {
+        discard;
+    }
+
+    // Same frame as fs_tiled picks for the block
+    float frame = floor(mod(u_animation.z / entry.z, entry.y));
+    vec2 uv = fract(position / u_tilemap_grid.xy);
+
+    // Variants share the layers of their base, the quarter turns are undone before the flips as
+    // the quad corners are turned for fs_tiled
+    float turns = floor(entry.w / 4.0);
+    if (turns == 1.0)
+    {
+        uv = vec2(uv.y, 1.0 - uv.x);
+    }
+    else if (turns == 2.0)
+    {
+        uv = vec2(1.0) - uv;
+    }
+    else if (turns == 3.0)
+    {
+        uv = vec2(1.0 - uv.y, uv.x);
+    }
+    vec2 flip = vec2(mod(entry.w, 2.0), mod(floor(entry.w / 2.0), 2.0));
+    uv = mix(uv, vec2(1.0) - uv, flip);
+
+    vec4 tint = texture2DLod(s_tile_table, vec2((id + 0.5) / BLOCK_TABLE_SIZE, 0.75), 0.0);
+    gl_FragColor = texture2DArrayLod(s_tile_blocks, vec3(uv, entry.x + frame), 0.0) * tint;
+}
@@ -1,5 +1,11 @@
 vec2 v_texcoord0 : TEXCOORD0;
+vec4 v_color0    : COLOR0;
 
 vec3 a_position  : POSITION;
 vec2 a_texcoord0 : TEXCOORD0;
+vec4 a_color0    : COLOR0;
+
+vec4 i_data0     : TEXCOORD7;
+vec4 i_data1     : TEXCOORD6;
+vec4 i_data2     : TEXCOORD5;
 
@@ -0,0 +1,17 @@
+$input a_position, a_texcoord0, i_data0, i_data1
+$output v_texcoord0, v_color0
+
+#include <bgfx_shader.sh>
+
+uniform vec4 u_resolution; // x = width, y = height of the target
+uniform vec4 u_particle; // x = v where the first frame of the block ends
+
+void main()
+{
+    // One instance per particle: i_data0 = top left and size in target pixels, i_data1 = color
+    vec2 pixel = i_data0.xy + a_position.xy * i_data0.zw;
+    vec2 clip = pixel / u_resolution.xy * 2.0 - 1.0;
+    gl_Position = vec4(clip.x, -clip.y, 0.0, 1.0);
+    v_texcoord0 = vec2(a_texcoord0.x, a_texcoord0.y * u_particle.x);
+    v_color0 = i_data1;
+}
@@ -0,0 +1,17 @@
+$input a_position, a_texcoord0, i_data0, i_data1, i_data2
+$output v_texcoord0, v_color0
+
+#include <bgfx_shader.sh>
+
+uniform vec4 u_resolution; // x = width, y = height of the window
+
+void main()
+{
+    // One instance per glyph: i_data0 = top left and size in window pixels, i_data1 = atlas uv
+    // rect, i_data2 = color. The unit quad spans the glyph
+    vec2 pixel = i_data0.xy + a_position.xy * i_data0.zw;
+    vec2 clip = pixel / u_resolution.xy * 2.0 - 1.0;
+    gl_Position = vec4(clip.x, -clip.y, 0.0, 1.0);
+    v_texcoord0 = mix(i_data1.xy, i_data1.zw, a_texcoord0);
+    v_color0 = i_data2;
+}
@@ -1,12 +1,33 @@
 package com.potato.Map;
 
+import com.potato.NativeUtils.BlockDesc;
+
 public class BlockItem {
     private int id;
     private String path;
+    // frames are stacked vertically in the image at `path`
+    private int frameCount;
+    private int frameDurationMs;
+    // lossy GPU compression, leave it off for pixel art that must stay exact
+    private boolean compressed;
+    // needed by blocks that show up in zoomed out views
+    private boolean mipmapped;
+    // found by collision queries and raycasts
+    private boolean solid;
 
     public BlockItem(int id, String path) {
+        this(id, path, 1, 0, false, false, false);
+    }
+
+    public BlockItem(int id, String path, int frameCount, int frameDurationMs, boolean compressed,
+                     boolean mipmapped, boolean solid) {
         this.id = id;
         this.path = path;
+        this.frameCount = frameCount;
+        this.frameDurationMs = frameDurationMs;
+        this.compressed = compressed;
+        this.mipmapped = mipmapped;
+        this.solid = solid;
     }
 
     public int getId() {
@@ -20,4 +41,42 @@ public class BlockItem {
     public String getPath() {
         return path;
     }
+
+    public int getFrameCount() {
+        return frameCount;
+    }
+
+    public int getFrameDurationMs() {
+        return frameDurationMs;
+    }
+
+    public boolean isAnimated() {
+        return frameCount > 1;
+    }
+
+    public boolean isCompressed() {
+        return compressed;
+    }
+
+    public boolean isMipmapped() {
+        return mipmapped;
+    }
+
+    public boolean isSolid() {
+        return solid;
+    }
+
+    public int getFlags() {
+        int flags = BlockDesc.FLAG_NONE;
+        if (compressed) {
+            flags |= BlockDesc.FLAG_COMPRESS;
+        }
+        if (mipmapped) {
+            flags |= BlockDesc.FLAG_MIPMAPS;
+        }
+        if (solid) {
+            flags |= BlockDesc.FLAG_SOLID;
+        }
+        return flags;
+    }
 }
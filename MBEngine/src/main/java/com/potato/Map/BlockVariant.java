@@ -0,0 +1,53 @@
+package com.potato.Map;
+
+import com.potato.NativeUtils.NativeCaller;
+
+public class BlockVariant {
+    private int id;
+    // block item whose texture the variant shares
+    private int baseId;
+    // 0xRRGGBBAA multiplied with the texture
+    private int tint;
+    // NativeCaller.ORIENT_* flags, mirrored first, then turned clockwise
+    private int orientation;
+
+    public BlockVariant(int id, int baseId, int tint, int orientation) {
+        this.id = id;
+        this.baseId = baseId;
+        this.tint = tint;
+        this.orientation = orientation;
+    }
+
+    public int getId() {
+        return id;
+    }
+
+    public int getBaseId() {
+        return baseId;
+    }
+
+    public int getTint() {
+        return tint;
+    }
+
+    public int getOrientation() {
+        return orientation;
+    }
+
+    /**
+     * Orientation of a map file variant, rotation is clockwise in degrees.
+     */
+    public static int toOrientation(boolean flipX, boolean flipY, int rotation) {
+        if (rotation % 90 != 0) {
+            throw new RuntimeException("Rotation " + rotation + " is not a multiple of 90 degrees");
+        }
+        int orientation = (Math.floorMod(rotation, 360) / 90) * NativeCaller.ORIENT_ROTATE_90;
+        if (flipX) {
+            orientation |= NativeCaller.ORIENT_FLIP_X;
+        }
+        if (flipY) {
+            orientation |= NativeCaller.ORIENT_FLIP_Y;
+        }
+        return orientation;
+    }
+}
@@ -8,6 +8,7 @@ public class Map {
     // use bucket to accelerate access speed
     private ArrayList<BlockItem> blockItems;
     private ArrayList<Block> blocks;
+    private ArrayList<BlockVariant> blockVariants = new ArrayList<>();
     private int blockWidth;
     private int blockHeight;
 
@@ -34,6 +35,14 @@ public class Map {
         return blockItems;
     }
 
+    public ArrayList<BlockVariant> getBlockVariants() {
+        return blockVariants;
+    }
+
+    public void setBlockVariants(ArrayList<BlockVariant> blockVariants) {
+        this.blockVariants = blockVariants;
+    }
+
     /**
      * Get the list of blocks that need to be rendered.
      * @return
@@ -50,6 +59,25 @@ public class Map {
         this.blockWidth = blockWidth;
     }
 
+    /**
+     * Width of the map in blocks, enough to hold the right most block.
+     */
+    public int getColumns() {
+        int columns = 0;
+        for (Block block : blocks) {
+            columns = Math.max(columns, block.getX() + 1);
+        }
+        return columns;
+    }
+
+    public int getRows() {
+        int rows = 0;
+        for (Block block : blocks) {
+            rows = Math.max(rows, block.getY() + 1);
+        }
+        return rows;
+    }
+
     public int getBlockWidth() {
         return blockWidth;
     }
@@ -6,6 +6,7 @@ import com.potato.NativeUtils.NativeCaller;
 
 import java.io.*;
 import java.util.ArrayList;
+import java.util.Arrays;
 import java.util.HashMap;
 import java.util.List;
 
@@ -45,12 +46,19 @@ public class MapManager {
         Toml mapFileToml = new Toml().read(mapFile);
         List<Toml> blockItemTomls = mapFileToml.getTables("block-item");
         List<Toml> blockTomls = mapFileToml.getTables("block");
+        List<Toml> blockVariantTomls = mapFileToml.getTables("block-variant");
 
         ArrayList<BlockItem> blockItems = new ArrayList<>();
         for (Toml blockItemToml : blockItemTomls) {
             int id = blockItemToml.getLong("id").intValue();
             String path = blockItemToml.getString("path");
-            BlockItem blockItem = new BlockItem(id, path);
+            int frameCount = blockItemToml.getLong("frames", 1L).intValue();
+            int frameDurationMs = blockItemToml.getLong("frame_duration", 0L).intValue();
+            boolean compressed = blockItemToml.getBoolean("compress", false);
+            boolean mipmapped = blockItemToml.getBoolean("mipmaps", false);
+            boolean solid = blockItemToml.getBoolean("solid", false);
+            BlockItem blockItem = new BlockItem(id, path, frameCount, frameDurationMs, compressed, mipmapped,
+                    solid);
             blockItems.add(blockItem);
         }
 
@@ -63,7 +71,22 @@ public class MapManager {
             blocks.add(block);
         }
 
+        // recolored or turned copies of a block item, e.g. tint = "FF8080FF", flip_x = true, rotation = 90
+        ArrayList<BlockVariant> blockVariants = new ArrayList<>();
+        if (blockVariantTomls != null) {
+            for (Toml blockVariantToml : blockVariantTomls) {
+                int id = blockVariantToml.getLong("id").intValue();
+                int baseId = blockVariantToml.getLong("base").intValue();
+                int tint = (int) Long.parseLong(blockVariantToml.getString("tint", "FFFFFFFF"), 16);
+                int orientation = BlockVariant.toOrientation(blockVariantToml.getBoolean("flip_x", false),
+                        blockVariantToml.getBoolean("flip_y", false),
+                        blockVariantToml.getLong("rotation", 0L).intValue());
+                blockVariants.add(new BlockVariant(id, baseId, tint, orientation));
+            }
+        }
+
         Map map = new Map(blockItems, blocks);
+        map.setBlockVariants(blockVariants);
 
         int blockWidth = mapFileToml.getLong("block_width").intValue();
         int blockHeight = mapFileToml.getLong("block_height").intValue();
@@ -83,25 +106,54 @@ public class MapManager {
         caller.clearBlock();
         Map map = maps.get(mapId);
         ArrayList<BlockItem> blockItems = map.getBlockItems();
+        // decoded on native workers while the layer below is set up, the first frames show the
+        // background where blocks are still loading
         for (BlockItem blockItem : blockItems) {
             if (blockItem == null) {
                 continue;
             }
-            caller.loadBlock(blockItem.getId(), blockItem.getPath());
+            caller.loadBlockAsync(blockItem.getId(), blockItem.getPath(), blockItem.getFrameCount(),
+                    blockItem.getFrameDurationMs(), blockItem.getFlags());
+        }
+        // queued bases are enough, a variant shows up with its base
+        for (BlockVariant blockVariant : map.getBlockVariants()) {
+            caller.registerBlockVariant(blockVariant.getId(), blockVariant.getBaseId(), blockVariant.getTint(),
+                    blockVariant.getOrientation());
+        }
+
+        // the map never moves on its own, the engine caches it and only redraws what changes
+        caller.setStaticLayer(map.getBlockWidth(), map.getBlockHeight(), map.getColumns(), map.getRows());
+        for (Block block : map.getRenderedBlocks()) {
+            caller.setStaticTile(block.getX(), block.getY(), block.getId());
         }
     }
 
-    public void renderMap(NativeCaller caller) {
-        String mapId = Config.gameContext.getCurrentMap();
+    /**
+     * Convert a registered map into a world file that `NativeCaller.openWorld` streams.
+     */
+    public void exportWorld(String mapId, String path, NativeCaller caller) {
         if (!maps.containsKey(mapId)) {
             throw new RuntimeException("Map " + mapId + " not registered.");
         }
 
         Map map = maps.get(mapId);
+        int columns = map.getColumns();
+        int rows = map.getRows();
+        short[] tiles = new short[columns * rows];
+        Arrays.fill(tiles, (short) -1);
         for (Block block : map.getRenderedBlocks()) {
-            caller.renderBlock(block.getId(), block.getX() * map.getBlockWidth(), block.getY() * map.getBlockHeight());
+            tiles[block.getY() * columns + block.getX()] = (short) block.getId();
         }
+        caller.writeWorld(path, map.getBlockWidth(), map.getBlockHeight(), columns, rows, tiles);
+    }
 
-        caller.renderFrame();
+    /**
+     * Load a registered map for editing, saved to the map file at path. The first time the map file is written
+     * from the TOML map, afterwards its tiles replace the TOML ones. Edit with `NativeCaller.setTile` and
+     * `fillRect`, `saveMap` keeps them.
+     */
+    public void editMap(String mapId, String path, NativeCaller caller) {
+        loadMap(mapId, caller);
+        caller.openMap(path);
     }
 }
@@ -0,0 +1,25 @@
+package com.potato.NativeUtils;
+
+import com.sun.jna.Structure;
+
+import java.util.List;
+
+// box in static layer pixels
+public class AABB extends Structure {
+    public int x, y, width, height;
+
+    public AABB() {
+    }
+
+    public AABB(int x, int y, int width, int height) {
+        this.x = x;
+        this.y = y;
+        this.width = width;
+        this.height = height;
+    }
+
+    @Override
+    protected List<String> getFieldOrder() {
+        return List.of("x", "y", "width", "height");
+    }
+}
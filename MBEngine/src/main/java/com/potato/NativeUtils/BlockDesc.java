@@ -0,0 +1,38 @@
+package com.potato.NativeUtils;
+
+import com.sun.jna.Structure;
+
+import java.util.List;
+
+public class BlockDesc extends Structure {
+    // keep in sync with ME_BLOCK_FLAG_* in mainboard_engine.h
+    public static final int FLAG_NONE = 0;
+    public static final int FLAG_COMPRESS = 1;
+    public static final int FLAG_MIPMAPS = 2;
+    public static final int FLAG_SOLID = 4;
+
+    public int frame_count, frame_duration_ms, flags;
+
+    public BlockDesc() {
+        this.frame_count = 1;
+        this.frame_duration_ms = 0;
+        this.flags = FLAG_NONE;
+    }
+
+    public BlockDesc(int frameCount, int frameDurationMs, int flags) {
+        this.frame_count = frameCount;
+        this.frame_duration_ms = frameDurationMs;
+        this.flags = flags;
+    }
+
+    public static class ByReference extends BlockDesc implements Structure.ByReference {
+        public ByReference(int frameCount, int frameDurationMs, int flags) {
+            super(frameCount, frameDurationMs, flags);
+        }
+    }
+
+    @Override
+    protected List<String> getFieldOrder() {
+        return List.of("frame_count", "frame_duration_ms", "flags");
+    }
+}
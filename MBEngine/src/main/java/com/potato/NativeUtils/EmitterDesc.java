@@ -0,0 +1,40 @@
+package com.potato.NativeUtils;
+
+import com.sun.jna.Structure;
+
+import java.util.List;
+
+public class EmitterDesc extends Structure {
+    public float x, y, width, height;
+    public float rate;
+    public float lifetime_min, lifetime_max;
+    public float speed_min, speed_max;
+    public float direction, spread;
+    public float gravity_x, gravity_y;
+    public float drag;
+    public float size_start, size_end;
+    // 0xRRGGBBAA
+    public int color_start, color_end;
+    public int block_id;
+
+    public EmitterDesc() {
+        this.lifetime_min = 1.0f;
+        this.lifetime_max = 1.0f;
+        this.spread = 360.0f;
+        this.size_start = 2.0f;
+        this.size_end = 2.0f;
+        this.color_start = 0xFFFFFFFF;
+        this.color_end = 0xFFFFFF00;
+        this.block_id = -1;
+    }
+
+    public static class ByReference extends EmitterDesc implements Structure.ByReference {
+    }
+
+    @Override
+    protected List<String> getFieldOrder() {
+        return List.of("x", "y", "width", "height", "rate", "lifetime_min", "lifetime_max", "speed_min",
+                "speed_max", "direction", "spread", "gravity_x", "gravity_y", "drag", "size_start", "size_end",
+                "color_start", "color_end", "block_id");
+    }
+}
@@ -0,0 +1,29 @@
+package com.potato.NativeUtils;
+
+import com.sun.jna.Pointer;
+import com.sun.jna.Structure;
+
+import java.util.List;
+
+public class LoopDesc extends Structure {
+    public double tick_rate;
+    public int max_ticks_per_frame;
+    // 0 to present as fast as vsync allows
+    public double frame_rate;
+    public MainboardNativeLibrary.TickCallback update;
+    public MainboardNativeLibrary.FrameCallback render;
+    public Pointer user_data;
+
+    public LoopDesc() {
+        this.tick_rate = 60.0;
+        this.max_ticks_per_frame = 5;
+    }
+
+    public static class ByReference extends LoopDesc implements Structure.ByReference {
+    }
+
+    @Override
+    protected List<String> getFieldOrder() {
+        return List.of("tick_rate", "max_ticks_per_frame", "frame_rate", "update", "render", "user_data");
+    }
+}
@@ -0,0 +1,52 @@
+package com.potato.NativeUtils;
+
+import java.io.File;
+
+// JNI bindings of the calls made every frame, registered by JNI_OnLoad in jni_bindings.cpp.
+// Like `MainboardNativeLibrary` it should NEVER be called directly. Use `NativeCaller` instead.
+public final class MainboardJNI {
+    // keep in sync with ME_VERSION in mainboard_engine.h
+    static final int VERSION = 1;
+
+    private static final boolean available = load();
+
+    private MainboardJNI() {
+    }
+
+    private static boolean load() {
+        // the library JNA already opened, loading it again through the JVM runs JNI_OnLoad
+        String libraryPath = System.getProperty("jna.library.path");
+        if (libraryPath == null) {
+            return false;
+        }
+        File library = new File(libraryPath, System.mapLibraryName("mainboard_native"));
+        try {
+            System.load(library.getAbsolutePath());
+            return getVersion() == VERSION;
+        } catch (UnsatisfiedLinkError e) {
+            return false;
+        }
+    }
+
+    public static boolean isAvailable() {
+        return available;
+    }
+
+    static native int getVersion();
+
+    static native int processEvents(long handle);
+
+    static native int renderBlock(int blockId, int x, int y);
+
+    static native int renderBlocks(int[] blockIds, int[] xs, int[] ys, int count);
+
+    static native int renderFrame(long handle);
+
+    static native int beginFrame(long handle);
+
+    static native int endFrame(long handle);
+
+    static native int setWindowTitle(long handle, String title);
+
+    static native int drawText(int fontId, int x, int y, String text, int color);
+}
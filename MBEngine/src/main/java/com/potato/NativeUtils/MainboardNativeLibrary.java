@@ -1,5 +1,6 @@
 package com.potato.NativeUtils;
 
+import com.sun.jna.Callback;
 import com.sun.jna.Library;
 import com.sun.jna.Native;
 import com.sun.jna.Pointer;
@@ -8,6 +9,16 @@ import com.sun.jna.Pointer;
 public interface MainboardNativeLibrary extends Library {
     MainboardNativeLibrary INSTANCE = Native.load("mainboard_native", MainboardNativeLibrary.class);
 
+    interface TickCallback extends Callback {
+        void invoke(double dt, Pointer userData);
+    }
+
+    interface FrameCallback extends Callback {
+        void invoke(double alpha, Pointer userData);
+    }
+
+    int ME_GetVersion();
+
     int ME_Initialize();
 
     Pointer ME_CreateWindow(int is_full_screen, int x, int y, int width, int height, String title);
@@ -16,8 +27,26 @@ public interface MainboardNativeLibrary extends Library {
 
     int ME_RenderBlock(int block_id, int x, int y);
 
+    int ME_RenderBlocks(int[] block_ids, int[] xs, int[] ys, int count);
+
+    int ME_RenderBlockEx(int block_id, int x, int y, int tint, int orientation);
+
+    int ME_RenderBlocksEx(int[] block_ids, int[] xs, int[] ys, int[] tints, int[] orientations, int count);
+
     int ME_RenderFrame(Pointer handle);
 
+    int ME_BeginFrame(Pointer handle);
+
+    int ME_EndFrame(Pointer handle);
+
+    int ME_RunLoop(Pointer handle, LoopDesc.ByReference desc);
+
+    int ME_StopLoop();
+
+    int ME_TraceStart();
+
+    int ME_TraceStop(String path);
+
     int ME_ClearView(Pointer handle);
 
     int ME_DestroyWindow(Pointer handle);
@@ -32,5 +61,102 @@ public interface MainboardNativeLibrary extends Library {
 
     int ME_LoadBlock(int id, String path);
 
+    int ME_LoadBlockEx(int id, String path, BlockDesc.ByReference desc);
+
+    int ME_LoadBlockAsync(int id, String path, BlockDesc.ByReference desc);
+
+    int ME_GetStartupStats(StartupStats.ByReference stats);
+
+    int ME_RegisterBlockVariant(int id, int base_id, int tint, int orientation);
+
+    int ME_CookBlockTexture(String path, String format, int flags);
+
+    int ME_SetRenderScale(float scale);
+
     int ME_ClearBlock();
+
+    int ME_SetStaticLayer(int tile_width, int tile_height, int columns, int rows);
+
+    int ME_SetStaticTile(int column, int row, int block_id);
+
+    int ME_SetStaticLayerMode(int mode);
+
+    int ME_SetBlockLight(int block_id, int emission, int opacity);
+
+    int ME_SetLighting(int enabled, int ambient, int air_falloff);
+
+    int ME_GetLight(int column, int row);
+
+    int ME_SetCamera(int x, int y);
+
+    int ME_CreateView(ViewDesc.ByReference desc);
+
+    int ME_UpdateView(int view, ViewDesc.ByReference desc);
+
+    int ME_DestroyView(int view);
+
+    int ME_SetViewLayers(int view, int layer_mask);
+
+    int ME_LoadFont(int font_id, String ttf_path, float pixel_height, int flags);
+
+    int ME_UnloadFont(int font_id);
+
+    int ME_DrawText(int font_id, int x, int y, String utf8, int color);
+
+    int ME_DrawTextScaled(int font_id, int x, int y, float scale, String utf8, int color);
+
+    int ME_CreateEmitter(EmitterDesc.ByReference desc);
+
+    int ME_UpdateEmitter(int emitter, EmitterDesc.ByReference desc);
+
+    int ME_DestroyEmitter(int emitter);
+
+    int ME_EmitParticles(int emitter, float x, float y, int count);
+
+    int ME_WriteWorld(String path, int tile_width, int tile_height, int columns, int rows, short[] tiles);
+
+    int ME_OpenWorld(String path, int placeholder_block_id, int memory_budget_kb);
+
+    int ME_CloseWorld();
+
+    int ME_QueryPoint(int x, int y);
+
+    int ME_QueryPoints(int[] xs, int[] ys, int count, int[] block_ids);
+
+    int ME_QueryAABBs(AABB[] boxes, int count, int[] solid_counts);
+
+    int ME_Raycast(Ray.ByReference ray, RaycastHit.ByReference hit);
+
+    int ME_FindPaths(PathRequest[] requests, int count);
+
+    int ME_WaitPaths(int batch);
+
+    // tiles are column, row pairs
+    int ME_GetPaths(int batch, PathResult[] results, int[] tiles, int capacity);
+
+    int ME_ReleasePaths(int batch);
+
+    int ME_OpenMap(String path);
+
+    int ME_SetTile(int column, int row, int block_id);
+
+    int ME_FillRect(int column, int row, int width, int height, int block_id);
+
+    int ME_SaveMap();
+
+    int ME_CompactMap();
+
+    int ME_CloseMap();
+
+    int ME_GetMapStats(MapStats.ByReference stats);
+
+    int ME_ReadFramePixels(byte[] rgba, int capacity, int[] width, int[] height);
+
+    int ME_SaveFramePng(String path);
+
+    int ME_SetRendererType(int type);
+
+    int ME_RecordStart(String path);
+
+    int ME_RecordStop();
 }
@@ -0,0 +1,23 @@
+package com.potato.NativeUtils;
+
+import com.sun.jna.Structure;
+
+import java.util.List;
+
+// the map opened by NativeCaller.openMap
+public class MapStats extends Structure {
+    // edits not saved yet, and saved since the map file was last rewritten
+    public int pending_edits, journal_records;
+    public long journal_bytes, base_bytes;
+    public int compactions, compacting, compaction_failed;
+    public double last_save_ms, last_compaction_ms;
+
+    public static class ByReference extends MapStats implements Structure.ByReference {
+    }
+
+    @Override
+    protected List<String> getFieldOrder() {
+        return List.of("pending_edits", "journal_records", "journal_bytes", "base_bytes", "compactions",
+                "compacting", "compaction_failed", "last_save_ms", "last_compaction_ms");
+    }
+}
@@ -2,6 +2,7 @@ package com.potato.NativeUtils;
 
 import com.potato.Config;
 import com.potato.Utils.EventProcesser;
+import com.potato.Utils.TickProcesser;
 import com.potato.Variable.EventMessage;
 import com.sun.jna.Pointer;
 
@@ -10,13 +11,48 @@ import java.util.ArrayList;
 
 // packing native function calls
 public class NativeCaller {
+    // ME_RENDERER_*, the ones the Java side picks
+    public static final int RENDERER_AUTO = 0;
+    public static final int RENDERER_NOOP = 1;
+    public static final int RENDERER_SOFTWARE = 7;
+
+    // ME_ORIENT_*, mirrored first, then turned clockwise
+    public static final int ORIENT_NONE = 0;
+    public static final int ORIENT_FLIP_X = 1;
+    public static final int ORIENT_FLIP_Y = 2;
+    public static final int ORIENT_ROTATE_90 = 4;
+    public static final int ORIENT_ROTATE_180 = 8;
+    public static final int ORIENT_ROTATE_270 = 12;
+    // ME_TINT_NONE, tints are 0xRRGGBBAA
+    public static final int TINT_NONE = 0xFFFFFFFF;
+
     private boolean isLoaded = false;
     private MainboardNativeLibrary library;
     private Pointer windowHandle;
+    private long windowHandleValue;
+    // per-frame calls go through JNI when the native library was built with it, JNA otherwise
+    private boolean useJNI;
+    // held while runLoop runs so the callbacks aren't collected under the native loop
+    private LoopDesc.ByReference loopDesc;
+    private double frameAlpha;
 
     public NativeCaller() {
         load();
         library = MainboardNativeLibrary.INSTANCE;
+        useJNI = MainboardJNI.isAvailable();
+    }
+
+    public NativeCaller(boolean allowJNI) {
+        this();
+        useJNI = allowJNI && useJNI;
+    }
+
+    public boolean isUsingJNI() {
+        return useJNI;
+    }
+
+    public Pointer getWindowHandle() {
+        return windowHandle;
     }
 
     private void load() {
@@ -42,29 +78,70 @@ public class NativeCaller {
         if (windowHandle == null) {
             throw new RuntimeException("Failed to create window.");
         }
+        windowHandleValue = Pointer.nativeValue(windowHandle);
     }
 
     public void processEvents(ArrayList<EventProcesser> eventProcessers) {
         while (true) {
-            // event process of java side
+            // event process of native side
+            int meg = useJNI ? MainboardJNI.processEvents(windowHandleValue) : library.ME_ProcessEvents(windowHandle);
+            if (meg == EventMessage.QUIT.getCode()) {
+                break;
+            }
+
+            // event process of java side, one present per iteration even if a processor calls renderFrame
+            beginFrame();
             if (eventProcessers != null) {
                 eventProcessers.forEach((processor) -> {
                     processor.process(Config.gameContext, this);
                 });
             }
+            endFrame();
+        }
+    }
 
-            // event process of native side
-            int meg = library.ME_ProcessEvents(windowHandle);
-            if (meg == EventMessage.QUIT.getCode()) {
-                break;
+    /**
+     * Native driven loop: tickProcessers run at a fixed tickRate however fast frames go, then
+     * eventProcessers draw the frame, see getFrameAlpha. Returns when the window closes or
+     * after stopLoop.
+     *
+     * @param frameRate frames per second cap, the loop sleeps in between, 0 to follow vsync
+     */
+    public void runLoop(double tickRate, double frameRate, ArrayList<TickProcesser> tickProcessers,
+                        ArrayList<EventProcesser> eventProcessers) {
+        loopDesc = new LoopDesc.ByReference();
+        loopDesc.tick_rate = tickRate;
+        loopDesc.frame_rate = frameRate;
+        loopDesc.update = (dt, userData) -> {
+            if (tickProcessers != null) {
+                tickProcessers.forEach((processor) -> processor.tick(Config.gameContext, this, dt));
             }
-
-            if (library.ME_RenderFrame(windowHandle) == 0) {
-                throw new RuntimeException("Failed to render frame.");
+        };
+        loopDesc.render = (alpha, userData) -> {
+            frameAlpha = alpha;
+            if (eventProcessers != null) {
+                eventProcessers.forEach((processor) -> processor.process(Config.gameContext, this));
             }
+        };
+        int message = library.ME_RunLoop(windowHandle, loopDesc);
+        loopDesc = null;
+        if (message == -1) {
+            throw new RuntimeException("Failed to run the loop.");
         }
     }
 
+    public void stopLoop() {
+        library.ME_StopLoop();
+    }
+
+    /**
+     * Fraction of a tick since the last one, in [0, 1). Draw at previous + (current - previous) *
+     * alpha to move smoothly at any frame rate.
+     */
+    public double getFrameAlpha() {
+        return frameAlpha;
+    }
+
     public void destroyWindow() {
         if (library.ME_DestroyWindow(windowHandle) == 0) {
             throw new RuntimeException("Failed to destroy window.");
@@ -72,7 +149,11 @@ public class NativeCaller {
     }
 
     public void setTitle(String title) {
-        library.ME_SetWindowTitle(windowHandle, title);
+        if (useJNI) {
+            MainboardJNI.setWindowTitle(windowHandleValue, title);
+        } else {
+            library.ME_SetWindowTitle(windowHandle, title);
+        }
     }
 
     public void setWindowSize(int width, int height) {
@@ -92,24 +173,521 @@ public class NativeCaller {
         }
     }
 
+    public void loadBlock(int id, String path, int frameCount, int frameDurationMs, int flags) {
+        BlockDesc.ByReference desc = new BlockDesc.ByReference(frameCount, frameDurationMs, flags);
+        if (library.ME_LoadBlockEx(id, path, desc) == 0) {
+            throw new RuntimeException("Failed to load block from " + path);
+        }
+    }
+
+    /**
+     * Decodes on a native worker and shows up a few frames later, until then the block draws
+     * nothing. Compressed blocks load right away.
+     */
+    public void loadBlockAsync(int id, String path, int frameCount, int frameDurationMs, int flags) {
+        BlockDesc.ByReference desc = new BlockDesc.ByReference(frameCount, frameDurationMs, flags);
+        if (library.ME_LoadBlockAsync(id, path, desc) == 0) {
+            throw new RuntimeException("Failed to queue block " + id + " from " + path);
+        }
+    }
+
+    public StartupStats getStartupStats() {
+        StartupStats.ByReference stats = new StartupStats.ByReference();
+        if (library.ME_GetStartupStats(stats) == 0) {
+            throw new RuntimeException("Failed to get startup stats.");
+        }
+        return stats;
+    }
+
+    /**
+     * Pre-encode a block texture so `BlockDesc.FLAG_COMPRESS` loads skip the encoder.
+     * @param format one of BC1, BC3, BC7, ETC2, ETC2A, ASTC4x4
+     * @param flags `BlockDesc.FLAG_MIPMAPS` to cook the mip chain as well
+     */
+    public void cookBlockTexture(String path, String format, int flags) {
+        if (library.ME_CookBlockTexture(path, format, flags) == 0) {
+            throw new RuntimeException("Failed to cook " + path + " as " + format);
+        }
+    }
+
+    /**
+     * Zoom the whole map, below 1 blocks loaded with `BlockDesc.FLAG_MIPMAPS` sample their mips.
+     */
+    public void setRenderScale(float scale) {
+        if (library.ME_SetRenderScale(scale) == 0) {
+            throw new RuntimeException("Invalid render scale " + scale);
+        }
+    }
+
     public void clearBlock() {
         if (library.ME_ClearBlock() == 0) {
             throw new RuntimeException("Failed to clear blocks.");
         }
     }
 
+    /**
+     * Replace the static layer with an empty grid, its tiles are rendered once and cached by the engine.
+     */
+    public void setStaticLayer(int tileWidth, int tileHeight, int columns, int rows) {
+        if (library.ME_SetStaticLayer(tileWidth, tileHeight, columns, rows) == 0) {
+            throw new RuntimeException("Invalid static layer " + columns + "x" + rows);
+        }
+    }
+
+    /**
+     * @param emission light level the block gives off, 0 to 255
+     * @param opacity  light lost entering the block, 0 for the air falloff of setLighting
+     */
+    public void setBlockLight(int blockId, int emission, int opacity) {
+        if (library.ME_SetBlockLight(blockId, emission, opacity) == 0) {
+            throw new RuntimeException("Failed to set light of block " + blockId);
+        }
+    }
+
+    /**
+     * @param ambient    light level nothing goes below, 0 to 255
+     * @param airFalloff light lost per empty tile, at least 8 so light stays near its source
+     */
+    public void setLighting(boolean enabled, int ambient, int airFalloff) {
+        if (library.ME_SetLighting(enabled ? 1 : 0, ambient, airFalloff) == 0) {
+            throw new RuntimeException("Failed to set lighting");
+        }
+    }
+
+    /**
+     * @return light level of the static tile, -1 outside the layer or with lighting off
+     */
+    public int getLight(int column, int row) {
+        return library.ME_GetLight(column, row);
+    }
+
+    /**
+     * @param blockId a loaded block, or -1 to empty the tile
+     */
+    public void setStaticTile(int column, int row, int blockId) {
+        if (library.ME_SetStaticTile(column, row, blockId) == 0) {
+            throw new RuntimeException("Failed to set static tile " + column + ", " + row + " to " + blockId);
+        }
+    }
+
+    /**
+     * @param cached true to always draw the static layer through its offscreen cache, false to let the
+     *               engine draw it as a tile id texture in one pass whenever the layer allows
+     */
+    public void setStaticLayerCached(boolean cached) {
+        if (library.ME_SetStaticLayerMode(cached ? 1 : 0) == 0) {
+            throw new RuntimeException("Failed to set static layer mode.");
+        }
+    }
+
+    /**
+     * Scroll the static layer, (x, y) is the pixel of the layer shown at the top left of the window.
+     */
+    public void setCamera(int x, int y) {
+        library.ME_SetCamera(x, y);
+    }
+
+    /**
+     * Draw another view of the same map each frame, see ViewDesc.window and ViewDesc.offscreen.
+     *
+     * @return the view id for updateView, destroyView and setViewLayers
+     */
+    public int createView(ViewDesc.ByReference desc) {
+        int view = library.ME_CreateView(desc);
+        if (view < 0) {
+            throw new RuntimeException("Failed to create view.");
+        }
+        return view;
+    }
+
+    public void updateView(int view, ViewDesc.ByReference desc) {
+        if (library.ME_UpdateView(view, desc) == 0) {
+            throw new RuntimeException("Failed to update view " + view);
+        }
+    }
+
+    public void destroyView(int view) {
+        if (library.ME_DestroyView(view) == 0) {
+            throw new RuntimeException("Failed to destroy view " + view);
+        }
+    }
+
+    /**
+     * @param view      a view id, or ViewDesc.MAIN for the window itself
+     * @param layerMask ViewDesc.LAYER_* flags
+     */
+    public void setViewLayers(int view, int layerMask) {
+        if (library.ME_SetViewLayers(view, layerMask) == 0) {
+            throw new RuntimeException("Failed to set layers of view " + view);
+        }
+    }
+
+    /**
+     * Load a TTF font for drawText, glyphs are rasterized at pixelHeight as they are first drawn.
+     *
+     * @param fontId 0 to 15, replaces the font loaded there
+     * @param sdf    distance field glyphs, they stay sharp when drawn scaled
+     */
+    public void loadFont(int fontId, String ttfPath, float pixelHeight, boolean sdf) {
+        if (library.ME_LoadFont(fontId, ttfPath, pixelHeight, sdf ? 1 : 0) == 0) {
+            throw new RuntimeException("Failed to load font " + ttfPath);
+        }
+    }
+
+    public void unloadFont(int fontId) {
+        if (library.ME_UnloadFont(fontId) == 0) {
+            throw new RuntimeException("Failed to unload font " + fontId);
+        }
+    }
+
+    /**
+     * Draw text over the frame, x and y are the top left of the first line in window pixels.
+     *
+     * @param color 0xRRGGBBAA
+     */
+    public void drawText(int fontId, int x, int y, String text, int color) {
+        int state = useJNI ? MainboardJNI.drawText(fontId, x, y, text, color)
+                : library.ME_DrawText(fontId, x, y, text, color);
+        if (state == 0) {
+            throw new RuntimeException("Failed to draw text with font " + fontId);
+        }
+    }
+
+    public void drawText(int fontId, int x, int y, float scale, String text, int color) {
+        if (library.ME_DrawTextScaled(fontId, x, y, scale, text, color) == 0) {
+            throw new RuntimeException("Failed to draw text with font " + fontId);
+        }
+    }
+
+    /**
+     * Particles are simulated and drawn by renderFrame, in the same pixel space as renderBlock.
+     *
+     * @return the emitter id for updateEmitter, destroyEmitter and emitParticles
+     */
+    public int createEmitter(EmitterDesc.ByReference desc) {
+        int emitter = library.ME_CreateEmitter(desc);
+        if (emitter < 0) {
+            throw new RuntimeException("Failed to create emitter.");
+        }
+        return emitter;
+    }
+
+    public void updateEmitter(int emitter, EmitterDesc.ByReference desc) {
+        if (library.ME_UpdateEmitter(emitter, desc) == 0) {
+            throw new RuntimeException("Failed to update emitter " + emitter);
+        }
+    }
+
+    public void destroyEmitter(int emitter) {
+        if (library.ME_DestroyEmitter(emitter) == 0) {
+            throw new RuntimeException("Failed to destroy emitter " + emitter);
+        }
+    }
+
+    /**
+     * Burst of particles around x, y, e.g. dust where a block broke.
+     */
+    public void emitParticles(int emitter, float x, float y, int count) {
+        if (library.ME_EmitParticles(emitter, x, y, count) == 0) {
+            throw new RuntimeException("Failed to emit particles from emitter " + emitter);
+        }
+    }
+
+    /**
+     * Write a world file for openWorld, tiles holds columns * rows block ids row by row, -1 for nothing.
+     */
+    public void writeWorld(String path, int tileWidth, int tileHeight, int columns, int rows, short[] tiles) {
+        if (library.ME_WriteWorld(path, tileWidth, tileHeight, columns, rows, tiles) == 0) {
+            throw new RuntimeException("Failed to write world " + path);
+        }
+    }
+
+    /**
+     * Stream a world onto the static layer, only the chunks around the camera are kept in memory.
+     * @param placeholderBlockId shown where a chunk is still loading, -1 for the background color
+     */
+    public void openWorld(String path, int placeholderBlockId, int memoryBudgetKb) {
+        if (library.ME_OpenWorld(path, placeholderBlockId, memoryBudgetKb) == 0) {
+            throw new RuntimeException("Failed to open world " + path);
+        }
+    }
+
+    public void closeWorld() {
+        library.ME_CloseWorld();
+    }
+
+    /**
+     * @return the block under a static layer pixel, -1 for nothing
+     */
+    public int queryPoint(int x, int y) {
+        return library.ME_QueryPoint(x, y);
+    }
+
+    /**
+     * Look up `count` points in one native call, results go to blockIds.
+     */
+    public void queryPoints(int[] xs, int[] ys, int count, int[] blockIds) {
+        library.ME_QueryPoints(xs, ys, count, blockIds);
+    }
+
+    /**
+     * Count the solid tiles under each box, boxes must come from `new AABB().toArray(count)`.
+     * @return how many boxes touch at least one solid tile
+     */
+    public int queryAABBs(AABB[] boxes, int count, int[] solidCounts) {
+        return library.ME_QueryAABBs(boxes, count, solidCounts);
+    }
+
+    /**
+     * @return the first solid tile along the ray, or null when nothing is hit within maxDistance
+     */
+    public RaycastHit raycast(float x, float y, float dirX, float dirY, float maxDistance) {
+        RaycastHit.ByReference hit = new RaycastHit.ByReference();
+        if (library.ME_Raycast(new Ray.ByReference(x, y, dirX, dirY, maxDistance), hit) == 0) {
+            return null;
+        }
+        return hit;
+    }
+
+    /**
+     * Solve paths on native worker threads, requests must come from `new PathRequest().toArray(count)`.
+     * @return the batch to pass to getPaths, release it once done
+     */
+    public int findPaths(PathRequest[] requests, int count) {
+        int batch = library.ME_FindPaths(requests, count);
+        if (batch < 0) {
+            throw new RuntimeException("Failed to find paths");
+        }
+        return batch;
+    }
+
+    public void waitPaths(int batch) {
+        if (library.ME_WaitPaths(batch) == 0) {
+            throw new RuntimeException("Unknown path batch " + batch);
+        }
+    }
+
+    /**
+     * Results go to results, which must come from `new PathResult().toArray(count)`, tiles get column, row pairs.
+     * @return how many tiles the paths take, when it is more than tiles holds some paths are left out
+     */
+    public int getPaths(int batch, PathResult[] results, int[] tiles) {
+        int total = library.ME_GetPaths(batch, results, tiles, tiles.length / 2);
+        if (total < 0) {
+            throw new RuntimeException("Unknown path batch " + batch);
+        }
+        return total;
+    }
+
+    public void releasePaths(int batch) {
+        library.ME_ReleasePaths(batch);
+    }
+
+    /**
+     * Blocking single path search, walking diagonally when the tiles beside the step are free.
+     * @return column, row pairs from start to goal, or null when there is no path
+     */
+    public int[] findPath(int startColumn, int startRow, int goalColumn, int goalRow) {
+        PathRequest[] requests = (PathRequest[]) new PathRequest().toArray(1);
+        requests[0].start_column = startColumn;
+        requests[0].start_row = startRow;
+        requests[0].goal_column = goalColumn;
+        requests[0].goal_row = goalRow;
+        requests[0].flags = PathRequest.DIAGONAL;
+        PathResult[] results = (PathResult[]) new PathResult().toArray(1);
+
+        int batch = findPaths(requests, 1);
+        try {
+            waitPaths(batch);
+            int length = getPaths(batch, results, new int[0]);
+            if (results[0].status != PathResult.FOUND) {
+                return null;
+            }
+            int[] tiles = new int[length * 2];
+            getPaths(batch, results, tiles);
+            return tiles;
+        } finally {
+            releasePaths(batch);
+        }
+    }
+
+    /**
+     * Edit the map file at path from now on, it replaces the static layer, or is written from it when it doesn't exist yet.
+     * Edits through setTile and fillRect are appended to path.journal by saveMap.
+     */
+    public void openMap(String path) {
+        if (library.ME_OpenMap(path) == 0) {
+            throw new RuntimeException("Failed to open map " + path);
+        }
+    }
+
+    public void setTile(int column, int row, int blockId) {
+        if (library.ME_SetTile(column, row, blockId) == 0) {
+            throw new RuntimeException("Failed to set tile " + column + ", " + row + " to block " + blockId);
+        }
+    }
+
+    public void fillRect(int column, int row, int width, int height, int blockId) {
+        if (library.ME_FillRect(column, row, width, height, blockId) == 0) {
+            throw new RuntimeException("Failed to fill " + width + "x" + height + " tiles with block " + blockId);
+        }
+    }
+
+    /**
+     * Takes time in proportion to the edits since the last save, not to the map size.
+     */
+    public void saveMap() {
+        if (library.ME_SaveMap() == 0) {
+            throw new RuntimeException("Failed to save map.");
+        }
+    }
+
+    public void compactMap() {
+        if (library.ME_CompactMap() == 0) {
+            throw new RuntimeException("Failed to compact map.");
+        }
+    }
+
+    public void closeMap() {
+        library.ME_CloseMap();
+    }
+
+    public MapStats getMapStats() {
+        MapStats.ByReference stats = new MapStats.ByReference();
+        if (library.ME_GetMapStats(stats) == 0) {
+            throw new RuntimeException("No map is open.");
+        }
+        return stats;
+    }
+
+    // for windows created afterwards
+    public void setRendererType(int type) {
+        if (library.ME_SetRendererType(type) == 0) {
+            throw new RuntimeException("Unknown renderer type " + type + ".");
+        }
+    }
+
+    // RENDERER_SOFTWARE only: the last frame as RGBA8 rows, size[0] and size[1] get its width and height
+    public byte[] readFramePixels(int[] size) {
+        int[] width = new int[1];
+        int[] height = new int[1];
+        library.ME_ReadFramePixels(null, 0, width, height);
+        byte[] rgba = new byte[width[0] * height[0] * 4];
+        if (library.ME_ReadFramePixels(rgba, rgba.length, width, height) == 0) {
+            throw new RuntimeException("No software frame to read.");
+        }
+        size[0] = width[0];
+        size[1] = height[0];
+        return rgba;
+    }
+
+    public void saveFramePng(String path) {
+        if (library.ME_SaveFramePng(path) == 0) {
+            throw new RuntimeException("Failed to save frame to " + path + ".");
+        }
+    }
+
     public void renderBlock(int blockId, int x, int y) {
-        if (library.ME_RenderBlock(blockId, x, y) == 0) {
+        int state = useJNI ? MainboardJNI.renderBlock(blockId, x, y) : library.ME_RenderBlock(blockId, x, y);
+        if (state == 0) {
+            throw new RuntimeException("Failed to render block " + blockId);
+        }
+    }
+
+    /**
+     * Render `count` blocks in one native call, positions are in pixels.
+     */
+    public void renderBlocks(int[] blockIds, int[] xs, int[] ys, int count) {
+        int rendered = useJNI ? MainboardJNI.renderBlocks(blockIds, xs, ys, count)
+                : library.ME_RenderBlocks(blockIds, xs, ys, count);
+        if (rendered != count) {
+            throw new RuntimeException("Failed to render " + (count - rendered) + " of " + count + " blocks");
+        }
+    }
+
+    /**
+     * A tinted and turned draw of the block, it still batches with the block's plain draws.
+     * @param tint 0xRRGGBBAA multiplied with the texture, `TINT_NONE` to leave it
+     * @param orientation `ORIENT_*` flags
+     */
+    public void renderBlock(int blockId, int x, int y, int tint, int orientation) {
+        if (library.ME_RenderBlockEx(blockId, x, y, tint, orientation) == 0) {
             throw new RuntimeException("Failed to render block " + blockId);
         }
     }
 
+    /**
+     * renderBlocks with a tint and orientation per block, either array may be null.
+     */
+    public void renderBlocks(int[] blockIds, int[] xs, int[] ys, int[] tints, int[] orientations, int count) {
+        int rendered = library.ME_RenderBlocksEx(blockIds, xs, ys, tints, orientations, count);
+        if (rendered != count) {
+            throw new RuntimeException("Failed to render " + (count - rendered) + " of " + count + " blocks");
+        }
+    }
+
+    /**
+     * Make id a tinted and turned copy of baseId sharing its texture, placed and drawn like any block.
+     * baseId must be loaded or queued by loadBlockAsync.
+     */
+    public void registerBlockVariant(int id, int baseId, int tint, int orientation) {
+        if (library.ME_RegisterBlockVariant(id, baseId, tint, orientation) == 0) {
+            throw new RuntimeException("Failed to register block " + id + " as a variant of " + baseId);
+        }
+    }
+
+    public void beginFrame() {
+        int state = useJNI ? MainboardJNI.beginFrame(windowHandleValue) : library.ME_BeginFrame(windowHandle);
+        if (state == 0) {
+            throw new RuntimeException("A frame is already open.");
+        }
+    }
+
+    public void endFrame() {
+        int state = useJNI ? MainboardJNI.endFrame(windowHandleValue) : library.ME_EndFrame(windowHandle);
+        if (state == 0) {
+            throw new RuntimeException("Failed to render frame.");
+        }
+    }
+
+    /**
+     * Presents right away, or nothing inside beginFrame / endFrame since endFrame presents that frame.
+     */
     public void renderFrame() {
-        if (library.ME_RenderFrame(windowHandle) == 0) {
+        int state = useJNI ? MainboardJNI.renderFrame(windowHandleValue) : library.ME_RenderFrame(windowHandle);
+        if (state == 0) {
             throw new RuntimeException("Failed to render frame.");
         }
     }
 
+    public void traceStart() {
+        library.ME_TraceStart();
+    }
+
+    /**
+     * Stop recording native spans and dump them, open the file in chrome://tracing or ui.perfetto.dev.
+     */
+    public void traceStop(String path) {
+        if (library.ME_TraceStop(path) == 0) {
+            throw new RuntimeException("Failed to write trace to " + path);
+        }
+    }
+
+    /**
+     * Log every native call from now on, the file can be replayed with the native me_replay tool.
+     */
+    public void recordStart(String path) {
+        if (library.ME_RecordStart(path) == 0) {
+            throw new RuntimeException("Failed to record to " + path);
+        }
+    }
+
+    public void recordStop() {
+        if (library.ME_RecordStop() == 0) {
+            throw new RuntimeException("Failed to write the recording.");
+        }
+    }
+
     public void clearView() {
         if (library.ME_ClearView(windowHandle) == 0) {
             throw new RuntimeException("Failed to clear view.");
@@ -0,0 +1,32 @@
+package com.potato.NativeUtils;
+
+import com.sun.jna.Structure;
+
+import java.util.List;
+
+// in tiles of the static layer or world
+public class PathRequest extends Structure {
+    public static final int DIAGONAL = 1;
+
+    public int start_column, start_row, goal_column, goal_row;
+    // DIAGONAL for 8 neighbours
+    public int flags;
+    // tiles the search may expand before giving up, 0 for no limit
+    public int max_expanded;
+
+    public PathRequest() {
+    }
+
+    public PathRequest(int startColumn, int startRow, int goalColumn, int goalRow, int flags) {
+        this.start_column = startColumn;
+        this.start_row = startRow;
+        this.goal_column = goalColumn;
+        this.goal_row = goalRow;
+        this.flags = flags;
+    }
+
+    @Override
+    protected List<String> getFieldOrder() {
+        return List.of("start_column", "start_row", "goal_column", "goal_row", "flags", "max_expanded");
+    }
+}
@@ -0,0 +1,24 @@
+package com.potato.NativeUtils;
+
+import com.sun.jna.Structure;
+
+import java.util.List;
+
+public class PathResult extends Structure {
+    public static final int PENDING = 0;
+    public static final int FOUND = 1;
+    public static final int NONE = 2;
+    public static final int INVALID = 3;
+    // a tile on the path turned solid since it was found
+    public static final int BLOCKED = 4;
+
+    public int status;
+    // tiles from start to goal, offset is where they start in the tiles of getPaths, -1 when they didn't fit
+    public int length, offset, expanded;
+    public float cost;
+
+    @Override
+    protected List<String> getFieldOrder() {
+        return List.of("status", "length", "offset", "expanded", "cost");
+    }
+}
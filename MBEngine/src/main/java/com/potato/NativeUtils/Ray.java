@@ -0,0 +1,31 @@
+package com.potato.NativeUtils;
+
+import com.sun.jna.Structure;
+
+import java.util.List;
+
+public class Ray extends Structure {
+    public float x, y, dir_x, dir_y, max_distance;
+
+    public Ray() {
+    }
+
+    public Ray(float x, float y, float dirX, float dirY, float maxDistance) {
+        this.x = x;
+        this.y = y;
+        this.dir_x = dirX;
+        this.dir_y = dirY;
+        this.max_distance = maxDistance;
+    }
+
+    public static class ByReference extends Ray implements Structure.ByReference {
+        public ByReference(float x, float y, float dirX, float dirY, float maxDistance) {
+            super(x, y, dirX, dirY, maxDistance);
+        }
+    }
+
+    @Override
+    protected List<String> getFieldOrder() {
+        return List.of("x", "y", "dir_x", "dir_y", "max_distance");
+    }
+}
@@ -0,0 +1,21 @@
+package com.potato.NativeUtils;
+
+import com.sun.jna.Structure;
+
+import java.util.List;
+
+public class RaycastHit extends Structure {
+    public int hit, column, row, block_id;
+    // (x, y) is where the ray enters the tile
+    public float distance, x, y;
+    // side of the tile that was hit, 0 when the ray starts inside it
+    public int normal_x, normal_y;
+
+    public static class ByReference extends RaycastHit implements Structure.ByReference {
+    }
+
+    @Override
+    protected List<String> getFieldOrder() {
+        return List.of("hit", "column", "row", "block_id", "distance", "x", "y", "normal_x", "normal_y");
+    }
+}
@@ -0,0 +1,22 @@
+package com.potato.NativeUtils;
+
+import com.sun.jna.Structure;
+
+import java.util.List;
+
+// milliseconds since initializeEngine
+public class StartupStats extends Structure {
+    public double window_ms;
+    // 0 until it happened
+    public double first_frame_ms, loaded_ms;
+    public int pending_blocks, async_blocks, failed_blocks;
+
+    public static class ByReference extends StartupStats implements Structure.ByReference {
+    }
+
+    @Override
+    protected List<String> getFieldOrder() {
+        return List.of("window_ms", "first_frame_ms", "loaded_ms", "pending_blocks", "async_blocks",
+                "failed_blocks");
+    }
+}
@@ -0,0 +1,61 @@
+package com.potato.NativeUtils;
+
+import com.sun.jna.Structure;
+
+import java.util.List;
+
+public class ViewDesc extends Structure {
+    // keep in sync with ME_VIEW_* in mainboard_engine.h
+    public static final int MAIN = 0;
+    public static final int LAYER_STATIC = 1;
+    public static final int LAYER_BLOCKS = 2;
+    public static final int LAYER_TEXT = 4;
+    public static final int LAYER_PARTICLES = 8;
+    public static final int LAYER_ALL = 15;
+
+    public int x, y, width, height, camera_x, camera_y;
+    public float scale;
+    public int layer_mask, target_block_id;
+
+    public ViewDesc() {
+        this.scale = 1.0f;
+        this.layer_mask = LAYER_ALL;
+        this.target_block_id = -1;
+    }
+
+    /**
+     * A view drawn into a rect of the window.
+     */
+    public static ViewDesc.ByReference window(int x, int y, int width, int height, int cameraX, int cameraY,
+                                              float scale, int layerMask) {
+        ViewDesc.ByReference desc = new ViewDesc.ByReference();
+        desc.x = x;
+        desc.y = y;
+        desc.width = width;
+        desc.height = height;
+        desc.camera_x = cameraX;
+        desc.camera_y = cameraY;
+        desc.scale = scale;
+        desc.layer_mask = layerMask;
+        return desc;
+    }
+
+    /**
+     * A view rendered into a texture that is drawn with renderBlock(targetBlockId, ...), e.g. a minimap.
+     */
+    public static ViewDesc.ByReference offscreen(int targetBlockId, int width, int height, int cameraX, int cameraY,
+                                                 float scale, int layerMask) {
+        ViewDesc.ByReference desc = window(0, 0, width, height, cameraX, cameraY, scale, layerMask);
+        desc.target_block_id = targetBlockId;
+        return desc;
+    }
+
+    public static class ByReference extends ViewDesc implements Structure.ByReference {
+    }
+
+    @Override
+    protected List<String> getFieldOrder() {
+        return List.of("x", "y", "width", "height", "camera_x", "camera_y", "scale", "layer_mask",
+                "target_block_id");
+    }
+}
@@ -6,10 +6,15 @@ import com.potato.NativeUtils.NativeCaller;
 
 import java.io.File;
 import java.util.ArrayList;
+import java.util.concurrent.CompletableFuture;
 
 public class Engine {
     private NativeCaller caller;
     private ArrayList eventProcessers = new ArrayList<EventProcesser>();
+    private ArrayList<TickProcesser> tickProcessers = new ArrayList<>();
+    // 0 keeps the java driven loop, which ticks once per frame
+    private double tickRate = 0.0;
+    private double frameRate = 0.0;
     private boolean hasStarted = false;
     private String configFilePath;
     public final EngineHelper engineHelper = new EngineHelper(this);
@@ -23,16 +28,21 @@ public class Engine {
 
     public void start(int isFullScreen, int x, int y, int width, int height, String title) {
         Config.init(new File(configFilePath));
+        // the map file is parsed while the native side brings up the window and the renderer
+        CompletableFuture<Void> mapParsed = CompletableFuture.runAsync(() ->
+                mapManager.registerMap(Config.defaultMapId, Config.defaultMapId));
         caller.initializeEngine();
         caller.createWindow(isFullScreen, x, y, width, height, title);
         Config.gameContext.adjustContext("ENGINE_START");
 
-        mapManager.registerMap(Config.defaultMapId, Config.defaultMapId);
+        mapParsed.join();
+        // the map is on the static layer from here on, the loop presents it with every frame
         mapManager.loadMap(Config.defaultMapId, caller);
-        registerEventProcessor(((gameContext, caller) -> {
-            mapManager.renderMap(caller);
-        }));
-        caller.processEvents(eventProcessers);
+        if (tickRate > 0.0) {
+            caller.runLoop(tickRate, frameRate, tickProcessers, eventProcessers);
+        } else {
+            caller.processEvents(eventProcessers);
+        }
 
         hasStarted = true;
     }
@@ -48,6 +58,21 @@ public class Engine {
         eventProcessers.add(eventProcesser);
     }
 
+    public void registerTickProcessor(TickProcesser tickProcesser) {
+        if (hasStarted) {
+            throw new RuntimeException("Cannot register tick processor after engine has started.");
+        }
+        tickProcessers.add(tickProcesser);
+    }
+
+    /**
+     * Runs the native fixed timestep loop instead, tick processors at tickRate and event processors once per frame.
+     */
+    public void setTickRate(double tickRate, double frameRate) {
+        this.tickRate = tickRate;
+        this.frameRate = frameRate;
+    }
+
     public void setConfigFilePath(String configFilePath) {
         this.configFilePath = configFilePath;
     }
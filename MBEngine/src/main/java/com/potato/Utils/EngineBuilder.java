@@ -13,6 +13,12 @@ public class EngineBuilder {
         return this;
     }
 
+    public EngineBuilder tickRate(double tickRate, double frameRate) {
+        engine.setTickRate(tickRate, frameRate);
+
+        return this;
+    }
+
     public Engine build() {
         return engine;
     }
@@ -0,0 +1,8 @@
+package com.potato.Utils;
+
+import com.potato.NativeUtils.NativeCaller;
+
+// runs once per fixed simulation tick of NativeCaller.runLoop, dt is always 1 / tick rate
+public interface TickProcesser {
+    void tick(GameContext gameContext, NativeCaller caller, double dt);
+}
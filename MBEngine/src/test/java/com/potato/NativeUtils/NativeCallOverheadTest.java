@@ -0,0 +1,67 @@
+package com.potato.NativeUtils;
+
+import com.sun.jna.Pointer;
+import org.junit.jupiter.api.Test;
+
+import java.util.Arrays;
+
+import static org.junit.jupiter.api.Assertions.assertEquals;
+
+// Prints the per-call cost of each binding, run it after building the native library with a JDK present
+class NativeCallOverheadTest {
+    private static final int WARMUP = 200_000;
+    private static final int CALLS = 2_000_000;
+
+    private static double nsPerCall(Runnable body) {
+        return nsPerCall(body, WARMUP, CALLS);
+    }
+
+    private static double nsPerCall(Runnable body, int warmup, int calls) {
+        for (int i = 0; i < warmup; i++) {
+            body.run();
+        }
+        long start = System.nanoTime();
+        for (int i = 0; i < calls; i++) {
+            body.run();
+        }
+        return (System.nanoTime() - start) / (double) calls;
+    }
+
+    @Test
+    void measure() {
+        NativeCaller caller = new NativeCaller();
+        MainboardNativeLibrary library = MainboardNativeLibrary.INSTANCE;
+        assertEquals(MainboardJNI.VERSION, library.ME_GetVersion());
+
+        caller.initializeEngine();
+        caller.createWindow(0, 0, 0, 800, 600, "Native Call Overhead Test");
+        Pointer window = caller.getWindowHandle();
+        long windowValue = Pointer.nativeValue(window);
+
+        // block 1023 is never registered, the native side returns right after the lookup
+        System.out.printf("JNA ME_GetVersion:       %8.1f ns%n", nsPerCall(library::ME_GetVersion));
+        System.out.printf("JNA ME_RenderBlock:      %8.1f ns%n", nsPerCall(() -> library.ME_RenderBlock(1023, 0, 0)));
+        System.out.printf("JNA ME_SetWindowTitle:   %8.1f ns%n",
+                nsPerCall(() -> library.ME_SetWindowTitle(window, "Frame count: 12345")));
+
+        if (!MainboardJNI.isAvailable()) {
+            System.out.println("JNI bindings not built, skipping JNI measurements");
+            return;
+        }
+        System.out.printf("JNI getVersion:          %8.1f ns%n", nsPerCall(MainboardJNI::getVersion));
+        System.out.printf("JNI renderBlock:         %8.1f ns%n", nsPerCall(() -> MainboardJNI.renderBlock(1023, 0, 0)));
+        System.out.printf("JNI setWindowTitle:      %8.1f ns%n",
+                nsPerCall(() -> MainboardJNI.setWindowTitle(windowValue, "Frame count: 12345")));
+
+        int[] ids = new int[1024];
+        int[] xs = new int[1024];
+        int[] ys = new int[1024];
+        Arrays.fill(ids, 1023);
+        double jnaBatch = nsPerCall(() -> library.ME_RenderBlocks(ids, xs, ys, ids.length), 1_000, 10_000) / ids.length;
+        double jniBatch = nsPerCall(() -> MainboardJNI.renderBlocks(ids, xs, ys, ids.length), 1_000, 10_000) / ids.length;
+        System.out.printf("JNA ME_RenderBlocks/blk: %8.1f ns%n", jnaBatch);
+        System.out.printf("JNI renderBlocks/blk:    %8.1f ns%n", jniBatch);
+
+        caller.destroyWindow();
+    }
+}
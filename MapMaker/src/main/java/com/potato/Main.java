@@ -1,17 +1,56 @@
 package com.potato;
 
-//TIP To <b>Run</b> code, press <shortcut actionId="Run"/> or
-// click the <icon src="AllIcons.Actions.Execute"/> icon in the gutter.
+import com.potato.Map.MapManager;
+import com.potato.NativeUtils.MapStats;
+import com.potato.NativeUtils.NativeCaller;
+
+import java.io.File;
+
+// Edits a map file through the engine, the way the game saves maps:
+//   MapMaker <config.toml> <map id> <map file> [set <column> <row> <block>] [fill <column> <row> <width> <height> <block>]...
+// The first run writes the TOML map <map id> to <map file>, later runs edit the map file. A run costs what it
+// edits, the edits are appended to <map file>.journal, which is folded into the map file once it grows.
 public class Main {
+    private static final String USAGE = "usage: MapMaker <config.toml> <map id> <map file> "
+            + "[set <column> <row> <block>] [fill <column> <row> <width> <height> <block>]...";
+
     public static void main(String[] args) {
-        //TIP Press <shortcut actionId="ShowIntentionActions"/> with your caret at the highlighted text
-        // to see how IntelliJ IDEA suggests fixing it.
-        System.out.printf("Hello and welcome!");
+        if (args.length < 3) {
+            System.out.println(USAGE);
+            System.exit(1);
+        }
+        Config.init(new File(args[0]));
+        String mapId = args[1];
+        MapManager mapManager = MapManager.getMapManager();
+        mapManager.registerMap(mapId, mapId);
 
-        for (int i = 1; i <= 5; i++) {
-            //TIP Press <shortcut actionId="Debug"/> to start debugging your code. We have set one <icon src="AllIcons.Debugger.Db_set_breakpoint"/> breakpoint
-            // for you, but you can always add more by pressing <shortcut actionId="ToggleLineBreakpoint"/>.
-            System.out.println("i = " + i);
+        NativeCaller caller = new NativeCaller();
+        caller.initializeEngine();
+        caller.createWindow(0, 0, 0, 320, 240, "MapMaker");
+        try {
+            mapManager.editMap(mapId, args[2], caller);
+            int edits = 0;
+            for (int i = 3; i < args.length; ++edits) {
+                if (args[i].equals("set") && i + 3 < args.length) {
+                    caller.setTile(Integer.parseInt(args[i + 1]), Integer.parseInt(args[i + 2]),
+                            Integer.parseInt(args[i + 3]));
+                    i += 4;
+                } else if (args[i].equals("fill") && i + 5 < args.length) {
+                    caller.fillRect(Integer.parseInt(args[i + 1]), Integer.parseInt(args[i + 2]),
+                            Integer.parseInt(args[i + 3]), Integer.parseInt(args[i + 4]),
+                            Integer.parseInt(args[i + 5]));
+                    i += 6;
+                } else {
+                    throw new RuntimeException("Bad edit at " + args[i] + "\n" + USAGE);
+                }
+            }
+            caller.saveMap();
+            MapStats stats = caller.getMapStats();
+            System.out.printf("%d edits saved in %.2f ms, journal %d B, map file %d B%n", edits, stats.last_save_ms,
+                    stats.journal_bytes, stats.base_bytes);
+            caller.closeMap();
+        } finally {
+            caller.destroyWindow();
         }
     }
-}
\ No newline at end of file
+}